@@ -15,4 +15,7 @@ namespace LLGI
 
 class GraphicsDX12;
 
+//! the number of stages which descriptors and registers are assigned for. compute shaders are not supported on DirectX12 yet
+static constexpr int GraphicsStageCountDX12 = static_cast<int>(ShaderStageType::Compute);
+
 } // namespace LLGI
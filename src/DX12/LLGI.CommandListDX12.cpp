@@ -19,7 +19,7 @@ bool CommandListDX12::Initialize(GraphicsDX12* graphics)
 	HRESULT hr;
 
 	SafeAddRef(graphics);
-	graphics_ = CreateSharedPtr(graphics);
+	graphics_ = CreateRef(graphics);
 
 	for (int32_t i = 0; i < graphics_->GetSwapBufferCount(); i++)
 	{
@@ -31,7 +31,7 @@ bool CommandListDX12::Initialize(GraphicsDX12* graphics)
 		{
 			goto FAILED_EXIT;
 		}
-		commandAllocators.push_back(CreateSharedPtr(commandAllocator));
+		commandAllocators.push_back(CreateRef(commandAllocator));
 
 		hr = graphics_->GetDevice()->CreateCommandList(
 			0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator, NULL, IID_PPV_ARGS(&commandList));
@@ -40,19 +40,18 @@ bool CommandListDX12::Initialize(GraphicsDX12* graphics)
 			goto FAILED_EXIT;
 		}
 		commandList->Close();
-		commandLists.push_back(CreateSharedPtr(commandList));
+		commandLists.push_back(CreateRef(commandList));
 	}
 
 	for (size_t i = 0; i < static_cast<size_t>(graphics_->GetSwapBufferCount()); i++)
 	{
-		auto dp = std::make_shared<DescriptorHeapDX12>(graphics_, 100, 2);
-		descriptorHeaps_.push_back(dp);
+		descriptorHeaps_.push_back(CreateRef(new DescriptorHeapDX12(graphics_, 100, 2)));
 	}
 
 	return true;
 
 FAILED_EXIT:;
-	graphics_.reset();
+	graphics_.Reset();
 	commandAllocators.clear();
 	commandLists.clear();
 	descriptorHeaps_.clear();
@@ -62,8 +61,8 @@ FAILED_EXIT:;
 
 void CommandListDX12::Begin()
 {
-	auto commandList = commandLists[graphics_->GetCurrentSwapBufferIndex()];
-	commandList->Reset(commandAllocators[graphics_->GetCurrentSwapBufferIndex()].get(), nullptr);
+	auto commandList = commandLists[graphics_->GetCurrentSwapBufferIndex()].Get();
+	commandList->Reset(commandAllocators[graphics_->GetCurrentSwapBufferIndex()].Get(), nullptr);
 
 	auto& dp = descriptorHeaps_[graphics_->GetCurrentSwapBufferIndex()];
 	dp->Reset();
@@ -73,17 +72,17 @@ void CommandListDX12::Begin()
 
 void CommandListDX12::End()
 {
-	auto commandList = commandLists[graphics_->GetCurrentSwapBufferIndex()];
+	auto commandList = commandLists[graphics_->GetCurrentSwapBufferIndex()].Get();
 
 	commandList->Close();
 }
 
 void CommandListDX12::BeginRenderPass(RenderPass* renderPass)
 {
-	auto commandList = commandLists[graphics_->GetCurrentSwapBufferIndex()];
+	auto commandList = commandLists[graphics_->GetCurrentSwapBufferIndex()].Get();
 
 	SafeAddRef(renderPass);
-	renderPass_ = CreateSharedPtr((RenderPassDX12*)renderPass);
+	renderPass_ = CreateRef((RenderPassDX12*)renderPass);
 
 	if (renderPass != nullptr)
 	{
@@ -100,7 +99,7 @@ void CommandListDX12::BeginRenderPass(RenderPass* renderPass)
 			descriptorHeaps->IncrementGpuHandle(D3D12_DESCRIPTOR_HEAP_TYPE_RTV, 1);
 
 			// memory barrior to make a rendertarget
-			renderPass_->GetTextures()[0]->ResourceBarrior(commandList.get(), D3D12_RESOURCE_STATE_RENDER_TARGET);
+			renderPass_->GetTextures()[0]->ResourceBarrior(commandList, D3D12_RESOURCE_STATE_RENDER_TARGET);
 		}
 
 		// Set render target
@@ -135,15 +134,68 @@ void CommandListDX12::BeginRenderPass(RenderPass* renderPass)
 
 void CommandListDX12::EndRenderPass()
 {
-	renderPass_.reset();
+	renderPass_.Reset();
+}
+
+void CommandListDX12::ResourceBarriers(const ResourceBarrier* barriers, int32_t count)
+{
+	auto commandList = commandLists[graphics_->GetCurrentSwapBufferIndex()].Get();
+
+	auto dxBarriers = GetFrameAllocator().Allocate<D3D12_RESOURCE_BARRIER>(count);
+	UINT dxBarrierCount = 0;
+
+	for (int32_t i = 0; i < count; i++)
+	{
+		auto texture = static_cast<TextureDX12*>(barriers[i].texture);
+		if (texture == nullptr)
+			continue;
+
+		D3D12_RESOURCE_STATES state = D3D12_RESOURCE_STATE_COMMON;
+		switch (barriers[i].state)
+		{
+		case ResourceState::ShaderResource:
+			state = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+			break;
+		case ResourceState::RenderTarget:
+			state = D3D12_RESOURCE_STATE_RENDER_TARGET;
+			break;
+		case ResourceState::DepthWrite:
+			state = D3D12_RESOURCE_STATE_DEPTH_WRITE;
+			break;
+		case ResourceState::CopySource:
+			state = D3D12_RESOURCE_STATE_COPY_SOURCE;
+			break;
+		case ResourceState::CopyDest:
+			state = D3D12_RESOURCE_STATE_COPY_DEST;
+			break;
+		}
+
+		D3D12_RESOURCE_BARRIER barrier;
+		if (texture->CreateResourceBarrior(state, barrier))
+		{
+			dxBarriers[dxBarrierCount] = barrier;
+			dxBarrierCount++;
+		}
+	}
+
+	if (dxBarrierCount > 0)
+	{
+		commandList->ResourceBarrier(dxBarrierCount, dxBarriers);
+	}
+}
+
+void CommandListDX12::Dispatch(int32_t x, int32_t y, int32_t z)
+{
+	assert(0 && "Dispatch is not supported on DirectX12");
+	CommandList::Dispatch(x, y, z);
 }
 
 void CommandListDX12::Draw(int32_t pritimiveCount)
 {
-	auto commandList = commandLists[graphics_->GetCurrentSwapBufferIndex()];
+	auto commandList = commandLists[graphics_->GetCurrentSwapBufferIndex()].Get();
 
 	BindingVertexBuffer vb_;
-	IndexBuffer* ib_ = nullptr;
+	BindingIndexBuffer ib_;
 	ConstantBuffer* cb = nullptr;
 	PipelineState* pip_ = nullptr;
 
@@ -156,29 +208,33 @@ void CommandListDX12::Draw(int32_t pritimiveCount)
 	GetCurrentPipelineState(pip_, isPipDirtied);
 
 	assert(vb_.vertexBuffer != nullptr);
-	assert(ib_ != nullptr);
+	assert(ib_.indexBuffer != nullptr);
 	assert(pip_ != nullptr);
 
-	auto vb = static_cast<VertexBufferDX12*>(vb_.vertexBuffer);
-	auto ib = static_cast<IndexBufferDX12*>(ib_);
+	auto ib = static_cast<IndexBufferDX12*>(ib_.indexBuffer);
 	auto pip = static_cast<PipelineStateDX12*>(pip_);
 
+	// assign vertex buffers
+	for (int32_t slot = 0; slot < NumVertexBufferSlot; slot++)
 	{
+		GetCurrentVertexBuffer(slot, vb_, isVBDirtied);
+		if (vb_.vertexBuffer == nullptr)
+			continue;
+
+		auto vb = static_cast<VertexBufferDX12*>(vb_.vertexBuffer);
+
 		D3D12_VERTEX_BUFFER_VIEW vertexView;
 		vertexView.BufferLocation = vb->Get()->GetGPUVirtualAddress() + vb_.offset;
-		vertexView.StrideInBytes = vb_.stride;
+		vertexView.StrideInBytes = pip->VertexStrides[slot] >= 0 ? pip->VertexStrides[slot] : vb_.stride;
 		vertexView.SizeInBytes = vb_.vertexBuffer->GetSize() - vb_.offset;
-		if (vb_.vertexBuffer != nullptr)
-		{
-			commandList->IASetVertexBuffers(0, 1, &vertexView);
-		}
+		commandList->IASetVertexBuffers(slot, 1, &vertexView);
 	}
 
 	if (ib != nullptr)
 	{
 		D3D12_INDEX_BUFFER_VIEW indexView;
-		indexView.BufferLocation = ib->Get()->GetGPUVirtualAddress();
-		indexView.SizeInBytes = ib->GetStride() * ib->GetCount();
+		indexView.BufferLocation = ib->Get()->GetGPUVirtualAddress() + ib_.offset;
+		indexView.SizeInBytes = ib->GetStride() * ib->GetCount() - ib_.offset;
 		indexView.Format = ib->GetStride() == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
 		commandList->IASetIndexBuffer(&indexView);
 	}
@@ -204,11 +260,11 @@ void CommandListDX12::Draw(int32_t pritimiveCount)
 		commandList->SetGraphicsRootDescriptorTable(1, descriptorHeaps->GetGpuHandle(D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER));
 	}
 
-	int increment = NumTexture * static_cast<int>(ShaderStageType::Max);
+	int increment = NumTexture * GraphicsStageCountDX12;
 
 	// constant buffer
 	{
-		for (int stage_ind = 0; stage_ind < static_cast<int>(ShaderStageType::Max); stage_ind++)
+		for (int stage_ind = 0; stage_ind < GraphicsStageCountDX12; stage_ind++)
 		{
 			GetCurrentConstantBuffer(static_cast<ShaderStageType>(stage_ind), cb);
 			if (cb != nullptr)
@@ -222,11 +278,11 @@ void CommandListDX12::Draw(int32_t pritimiveCount)
 			}
 			descriptorHeaps->IncrementCpuHandle(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 1);
 		}
-		descriptorHeaps->IncrementGpuHandle(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, static_cast<int>(ShaderStageType::Max));
+		descriptorHeaps->IncrementGpuHandle(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, GraphicsStageCountDX12);
 	}
 
 	{
-		for (int stage_ind = 0; stage_ind < static_cast<int>(ShaderStageType::Max); stage_ind++)
+		for (int stage_ind = 0; stage_ind < GraphicsStageCountDX12; stage_ind++)
 		{
 			for (int unit_ind = 0; unit_ind < currentTextures[stage_ind].size(); unit_ind++)
 			{
@@ -241,11 +297,11 @@ void CommandListDX12::Draw(int32_t pritimiveCount)
 					{
 						if (stage_ind == static_cast<int>(ShaderStageType::Pixel))
 						{
-							texture->ResourceBarrior(commandList.get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+							texture->ResourceBarrior(commandList, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 						}
 						else
 						{
-							texture->ResourceBarrior(commandList.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+							texture->ResourceBarrior(commandList, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
 						}
 					}
 
@@ -262,33 +318,14 @@ void CommandListDX12::Draw(int32_t pritimiveCount)
 						graphics_->GetDevice()->CreateShaderResourceView(texture->Get(), &srvDesc, cpuHandle);
 					}
 
-					// Sampler
+					// Sampler (copied from a shared cache)
 					{
-						D3D12_SAMPLER_DESC samplerDesc = {};
-
-						// TODO
-						samplerDesc.Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
-
-						if (wrapMode == TextureWrapMode::Repeat)
+						auto samplerHandle = graphics_->GetSampler(wrapMode, minMagFilter);
+						if (samplerHandle.ptr != 0)
 						{
-							samplerDesc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
-							samplerDesc.AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
-							samplerDesc.AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+							auto cpuHandle = descriptorHeaps->GetCpuHandle(D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
+							graphics_->GetDevice()->CopyDescriptorsSimple(1, cpuHandle, samplerHandle, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
 						}
-						else
-						{
-							samplerDesc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-							samplerDesc.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-							samplerDesc.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-						}
-						samplerDesc.MipLODBias = 0;
-						samplerDesc.MaxAnisotropy = 0;
-						samplerDesc.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
-						samplerDesc.MinLOD = 0.0f;
-						samplerDesc.MaxLOD = D3D12_FLOAT32_MAX;
-
-						auto cpuHandle = descriptorHeaps->GetCpuHandle(D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
-						graphics_->GetDevice()->CreateSampler(&samplerDesc, cpuHandle);
 					}
 				}
 				descriptorHeaps->IncrementCpuHandle(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 1);
@@ -298,6 +335,26 @@ void CommandListDX12::Draw(int32_t pritimiveCount)
 		descriptorHeaps->IncrementGpuHandle(D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER, increment);
 	}
 
+	// push constants are reassigned because root arguments are reset with a root signature
+	for (int stage_ind = 0; stage_ind < static_cast<int>(ShaderStageType::Max); stage_ind++)
+	{
+		auto stage = static_cast<ShaderStageType>(stage_ind);
+		auto rootParameterIndex = pip->GetPushConstantRootParameterIndex(stage);
+		if (rootParameterIndex < 0)
+			continue;
+
+		const void* data = nullptr;
+		int32_t size = 0;
+		bool isDirtied = false;
+		GetCurrentPushConstants(stage, data, size, isDirtied);
+
+		size = (std::min)(size, pip->PushConstantSizes[stage_ind]);
+		if (size == 0)
+			continue;
+
+		commandList->SetGraphicsRoot32BitConstants(rootParameterIndex, size / 4, data, 0);
+	}
+
 	// setup a topology (triangle)
 	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
@@ -309,9 +366,9 @@ void CommandListDX12::Draw(int32_t pritimiveCount)
 
 void CommandListDX12::Clear(const Color8& color)
 {
-	auto commandList = commandLists[graphics_->GetCurrentSwapBufferIndex()];
+	auto commandList = commandLists[graphics_->GetCurrentSwapBufferIndex()].Get();
 
-	auto rt = renderPass_;
+	auto rt = renderPass_.Get();
 	if (rt == nullptr)
 		return;
 
@@ -322,8 +379,8 @@ void CommandListDX12::Clear(const Color8& color)
 
 ID3D12GraphicsCommandList* CommandListDX12::GetCommandList() const
 {
-	auto commandList = commandLists[graphics_->GetCurrentSwapBufferIndex()];
-	return commandList.get();
+	auto commandList = commandLists[graphics_->GetCurrentSwapBufferIndex()].Get();
+	return commandList;
 }
 
 } // namespace LLGI
@@ -13,13 +13,13 @@ namespace LLGI
 class CommandListDX12 : public CommandList
 {
 private:
-	std::shared_ptr<GraphicsDX12> graphics_;
-	std::shared_ptr<RenderPassDX12> renderPass_;
+	Ref<GraphicsDX12> graphics_;
+	Ref<RenderPassDX12> renderPass_;
 
-	std::vector<std::shared_ptr<ID3D12GraphicsCommandList>> commandLists;
-	std::vector<std::shared_ptr<ID3D12CommandAllocator>> commandAllocators;
+	std::vector<Ref<ID3D12GraphicsCommandList>> commandLists;
+	std::vector<Ref<ID3D12CommandAllocator>> commandAllocators;
 
-	std::vector<std::shared_ptr<DescriptorHeapDX12>> descriptorHeaps_;
+	std::vector<Ref<DescriptorHeapDX12>> descriptorHeaps_;
 
 public:
 	CommandListDX12();
@@ -30,8 +30,12 @@ public:
 	void End() override;
 	void BeginRenderPass(RenderPass* renderPass) override;
 	void EndRenderPass() override;
+	void ResourceBarriers(const ResourceBarrier* barriers, int32_t count) override;
 	void Draw(int32_t pritimiveCount) override;
 
+	//! compute shaders are not supported yet
+	void Dispatch(int32_t x, int32_t y, int32_t z) override;
+
 	void Clear(const Color8& color);
 
 	ID3D12GraphicsCommandList* GetCommandList() const;
@@ -68,6 +68,7 @@ void CompilerDX12::Compile(CompilerResult& result, const char* code, ShaderStage
 {
 	char* vs_target = "vs_5_0";
 	char* ps_target = "ps_5_0";
+	char* cs_target = "cs_5_0";
 	char* target = nullptr;
 
 	if (shaderStage == ShaderStageType::Vertex)
@@ -78,6 +79,10 @@ void CompilerDX12::Compile(CompilerResult& result, const char* code, ShaderStage
 	{
 		target = ps_target;
 	}
+	else if (shaderStage == ShaderStageType::Compute)
+	{
+		target = cs_target;
+	}
 
 	std::vector<D3D_SHADER_MACRO> macro;
 	auto compileResult = CompileShader(code, "dx12_code", target, macro);
@@ -3,11 +3,9 @@
 namespace LLGI
 {
 
-DescriptorHeapDX12::DescriptorHeapDX12(std::shared_ptr<GraphicsDX12> graphics, int size, int stage)
-	: graphics_(graphics), size_(size), stage_(stage)
+DescriptorHeapDX12::DescriptorHeapDX12(Ref<GraphicsDX12> graphics, int size, int stage)
+	: graphics_(std::move(graphics)), size_(size), stage_(stage)
 {
-	SafeAddRef(graphics);
-
 	for (int i = 0; i < numHeaps_; i++)
 	{
 		auto heap = CreateHeap(static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(i), size_ * stage_);
@@ -20,7 +18,6 @@ DescriptorHeapDX12::DescriptorHeapDX12(std::shared_ptr<GraphicsDX12> graphics, i
 
 DescriptorHeapDX12::~DescriptorHeapDX12()
 {
-	SafeRelease(graphics_);
 	for (int i = 0; i < numHeaps_; i++)
 		SafeRelease(descriptorHeaps_[i]);
 }
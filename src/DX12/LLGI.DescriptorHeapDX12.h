@@ -5,12 +5,12 @@
 
 namespace LLGI
 {
-class DescriptorHeapDX12
+class DescriptorHeapDX12 : public ReferenceObject
 {
 private:
 	static const int numHeaps_ = static_cast<int>(D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES);
 
-	std::shared_ptr<GraphicsDX12> graphics_;
+	Ref<GraphicsDX12> graphics_;
 	int size_ = 0;
 	int stage_ = 0;
 	int offset_ = 0;
@@ -22,7 +22,7 @@ private:
 	ID3D12DescriptorHeap* CreateHeap(D3D12_DESCRIPTOR_HEAP_TYPE heapType, int numDescriptors);
 
 public:
-	DescriptorHeapDX12(std::shared_ptr<GraphicsDX12> graphics, int size, int stage);
+	DescriptorHeapDX12(Ref<GraphicsDX12> graphics, int size, int stage);
 	virtual ~DescriptorHeapDX12();
 
 	void IncrementCpuHandle(D3D12_DESCRIPTOR_HEAP_TYPE heapType, int count);
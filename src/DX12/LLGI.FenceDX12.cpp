@@ -0,0 +1,110 @@
+#include "LLGI.FenceDX12.h"
+
+namespace LLGI
+{
+
+FenceDX12::~FenceDX12()
+{
+	// an event must not be closed while it may be set
+	Wait(signaledValue_);
+	ClosePendingEvents(signaledValue_);
+
+	SafeRelease(fence_);
+}
+
+void FenceDX12::ClosePendingEvents(uint64_t completedValue)
+{
+	std::lock_guard<std::mutex> lock(pendingEventsMutex_);
+
+	auto it = pendingEvents_.begin();
+	while (it != pendingEvents_.end())
+	{
+		if (it->first <= completedValue)
+		{
+			CloseHandle(it->second);
+			it = pendingEvents_.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+}
+
+bool FenceDX12::Initialize(GraphicsDX12* graphics)
+{
+	auto hr = graphics->GetDevice()->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
+	if (FAILED(hr))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+uint64_t FenceDX12::Signal(ID3D12CommandQueue* commandQueue)
+{
+	auto hr = commandQueue->Signal(fence_, signaledValue_ + 1);
+	if (FAILED(hr))
+	{
+		return 0;
+	}
+
+	signaledValue_++;
+	return signaledValue_;
+}
+
+uint64_t FenceDX12::GetCompletedValue()
+{
+	if (fence_ == nullptr)
+	{
+		return 0;
+	}
+
+	return fence_->GetCompletedValue();
+}
+
+bool FenceDX12::Wait(uint64_t value, int32_t timeout)
+{
+	auto completedValue = GetCompletedValue();
+	ClosePendingEvents(completedValue);
+
+	if (completedValue >= value)
+	{
+		return true;
+	}
+
+	// it would wait forever
+	if (value > signaledValue_)
+	{
+		return false;
+	}
+
+	// an event is made per wait, so that it is not set by waits on other threads or waits which are timed out
+	auto event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	if (event == nullptr)
+	{
+		return false;
+	}
+
+	auto hr = fence_->SetEventOnCompletion(value, event);
+	if (FAILED(hr))
+	{
+		CloseHandle(event);
+		return false;
+	}
+
+	if (WaitForSingleObject(event, timeout < 0 ? INFINITE : static_cast<DWORD>(timeout)) == WAIT_OBJECT_0)
+	{
+		CloseHandle(event);
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock(pendingEventsMutex_);
+		pendingEvents_.push_back(std::make_pair(value, event));
+	}
+
+	return GetCompletedValue() >= value;
+}
+
+} // namespace LLGI
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../LLGI.Fence.h"
+#include "LLGI.BaseDX12.h"
+#include "LLGI.GraphicsDX12.h"
+#include <mutex>
+#include <vector>
+
+namespace LLGI
+{
+
+class FenceDX12 : public Fence
+{
+private:
+	ID3D12Fence* fence_ = nullptr;
+
+	//! events of waits which are timed out. They are closed after the fence sets them.
+	std::vector<std::pair<uint64_t, HANDLE>> pendingEvents_;
+	std::mutex pendingEventsMutex_;
+
+	void ClosePendingEvents(uint64_t completedValue);
+
+public:
+	FenceDX12() = default;
+	virtual ~FenceDX12();
+
+	bool Initialize(GraphicsDX12* graphics);
+
+	//! signal a value on a queue after commands which are executed before
+	uint64_t Signal(ID3D12CommandQueue* commandQueue);
+
+	uint64_t GetCompletedValue() override;
+
+	bool Wait(uint64_t value, int32_t timeout = -1) override;
+};
+
+} // namespace LLGI
@@ -1,6 +1,7 @@
 #include "LLGI.GraphicsDX12.h"
 #include "LLGI.CommandListDX12.h"
 #include "LLGI.ConstantBufferDX12.h"
+#include "LLGI.FenceDX12.h"
 #include "LLGI.IndexBufferDX12.h"
 #include "LLGI.PipelineStateDX12.h"
 #include "LLGI.ShaderDX12.h"
@@ -29,18 +30,30 @@ GraphicsDX12::GraphicsDX12(ID3D12Device* device,
 	// Create Command Allocator
 	hr = device->CreateCommandAllocator(commandListType_, IID_PPV_ARGS(&commandAllocator_));
 	assert(SUCCEEDED(hr));
+
+	// buffers on an upload heap can be mapped persistently
+	InitializeTransientBuffers(swapBufferCount_);
 }
 
 GraphicsDX12::~GraphicsDX12()
 {
 	WaitFinish();
 
+	DisposeTransientBuffers();
+
+	samplers_.clear();
+	SafeRelease(samplerHeap_);
+
 	SafeRelease(device_);
 	SafeRelease(commandQueue_);
 	SafeRelease(commandAllocator_);
 }
 
-void GraphicsDX12::NewFrame() { currentSwapBufferIndex = (currentSwapBufferIndex + 1) % swapBufferCount_; }
+void GraphicsDX12::NewFrame()
+{
+	currentSwapBufferIndex = (currentSwapBufferIndex + 1) % swapBufferCount_;
+	NewTransientBufferFrame();
+}
 
 void GraphicsDX12::Execute(CommandList* commandList)
 {
@@ -49,6 +62,16 @@ void GraphicsDX12::Execute(CommandList* commandList)
 	commandQueue_->ExecuteCommandLists(1, (ID3D12CommandList**)(&cl_internal));
 }
 
+uint64_t GraphicsDX12::Signal(Fence* fence)
+{
+	if (fence == nullptr)
+	{
+		return 0;
+	}
+
+	return static_cast<FenceDX12*>(fence)->Signal(commandQueue_);
+}
+
 void GraphicsDX12::WaitFinish()
 {
 	if (waitFunc_ != nullptr)
@@ -122,6 +145,12 @@ Shader* GraphicsDX12::CreateShader(DataStructure* data, int32_t count)
 	return obj;
 }
 
+StorageBuffer* GraphicsDX12::CreateStorageBuffer(int32_t size)
+{
+	assert(0 && "StorageBuffer is not supported on DirectX12");
+	return nullptr;
+}
+
 CommandList* GraphicsDX12::CreateCommandList()
 {
 	auto obj = new CommandListDX12();
@@ -133,6 +162,17 @@ CommandList* GraphicsDX12::CreateCommandList()
 	return obj;
 }
 
+Fence* GraphicsDX12::CreateFence()
+{
+	auto obj = new FenceDX12();
+	if (!obj->Initialize(this))
+	{
+		SafeRelease(obj);
+		return nullptr;
+	}
+	return obj;
+}
+
 PipelineState* GraphicsDX12::CreatePiplineState() { return new PipelineStateDX12(this); }
 
 RenderPass* GraphicsDX12::CreateRenderPass(const Texture** textures, int32_t textureCount, Texture* depthTexture)
@@ -189,6 +229,71 @@ std::shared_ptr<RenderPassPipelineStateDX12> GraphicsDX12::CreateRenderPassPipel
 	return ret;
 }
 
+D3D12_CPU_DESCRIPTOR_HANDLE GraphicsDX12::GetSampler(const SamplerDX12Key& key)
+{
+	auto it = samplers_.find(key);
+	if (it != samplers_.end())
+	{
+		return it->second;
+	}
+
+	D3D12_CPU_DESCRIPTOR_HANDLE handle = {};
+
+	if (samplerHeap_ == nullptr)
+	{
+		D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+		heapDesc.NumDescriptors = MaxSamplerCount;
+		heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER;
+		heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+		heapDesc.NodeMask = 1;
+
+		auto hr = device_->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&samplerHeap_));
+		if (FAILED(hr))
+		{
+			SafeRelease(samplerHeap_);
+			return handle;
+		}
+	}
+
+	if (samplerCount_ >= MaxSamplerCount)
+	{
+		return handle;
+	}
+
+	D3D12_SAMPLER_DESC samplerDesc = {};
+	samplerDesc.Filter = key.filter;
+	samplerDesc.AddressU = key.addressU;
+	samplerDesc.AddressV = key.addressV;
+	samplerDesc.AddressW = key.addressW;
+	samplerDesc.MipLODBias = 0;
+	samplerDesc.MaxAnisotropy = key.maxAnisotropy;
+	samplerDesc.ComparisonFunc = key.comparisonFunc;
+	samplerDesc.MinLOD = key.minLOD;
+	samplerDesc.MaxLOD = key.maxLOD;
+
+	handle = samplerHeap_->GetCPUDescriptorHandleForHeapStart();
+	handle.ptr += device_->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER) * samplerCount_;
+	device_->CreateSampler(&samplerDesc, handle);
+
+	samplerCount_++;
+	samplers_[key] = handle;
+	return handle;
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE GraphicsDX12::GetSampler(TextureWrapMode wrapMode, TextureMinMagFilter minMagFilter)
+{
+	SamplerDX12Key key;
+
+	key.filter = minMagFilter == TextureMinMagFilter::Linear ? D3D12_FILTER_MIN_MAG_MIP_LINEAR : D3D12_FILTER_MIN_MAG_MIP_POINT;
+
+	auto addressMode = wrapMode == TextureWrapMode::Repeat ? D3D12_TEXTURE_ADDRESS_MODE_WRAP : D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	key.addressU = addressMode;
+	key.addressV = addressMode;
+	key.addressW = addressMode;
+
+	return GetSampler(key);
+}
+
 ID3D12Device* GraphicsDX12::GetDevice() { return device_; }
 
 int32_t GraphicsDX12::GetCurrentSwapBufferIndex() const { return currentSwapBufferIndex; }
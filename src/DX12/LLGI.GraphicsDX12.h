@@ -12,6 +12,47 @@ namespace LLGI
 {
 class RenderPassDX12;
 
+/**
+	@brief	a description of a sampler which is shared between command lists
+*/
+struct SamplerDX12Key
+{
+	D3D12_FILTER filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+	D3D12_TEXTURE_ADDRESS_MODE addressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	D3D12_TEXTURE_ADDRESS_MODE addressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	D3D12_TEXTURE_ADDRESS_MODE addressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	UINT maxAnisotropy = 0;
+	D3D12_COMPARISON_FUNC comparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+	float minLOD = 0.0f;
+	float maxLOD = D3D12_FLOAT32_MAX;
+
+	bool operator==(const SamplerDX12Key& value) const
+	{
+		return filter == value.filter && addressU == value.addressU && addressV == value.addressV && addressW == value.addressW &&
+			   maxAnisotropy == value.maxAnisotropy && comparisonFunc == value.comparisonFunc && minLOD == value.minLOD &&
+			   maxLOD == value.maxLOD;
+	}
+
+	struct Hash
+	{
+		typedef std::size_t result_type;
+
+		std::size_t operator()(const SamplerDX12Key& key) const
+		{
+			std::size_t hash = 0;
+			HashCombine(hash, std::hash<int32_t>()(static_cast<int32_t>(key.filter)));
+			HashCombine(hash, std::hash<int32_t>()(static_cast<int32_t>(key.addressU)));
+			HashCombine(hash, std::hash<int32_t>()(static_cast<int32_t>(key.addressV)));
+			HashCombine(hash, std::hash<int32_t>()(static_cast<int32_t>(key.addressW)));
+			HashCombine(hash, std::hash<uint32_t>()(key.maxAnisotropy));
+			HashCombine(hash, std::hash<int32_t>()(static_cast<int32_t>(key.comparisonFunc)));
+			HashCombine(hash, std::hash<float>()(key.minLOD));
+			HashCombine(hash, std::hash<float>()(key.maxLOD));
+			return hash;
+		}
+	};
+};
+
 class GraphicsDX12 : public Graphics
 {
 private:
@@ -31,7 +72,15 @@ private:
 	std::unordered_map<RenderPassPipelineStateDX12Key, std::weak_ptr<RenderPassPipelineStateDX12>, RenderPassPipelineStateDX12Key::Hash>
 		renderPassPipelineStates;
 
+	//! a heap which is not shader visible to keep samplers to be copied
+	ID3D12DescriptorHeap* samplerHeap_ = nullptr;
+	int32_t samplerCount_ = 0;
+	std::unordered_map<SamplerDX12Key, D3D12_CPU_DESCRIPTOR_HANDLE, SamplerDX12Key::Hash> samplers_;
+
 public:
+	//! the maximum number of kinds of samplers
+	static const int32_t MaxSamplerCount = 256;
+
 	GraphicsDX12(ID3D12Device* device,
 				 std::function<std::tuple<D3D12_CPU_DESCRIPTOR_HANDLE, ID3D12Resource*>()> getScreenFunc,
 				 std::function<void()> waitFunc,
@@ -42,21 +91,34 @@ public:
 	void NewFrame() override;
 
 	void Execute(CommandList* commandList) override;
+	uint64_t Signal(Fence* fence) override;
 	void WaitFinish() override;
 
 	RenderPass* GetCurrentScreen(const Color8& clearColor, bool isColorCleared, bool isDepthCleared) override;
 	VertexBuffer* CreateVertexBuffer(int32_t size) override;
 	IndexBuffer* CreateIndexBuffer(int32_t stride, int32_t count) override;
 	ConstantBuffer* CreateConstantBuffer(int32_t size, ConstantBufferType type = ConstantBufferType::LongTime) override;
+
+	//! storage buffers are not supported yet, so it returns null
+	StorageBuffer* CreateStorageBuffer(int32_t size) override;
 	Shader* CreateShader(DataStructure* data, int32_t count) override;
 	PipelineState* CreatePiplineState() override;
 	CommandList* CreateCommandList() override;
+	Fence* CreateFence() override;
 	RenderPass* CreateRenderPass(const Texture** textures, int32_t textureCount, Texture* depthTexture) override;
 	Texture* CreateTexture(const Vec2I& size, bool isRenderPass, bool isDepthBuffer) override;
 	Texture* CreateTexture(uint64_t id) override;
 
 	std::shared_ptr<RenderPassPipelineStateDX12> CreateRenderPassPipelineState(bool isPresentMode, bool hasDepth);
 
+	/**
+		@brief	get a sampler which is created once per description and shared
+		@return	a cpu handle to be copied into a shader visible heap. ptr is 0 if it is failed to create.
+	*/
+	D3D12_CPU_DESCRIPTOR_HANDLE GetSampler(const SamplerDX12Key& key);
+
+	D3D12_CPU_DESCRIPTOR_HANDLE GetSampler(TextureWrapMode wrapMode, TextureMinMagFilter minMagFilter);
+
 	ID3D12Device* GetDevice();
 
 	int32_t GetCurrentSwapBufferIndex() const;
@@ -11,8 +11,9 @@ namespace LLGI
 PipelineStateDX12::PipelineStateDX12(GraphicsDX12* graphics)
 {
 	SafeAddRef(graphics);
-	graphics_ = CreateSharedPtr(graphics);
+	graphics_ = CreateRef(graphics);
 	shaders_.fill(nullptr);
+	pushConstantRootParameterIndexes_.fill(-1);
 }
 
 PipelineStateDX12::~PipelineStateDX12()
@@ -33,6 +34,46 @@ void PipelineStateDX12::SetShader(ShaderStageType stage, Shader* shader)
 	shaders_[static_cast<int>(stage)] = shader;
 }
 
+static DXGI_FORMAT ConvertVertexLayoutFormat(VertexLayoutFormat format)
+{
+	switch (format)
+	{
+	case VertexLayoutFormat::R32G32B32_FLOAT:
+		return DXGI_FORMAT_R32G32B32_FLOAT;
+	case VertexLayoutFormat::R32G32B32A32_FLOAT:
+		return DXGI_FORMAT_R32G32B32A32_FLOAT;
+	case VertexLayoutFormat::R8G8B8A8_UNORM:
+		return DXGI_FORMAT_R8G8B8A8_UNORM;
+	case VertexLayoutFormat::R8G8B8A8_UINT:
+		return DXGI_FORMAT_R8G8B8A8_UINT;
+	case VertexLayoutFormat::R32G32_FLOAT:
+		return DXGI_FORMAT_R32G32_FLOAT;
+	case VertexLayoutFormat::R16G16_FLOAT:
+		return DXGI_FORMAT_R16G16_FLOAT;
+	case VertexLayoutFormat::R16G16B16A16_FLOAT:
+		return DXGI_FORMAT_R16G16B16A16_FLOAT;
+	case VertexLayoutFormat::R16G16_SNORM:
+		return DXGI_FORMAT_R16G16_SNORM;
+	case VertexLayoutFormat::R16G16B16A16_SNORM:
+		return DXGI_FORMAT_R16G16B16A16_SNORM;
+	case VertexLayoutFormat::R16G16_UNORM:
+		return DXGI_FORMAT_R16G16_UNORM;
+	case VertexLayoutFormat::R16G16B16A16_UNORM:
+		return DXGI_FORMAT_R16G16B16A16_UNORM;
+	case VertexLayoutFormat::R8G8B8A8_SNORM:
+		return DXGI_FORMAT_R8G8B8A8_SNORM;
+	case VertexLayoutFormat::R10G10B10A2_UNORM:
+		return DXGI_FORMAT_R10G10B10A2_UNORM;
+	case VertexLayoutFormat::R16G16B16A16_UINT:
+		return DXGI_FORMAT_R16G16B16A16_UINT;
+	case VertexLayoutFormat::R32_UINT:
+		return DXGI_FORMAT_R32_UINT;
+	}
+
+	assert(0);
+	return DXGI_FORMAT_UNKNOWN;
+}
+
 void PipelineStateDX12::Compile()
 {
 	CreateRootSignature();
@@ -41,6 +82,9 @@ void PipelineStateDX12::Compile()
 
 	for (size_t i = 0; i < shaders_.size(); i++)
 	{
+		if (shaders_[i] == nullptr)
+			continue;
+
 		auto& shaderData = static_cast<ShaderDX12*>(shaders_[i])->GetData();
 
 		if (i == static_cast<int>(ShaderStageType::Pixel))
@@ -58,44 +102,16 @@ void PipelineStateDX12::Compile()
 	// setup a vertex layout
 	std::array<D3D12_INPUT_ELEMENT_DESC, 16> elementDescs;
 	elementDescs.fill(D3D12_INPUT_ELEMENT_DESC{});
-	int32_t elementOffset = 0;
 
 	for (int i = 0; i < VertexLayoutCount; i++)
 	{
 		elementDescs[i].SemanticName = this->VertexLayoutNames[i].c_str();
 		elementDescs[i].SemanticIndex = 0;
-		elementDescs[i].AlignedByteOffset = elementOffset;
+		elementDescs[i].InputSlot = VertexLayoutSlots[i];
+		elementDescs[i].AlignedByteOffset = GetVertexLayoutOffset(i);
 		elementDescs[i].InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
 
-		if (VertexLayouts[i] == VertexLayoutFormat::R32G32_FLOAT)
-		{
-			elementDescs[i].Format = DXGI_FORMAT_R32G32_FLOAT;
-			elementOffset += sizeof(float) * 2;
-		}
-		else if (VertexLayouts[i] == VertexLayoutFormat::R32G32B32_FLOAT)
-		{
-			elementDescs[i].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-			elementOffset += sizeof(float) * 3;
-		}
-		else if (VertexLayouts[i] == VertexLayoutFormat::R32G32B32A32_FLOAT)
-		{
-			elementDescs[i].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
-			elementOffset += sizeof(float) * 4;
-		}
-		else if (VertexLayouts[i] == VertexLayoutFormat::R8G8B8A8_UNORM)
-		{
-			elementDescs[i].Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-			elementOffset += sizeof(float) * 1;
-		}
-		else if (VertexLayouts[i] == VertexLayoutFormat::R8G8B8A8_UINT)
-		{
-			elementDescs[i].Format = DXGI_FORMAT_R8G8B8A8_UINT;
-			elementOffset += sizeof(float) * 1;
-		}
-		else
-		{
-			assert(0);
-		}
+		elementDescs[i].Format = ConvertVertexLayoutFormat(VertexLayouts[i]);
 	}
 
 	// setup a topology
@@ -225,25 +241,26 @@ FAILED_EXIT:
 bool PipelineStateDX12::CreateRootSignature()
 {
 	D3D12_DESCRIPTOR_RANGE ranges[3] = {{}, {}, {}};
-	D3D12_ROOT_PARAMETER rootParameters[2] = {{}, {}};
+	D3D12_ROOT_PARAMETER rootParameters[2 + GraphicsStageCountDX12] = {};
+	int32_t rootParameterCount = 2;
 
 	// descriptor range for constant buffer view
 	ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
-	ranges[0].NumDescriptors = static_cast<int>(ShaderStageType::Max);
+	ranges[0].NumDescriptors = GraphicsStageCountDX12;
 	ranges[0].BaseShaderRegister = 0;
 	ranges[0].RegisterSpace = 0;
 	ranges[0].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
 
 	// descriptor range for shader resorce view
 	ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
-	ranges[1].NumDescriptors = NumTexture * static_cast<int>(ShaderStageType::Max);
+	ranges[1].NumDescriptors = NumTexture * GraphicsStageCountDX12;
 	ranges[1].BaseShaderRegister = 0;
 	ranges[1].RegisterSpace = 0;
 	ranges[1].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
 
 	// descriptor range for sampler
 	ranges[2].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER;
-	ranges[2].NumDescriptors = NumTexture * static_cast<int>(ShaderStageType::Max);
+	ranges[2].NumDescriptors = NumTexture * GraphicsStageCountDX12;
 	ranges[2].BaseShaderRegister = 0;
 	ranges[2].RegisterSpace = 0;
 	ranges[2].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
@@ -260,8 +277,30 @@ bool PipelineStateDX12::CreateRootSignature()
 	rootParameters[1].DescriptorTable.pDescriptorRanges = &ranges[2];
 	rootParameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 
+	// root constants for push constants (b2 in a vertex shader, b3 in a pixel shader)
+	for (int i = 0; i < GraphicsStageCountDX12; i++)
+	{
+		pushConstantRootParameterIndexes_[i] = -1;
+
+		if (PushConstantSizes[i] == 0)
+			continue;
+
+		assert(PushConstantSizes[i] % 4 == 0);
+
+		auto& parameter = rootParameters[rootParameterCount];
+		parameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+		parameter.Constants.ShaderRegister = GraphicsStageCountDX12 + i;
+		parameter.Constants.RegisterSpace = 0;
+		parameter.Constants.Num32BitValues = PushConstantSizes[i] / 4;
+		parameter.ShaderVisibility =
+			i == static_cast<int>(ShaderStageType::Pixel) ? D3D12_SHADER_VISIBILITY_PIXEL : D3D12_SHADER_VISIBILITY_VERTEX;
+
+		pushConstantRootParameterIndexes_[i] = rootParameterCount;
+		rootParameterCount++;
+	}
+
 	D3D12_ROOT_SIGNATURE_DESC desc = {};
-	desc.NumParameters = 2;
+	desc.NumParameters = rootParameterCount;
 	desc.pParameters = rootParameters;
 	desc.NumStaticSamplers = 0;
 	desc.pStaticSamplers = nullptr;
@@ -14,7 +14,7 @@ namespace LLGI
 class PipelineStateDX12 : public PipelineState
 {
 private:
-	std::shared_ptr<GraphicsDX12> graphics_;
+	Ref<GraphicsDX12> graphics_;
 
 	std::array<Shader*, static_cast<int>(ShaderStageType::Max)> shaders_;
 
@@ -23,6 +23,8 @@ private:
 	ID3DBlob* signature_ = nullptr;
 	ID3D12RootSignature* rootSignature_ = nullptr;
 
+	std::array<int32_t, static_cast<int>(ShaderStageType::Max)> pushConstantRootParameterIndexes_;
+
 	bool CreateRootSignature();
 
 public:
@@ -35,6 +37,12 @@ public:
 
 	ID3D12PipelineState* GetPipelineState() { return pipelineState_; }
 	ID3D12RootSignature* GetRootSignature() { return rootSignature_; }
+
+	//! -1 if push constants are not used in the stage
+	int32_t GetPushConstantRootParameterIndex(ShaderStageType stage) const
+	{
+		return pushConstantRootParameterIndexes_[static_cast<int>(stage)];
+	}
 };
 
 } // namespace LLGI
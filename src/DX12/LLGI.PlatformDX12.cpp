@@ -281,13 +281,10 @@ FAILED_EXIT:;
 	return false;
 }
 
-bool PlatformDX12::NewFrame()
-{
-	if (!window.DoEvent())
-	{
-		return false;
-	}
+bool PlatformDX12::ProcessEvents() { return window.DoEvent(); }
 
+bool PlatformDX12::AcquireScreen()
+{
 	frameIndex = swapChain->GetCurrentBackBufferIndex();
 
 	commandListStart->Reset(commandAllocator, nullptr);
@@ -43,7 +43,8 @@ public:
 
 	bool Initialize(Vec2I windowSize);
 
-	bool NewFrame() override;
+	bool ProcessEvents() override;
+	bool AcquireScreen() override;
 	void Present() override;
 	Graphics* CreateGraphics() override;
 
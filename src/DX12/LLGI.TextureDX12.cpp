@@ -128,18 +128,28 @@ bool TextureDX12::IsDepthTexture() const
 
 void TextureDX12::ResourceBarrior(ID3D12GraphicsCommandList* commandList, D3D12_RESOURCE_STATES state)
 {
-	if (state_ == state)
+	D3D12_RESOURCE_BARRIER barrier = {};
+	if (!CreateResourceBarrior(state, barrier))
 		return;
 
-	D3D12_RESOURCE_BARRIER barrier = {};
+	commandList->ResourceBarrier(1, &barrier);
+}
+
+bool TextureDX12::CreateResourceBarrior(D3D12_RESOURCE_STATES state, D3D12_RESOURCE_BARRIER& barrier)
+{
+	// a combined read state contains the state
+	if (state_ == state || (state != D3D12_RESOURCE_STATE_COMMON && (state_ & state) == state))
+		return false;
+
+	barrier = {};
 	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
 	barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
 	barrier.Transition.pResource = texture_;
 	barrier.Transition.StateBefore = state_;
 	barrier.Transition.StateAfter = state;
 	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-	commandList->ResourceBarrier(1, &barrier);
 	state_ = state;
+	return true;
 }
 
 } // namespace LLGI
\ No newline at end of file
@@ -39,5 +39,11 @@ public:
 	bool IsDepthTexture() const override;
 
 	void ResourceBarrior(ID3D12GraphicsCommandList* commandList, D3D12_RESOURCE_STATES state);
+
+	/**
+		@brief	make a barrier to transit into a state, which is recorded by a caller with other barriers
+		@return	false if the texture is already in the state
+	*/
+	bool CreateResourceBarrior(D3D12_RESOURCE_STATES state, D3D12_RESOURCE_BARRIER& barrier);
 };
 } // namespace LLGI
\ No newline at end of file
@@ -5,9 +5,12 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <deque>
 #include <memory>
 #include <queue>
 #include <string>
@@ -34,6 +37,7 @@ enum class ShaderStageType
 {
 	Vertex,
 	Pixel,
+	Compute,
 	Max,
 };
 
@@ -74,6 +78,18 @@ enum class VertexLayoutFormat
 	R8G8B8A8_UNORM,
 	R8G8B8A8_UINT,
 	R32G32_FLOAT,
+
+	//! compact formats which reduce memory and bandwidth of vertices
+	R16G16_FLOAT,
+	R16G16B16A16_FLOAT,
+	R16G16_SNORM,
+	R16G16B16A16_SNORM,
+	R16G16_UNORM,
+	R16G16B16A16_UNORM,
+	R8G8B8A8_SNORM,
+	R10G10B10A2_UNORM,
+	R16G16B16A16_UINT,
+	R32_UINT,
 };
 
 enum class TopologyType
@@ -94,6 +110,60 @@ enum class TextureMinMagFilter
 	Linear,
 };
 
+enum class TextureFormatType
+{
+	R8G8B8A8_UNORM,
+	R8_UNORM,
+	R8G8_UNORM,
+	R16G16B16A16_FLOAT,
+	R32_FLOAT,
+
+	//! block compressed formats which are mainly supported on desktop
+	BC1,
+	BC2,
+	BC3,
+	BC4,
+	BC5,
+	BC6H,
+	BC7,
+
+	//! block compressed formats which are mainly supported on mobile
+	ETC2_RGB8,
+	ETC2_RGBA8,
+	ASTC_4x4,
+};
+
+/**
+	@brief	a way in which commands access a texture
+*/
+enum class ResourceState
+{
+	ShaderResource,
+	RenderTarget,
+	DepthWrite,
+	CopySource,
+	CopyDest,
+};
+
+/**
+	@brief	what is done with contents of an attachment when a render pass begins
+*/
+enum class AttachmentLoadOp
+{
+	Clear,
+	Load,
+	DontCare,
+};
+
+/**
+	@brief	what is done with contents of an attachment when a render pass ends
+*/
+enum class AttachmentStoreOp
+{
+	Store,
+	DontCare,
+};
+
 enum class DepthFuncType
 {
 	Never,
@@ -112,6 +182,12 @@ enum class ConstantBufferType
 	ShortTime, //! this constant buffer is disposed or rewrite by a frame. If shorttime, this constant buffer must be disposed by a frame.
 };
 
+//! the maximum size of push constants in bytes which are shared by all stages
+static constexpr int MaxPushConstantSize = 128;
+
+//! the number of vertex buffers which can be bound at the same time
+static constexpr int NumVertexBufferSlot = 4;
+
 struct Vec2I
 {
 	int32_t X;
@@ -174,6 +250,29 @@ struct DataStructure
 	int32_t Size;
 };
 
+struct TextureInitializationParameter
+{
+	Vec2I Size;
+	TextureFormatType Format = TextureFormatType::R8G8B8A8_UNORM;
+
+	/**
+		@brief	the number of mip levels. 0 means a full mip chain
+		@note
+		Levels except the first are generated on gpu when a texture is unlocked unless the format is compressed.
+		A texture is not created if the gpu can't generate levels of the format.
+	*/
+	int32_t MipMapCount = 1;
+
+	int32_t ArrayLayerCount = 1;
+
+	/**
+		@brief	whether mip levels are uploaded one by one with Graphics::RequestTextureMipMap instead of Lock
+		@note
+		Levels are not generated on gpu. A texture can be sampled after the last (coarsest) level is uploaded.
+	*/
+	bool IsStreamed = false;
+};
+
 template <class T> void SafeAddRef(T& t)
 {
 	if (t != NULL)
@@ -207,10 +306,23 @@ template <class T> void SafeDelete(T& t)
 	}
 }
 
+//! combine a hash of a member into a hash of a key
+inline void HashCombine(std::size_t& hash, std::size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); }
+
+/**
+	@brief	a base class of objects which are released when their reference counts become zero
+	@note
+	Define LLGI_NON_ATOMIC_REFERENCE_COUNT (USE_NON_ATOMIC_REFERENCE_COUNT in CMake) for applications which use LLGI on a single thread.
+	It must be defined for both LLGI and applications.
+*/
 class ReferenceObject
 {
 private:
+#ifdef LLGI_NON_ATOMIC_REFERENCE_COUNT
+	mutable int32_t reference;
+#else
 	mutable std::atomic<int32_t> reference;
+#endif
 
 public:
 	ReferenceObject() : reference(1) {}
@@ -219,24 +331,44 @@ public:
 
 	int AddRef()
 	{
-		std::atomic_fetch_add_explicit(&reference, 1, std::memory_order_consume);
-		return reference;
+#ifdef LLGI_NON_ATOMIC_REFERENCE_COUNT
+		return ++reference;
+#else
+		// a caller already holds a reference, so it doesn't need to synchronize anything
+		return std::atomic_fetch_add_explicit(&reference, 1, std::memory_order_relaxed) + 1;
+#endif
 	}
 
-	int GetRef() { return reference; }
+	int GetRef()
+	{
+#ifdef LLGI_NON_ATOMIC_REFERENCE_COUNT
+		return reference;
+#else
+		return reference.load(std::memory_order_relaxed);
+#endif
+	}
 
 	int Release()
 	{
-		assert(reference > 0);
+		assert(GetRef() > 0);
+
+#ifdef LLGI_NON_ATOMIC_REFERENCE_COUNT
+		auto count = --reference;
+#else
+		// writes by other owners must be visible to the destructor
+		auto count = std::atomic_fetch_sub_explicit(&reference, 1, std::memory_order_release) - 1;
+		if (count == 0)
+		{
+			std::atomic_thread_fence(std::memory_order_acquire);
+		}
+#endif
 
-		bool destroy = std::atomic_fetch_sub_explicit(&reference, 1, std::memory_order_consume) == 1;
-		if (destroy)
+		if (count == 0)
 		{
 			delete this;
-			return 0;
 		}
 
-		return reference;
+		return count;
 	}
 };
 
@@ -251,9 +383,100 @@ template <typename T> struct ReferenceDeleter
 
 template <typename T> static std::shared_ptr<T> CreateSharedPtr(T* p) { return std::shared_ptr<T>(p, ReferenceDeleter<T>()); }
 
+/**
+	@brief	an intrusive smart pointer of an object which has AddRef and Release like ReferenceObject and COM objects
+	@note
+	Unlike std::shared_ptr, it uses a reference count in an object and doesn't allocate a control block.
+*/
+template <typename T> class Ref
+{
+private:
+	template <typename U> friend class Ref;
+
+	T* ptr_ = nullptr;
+
+public:
+	Ref() = default;
+
+	Ref(std::nullptr_t) {}
+
+	//! take over a reference which a caller holds
+	explicit Ref(T* ptr) : ptr_(ptr) {}
+
+	Ref(const Ref& other) : ptr_(other.ptr_) { SafeAddRef(ptr_); }
+
+	Ref(Ref&& other) noexcept : ptr_(other.ptr_) { other.ptr_ = nullptr; }
+
+	template <typename U> Ref(const Ref<U>& other) : ptr_(other.ptr_) { SafeAddRef(ptr_); }
+
+	template <typename U> Ref(Ref<U>&& other) noexcept : ptr_(other.ptr_) { other.ptr_ = nullptr; }
+
+	~Ref() { SafeRelease(ptr_); }
+
+	Ref& operator=(const Ref& other)
+	{
+		SafeAssign(ptr_, other.ptr_);
+		return *this;
+	}
+
+	Ref& operator=(Ref&& other) noexcept
+	{
+		if (this != &other)
+		{
+			SafeRelease(ptr_);
+			ptr_ = other.ptr_;
+			other.ptr_ = nullptr;
+		}
+		return *this;
+	}
+
+	Ref& operator=(std::nullptr_t)
+	{
+		SafeRelease(ptr_);
+		return *this;
+	}
+
+	//! release a held object and take over a reference which a caller holds
+	void Reset(T* ptr = nullptr)
+	{
+		SafeRelease(ptr_);
+		ptr_ = ptr;
+	}
+
+	//! give up a reference to a caller without releasing it
+	T* Detach()
+	{
+		auto ptr = ptr_;
+		ptr_ = nullptr;
+		return ptr;
+	}
+
+	T* Get() const { return ptr_; }
+
+	T* operator->() const { return ptr_; }
+
+	T& operator*() const { return *ptr_; }
+
+	explicit operator bool() const { return ptr_ != nullptr; }
+
+	bool operator==(const Ref& other) const { return ptr_ == other.ptr_; }
+
+	bool operator!=(const Ref& other) const { return ptr_ != other.ptr_; }
+
+	bool operator==(std::nullptr_t) const { return ptr_ == nullptr; }
+
+	bool operator!=(std::nullptr_t) const { return ptr_ != nullptr; }
+
+	bool operator<(const Ref& other) const { return ptr_ < other.ptr_; }
+};
+
+//! create Ref which takes over a reference like CreateSharedPtr
+template <typename T> Ref<T> CreateRef(T* p) { return Ref<T>(p); }
+
 class VertexBuffer;
 class IndexBuffer;
 class ConstantBuffer;
+class StorageBuffer;
 class Shader;
 class PipelineState;
 class Texture;
@@ -263,6 +486,40 @@ class CommandList;
 class Compiler;
 class RenderPass;
 class RenderPassPipelineState;
+class Fence;
+
+/**
+	@brief	a region of a vertex buffer which is valid only in the current frame
+*/
+struct TransientVertexBuffer
+{
+	VertexBuffer* vertexBuffer = nullptr;
+	int32_t offset = 0;
+
+	//! a pointer to the region to be written directly
+	void* data = nullptr;
+};
+
+/**
+	@brief	a region of an index buffer which is valid only in the current frame
+*/
+struct TransientIndexBuffer
+{
+	IndexBuffer* indexBuffer = nullptr;
+	int32_t offset = 0;
+
+	//! a pointer to the region to be written directly
+	void* data = nullptr;
+};
+
+/**
+	@brief	a transition of a texture into a state
+*/
+struct ResourceBarrier
+{
+	Texture* texture = nullptr;
+	ResourceState state = ResourceState::ShaderResource;
+};
 
 namespace G3
 {
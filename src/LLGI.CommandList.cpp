@@ -3,22 +3,22 @@
 #include "LLGI.ConstantBuffer.h"
 #include "LLGI.IndexBuffer.h"
 #include "LLGI.PipelineState.h"
+#include "LLGI.StorageBuffer.h"
 #include "LLGI.Texture.h"
 #include "LLGI.VertexBuffer.h"
 
 namespace LLGI
 {
 
-void CommandList::GetCurrentVertexBuffer(BindingVertexBuffer& buffer, bool& isDirtied)
+void CommandList::GetCurrentVertexBuffer(int32_t slot, BindingVertexBuffer& buffer, bool& isDirtied)
 {
-
-	buffer = bindingVertexBuffer;
-	isDirtied = isVertexBufferDirtied;
+	buffer = bindingVertexBuffers[slot];
+	isDirtied = isVertexBufferDirtied[slot];
 }
 
-void CommandList::GetCurrentIndexBuffer(IndexBuffer*& buffer, bool& isDirtied)
+void CommandList::GetCurrentIndexBuffer(BindingIndexBuffer& buffer, bool& isDirtied)
 {
-	buffer = currentIndexBuffer;
+	buffer = bindingIndexBuffer;
 	isDirtied = isCurrentIndexBufferDirtied;
 }
 
@@ -33,9 +33,20 @@ void CommandList::GetCurrentConstantBuffer(ShaderStageType type, ConstantBuffer*
 	buffer = constantBuffers[static_cast<int>(type)];
 }
 
+void CommandList::GetCurrentPushConstants(ShaderStageType type, const void*& data, int32_t& size, bool& isDirtied)
+{
+	auto ind = static_cast<int>(type);
+	data = pushConstants_[ind].data();
+	size = pushConstantSizes_[ind];
+	isDirtied = isPushConstantDirtied_[ind];
+}
+
 CommandList::CommandList()
 {
+	isVertexBufferDirtied.fill(true);
 	constantBuffers.fill(nullptr);
+	pushConstantSizes_.fill(0);
+	isPushConstantDirtied_.fill(false);
 
 	for (auto& t : currentTextures)
 	{
@@ -44,10 +55,17 @@ CommandList::CommandList()
 			bt.texture = nullptr;
 		}
 	}
+
+	for (auto& s : currentStorageBuffers)
+	{
+		s.fill(nullptr);
+	}
 }
 
 CommandList::~CommandList()
 {
+	ReleaseBundleResources();
+
 	for (auto& c : constantBuffers)
 	{
 		SafeRelease(c);
@@ -60,16 +78,35 @@ CommandList::~CommandList()
 			SafeRelease(bt.texture);
 		}
 	}
+
+	for (auto& s : currentStorageBuffers)
+	{
+		for (auto& sb : s)
+		{
+			SafeRelease(sb);
+		}
+	}
 }
 
 void CommandList::Begin()
 {
-	bindingVertexBuffer.vertexBuffer = nullptr;
-	currentIndexBuffer = nullptr;
+	for (auto& vb : bindingVertexBuffers)
+	{
+		vb.vertexBuffer = nullptr;
+	}
+	bindingIndexBuffer.indexBuffer = nullptr;
 	currentPipelineState = nullptr;
-	isVertexBufferDirtied = true;
+	isVertexBufferDirtied.fill(true);
 	isCurrentIndexBufferDirtied = true;
 	isPipelineDirtied = true;
+	pushConstantSizes_.fill(0);
+	isPushConstantDirtied_.fill(false);
+
+	// arrays which were allocated in a previous frame were already recorded into commands
+	frameAllocator_.Reset();
+
+	// a bundle is recorded again
+	ReleaseBundleResources();
 }
 
 void CommandList::End() {}
@@ -78,24 +115,40 @@ void CommandList::SetScissor(int32_t x, int32_t y, int32_t width, int32_t height
 
 void CommandList::Draw(int32_t pritimiveCount)
 {
-	isVertexBufferDirtied = false;
+	if (isBundle_)
+	{
+		HoldBundleResources();
+	}
+
+	isVertexBufferDirtied.fill(false);
 	isCurrentIndexBufferDirtied = false;
 	isPipelineDirtied = false;
+	isPushConstantDirtied_.fill(false);
 }
 
-void CommandList::SetVertexBuffer(VertexBuffer* vertexBuffer, int32_t stride, int32_t offset)
+void CommandList::Dispatch(int32_t x, int32_t y, int32_t z)
 {
-	isVertexBufferDirtied |=
-		bindingVertexBuffer.vertexBuffer != vertexBuffer || bindingVertexBuffer.stride != stride || bindingVertexBuffer.offset != offset;
-	bindingVertexBuffer.vertexBuffer = vertexBuffer;
-	bindingVertexBuffer.stride = stride;
-	bindingVertexBuffer.offset = offset;
+	isPipelineDirtied = false;
+	isPushConstantDirtied_[static_cast<int>(ShaderStageType::Compute)] = false;
 }
 
-void CommandList::SetIndexBuffer(IndexBuffer* indexBuffer)
+void CommandList::SetVertexBuffer(VertexBuffer* vertexBuffer, int32_t stride, int32_t offset, int32_t slot)
 {
-	isCurrentIndexBufferDirtied |= currentIndexBuffer != indexBuffer;
-	currentIndexBuffer = indexBuffer;
+	assert(0 <= slot && slot < NumVertexBufferSlot);
+
+	auto& binding = bindingVertexBuffers[slot];
+	isVertexBufferDirtied[slot] =
+		isVertexBufferDirtied[slot] || binding.vertexBuffer != vertexBuffer || binding.stride != stride || binding.offset != offset;
+	binding.vertexBuffer = vertexBuffer;
+	binding.stride = stride;
+	binding.offset = offset;
+}
+
+void CommandList::SetIndexBuffer(IndexBuffer* indexBuffer, int32_t offset)
+{
+	isCurrentIndexBufferDirtied |= bindingIndexBuffer.indexBuffer != indexBuffer || bindingIndexBuffer.offset != offset;
+	bindingIndexBuffer.indexBuffer = indexBuffer;
+	bindingIndexBuffer.offset = offset;
 }
 
 void CommandList::SetPipelineState(PipelineState* pipelineState)
@@ -110,6 +163,16 @@ void CommandList::SetConstantBuffer(ConstantBuffer* constantBuffer, ShaderStageT
 	SafeAssign(constantBuffers[ind], constantBuffer);
 }
 
+void CommandList::SetPushConstants(ShaderStageType stage, const void* data, int32_t size)
+{
+	assert(0 <= size && size <= MaxPushConstantSize);
+
+	auto ind = static_cast<int>(stage);
+	memcpy(pushConstants_[ind].data(), data, size);
+	pushConstantSizes_[ind] = size;
+	isPushConstantDirtied_[ind] = true;
+}
+
 void CommandList::SetTexture(
 	Texture* texture, TextureWrapMode wrapMode, TextureMinMagFilter minmagFilter, int32_t unit, ShaderStageType shaderStage)
 {
@@ -118,12 +181,84 @@ void CommandList::SetTexture(
 	currentTextures[ind][unit].wrapMode = wrapMode;
 	currentTextures[ind][unit].minMagFilter = minmagFilter;
 }
+
+void CommandList::SetStorageBuffer(StorageBuffer* storageBuffer, int32_t unit, ShaderStageType shaderStage)
+{
+	assert(0 <= unit && unit < NumStorageBuffer);
+
+	auto ind = static_cast<int>(shaderStage);
+	SafeAssign(currentStorageBuffers[ind][unit], storageBuffer);
+}
     
     void CommandList::BeginRenderPass(RenderPass* renderPass)
     {
-        isVertexBufferDirtied = true;
+        isVertexBufferDirtied.fill(true);
         isCurrentIndexBufferDirtied = true;
         isPipelineDirtied = true;
     }
 
+void CommandList::ExecuteBundle(CommandList* bundle)
+{
+	assert(bundle != nullptr && bundle->IsBundle());
+	assert(!isBundle_);
+
+	// bindings after a bundle are undefined
+	isVertexBufferDirtied.fill(true);
+	isCurrentIndexBufferDirtied = true;
+	isPipelineDirtied = true;
+
+	for (size_t i = 0; i < pushConstantSizes_.size(); i++)
+	{
+		isPushConstantDirtied_[i] = pushConstantSizes_[i] > 0;
+	}
+}
+
+void CommandList::HoldBundleResources()
+{
+	auto hold = [this](ReferenceObject* resource) {
+		if (resource != nullptr && bundleResources_.insert(resource).second)
+		{
+			resource->AddRef();
+		}
+	};
+
+	for (auto& binding : bindingVertexBuffers)
+	{
+		hold(binding.vertexBuffer);
+	}
+
+	hold(bindingIndexBuffer.indexBuffer);
+	hold(currentPipelineState);
+
+	for (auto& c : constantBuffers)
+	{
+		hold(c);
+	}
+
+	for (auto& t : currentTextures)
+	{
+		for (auto& bt : t)
+		{
+			hold(bt.texture);
+		}
+	}
+
+	for (auto& s : currentStorageBuffers)
+	{
+		for (auto& sb : s)
+		{
+			hold(sb);
+		}
+	}
+}
+
+void CommandList::ReleaseBundleResources()
+{
+	for (auto resource : bundleResources_)
+	{
+		resource->Release();
+	}
+	bundleResources_.clear();
+}
+
 } // namespace LLGI
@@ -2,10 +2,13 @@
 #pragma once
 
 #include "LLGI.Base.h"
+#include "LLGI.LinearAllocator.h"
+#include <unordered_set>
 
 namespace LLGI
 {
 static constexpr int NumTexture = 8;
+static constexpr int NumStorageBuffer = 4;
 
 class VertexBuffer;
 class IndexBuffer;
@@ -20,6 +23,12 @@ protected:
 		int32_t offset = 0;
 	};
 
+	struct BindingIndexBuffer
+	{
+		IndexBuffer* indexBuffer = nullptr;
+		int32_t offset = 0;
+	};
+
 	struct BindingTexture
 	{
 		Texture* texture = nullptr;
@@ -28,24 +37,48 @@ protected:
 	};
 
 private:
-	BindingVertexBuffer bindingVertexBuffer;
-	IndexBuffer* currentIndexBuffer = nullptr;
+	std::array<BindingVertexBuffer, NumVertexBufferSlot> bindingVertexBuffers;
+	BindingIndexBuffer bindingIndexBuffer;
 	PipelineState* currentPipelineState = nullptr;
 
-	bool isVertexBufferDirtied = true;
+	std::array<bool, NumVertexBufferSlot> isVertexBufferDirtied;
 	bool isCurrentIndexBufferDirtied = true;
 	bool isPipelineDirtied = true;
 
 	std::array<ConstantBuffer*, static_cast<int>(ShaderStageType::Max)> constantBuffers;
 
+	std::array<std::array<uint8_t, MaxPushConstantSize>, static_cast<int>(ShaderStageType::Max)> pushConstants_;
+	std::array<int32_t, static_cast<int>(ShaderStageType::Max)> pushConstantSizes_;
+	std::array<bool, static_cast<int>(ShaderStageType::Max)> isPushConstantDirtied_;
+
+	LinearAllocator frameAllocator_;
+
+	//! resources which are used by draws in a bundle. A bundle holds them while it may be executed.
+	std::unordered_set<ReferenceObject*> bundleResources_;
+
+	void HoldBundleResources();
+	void ReleaseBundleResources();
+
 protected:
+	bool isBundle_ = false;
+
 	std::array<std::array<BindingTexture, NumTexture>, static_cast<int>(ShaderStageType::Max)> currentTextures;
+	std::array<std::array<StorageBuffer*, NumStorageBuffer>, static_cast<int>(ShaderStageType::Max)> currentStorageBuffers;
 
 protected:
-	void GetCurrentVertexBuffer(BindingVertexBuffer& buffer, bool& isDirtied);
-	void GetCurrentIndexBuffer(IndexBuffer*& buffer, bool& isDirtied);
+	void GetCurrentVertexBuffer(BindingVertexBuffer& buffer, bool& isDirtied) { GetCurrentVertexBuffer(0, buffer, isDirtied); }
+	void GetCurrentVertexBuffer(int32_t slot, BindingVertexBuffer& buffer, bool& isDirtied);
+	void GetCurrentIndexBuffer(BindingIndexBuffer& buffer, bool& isDirtied);
 	void GetCurrentPipelineState(PipelineState*& pipelineState, bool& isDirtied);
 	void GetCurrentConstantBuffer(ShaderStageType type, ConstantBuffer*& buffer);
+	void GetCurrentPushConstants(ShaderStageType type, const void*& data, int32_t& size, bool& isDirtied);
+
+	/**
+		@brief	get an allocator for temporary arrays which are used while commands are recorded
+		@note
+		It is reset in Begin, so draws and passes in a frame don't allocate on heap once it has grown.
+	*/
+	LinearAllocator& GetFrameAllocator() { return frameAllocator_; }
 
 public:
 	CommandList();
@@ -56,14 +89,81 @@ public:
 
 	virtual void SetScissor(int32_t x, int32_t y, int32_t width, int32_t height);
 	virtual void Draw(int32_t pritimiveCount);
-	virtual void SetVertexBuffer(VertexBuffer* vertexBuffer, int32_t stride, int32_t offset);
-	virtual void SetIndexBuffer(IndexBuffer* indexBuffer);
+
+	/**
+		@brief	set a vertex buffer
+		@param	slot	a slot which attributes with the same PipelineState::VertexLayoutSlots are read from
+	*/
+	virtual void SetVertexBuffer(VertexBuffer* vertexBuffer, int32_t stride, int32_t offset, int32_t slot = 0);
+
+	/**
+		@brief	set a region of a vertex buffer which is allocated with Graphics::AllocateTransientVertices
+	*/
+	void SetVertexBuffer(const TransientVertexBuffer& vertexBuffer, int32_t stride, int32_t slot = 0)
+	{
+		SetVertexBuffer(vertexBuffer.vertexBuffer, stride, vertexBuffer.offset, slot);
+	}
+
+	/**
+		@brief	set an index buffer
+		@param	offset	an offset in bytes to the first index
+	*/
+	virtual void SetIndexBuffer(IndexBuffer* indexBuffer, int32_t offset = 0);
+
+	/**
+		@brief	set a region of an index buffer which is allocated with Graphics::AllocateTransientIndices
+	*/
+	void SetIndexBuffer(const TransientIndexBuffer& indexBuffer) { SetIndexBuffer(indexBuffer.indexBuffer, indexBuffer.offset); }
 	virtual void SetPipelineState(PipelineState* pipelineState);
 	virtual void SetConstantBuffer(ConstantBuffer* constantBuffer, ShaderStageType shaderStage);
+
+	/**
+		@brief	set small data which is sent with a command directly
+		@param	stage	a stage which reads data
+		@param	data	data which is copied at once
+		@param	size	size of data which must not exceed PipelineState::PushConstantSizes
+	*/
+	virtual void SetPushConstants(ShaderStageType stage, const void* data, int32_t size);
 	virtual void
 	SetTexture(Texture* texture, TextureWrapMode wrapMode, TextureMinMagFilter minmagFilter, int32_t unit, ShaderStageType shaderStage);
+
+	/**
+		@brief	set a storage buffer which shaders read and write
+		@param	unit	an index among storage buffers in a shader which are ordered by set and binding on Vulkan
+	*/
+	virtual void SetStorageBuffer(StorageBuffer* storageBuffer, int32_t unit, ShaderStageType shaderStage);
+
 	virtual void BeginRenderPass(RenderPass* renderPass);
 	virtual void EndRenderPass() {}
+
+	/**
+		@brief	transit textures into states with a batch
+		@note
+		Textures which are already in the states are skipped. Call it outside of a render pass.
+	*/
+	virtual void ResourceBarriers(const ResourceBarrier* barriers, int32_t count) {}
+
+	/**
+		@brief	run a compute pipeline which is set with SetPipelineState
+		@param	x	the number of work groups in x
+		@note
+		Call it outside of a render pass. Writes in a compute shader are visible to commands after it.
+	*/
+	virtual void Dispatch(int32_t x, int32_t y, int32_t z);
+
+	/**
+		@brief	execute commands which are recorded in a bundle
+		@param	bundle	a command list which is created with Graphics::CreateCommandBundle
+		@note
+		Call it in a render pass whose format is the same as the bundle. States which are set before it are not inherited by the bundle
+		and must be set again after it.
+	*/
+	virtual void ExecuteBundle(CommandList* bundle);
+
+	/**
+		@brief	whether this is created with Graphics::CreateCommandBundle
+	*/
+	bool IsBundle() const { return isBundle_; }
 };
 
 } // namespace LLGI
@@ -0,0 +1,603 @@
+#include "LLGI.CommandPacketList.h"
+#include "LLGI.Graphics.h"
+
+namespace LLGI
+{
+
+namespace
+{
+
+using PacketType = CommandPacketList::PacketType;
+using PacketHeader = CommandPacketList::PacketHeader;
+
+struct SetVertexBufferPacket
+{
+	PacketHeader Header;
+	VertexBuffer* Buffer;
+	int32_t Stride;
+	int32_t Offset;
+	int32_t Slot;
+};
+
+struct SetIndexBufferPacket
+{
+	PacketHeader Header;
+	IndexBuffer* Buffer;
+	int32_t Offset;
+};
+
+struct SetPipelineStatePacket
+{
+	PacketHeader Header;
+	PipelineState* State;
+};
+
+struct SetConstantBufferPacket
+{
+	PacketHeader Header;
+	ConstantBuffer* Buffer;
+	ShaderStageType Stage;
+};
+
+//! data follows it. It is aligned so that data after it is aligned.
+struct alignas(CommandPacketList::PacketAlignment) SetPushConstantsPacket
+{
+	PacketHeader Header;
+	ShaderStageType Stage;
+	int32_t Size;
+};
+
+struct SetTexturePacket
+{
+	PacketHeader Header;
+	Texture* Target;
+	TextureWrapMode WrapMode;
+	TextureMinMagFilter MinMagFilter;
+	int32_t Unit;
+	ShaderStageType Stage;
+};
+
+struct SetStorageBufferPacket
+{
+	PacketHeader Header;
+	StorageBuffer* Buffer;
+	int32_t Unit;
+	ShaderStageType Stage;
+};
+
+struct SetScissorPacket
+{
+	PacketHeader Header;
+	int32_t X;
+	int32_t Y;
+	int32_t Width;
+	int32_t Height;
+};
+
+struct DrawPacket
+{
+	PacketHeader Header;
+	int32_t PrimitiveCount;
+};
+
+struct DispatchPacket
+{
+	PacketHeader Header;
+	int32_t X;
+	int32_t Y;
+	int32_t Z;
+};
+
+struct BeginRenderPassPacket
+{
+	PacketHeader Header;
+	RenderPass* Target;
+};
+
+struct BeginScreenRenderPassPacket
+{
+	PacketHeader Header;
+	Color8 ClearColor;
+	bool IsColorCleared;
+	bool IsDepthCleared;
+};
+
+struct EndRenderPassPacket
+{
+	PacketHeader Header;
+};
+
+//! barriers follow it. It is aligned so that barriers after it are aligned.
+struct alignas(CommandPacketList::PacketAlignment) ResourceBarriersPacket
+{
+	PacketHeader Header;
+	int32_t Count;
+};
+
+struct ExecuteBundlePacket
+{
+	PacketHeader Header;
+	CommandList* Bundle;
+};
+
+static_assert(alignof(ResourceBarrier) <= CommandPacketList::PacketAlignment, "barriers after a packet are not aligned");
+
+//! a state which is set into a native command list. It is unknown until it is set in a translation.
+template <typename T> struct TranslatedState
+{
+	bool IsKnown = false;
+	T Value;
+
+	bool Update(const T& value)
+	{
+		if (IsKnown && Value == value)
+		{
+			return false;
+		}
+
+		IsKnown = true;
+		Value = value;
+		return true;
+	}
+};
+
+struct VertexBufferState
+{
+	VertexBuffer* Buffer;
+	int32_t Stride;
+	int32_t Offset;
+
+	bool operator==(const VertexBufferState& value) const
+	{
+		return Buffer == value.Buffer && Stride == value.Stride && Offset == value.Offset;
+	}
+};
+
+struct IndexBufferState
+{
+	IndexBuffer* Buffer;
+	int32_t Offset;
+
+	bool operator==(const IndexBufferState& value) const { return Buffer == value.Buffer && Offset == value.Offset; }
+};
+
+struct TextureState
+{
+	Texture* Target;
+	TextureWrapMode WrapMode;
+	TextureMinMagFilter MinMagFilter;
+
+	bool operator==(const TextureState& value) const
+	{
+		return Target == value.Target && WrapMode == value.WrapMode && MinMagFilter == value.MinMagFilter;
+	}
+};
+
+} // namespace
+
+template <typename T> T* CommandPacketList::AddPacket(PacketType type, size_t extraSize)
+{
+	assert(isRecording_);
+
+	auto size = (sizeof(T) + extraSize + PacketAlignment - 1) / PacketAlignment * PacketAlignment;
+	auto offset = packets_.size();
+	packets_.resize(offset + size);
+
+	auto packet = reinterpret_cast<T*>(packets_.data() + offset);
+	packet->Header.Type = type;
+	packet->Header.Size = static_cast<uint32_t>(size);
+	packetCount_++;
+	return packet;
+}
+
+void CommandPacketList::Begin()
+{
+	// the capacity is kept for a next frame
+	packets_.clear();
+	packetCount_ = 0;
+	isRecording_ = true;
+
+	CommandList::Begin();
+}
+
+void CommandPacketList::End() { isRecording_ = false; }
+
+void CommandPacketList::SetScissor(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+	auto packet = AddPacket<SetScissorPacket>(PacketType::SetScissor);
+	packet->X = x;
+	packet->Y = y;
+	packet->Width = width;
+	packet->Height = height;
+}
+
+void CommandPacketList::Draw(int32_t pritimiveCount)
+{
+	auto packet = AddPacket<DrawPacket>(PacketType::Draw);
+	packet->PrimitiveCount = pritimiveCount;
+}
+
+void CommandPacketList::SetVertexBuffer(VertexBuffer* vertexBuffer, int32_t stride, int32_t offset, int32_t slot)
+{
+	assert(0 <= slot && slot < NumVertexBufferSlot);
+
+	auto packet = AddPacket<SetVertexBufferPacket>(PacketType::SetVertexBuffer);
+	packet->Buffer = vertexBuffer;
+	packet->Stride = stride;
+	packet->Offset = offset;
+	packet->Slot = slot;
+}
+
+void CommandPacketList::SetIndexBuffer(IndexBuffer* indexBuffer, int32_t offset)
+{
+	auto packet = AddPacket<SetIndexBufferPacket>(PacketType::SetIndexBuffer);
+	packet->Buffer = indexBuffer;
+	packet->Offset = offset;
+}
+
+void CommandPacketList::SetPipelineState(PipelineState* pipelineState)
+{
+	auto packet = AddPacket<SetPipelineStatePacket>(PacketType::SetPipelineState);
+	packet->State = pipelineState;
+}
+
+void CommandPacketList::SetConstantBuffer(ConstantBuffer* constantBuffer, ShaderStageType shaderStage)
+{
+	auto packet = AddPacket<SetConstantBufferPacket>(PacketType::SetConstantBuffer);
+	packet->Buffer = constantBuffer;
+	packet->Stage = shaderStage;
+}
+
+void CommandPacketList::SetPushConstants(ShaderStageType stage, const void* data, int32_t size)
+{
+	assert(0 <= size && size <= MaxPushConstantSize);
+
+	auto packet = AddPacket<SetPushConstantsPacket>(PacketType::SetPushConstants, size);
+	packet->Stage = stage;
+	packet->Size = size;
+	memcpy(packet + 1, data, size);
+}
+
+void CommandPacketList::SetTexture(
+	Texture* texture, TextureWrapMode wrapMode, TextureMinMagFilter minmagFilter, int32_t unit, ShaderStageType shaderStage)
+{
+	assert(0 <= unit && unit < NumTexture);
+
+	auto packet = AddPacket<SetTexturePacket>(PacketType::SetTexture);
+	packet->Target = texture;
+	packet->WrapMode = wrapMode;
+	packet->MinMagFilter = minmagFilter;
+	packet->Unit = unit;
+	packet->Stage = shaderStage;
+}
+
+void CommandPacketList::SetStorageBuffer(StorageBuffer* storageBuffer, int32_t unit, ShaderStageType shaderStage)
+{
+	assert(0 <= unit && unit < NumStorageBuffer);
+
+	auto packet = AddPacket<SetStorageBufferPacket>(PacketType::SetStorageBuffer);
+	packet->Buffer = storageBuffer;
+	packet->Unit = unit;
+	packet->Stage = shaderStage;
+}
+
+void CommandPacketList::BeginRenderPass(RenderPass* renderPass)
+{
+	auto packet = AddPacket<BeginRenderPassPacket>(PacketType::BeginRenderPass);
+	packet->Target = renderPass;
+}
+
+void CommandPacketList::BeginScreenRenderPass(const Color8& clearColor, bool isColorCleared, bool isDepthCleared)
+{
+	auto packet = AddPacket<BeginScreenRenderPassPacket>(PacketType::BeginScreenRenderPass);
+	packet->ClearColor = clearColor;
+	packet->IsColorCleared = isColorCleared;
+	packet->IsDepthCleared = isDepthCleared;
+}
+
+void CommandPacketList::EndRenderPass() { AddPacket<EndRenderPassPacket>(PacketType::EndRenderPass); }
+
+void CommandPacketList::ResourceBarriers(const ResourceBarrier* barriers, int32_t count)
+{
+	auto packet = AddPacket<ResourceBarriersPacket>(PacketType::ResourceBarriers, sizeof(ResourceBarrier) * count);
+	packet->Count = count;
+	memcpy(packet + 1, barriers, sizeof(ResourceBarrier) * count);
+}
+
+void CommandPacketList::Dispatch(int32_t x, int32_t y, int32_t z)
+{
+	auto packet = AddPacket<DispatchPacket>(PacketType::Dispatch);
+	packet->X = x;
+	packet->Y = y;
+	packet->Z = z;
+}
+
+void CommandPacketList::ExecuteBundle(CommandList* bundle)
+{
+	assert(bundle != nullptr && bundle->IsBundle());
+
+	auto packet = AddPacket<ExecuteBundlePacket>(PacketType::ExecuteBundle);
+	packet->Bundle = bundle;
+}
+
+void CommandPacketList::Translate(CommandList* commandList, CommandPacketStatistics* statistics, Graphics* graphics) const
+{
+	assert(!isRecording_);
+
+	CommandPacketStatistics result;
+
+	// a native command list resets bindings of buffers and a pipeline state in Begin
+	std::array<TranslatedState<VertexBufferState>, NumVertexBufferSlot> vertexBuffers;
+	for (auto& vb : vertexBuffers)
+	{
+		vb.Update({nullptr, 0, 0});
+	}
+
+	TranslatedState<IndexBufferState> indexBuffer;
+	indexBuffer.Update({nullptr, 0});
+
+	TranslatedState<PipelineState*> pipelineState;
+	pipelineState.Update(nullptr);
+
+	std::array<TranslatedState<ConstantBuffer*>, static_cast<int>(ShaderStageType::Max)> constantBuffers;
+	std::array<std::array<TranslatedState<TextureState>, NumTexture>, static_cast<int>(ShaderStageType::Max)> textures;
+	std::array<std::array<TranslatedState<StorageBuffer*>, NumStorageBuffer>, static_cast<int>(ShaderStageType::Max)> storageBuffers;
+
+	bool isInRenderPass = false;
+
+	commandList->Begin();
+
+	size_t offset = 0;
+	while (offset < packets_.size())
+	{
+		auto header = reinterpret_cast<const PacketHeader*>(packets_.data() + offset);
+		offset += header->Size;
+		result.PacketCount++;
+
+		switch (header->Type)
+		{
+		case PacketType::SetVertexBuffer:
+		{
+			auto packet = reinterpret_cast<const SetVertexBufferPacket*>(header);
+			if (!vertexBuffers[packet->Slot].Update({packet->Buffer, packet->Stride, packet->Offset}))
+			{
+				result.FilteredCount++;
+				break;
+			}
+			commandList->SetVertexBuffer(packet->Buffer, packet->Stride, packet->Offset, packet->Slot);
+			break;
+		}
+		case PacketType::SetIndexBuffer:
+		{
+			auto packet = reinterpret_cast<const SetIndexBufferPacket*>(header);
+			if (!indexBuffer.Update({packet->Buffer, packet->Offset}))
+			{
+				result.FilteredCount++;
+				break;
+			}
+			commandList->SetIndexBuffer(packet->Buffer, packet->Offset);
+			break;
+		}
+		case PacketType::SetPipelineState:
+		{
+			auto packet = reinterpret_cast<const SetPipelineStatePacket*>(header);
+			if (!pipelineState.Update(packet->State))
+			{
+				result.FilteredCount++;
+				break;
+			}
+			commandList->SetPipelineState(packet->State);
+			break;
+		}
+		case PacketType::SetConstantBuffer:
+		{
+			auto packet = reinterpret_cast<const SetConstantBufferPacket*>(header);
+			if (!constantBuffers[static_cast<int>(packet->Stage)].Update(packet->Buffer))
+			{
+				result.FilteredCount++;
+				break;
+			}
+			commandList->SetConstantBuffer(packet->Buffer, packet->Stage);
+			break;
+		}
+		case PacketType::SetPushConstants:
+		{
+			auto packet = reinterpret_cast<const SetPushConstantsPacket*>(header);
+			commandList->SetPushConstants(packet->Stage, packet + 1, packet->Size);
+			break;
+		}
+		case PacketType::SetTexture:
+		{
+			auto packet = reinterpret_cast<const SetTexturePacket*>(header);
+			auto& texture = textures[static_cast<int>(packet->Stage)][packet->Unit];
+			if (!texture.Update({packet->Target, packet->WrapMode, packet->MinMagFilter}))
+			{
+				result.FilteredCount++;
+				break;
+			}
+			commandList->SetTexture(packet->Target, packet->WrapMode, packet->MinMagFilter, packet->Unit, packet->Stage);
+			break;
+		}
+		case PacketType::SetStorageBuffer:
+		{
+			auto packet = reinterpret_cast<const SetStorageBufferPacket*>(header);
+			if (!storageBuffers[static_cast<int>(packet->Stage)][packet->Unit].Update(packet->Buffer))
+			{
+				result.FilteredCount++;
+				break;
+			}
+			commandList->SetStorageBuffer(packet->Buffer, packet->Unit, packet->Stage);
+			break;
+		}
+		case PacketType::SetScissor:
+		{
+			auto packet = reinterpret_cast<const SetScissorPacket*>(header);
+			commandList->SetScissor(packet->X, packet->Y, packet->Width, packet->Height);
+			break;
+		}
+		case PacketType::Draw:
+		{
+			auto packet = reinterpret_cast<const DrawPacket*>(header);
+			if (!isInRenderPass || pipelineState.Value == nullptr || indexBuffer.Value.Buffer == nullptr ||
+				vertexBuffers[0].Value.Buffer == nullptr)
+			{
+				result.InvalidCount++;
+				break;
+			}
+			commandList->Draw(packet->PrimitiveCount);
+			break;
+		}
+		case PacketType::Dispatch:
+		{
+			auto packet = reinterpret_cast<const DispatchPacket*>(header);
+			if (isInRenderPass || pipelineState.Value == nullptr)
+			{
+				result.InvalidCount++;
+				break;
+			}
+			commandList->Dispatch(packet->X, packet->Y, packet->Z);
+			break;
+		}
+		case PacketType::BeginRenderPass:
+		{
+			auto packet = reinterpret_cast<const BeginRenderPassPacket*>(header);
+			commandList->BeginRenderPass(packet->Target);
+			isInRenderPass = true;
+			break;
+		}
+		case PacketType::BeginScreenRenderPass:
+		{
+			auto packet = reinterpret_cast<const BeginScreenRenderPassPacket*>(header);
+			RenderPass* renderPass = nullptr;
+			if (graphics != nullptr)
+			{
+				renderPass = graphics->GetCurrentScreen(packet->ClearColor, packet->IsColorCleared, packet->IsDepthCleared);
+			}
+
+			if (renderPass == nullptr)
+			{
+				result.InvalidCount++;
+				break;
+			}
+			commandList->BeginRenderPass(renderPass);
+			isInRenderPass = true;
+			break;
+		}
+		case PacketType::EndRenderPass:
+		{
+			if (!isInRenderPass)
+			{
+				result.InvalidCount++;
+				break;
+			}
+			commandList->EndRenderPass();
+			isInRenderPass = false;
+			break;
+		}
+		case PacketType::ResourceBarriers:
+		{
+			auto packet = reinterpret_cast<const ResourceBarriersPacket*>(header);
+			commandList->ResourceBarriers(reinterpret_cast<const ResourceBarrier*>(packet + 1), packet->Count);
+			break;
+		}
+		case PacketType::ExecuteBundle:
+		{
+			auto packet = reinterpret_cast<const ExecuteBundlePacket*>(header);
+			if (!isInRenderPass)
+			{
+				result.InvalidCount++;
+				break;
+			}
+			commandList->ExecuteBundle(packet->Bundle);
+			break;
+		}
+		}
+	}
+
+	commandList->End();
+
+	if (statistics != nullptr)
+	{
+		statistics->PacketCount += result.PacketCount;
+		statistics->FilteredCount += result.FilteredCount;
+		statistics->InvalidCount += result.InvalidCount;
+	}
+}
+
+CommandTranslator::CommandTranslator(Graphics* graphics)
+{
+	SafeAssign(graphics_, graphics);
+	thread_ = std::thread([this]() { Run(); });
+}
+
+CommandTranslator::~CommandTranslator()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		isTerminated_ = true;
+	}
+	jobAdded_.notify_all();
+
+	// submitted jobs are translated before the thread finishes
+	thread_.join();
+
+	SafeRelease(graphics_);
+}
+
+void CommandTranslator::Run()
+{
+	while (true)
+	{
+		Job job;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			jobAdded_.wait(lock, [this]() { return isTerminated_ || !jobs_.empty(); });
+
+			if (jobs_.empty())
+			{
+				return;
+			}
+
+			job = jobs_.front();
+			jobs_.pop_front();
+			isTranslating_ = true;
+		}
+
+		job.packets->Translate(job.commandList, &statistics_, graphics_);
+
+		SafeRelease(job.packets);
+		SafeRelease(job.commandList);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			isTranslating_ = false;
+		}
+		jobFinished_.notify_all();
+	}
+}
+
+void CommandTranslator::Submit(CommandPacketList* packets, CommandList* commandList)
+{
+	assert(packets != nullptr && commandList != nullptr);
+
+	Job job;
+	job.packets = packets;
+	job.commandList = commandList;
+	SafeAddRef(job.packets);
+	SafeAddRef(job.commandList);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		jobs_.push_back(job);
+	}
+	jobAdded_.notify_one();
+}
+
+void CommandTranslator::Wait()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	jobFinished_.wait(lock, [this]() { return jobs_.empty() && !isTranslating_; });
+}
+
+} // namespace LLGI
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "LLGI.CommandList.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace LLGI
+{
+
+struct CommandPacketStatistics
+{
+	//! the number of packets which are translated
+	int32_t PacketCount = 0;
+
+	//! the number of packets which are skipped because they set the same states as current ones
+	int32_t FilteredCount = 0;
+
+	//! the number of commands which are skipped because required states are not set or they are in wrong places
+	int32_t InvalidCount = 0;
+};
+
+/**
+	@brief	a command list which records commands into a buffer of backend independent packets
+	@note
+	Commands are converted into commands of a native command list with Translate, which is usually called by CommandTranslator
+	on a worker thread. Recording packets only copies arguments, so it is cheap on an application thread.
+	Resources are not held by packets. Don't release them until packets are translated and executed.
+	A buffer keeps its capacity when it is recorded again, so it doesn't allocate on heap in a steady state.
+*/
+class CommandPacketList : public CommandList
+{
+public:
+	enum class PacketType : uint32_t
+	{
+		SetVertexBuffer,
+		SetIndexBuffer,
+		SetPipelineState,
+		SetConstantBuffer,
+		SetPushConstants,
+		SetTexture,
+		SetStorageBuffer,
+		SetScissor,
+		Draw,
+		Dispatch,
+		BeginRenderPass,
+		BeginScreenRenderPass,
+		EndRenderPass,
+		ResourceBarriers,
+		ExecuteBundle,
+	};
+
+	struct PacketHeader
+	{
+		PacketType Type;
+
+		//! the size of a packet including a header, which is a multiple of PacketAlignment
+		uint32_t Size;
+	};
+
+	static const int32_t PacketAlignment = 8;
+
+private:
+	std::vector<uint8_t> packets_;
+	int32_t packetCount_ = 0;
+	bool isRecording_ = false;
+
+	template <typename T> T* AddPacket(PacketType type, size_t extraSize = 0);
+
+public:
+	CommandPacketList() = default;
+	virtual ~CommandPacketList() = default;
+
+	using CommandList::SetIndexBuffer;
+	using CommandList::SetVertexBuffer;
+
+	void Begin() override;
+	void End() override;
+
+	void SetScissor(int32_t x, int32_t y, int32_t width, int32_t height) override;
+	void Draw(int32_t pritimiveCount) override;
+	void SetVertexBuffer(VertexBuffer* vertexBuffer, int32_t stride, int32_t offset, int32_t slot = 0) override;
+	void SetIndexBuffer(IndexBuffer* indexBuffer, int32_t offset = 0) override;
+	void SetPipelineState(PipelineState* pipelineState) override;
+	void SetConstantBuffer(ConstantBuffer* constantBuffer, ShaderStageType shaderStage) override;
+	void SetPushConstants(ShaderStageType stage, const void* data, int32_t size) override;
+	void SetTexture(Texture* texture,
+					TextureWrapMode wrapMode,
+					TextureMinMagFilter minmagFilter,
+					int32_t unit,
+					ShaderStageType shaderStage) override;
+	void SetStorageBuffer(StorageBuffer* storageBuffer, int32_t unit, ShaderStageType shaderStage) override;
+	void BeginRenderPass(RenderPass* renderPass) override;
+	void EndRenderPass() override;
+	void ResourceBarriers(const ResourceBarrier* barriers, int32_t count) override;
+	void Dispatch(int32_t x, int32_t y, int32_t z) override;
+	void ExecuteBundle(CommandList* bundle) override;
+
+	/**
+		@brief	begin a render pass of a screen which is decided when packets are translated
+		@note
+		Use it instead of Graphics::GetCurrentScreen when packets are recorded before a frame of a screen is begun.
+	*/
+	void BeginScreenRenderPass(const Color8& clearColor = Color8(), bool isColorCleared = false, bool isDepthCleared = false);
+
+	/**
+		@brief	record packets into a native command list between its Begin and End
+		@param	statistics	statistics which are accumulated if it is not nullptr
+		@param	graphics	graphics to get a screen for BeginScreenRenderPass
+		@note
+		States which are the same as current ones are filtered and draws without required states are skipped.
+		It is read only for this instance, so packets can be translated while other lists are recorded.
+	*/
+	void Translate(CommandList* commandList, CommandPacketStatistics* statistics = nullptr, Graphics* graphics = nullptr) const;
+
+	int32_t GetPacketCount() const { return packetCount_; }
+
+	//! the size of recorded packets in bytes
+	size_t GetSize() const { return packets_.size(); }
+};
+
+/**
+	@brief	a worker thread which translates packets into native command lists
+	@note
+	Submit packets after they are recorded and continue other work on an application thread.
+	Call Wait before a native command list is executed and before Graphics::NewFrame, because native command lists
+	refer to resources of the current frame.
+	Other lists can be recorded between Submit and Wait, but render passes and textures which are used by submitted packets
+	must not be used by them until Wait, because their states are changed while packets are translated.
+	Don't call Graphics::NewFrame, Execute and GetCurrentScreen until Wait either, which the worker thread can use.
+*/
+class CommandTranslator : public ReferenceObject
+{
+private:
+	struct Job
+	{
+		CommandPacketList* packets = nullptr;
+		CommandList* commandList = nullptr;
+	};
+
+	std::thread thread_;
+	std::mutex mutex_;
+	std::condition_variable jobAdded_;
+	std::condition_variable jobFinished_;
+	std::deque<Job> jobs_;
+	bool isTranslating_ = false;
+	bool isTerminated_ = false;
+
+	Graphics* graphics_ = nullptr;
+	CommandPacketStatistics statistics_;
+
+	void Run();
+
+public:
+	/**
+		@param	graphics	graphics to get a screen for CommandPacketList::BeginScreenRenderPass
+	*/
+	explicit CommandTranslator(Graphics* graphics = nullptr);
+	virtual ~CommandTranslator();
+
+	/**
+		@brief	translate packets into a native command list on the worker thread
+		@note
+		Both are held until they are translated. Don't record them until Wait is called.
+	*/
+	void Submit(CommandPacketList* packets, CommandList* commandList);
+
+	//! wait until all submitted packets are translated
+	void Wait();
+
+	//! statistics which are accumulated since it is created. Call it after Wait.
+	const CommandPacketStatistics& GetStatistics() const { return statistics_; }
+};
+
+} // namespace LLGI
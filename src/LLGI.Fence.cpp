@@ -0,0 +1,10 @@
+#include "LLGI.Fence.h"
+
+namespace LLGI
+{
+
+uint64_t Fence::GetCompletedValue() { return 0; }
+
+bool Fence::Wait(uint64_t value, int32_t timeout) { return false; }
+
+} // namespace LLGI
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "LLGI.Base.h"
+
+namespace LLGI
+{
+
+/**
+	@brief	an object to know when commands which are executed on gpu are finished
+	@note
+	It has a value which increases whenever Graphics::Signal is called. The value reaches the returned one
+	when commands which are executed before the call are finished.
+*/
+class Fence : public ReferenceObject
+{
+protected:
+	uint64_t signaledValue_ = 0;
+
+public:
+	Fence() = default;
+	virtual ~Fence() = default;
+
+	//! the last value which is returned by Graphics::Signal. It is known on cpu without waiting gpu.
+	uint64_t GetSignaledValue() const { return signaledValue_; }
+
+	//! the largest value whose commands are finished on gpu
+	virtual uint64_t GetCompletedValue();
+
+	//! whether commands before a value are finished
+	bool IsCompleted(uint64_t value) { return GetCompletedValue() >= value; }
+
+	//! whether all commands which are signaled are finished
+	bool IsCompleted() { return IsCompleted(signaledValue_); }
+
+	/**
+		@brief	wait until commands before a value are finished
+		@param	timeout	time in milliseconds. It waits without limit if it is negative.
+		@return	false if it is timed out or the value is not signaled yet
+	*/
+	virtual bool Wait(uint64_t value, int32_t timeout = -1);
+};
+
+} // namespace LLGI
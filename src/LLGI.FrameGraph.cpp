@@ -0,0 +1,460 @@
+#include "LLGI.FrameGraph.h"
+#include "LLGI.CommandList.h"
+#include "LLGI.Graphics.h"
+#include "LLGI.Texture.h"
+
+namespace LLGI
+{
+
+FrameGraph::~FrameGraph()
+{
+	for (auto& renderPass : renderPasses_)
+	{
+		SafeRelease(renderPass.second);
+	}
+	renderPasses_.clear();
+
+	for (auto& textures : texturePool_)
+	{
+		for (auto& texture : textures.second)
+		{
+			SafeRelease(texture.texture);
+		}
+	}
+	texturePool_.clear();
+
+	SafeRelease(graphics_);
+}
+
+bool FrameGraph::Initialize(Graphics* graphics)
+{
+	if (graphics == nullptr)
+	{
+		return false;
+	}
+
+	SafeAssign(graphics_, graphics);
+	return true;
+}
+
+FrameGraphResource FrameGraph::CreateTexture(const char* name, const FrameGraphTextureDesc& desc)
+{
+	ResourceNode resource;
+	resource.name = name;
+	resource.desc = desc;
+	resources_.push_back(resource);
+	isCompiled_ = false;
+	return static_cast<FrameGraphResource>(resources_.size() - 1);
+}
+
+FrameGraphResource FrameGraph::ImportTexture(const char* name, Texture* texture, bool isDepthBuffer)
+{
+	if (texture == nullptr)
+	{
+		return InvalidFrameGraphResource;
+	}
+
+	ResourceNode resource;
+	resource.name = name;
+	resource.desc.Size = texture->GetSizeAs2D();
+	resource.desc.IsDepthBuffer = isDepthBuffer;
+	resource.imported = texture;
+	resources_.push_back(resource);
+	isCompiled_ = false;
+	return static_cast<FrameGraphResource>(resources_.size() - 1);
+}
+
+int32_t FrameGraph::AddPass(const char* name, ExecuteFunction execute)
+{
+	PassNode pass;
+	pass.name = name;
+	pass.execute = execute;
+	passes_.push_back(pass);
+	isCompiled_ = false;
+	return static_cast<int32_t>(passes_.size() - 1);
+}
+
+void FrameGraph::Read(int32_t pass, FrameGraphResource resource)
+{
+	if (resource == InvalidFrameGraphResource)
+		return;
+
+	passes_[pass].reads.push_back(resource);
+	isCompiled_ = false;
+}
+
+void FrameGraph::Write(int32_t pass, FrameGraphResource resource)
+{
+	if (resource == InvalidFrameGraphResource)
+		return;
+
+	passes_[pass].writes.push_back(resource);
+	isCompiled_ = false;
+}
+
+void FrameGraph::SetSideEffect(int32_t pass) { passes_[pass].hasSideEffect = true; }
+
+void FrameGraph::SetClearColor(int32_t pass, const Color8& color)
+{
+	passes_[pass].isCleared = true;
+	passes_[pass].clearColor = color;
+}
+
+Texture* FrameGraph::AcquireTexture(const FrameGraphTextureDesc& desc, bool isTransient)
+{
+	auto& textures = texturePool_[std::make_pair(desc, isTransient)];
+
+	for (auto& texture : textures)
+	{
+		if (!texture.isUsed)
+		{
+			texture.isUsed = true;
+			return texture.texture;
+		}
+	}
+
+	PooledTexture texture;
+	if (desc.IsDepthBuffer)
+	{
+		texture.texture = graphics_->CreateDepthTexture(desc.Size, isTransient);
+	}
+	else
+	{
+		texture.texture = graphics_->CreateTexture(desc.Size, true, false);
+	}
+
+	if (texture.texture == nullptr)
+	{
+		return nullptr;
+	}
+
+	texture.isUsed = true;
+	textures.push_back(texture);
+	return texture.texture;
+}
+
+void FrameGraph::ReleaseTexture(const FrameGraphTextureDesc& desc, bool isTransient, Texture* texture)
+{
+	for (auto& pooled : texturePool_[std::make_pair(desc, isTransient)])
+	{
+		if (pooled.texture == texture)
+		{
+			pooled.isUsed = false;
+			return;
+		}
+	}
+}
+
+RenderPass* FrameGraph::GetRenderPass(const PassNode& pass)
+{
+	std::vector<const Texture*> colors;
+	Texture* depth = nullptr;
+
+	for (auto write : pass.writes)
+	{
+		const auto& resource = resources_[write];
+		if (resource.desc.IsDepthBuffer)
+		{
+			depth = resource.texture;
+		}
+		else
+		{
+			colors.push_back(resource.texture);
+		}
+	}
+
+	if (colors.size() == 0)
+	{
+		return nullptr;
+	}
+
+	// the last element is a depth buffer
+	std::vector<Texture*> key;
+	for (auto color : colors)
+	{
+		key.push_back(const_cast<Texture*>(color));
+	}
+	key.push_back(depth);
+
+	auto it = renderPasses_.find(key);
+	if (it != renderPasses_.end())
+	{
+		return it->second;
+	}
+
+	auto renderPass = graphics_->CreateRenderPass(colors.data(), static_cast<int32_t>(colors.size()), depth);
+	if (renderPass == nullptr)
+	{
+		return nullptr;
+	}
+
+	renderPasses_[key] = renderPass;
+	return renderPass;
+}
+
+void FrameGraph::Compile()
+{
+	// cull passes whose outputs are not read
+	for (auto& pass : passes_)
+	{
+		pass.refCount = static_cast<int32_t>(pass.writes.size());
+		pass.isCulled = false;
+		pass.barriers.clear();
+	}
+
+	for (auto& resource : resources_)
+	{
+		resource.writers.clear();
+		resource.readerCount = 0;
+		resource.firstPass = -1;
+		resource.lastPass = -1;
+		resource.isTransient = false;
+	}
+
+	for (size_t i = 0; i < passes_.size(); i++)
+	{
+		for (auto read : passes_[i].reads)
+		{
+			resources_[read].readerCount++;
+		}
+
+		for (auto write : passes_[i].writes)
+		{
+			resources_[write].writers.push_back(static_cast<int32_t>(i));
+		}
+	}
+
+	// passes which write nothing and have no side effects are culled first, so that their reads are not referenced
+	for (auto& pass : passes_)
+	{
+		if (pass.writes.size() > 0 || pass.hasSideEffect)
+			continue;
+
+		pass.isCulled = true;
+
+		for (auto read : pass.reads)
+		{
+			resources_[read].readerCount--;
+		}
+	}
+
+	std::vector<FrameGraphResource> unreferenced;
+	for (size_t i = 0; i < resources_.size(); i++)
+	{
+		if (resources_[i].readerCount == 0 && resources_[i].imported == nullptr)
+		{
+			unreferenced.push_back(static_cast<FrameGraphResource>(i));
+		}
+	}
+
+	while (unreferenced.size() > 0)
+	{
+		auto resource = unreferenced.back();
+		unreferenced.pop_back();
+
+		for (auto writer : resources_[resource].writers)
+		{
+			auto& pass = passes_[writer];
+			if (pass.isCulled || pass.hasSideEffect)
+				continue;
+
+			pass.refCount--;
+			if (pass.refCount > 0)
+				continue;
+
+			pass.isCulled = true;
+
+			for (auto read : pass.reads)
+			{
+				resources_[read].readerCount--;
+				if (resources_[read].readerCount == 0 && resources_[read].imported == nullptr)
+				{
+					unreferenced.push_back(read);
+				}
+			}
+		}
+	}
+
+	// lifetimes
+	for (size_t i = 0; i < passes_.size(); i++)
+	{
+		if (passes_[i].isCulled)
+			continue;
+
+		auto update = [this, i](FrameGraphResource r) -> void {
+			auto& resource = resources_[r];
+			if (resource.firstPass < 0)
+			{
+				resource.firstPass = static_cast<int32_t>(i);
+			}
+			resource.lastPass = static_cast<int32_t>(i);
+		};
+
+		for (auto read : passes_[i].reads)
+			update(read);
+		for (auto write : passes_[i].writes)
+			update(write);
+	}
+
+	// assign textures and compute barriers
+	for (auto& resource : resources_)
+	{
+		resource.texture = resource.imported;
+		resource.isTransient = resource.desc.IsDepthBuffer && resource.imported == nullptr && resource.readerCount == 0;
+	}
+
+	std::map<Texture*, ResourceState> states;
+
+	for (size_t i = 0; i < passes_.size(); i++)
+	{
+		auto& pass = passes_[i];
+		if (pass.isCulled)
+			continue;
+
+		for (auto& resource : resources_)
+		{
+			if (resource.firstPass == static_cast<int32_t>(i) && resource.imported == nullptr)
+			{
+				resource.texture = AcquireTexture(resource.desc, resource.isTransient);
+			}
+		}
+
+		auto addBarrier = [&](FrameGraphResource r, ResourceState state) -> void {
+			auto texture = resources_[r].texture;
+			if (texture == nullptr)
+				return;
+
+			auto it = states.find(texture);
+			if (it != states.end() && it->second == state)
+				return;
+
+			states[texture] = state;
+
+			ResourceBarrier barrier;
+			barrier.texture = texture;
+			barrier.state = state;
+			pass.barriers.push_back(barrier);
+		};
+
+		for (auto read : pass.reads)
+			addBarrier(read, ResourceState::ShaderResource);
+
+		for (auto write : pass.writes)
+			addBarrier(write, resources_[write].desc.IsDepthBuffer ? ResourceState::DepthWrite : ResourceState::RenderTarget);
+
+		// contents are loaded only if they are written by previous passes
+		pass.colorLoadOp = pass.isCleared ? AttachmentLoadOp::Clear : AttachmentLoadOp::DontCare;
+		pass.depthLoadOp = pass.isCleared ? AttachmentLoadOp::Clear : AttachmentLoadOp::DontCare;
+		pass.depthStoreOp = AttachmentStoreOp::Store;
+
+		for (auto write : pass.writes)
+		{
+			const auto& resource = resources_[write];
+			auto isWrittenBefore = resource.imported != nullptr || resource.firstPass != static_cast<int32_t>(i);
+
+			if (resource.desc.IsDepthBuffer)
+			{
+				if (!pass.isCleared && isWrittenBefore)
+					pass.depthLoadOp = AttachmentLoadOp::Load;
+
+				if (resource.isTransient && resource.lastPass == static_cast<int32_t>(i))
+					pass.depthStoreOp = AttachmentStoreOp::DontCare;
+			}
+			else if (!pass.isCleared && isWrittenBefore)
+			{
+				pass.colorLoadOp = AttachmentLoadOp::Load;
+			}
+		}
+
+		// textures which are not used anymore are aliased by following passes
+		for (auto& resource : resources_)
+		{
+			if (resource.lastPass == static_cast<int32_t>(i) && resource.imported == nullptr && resource.texture != nullptr)
+			{
+				ReleaseTexture(resource.desc, resource.isTransient, resource.texture);
+			}
+		}
+	}
+
+	isCompiled_ = true;
+}
+
+void FrameGraph::Execute(CommandList* commandList)
+{
+	if (!isCompiled_)
+	{
+		Compile();
+	}
+
+	for (auto& pass : passes_)
+	{
+		if (pass.isCulled)
+			continue;
+
+		if (pass.barriers.size() > 0)
+		{
+			commandList->ResourceBarriers(pass.barriers.data(), static_cast<int32_t>(pass.barriers.size()));
+		}
+
+		auto renderPass = pass.writes.size() > 0 ? GetRenderPass(pass) : nullptr;
+		currentRenderPass_ = renderPass;
+
+		if (renderPass != nullptr)
+		{
+			renderPass->SetColorLoadOp(pass.colorLoadOp);
+			renderPass->SetDepthLoadOp(pass.depthLoadOp);
+			renderPass->SetDepthStoreOp(pass.depthStoreOp);
+			renderPass->SetClearColor(pass.clearColor);
+			commandList->BeginRenderPass(renderPass);
+		}
+
+		if (pass.execute)
+		{
+			pass.execute(*this, commandList);
+		}
+
+		if (renderPass != nullptr)
+		{
+			commandList->EndRenderPass();
+		}
+	}
+
+	currentRenderPass_ = nullptr;
+}
+
+void FrameGraph::Reset()
+{
+	for (auto& textures : texturePool_)
+	{
+		for (auto& texture : textures.second)
+		{
+			texture.isUsed = false;
+		}
+	}
+
+	resources_.clear();
+	passes_.clear();
+	isCompiled_ = false;
+}
+
+Texture* FrameGraph::GetTexture(FrameGraphResource resource) const
+{
+	if (resource < 0 || resource >= static_cast<FrameGraphResource>(resources_.size()))
+	{
+		return nullptr;
+	}
+
+	return resources_[resource].texture;
+}
+
+int32_t FrameGraph::GetPooledTextureCount() const
+{
+	int32_t count = 0;
+	for (auto& textures : texturePool_)
+	{
+		count += static_cast<int32_t>(textures.second.size());
+	}
+	return count;
+}
+
+} // namespace LLGI
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "LLGI.Base.h"
+#include <functional>
+#include <map>
+
+namespace LLGI
+{
+
+/**
+	@brief	a handle of a texture in FrameGraph
+*/
+typedef int32_t FrameGraphResource;
+
+static const FrameGraphResource InvalidFrameGraphResource = -1;
+
+/**
+	@brief	a description of a texture which is created and aliased by FrameGraph
+*/
+struct FrameGraphTextureDesc
+{
+	Vec2I Size;
+	bool IsDepthBuffer = false;
+
+	bool operator<(const FrameGraphTextureDesc& value) const
+	{
+		if (Size.X != value.Size.X)
+			return Size.X < value.Size.X;
+		if (Size.Y != value.Size.Y)
+			return Size.Y < value.Size.Y;
+		return IsDepthBuffer < value.IsDepthBuffer;
+	}
+};
+
+/**
+	@brief	a class to declare passes with textures which they read and write, and execute them
+	@note
+	Passes are compiled in the order of declarations.
+	- Passes whose outputs are not read by other passes are culled unless they write imported textures or have side effects.
+	- Barriers which a pass needs are recorded with a batch before it.
+	- Transient textures whose lifetimes don't overlap share a texture.
+	- Depth buffers which are not read by any pass are created as transient depth buffers and not stored.
+	- Contents of textures are not loaded in a pass which writes them first.
+	If a pass writes textures, a render pass with them is begun before it is executed.
+	Transient textures are kept in a pool over frames, so call Reset and declare passes again in each frame.
+*/
+class FrameGraph : public ReferenceObject
+{
+public:
+	typedef std::function<void(FrameGraph& frameGraph, CommandList* commandList)> ExecuteFunction;
+
+private:
+	struct ResourceNode
+	{
+		std::string name;
+		FrameGraphTextureDesc desc;
+		Texture* imported = nullptr;
+		Texture* texture = nullptr;
+
+		std::vector<int32_t> writers;
+		int32_t readerCount = 0;
+		int32_t firstPass = -1;
+		int32_t lastPass = -1;
+
+		//! a depth buffer which is not read by any pass
+		bool isTransient = false;
+	};
+
+	struct PassNode
+	{
+		std::string name;
+		ExecuteFunction execute;
+		std::vector<FrameGraphResource> reads;
+		std::vector<FrameGraphResource> writes;
+		bool hasSideEffect = false;
+		bool isCleared = false;
+		Color8 clearColor;
+		int32_t refCount = 0;
+		bool isCulled = false;
+		std::vector<ResourceBarrier> barriers;
+		AttachmentLoadOp colorLoadOp = AttachmentLoadOp::Load;
+		AttachmentLoadOp depthLoadOp = AttachmentLoadOp::Load;
+		AttachmentStoreOp depthStoreOp = AttachmentStoreOp::Store;
+	};
+
+	struct PooledTexture
+	{
+		Texture* texture = nullptr;
+		bool isUsed = false;
+	};
+
+	Graphics* graphics_ = nullptr;
+
+	std::vector<ResourceNode> resources_;
+	std::vector<PassNode> passes_;
+	bool isCompiled_ = false;
+	RenderPass* currentRenderPass_ = nullptr;
+
+	//! textures for each description and whether they are transient
+	std::map<std::pair<FrameGraphTextureDesc, bool>, std::vector<PooledTexture>> texturePool_;
+	std::map<std::vector<Texture*>, RenderPass*> renderPasses_;
+
+	Texture* AcquireTexture(const FrameGraphTextureDesc& desc, bool isTransient);
+	void ReleaseTexture(const FrameGraphTextureDesc& desc, bool isTransient, Texture* texture);
+	RenderPass* GetRenderPass(const PassNode& pass);
+
+public:
+	FrameGraph() = default;
+	virtual ~FrameGraph();
+
+	bool Initialize(Graphics* graphics);
+
+	/**
+		@brief	declare a texture which is created by the graph
+	*/
+	FrameGraphResource CreateTexture(const char* name, const FrameGraphTextureDesc& desc);
+
+	/**
+		@brief	declare a texture which is created outside of the graph
+		@note
+		Passes which write it are not culled. It is not held.
+	*/
+	FrameGraphResource ImportTexture(const char* name, Texture* texture, bool isDepthBuffer = false);
+
+	/**
+		@brief	declare a pass
+		@param	execute	a function to record commands of the pass
+		@return	an index of the pass
+	*/
+	int32_t AddPass(const char* name, ExecuteFunction execute);
+
+	//! declare that a pass samples a texture
+	void Read(int32_t pass, FrameGraphResource resource);
+
+	//! declare that a pass renders into a texture
+	void Write(int32_t pass, FrameGraphResource resource);
+
+	/**
+		@brief	make a pass not culled
+		@note
+		For example, a pass which renders into a screen has side effects.
+	*/
+	void SetSideEffect(int32_t pass);
+
+	//! clear textures which a pass writes before it is executed
+	void SetClearColor(int32_t pass, const Color8& color);
+
+	/**
+		@brief	cull passes, assign textures and compute barriers
+	*/
+	void Compile();
+
+	/**
+		@brief	record passes which are not culled
+		@note
+		Compile is called if it is not called.
+	*/
+	void Execute(CommandList* commandList);
+
+	/**
+		@brief	remove passes and resources to declare a next frame
+		@note
+		Pooled textures are kept.
+	*/
+	void Reset();
+
+	/**
+		@brief	get a texture which is assigned to a resource
+		@note
+		It is valid after Compile is called and until Reset is called.
+	*/
+	Texture* GetTexture(FrameGraphResource resource) const;
+
+	/**
+		@brief	get a render pass which is begun for a pass being executed
+		@note
+		It is valid in ExecuteFunction. It is nullptr if the pass writes no color textures.
+	*/
+	RenderPass* GetCurrentRenderPass() const { return currentRenderPass_; }
+
+	//! get whether a pass is culled after Compile is called
+	bool IsCulled(int32_t pass) const { return passes_[pass].isCulled; }
+
+	//! get the number of textures which are created by the graph
+	int32_t GetPooledTextureCount() const;
+};
+
+} // namespace LLGI
@@ -1,38 +1,286 @@
 #include "LLGI.Graphics.h"
+#include "LLGI.IndexBuffer.h"
+#include "LLGI.Texture.h"
+#include "LLGI.VertexBuffer.h"
 
 namespace LLGI
 {
 
-void RenderPass::SetIsColorCleared(bool isColorCleared) { isColorCleared_ = isColorCleared; }
+void RenderPass::SetIsColorCleared(bool isColorCleared)
+{
+	colorLoadOp_ = isColorCleared ? AttachmentLoadOp::Clear : AttachmentLoadOp::Load;
+}
 
-void RenderPass::SetIsDepthCleared(bool isDepthCleared) { isDepthCleared_ = isDepthCleared; }
+void RenderPass::SetIsDepthCleared(bool isDepthCleared)
+{
+	depthLoadOp_ = isDepthCleared ? AttachmentLoadOp::Clear : AttachmentLoadOp::Load;
+}
 
 void RenderPass::SetClearColor(const Color8& color) { color_ = color; }
 
+void RenderPass::SetColorLoadOp(AttachmentLoadOp loadOp) { colorLoadOp_ = loadOp; }
+
+void RenderPass::SetDepthLoadOp(AttachmentLoadOp loadOp) { depthLoadOp_ = loadOp; }
+
+void RenderPass::SetColorStoreOp(AttachmentStoreOp storeOp) { colorStoreOp_ = storeOp; }
+
+void RenderPass::SetDepthStoreOp(AttachmentStoreOp storeOp) { depthStoreOp_ = storeOp; }
+
 RenderPassPipelineState* RenderPass::CreateRenderPassPipelineState() { return nullptr; }
 
+template <typename T, typename F>
+Graphics::TransientBufferPage<T>* Graphics::AllocateTransientBufferRegion(
+	std::vector<TransientBufferPage<T>>& pages, int32_t size, int32_t alignment, F createBuffer, int32_t& offset)
+{
+	for (auto& page : pages)
+	{
+		auto aligned = (page.offset + alignment - 1) / alignment * alignment;
+		if (aligned + size <= page.size)
+		{
+			offset = aligned;
+			page.offset = aligned + size;
+			return &page;
+		}
+	}
+
+	// a large region occupies a page
+	TransientBufferPage<T> page;
+	const int32_t pageSize = TransientBufferPageSize;
+	page.size = (std::max)(size, pageSize);
+	page.buffer = createBuffer(page.size);
+	if (page.buffer == nullptr)
+	{
+		return nullptr;
+	}
+
+	// pages are kept mapped until they are disposed
+	page.data = static_cast<uint8_t*>(page.buffer->Lock());
+	if (page.data == nullptr)
+	{
+		SafeRelease(page.buffer);
+		return nullptr;
+	}
+
+	page.offset = size;
+	pages.push_back(page);
+
+	offset = 0;
+	return &pages.back();
+}
+
+void Graphics::InitializeTransientBuffers(int32_t frameCount)
+{
+	DisposeTransientBuffers();
+	transientBufferFrames_.resize(frameCount);
+	transientBufferFrameIndex_ = 0;
+}
+
+void Graphics::NewTransientBufferFrame()
+{
+	if (transientBufferFrames_.size() == 0)
+	{
+		return;
+	}
+
+	transientBufferFrameIndex_ = (transientBufferFrameIndex_ + 1) % static_cast<int32_t>(transientBufferFrames_.size());
+
+	auto& frame = transientBufferFrames_[transientBufferFrameIndex_];
+
+	for (auto& page : frame.vertexPages)
+	{
+		page.offset = 0;
+	}
+
+	for (auto& pages : frame.indexPages)
+	{
+		for (auto& page : pages)
+		{
+			page.offset = 0;
+		}
+	}
+}
+
+void Graphics::DisposeTransientBuffers()
+{
+	for (auto& frame : transientBufferFrames_)
+	{
+		for (auto& page : frame.vertexPages)
+		{
+			page.buffer->Unlock();
+			SafeRelease(page.buffer);
+		}
+
+		for (auto& pages : frame.indexPages)
+		{
+			for (auto& page : pages)
+			{
+				page.buffer->Unlock();
+				SafeRelease(page.buffer);
+			}
+		}
+	}
+
+	transientBufferFrames_.clear();
+}
+
+void Graphics::ProcessTextureStreaming()
+{
+	int32_t uploadedSize = 0;
+
+	while (textureMipMapRequests_.size() > 0)
+	{
+		auto& request = textureMipMapRequests_.front();
+		auto size = static_cast<int32_t>(request.data.size());
+
+		if (uploadedSize > 0 && uploadedSize + size > textureStreamingBudget_)
+		{
+			break;
+		}
+
+		UploadTextureMipMap(request.texture, request.mipLevel, request.data.data(), size);
+		uploadedSize += size;
+
+		SafeRelease(request.texture);
+		textureMipMapRequests_.pop_front();
+	}
+}
+
+void Graphics::DisposeTextureStreaming()
+{
+	for (auto& request : textureMipMapRequests_)
+	{
+		SafeRelease(request.texture);
+	}
+
+	textureMipMapRequests_.clear();
+}
+
 void Graphics::NewFrame() {}
 
 void Graphics::SetWindowSize(const Vec2I& windowSize) { windowSize_ = windowSize; }
 
 void Graphics::Execute(CommandList* commandList) {}
 
+void Graphics::ExecuteCompute(CommandList* commandList) { Execute(commandList); }
+
+uint64_t Graphics::Signal(Fence* fence) { return 0; }
+
 RenderPass* Graphics::GetCurrentScreen(const Color8& clearColor, bool isColorCleared, bool isDepthCleared) { return nullptr; }
 
 VertexBuffer* Graphics::CreateVertexBuffer(int32_t size) { return nullptr; }
 
 IndexBuffer* Graphics::CreateIndexBuffer(int32_t stride, int32_t count) { return nullptr; }
 
+TransientVertexBuffer Graphics::AllocateTransientVertices(int32_t size)
+{
+	TransientVertexBuffer ret;
+
+	if (transientBufferFrames_.size() == 0 || size <= 0)
+	{
+		return ret;
+	}
+
+	auto& pages = transientBufferFrames_[transientBufferFrameIndex_].vertexPages;
+
+	int32_t offset = 0;
+	auto page = AllocateTransientBufferRegion(
+		pages, size, 16, [this](int32_t pageSize) { return CreateTransientVertexBuffer(pageSize); }, offset);
+
+	if (page == nullptr)
+	{
+		return ret;
+	}
+
+	ret.vertexBuffer = page->buffer;
+	ret.offset = offset;
+	ret.data = page->data + offset;
+	return ret;
+}
+
+TransientIndexBuffer Graphics::AllocateTransientIndices(int32_t stride, int32_t count)
+{
+	TransientIndexBuffer ret;
+
+	if (transientBufferFrames_.size() == 0 || count <= 0 || (stride != 2 && stride != 4))
+	{
+		return ret;
+	}
+
+	auto& pages = transientBufferFrames_[transientBufferFrameIndex_].indexPages[stride == 2 ? 0 : 1];
+
+	int32_t offset = 0;
+	auto createBuffer = [this, stride](int32_t pageSize) { return CreateTransientIndexBuffer(stride, pageSize / stride); };
+	auto page = AllocateTransientBufferRegion(pages, stride * count, stride, createBuffer, offset);
+
+	if (page == nullptr)
+	{
+		return ret;
+	}
+
+	ret.indexBuffer = page->buffer;
+	ret.offset = offset;
+	ret.data = page->data + offset;
+	return ret;
+}
+
 Shader* Graphics::CreateShader(DataStructure* data, int32_t count) { return nullptr; }
 
 PipelineState* Graphics::CreatePiplineState() { return nullptr; }
 
 CommandList* Graphics::CreateCommandList() { return nullptr; }
 
+CommandList* Graphics::CreateCommandBundle(RenderPassPipelineState* renderPassPipelineState, const Vec2I& viewportSize) { return nullptr; }
+
+CommandList* Graphics::CreateComputeCommandList() { return CreateCommandList(); }
+
 ConstantBuffer* Graphics::CreateConstantBuffer(int32_t size, ConstantBufferType type) { return nullptr; }
 
+StorageBuffer* Graphics::CreateStorageBuffer(int32_t size) { return nullptr; }
+
+Fence* Graphics::CreateFence() { return nullptr; }
+
 Texture* Graphics::CreateTexture(const Vec2I& size, bool isRenderPass, bool isDepthBuffer) { return nullptr; }
 
 Texture* Graphics::CreateTexture(uint64_t id) { return nullptr; }
 
+Texture* Graphics::CreateDepthTexture(const Vec2I& size, bool isTransient) { return CreateTexture(size, false, true); }
+
+Texture* Graphics::CreateTexture(const TextureInitializationParameter& parameter)
+{
+	if (parameter.Format != TextureFormatType::R8G8B8A8_UNORM || parameter.MipMapCount != 1 || parameter.ArrayLayerCount != 1 ||
+		parameter.IsStreamed)
+	{
+		return nullptr;
+	}
+
+	return CreateTexture(parameter.Size, false, false);
+}
+
+bool Graphics::RequestTextureMipMap(Texture* texture, int32_t mipLevel, const void* data, int32_t size)
+{
+	if (texture == nullptr || !texture->IsStreamed() || mipLevel < 0 || mipLevel >= texture->GetMipMapCount())
+	{
+		return false;
+	}
+
+	auto textureSize = texture->GetSizeAs2D();
+	auto mipSize = Vec2I(std::max(textureSize.X >> mipLevel, 1), std::max(textureSize.Y >> mipLevel, 1));
+	if (size != GetTextureMemorySize(texture->GetFormat(), mipSize) * texture->GetArrayLayerCount())
+	{
+		return false;
+	}
+
+	TextureMipMapRequest request;
+	SafeAssign(request.texture, texture);
+	request.mipLevel = mipLevel;
+	request.data.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+	textureMipMapRequests_.push_back(std::move(request));
+
+	return true;
+}
+
+int32_t Graphics::RegisterBindlessTexture(Texture* texture) { return -1; }
+
+void Graphics::UnregisterBindlessTexture(int32_t index) {}
+
 } // namespace LLGI
\ No newline at end of file
@@ -9,9 +9,13 @@ namespace LLGI
 class RenderPass : public ReferenceObject
 {
 private:
-	bool isColorCleared_ = false;
+	AttachmentLoadOp colorLoadOp_ = AttachmentLoadOp::Load;
 
-	bool isDepthCleared_ = false;
+	AttachmentLoadOp depthLoadOp_ = AttachmentLoadOp::Load;
+
+	AttachmentStoreOp colorStoreOp_ = AttachmentStoreOp::Store;
+
+	AttachmentStoreOp depthStoreOp_ = AttachmentStoreOp::Store;
 
 	Color8 color_;
 
@@ -19,18 +23,59 @@ public:
 	RenderPass() = default;
 	virtual ~RenderPass() = default;
 
-	virtual bool GetIsColorCleared() const { return isColorCleared_; }
+	virtual bool GetIsColorCleared() const { return colorLoadOp_ == AttachmentLoadOp::Clear; }
 
-	virtual bool GetIsDepthCleared() const { return isDepthCleared_; }
+	virtual bool GetIsDepthCleared() const { return depthLoadOp_ == AttachmentLoadOp::Clear; }
 
 	virtual Color8 GetClearColor() const { return color_; }
 
+	/**
+		@brief	set whether color buffers are cleared
+		@note
+		It sets the load op of color buffers to Clear or Load.
+	*/
 	virtual void SetIsColorCleared(bool isColorCleared);
 
+	/**
+		@brief	set whether a depth buffer is cleared
+		@note
+		It sets the load op of a depth buffer to Clear or Load.
+	*/
 	virtual void SetIsDepthCleared(bool isDepthCleared);
 
 	virtual void SetClearColor(const Color8& color);
 
+	virtual AttachmentLoadOp GetColorLoadOp() const { return colorLoadOp_; }
+
+	virtual AttachmentLoadOp GetDepthLoadOp() const { return depthLoadOp_; }
+
+	virtual AttachmentStoreOp GetColorStoreOp() const { return colorStoreOp_; }
+
+	virtual AttachmentStoreOp GetDepthStoreOp() const { return depthStoreOp_; }
+
+	/**
+		@brief	set what is done with color buffers when a render pass begins
+		@note
+		DontCare is faster than Load when all pixels are overwritten.
+	*/
+	virtual void SetColorLoadOp(AttachmentLoadOp loadOp);
+
+	virtual void SetDepthLoadOp(AttachmentLoadOp loadOp);
+
+	/**
+		@brief	set what is done with color buffers when a render pass ends
+		@note
+		DontCare saves bandwidth when contents are not read after a render pass.
+	*/
+	virtual void SetColorStoreOp(AttachmentStoreOp storeOp);
+
+	/**
+		@brief	set what is done with a depth buffer when a render pass ends
+		@note
+		Set DontCare when a depth buffer is not read after a render pass, especially with a transient depth buffer.
+	*/
+	virtual void SetDepthStoreOp(AttachmentStoreOp storeOp);
+
 	/**
 		@brief	create a RenderPassPipelineState
 		@note
@@ -53,9 +98,97 @@ public:
 
 class Graphics : public ReferenceObject
 {
+private:
+	template <typename T> struct TransientBufferPage
+	{
+		T* buffer = nullptr;
+		uint8_t* data = nullptr;
+		int32_t size = 0;
+		int32_t offset = 0;
+	};
+
+	struct TransientBufferFrame
+	{
+		std::vector<TransientBufferPage<VertexBuffer>> vertexPages;
+
+		//! pages for 16bit and 32bit indexes
+		std::array<std::vector<TransientBufferPage<IndexBuffer>>, 2> indexPages;
+	};
+
+	std::vector<TransientBufferFrame> transientBufferFrames_;
+	int32_t transientBufferFrameIndex_ = 0;
+
+	template <typename T, typename F>
+	TransientBufferPage<T>* AllocateTransientBufferRegion(
+		std::vector<TransientBufferPage<T>>& pages, int32_t size, int32_t alignment, F createBuffer, int32_t& offset);
+
+	struct TextureMipMapRequest
+	{
+		Texture* texture = nullptr;
+		int32_t mipLevel = 0;
+		std::vector<uint8_t> data;
+	};
+
+	std::deque<TextureMipMapRequest> textureMipMapRequests_;
+	int32_t textureStreamingBudget_ = 4 * 1024 * 1024;
+
 protected:
 	Vec2I windowSize_;
 
+	//! the default size of a page of transient buffers
+	static const int32_t TransientBufferPageSize = 1024 * 1024;
+
+	/**
+		@brief	enable transient buffers
+		@param	frameCount	the number of frames which gpu may be processing at the same time
+	*/
+	void InitializeTransientBuffers(int32_t frameCount);
+
+	/**
+		@brief	make regions which are allocated at frameCount frames ago available
+		@note
+		Call it in NewFrame.
+	*/
+	void NewTransientBufferFrame();
+
+	/**
+		@brief	release transient buffers
+		@note
+		Call it in a destructor of a derived class because buffers are released with a device.
+	*/
+	void DisposeTransientBuffers();
+
+	/**
+		@brief	create a page of transient buffers which is mapped persistently
+		@note
+		A page must not hold a reference of this instance.
+	*/
+	virtual VertexBuffer* CreateTransientVertexBuffer(int32_t size) { return CreateVertexBuffer(size); }
+
+	virtual IndexBuffer* CreateTransientIndexBuffer(int32_t stride, int32_t count) { return CreateIndexBuffer(stride, count); }
+
+	/**
+		@brief	upload requested mip levels in order until they reach the budget
+		@note
+		Call it in NewFrame. At least one request is uploaded in a frame even if it is larger than the budget.
+	*/
+	void ProcessTextureStreaming();
+
+	/**
+		@brief	discard requests which are not uploaded
+		@note
+		Call it in a destructor of a derived class.
+	*/
+	void DisposeTextureStreaming();
+
+	/**
+		@brief	record an upload of a mip level of a streamed texture without waiting gpu
+		@param	data	data of the level which are packed for each array layer in order
+		@note
+		Uploaded data must be visible to commands which are executed after it.
+	*/
+	virtual bool UploadTextureMipMap(Texture* texture, int32_t mipLevel, const void* data, int32_t size) { return false; }
+
 public:
 	Graphics() = default;
 	virtual ~Graphics() = default;
@@ -73,6 +206,23 @@ public:
 	*/
 	virtual void Execute(CommandList* commandList);
 
+	/**
+		@brief	Execute compute commands on an async compute queue
+		@param	commandList	a command list which is created with CreateComputeCommandList
+		@note
+		It waits for command lists and uploads which are executed before it, and command lists which are executed
+		with Execute after it wait for it on gpu. Backends without a dedicated compute queue execute it with Execute.
+	*/
+	virtual void ExecuteCompute(CommandList* commandList);
+
+	/**
+		@brief	signal a fence when commands which are executed before it are finished on gpu
+		@return	a value which the fence reaches when they are finished. 0 if fences are not supported.
+		@note
+		Use it to know when resources which are used by commands can be reused instead of WaitFinish.
+	*/
+	virtual uint64_t Signal(Fence* fence);
+
 	/**
 	@brief	to prevent instances to be disposed before finish rendering, finish all renderings.
 	*/
@@ -98,10 +248,50 @@ public:
 		@param	count	the number of index
 	*/
 	virtual IndexBuffer* CreateIndexBuffer(int32_t stride, int32_t count);
+
+	/**
+		@brief	allocate a region of a vertex buffer which is valid only in the current frame
+		@param	size	the size of the region
+		@return	vertexBuffer is nullptr if transient buffers are not supported
+		@note
+		Write vertices into data directly without Lock and Unlock, and pass it into CommandList::SetVertexBuffer.
+	*/
+	virtual TransientVertexBuffer AllocateTransientVertices(int32_t size);
+
+	/**
+		@brief	allocate a region of an index buffer which is valid only in the current frame
+		@param	stride	the stride of index(2 or 4)
+		@param	count	the number of index
+		@return	indexBuffer is nullptr if transient buffers are not supported
+	*/
+	virtual TransientIndexBuffer AllocateTransientIndices(int32_t stride, int32_t count);
+
+	//! whether AllocateTransientVertices and AllocateTransientIndices are supported
+	bool IsTransientBufferSupported() const { return transientBufferFrames_.size() > 0; }
+
 	virtual Shader* CreateShader(DataStructure* data, int32_t count);
 	virtual PipelineState* CreatePiplineState();
 	virtual CommandList* CreateCommandList();
 
+	/**
+		@brief	create a command list which is recorded once and executed in render passes with CommandList::ExecuteBundle
+		@param	renderPassPipelineState	a format of render passes in which the bundle is executed
+		@param	viewportSize	the size of a viewport which draws in the bundle use
+		@return	nullptr if bundles are not supported
+		@note
+		Record draws between Begin and End without BeginRenderPass. The bundle holds resources which are used by its draws
+		until it is recorded again or released. Contents of resources are read when it is executed, so constant buffers
+		must be LongTime and transient buffers can't be used. Don't record it again while it may be executed.
+	*/
+	virtual CommandList* CreateCommandBundle(RenderPassPipelineState* renderPassPipelineState, const Vec2I& viewportSize);
+
+	/**
+		@brief	create a command list which is executed with ExecuteCompute
+		@note
+		Record only Dispatch and states for it. Backends without a dedicated compute queue create a usual command list.
+	*/
+	virtual CommandList* CreateComputeCommandList();
+
 	/**
 		@brief	create a constant buffer
 		@param	size buffer size
@@ -109,9 +299,77 @@ public:
 	*/
 	virtual ConstantBuffer* CreateConstantBuffer(int32_t size, ConstantBufferType type = ConstantBufferType::LongTime);
 
+	/**
+		@brief	create a storage buffer which compute shaders read and write
+		@param	size	buffer size
+		@return	nullptr if compute shaders are not supported
+	*/
+	virtual StorageBuffer* CreateStorageBuffer(int32_t size);
+
+	/**
+		@brief	create a fence which is signaled with Signal
+		@return	nullptr if fences are not supported
+	*/
+	virtual Fence* CreateFence();
+
 	virtual RenderPass* CreateRenderPass(const Texture** textures, int32_t textureCount, Texture* depthTexture) { return nullptr; }
 	virtual Texture* CreateTexture(const Vec2I& size, bool isRenderPass, bool isDepthBuffer);
 	virtual Texture* CreateTexture(uint64_t id);
+
+	/**
+		@brief	create a depth buffer
+		@param	isTransient	whether it is not read after render passes. It may not be backed by memory on tile based gpus.
+		@note
+		Set AttachmentStoreOp::DontCare as the depth store op of render passes with a transient depth buffer.
+		Backends which don't support transient memory create a usual depth buffer.
+	*/
+	virtual Texture* CreateDepthTexture(const Vec2I& size, bool isTransient);
+
+	/**
+		@brief	create a texture with a format, mip levels and array layers
+		@note
+		Backends which don't support the parameter accept only a single RGBA8 texture.
+	*/
+	virtual Texture* CreateTexture(const TextureInitializationParameter& parameter);
+
+	/**
+		@brief	request to upload a mip level of a streamed texture in a later frame
+		@param	texture	a texture which is created with IsStreamed. It is held until the level is uploaded.
+		@param	mipLevel	a level to upload
+		@param	data	data of the level which are packed for each array layer in order. They are copied.
+		@param	size	the size of data
+		@return	false if the texture is not streamed or the size is wrong
+		@note
+		Requests are uploaded in order under a budget per frame. Request coarse levels first to make a texture usable early.
+		Requests which are not uploaded are discarded by WaitFinish, because textures which they hold would keep this instance alive.
+	*/
+	virtual bool RequestTextureMipMap(Texture* texture, int32_t mipLevel, const void* data, int32_t size);
+
+	/**
+		@brief	set the maximum number of bytes which are uploaded by streaming in a frame
+	*/
+	void SetTextureStreamingBudget(int32_t size) { textureStreamingBudget_ = size; }
+
+	int32_t GetTextureStreamingBudget() const { return textureStreamingBudget_; }
+
+	//! the number of mip levels which are requested but not uploaded
+	int32_t GetPendingTextureMipMapCount() const { return static_cast<int32_t>(textureMipMapRequests_.size()); }
+
+	/**
+		@brief	register a texture to an array which shaders access with an index
+		@param	texture	a texture which is held until it is unregistered
+		@return	an index of the texture in the array. -1 if bindless textures are not supported
+		@note
+		An index must be dynamically uniform, like a push constant, because non uniform indexing is not required.
+	*/
+	virtual int32_t RegisterBindlessTexture(Texture* texture);
+
+	/**
+		@brief	unregister a texture from the array
+		@note
+		The index is reused after frames which may refer it are finished.
+	*/
+	virtual void UnregisterBindlessTexture(int32_t index);
 };
 
 } // namespace LLGI
\ No newline at end of file
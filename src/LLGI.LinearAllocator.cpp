@@ -0,0 +1,87 @@
+#include "LLGI.LinearAllocator.h"
+
+namespace LLGI
+{
+
+LinearAllocator::LinearAllocator(size_t blockSize) : blockSize_(blockSize) {}
+
+LinearAllocator::~LinearAllocator() { ReleaseBlocks(); }
+
+void LinearAllocator::AddBlock(size_t size)
+{
+	Block block;
+	block.data = new uint8_t[size];
+	block.size = size;
+	blocks_.push_back(block);
+}
+
+void LinearAllocator::ReleaseBlocks()
+{
+	for (auto& block : blocks_)
+	{
+		delete[] block.data;
+	}
+	blocks_.clear();
+}
+
+void* LinearAllocator::Allocate(size_t size, size_t alignment)
+{
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+	if (blocks_.empty())
+	{
+		AddBlock((std::max)(blockSize_, size + alignment));
+		currentBlock_ = 0;
+		offset_ = 0;
+	}
+
+	while (true)
+	{
+		auto& block = blocks_[currentBlock_];
+		auto head = reinterpret_cast<uintptr_t>(block.data);
+		auto aligned = (head + offset_ + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+
+		if (aligned + size <= head + block.size)
+		{
+			offset_ = aligned + size - head;
+			usedSize_ += size;
+			return reinterpret_cast<void*>(aligned);
+		}
+
+		// a next block is larger than the current one so the number of blocks is small
+		if (currentBlock_ + 1 == blocks_.size())
+		{
+			AddBlock((std::max)(block.size * 2, size + alignment));
+		}
+
+		currentBlock_++;
+		offset_ = 0;
+	}
+}
+
+void LinearAllocator::Reset()
+{
+	// blocks are merged so following frames which have the same size fit in a block
+	if (blocks_.size() > 1)
+	{
+		auto capacity = GetCapacity();
+		ReleaseBlocks();
+		AddBlock(capacity);
+	}
+
+	currentBlock_ = 0;
+	offset_ = 0;
+	usedSize_ = 0;
+}
+
+size_t LinearAllocator::GetCapacity() const
+{
+	size_t ret = 0;
+	for (auto& block : blocks_)
+	{
+		ret += block.size;
+	}
+	return ret;
+}
+
+} // namespace LLGI
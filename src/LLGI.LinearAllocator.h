@@ -0,0 +1,78 @@
+#pragma once
+
+#include "LLGI.Base.h"
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace LLGI
+{
+
+/**
+	@brief	a bump allocator for temporary memory which is released at once
+	@note
+	Memory is allocated from blocks by moving an offset and it is not freed until Reset is called.
+	When blocks are added in a frame, Reset merges them into a block, so an allocator stops allocating on heap
+	after a few frames when sizes of frames are steady.
+	Destructors of objects allocated from it are not called. It is not thread safe.
+*/
+class LinearAllocator
+{
+private:
+	struct Block
+	{
+		uint8_t* data = nullptr;
+		size_t size = 0;
+	};
+
+	std::vector<Block> blocks_;
+	size_t currentBlock_ = 0;
+	size_t offset_ = 0;
+	size_t usedSize_ = 0;
+	size_t blockSize_ = 0;
+
+	void AddBlock(size_t size);
+	void ReleaseBlocks();
+
+public:
+	/**
+		@param	blockSize	the size of the first block in bytes
+	*/
+	explicit LinearAllocator(size_t blockSize = 64 * 1024);
+	~LinearAllocator();
+
+	LinearAllocator(const LinearAllocator&) = delete;
+	LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+	/**
+		@brief	allocate memory which is valid until Reset is called
+		@param	alignment	a power of two
+	*/
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	/**
+		@brief	allocate an array of trivial objects which are value initialized
+	*/
+	template <typename T> T* Allocate(size_t count)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "destructors are not called");
+
+		auto ret = static_cast<T*>(Allocate(sizeof(T) * (std::max)(count, static_cast<size_t>(1)), alignof(T)));
+		for (size_t i = 0; i < count; i++)
+		{
+			new (&ret[i]) T();
+		}
+		return ret;
+	}
+
+	//! release all memory which is allocated from this allocator and keep blocks
+	void Reset();
+
+	//! the size which is allocated since Reset is called in bytes
+	size_t GetUsedSize() const { return usedSize_; }
+
+	//! the size of blocks in bytes
+	size_t GetCapacity() const;
+};
+
+} // namespace LLGI
@@ -0,0 +1,528 @@
+#include "LLGI.MeshFile.h"
+#include "LLGI.Graphics.h"
+#include "LLGI.IndexBuffer.h"
+#include "LLGI.PipelineState.h"
+#include "LLGI.VertexBuffer.h"
+#include <float.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace LLGI
+{
+
+static_assert(sizeof(MeshFileHeader) == 64, "MeshFileHeader must be packed");
+static_assert(sizeof(MeshFileVertexStream) == 16, "MeshFileVertexStream must be packed");
+static_assert(sizeof(MeshFileAttribute) == 32, "MeshFileAttribute must be packed");
+static_assert(sizeof(MeshFileSubMesh) == 32, "MeshFileSubMesh must be packed");
+
+namespace
+{
+
+//! values are read from mapped pages without swapping bytes
+bool IsLittleEndian()
+{
+	const uint16_t value = 1;
+	uint8_t firstByte = 0;
+	memcpy(&firstByte, &value, 1);
+	return firstByte == 1;
+}
+
+uint64_t AlignMeshFileOffset(uint64_t offset)
+{
+	return (offset + MeshFileDataAlignment - 1) / MeshFileDataAlignment * MeshFileDataAlignment;
+}
+
+uint64_t GetMeshFileTableSize(int32_t vertexStreamCount, int32_t attributeCount, int32_t subMeshCount)
+{
+	return sizeof(MeshFileHeader) + sizeof(MeshFileVertexStream) * vertexStreamCount + sizeof(MeshFileAttribute) * attributeCount +
+		   sizeof(MeshFileSubMesh) * subMeshCount;
+}
+
+void ResetBounds(float* boundsMin, float* boundsMax)
+{
+	for (int32_t i = 0; i < 3; i++)
+	{
+		boundsMin[i] = FLT_MAX;
+		boundsMax[i] = -FLT_MAX;
+	}
+}
+
+void AddBounds(float* boundsMin, float* boundsMax, const float* position)
+{
+	for (int32_t i = 0; i < 3; i++)
+	{
+		boundsMin[i] = (std::min)(boundsMin[i], position[i]);
+		boundsMax[i] = (std::max)(boundsMax[i], position[i]);
+	}
+}
+
+void FinishBounds(float* boundsMin, float* boundsMax)
+{
+	// an empty box is saved as zero
+	if (boundsMin[0] > boundsMax[0])
+	{
+		for (int32_t i = 0; i < 3; i++)
+		{
+			boundsMin[i] = 0.0f;
+			boundsMax[i] = 0.0f;
+		}
+	}
+}
+
+} // namespace
+
+MeshFile::~MeshFile() { Unmap(); }
+
+bool MeshFile::Map(const char* path)
+{
+#ifdef _WIN32
+	auto file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	file_ = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		return false;
+	}
+
+	mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_ == nullptr)
+	{
+		return false;
+	}
+
+	data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+	if (data_ == nullptr)
+	{
+		return false;
+	}
+
+	size_ = static_cast<uint64_t>(size.QuadPart);
+#else
+	auto fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	// a mapping is kept after the descriptor is closed
+	auto data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+
+	data_ = static_cast<const uint8_t*>(data);
+	size_ = static_cast<uint64_t>(st.st_size);
+#endif
+
+	return true;
+}
+
+void MeshFile::Unmap()
+{
+#ifdef _WIN32
+	if (data_ != nullptr)
+	{
+		UnmapViewOfFile(data_);
+	}
+
+	if (mapping_ != nullptr)
+	{
+		CloseHandle(mapping_);
+		mapping_ = nullptr;
+	}
+
+	if (file_ != nullptr)
+	{
+		CloseHandle(file_);
+		file_ = nullptr;
+	}
+#else
+	if (data_ != nullptr)
+	{
+		munmap(const_cast<uint8_t*>(data_), static_cast<size_t>(size_));
+	}
+#endif
+
+	data_ = nullptr;
+	size_ = 0;
+	header_ = nullptr;
+}
+
+bool MeshFile::Validate()
+{
+	if (!IsLittleEndian() || size_ < sizeof(MeshFileHeader))
+	{
+		return false;
+	}
+
+	auto header = reinterpret_cast<const MeshFileHeader*>(data_);
+
+	if (header->Magic != MeshFileMagic || header->Version != MeshFileVersion)
+	{
+		return false;
+	}
+
+	if (header->VertexCount < 0 || header->IndexCount < 0 || (header->IndexStride != 2 && header->IndexStride != 4) ||
+		header->VertexStreamCount < 0 || header->VertexStreamCount > NumVertexBufferSlot || header->AttributeCount < 0 ||
+		header->AttributeCount > 16 || header->SubMeshCount < 0)
+	{
+		return false;
+	}
+
+	if (GetMeshFileTableSize(header->VertexStreamCount, header->AttributeCount, header->SubMeshCount) > size_)
+	{
+		return false;
+	}
+
+	auto vertexStreams = reinterpret_cast<const MeshFileVertexStream*>(data_ + sizeof(MeshFileHeader));
+	auto attributes = reinterpret_cast<const MeshFileAttribute*>(vertexStreams + header->VertexStreamCount);
+	auto subMeshes = reinterpret_cast<const MeshFileSubMesh*>(attributes + header->AttributeCount);
+
+	for (int32_t i = 0; i < header->VertexStreamCount; i++)
+	{
+		const auto& stream = vertexStreams[i];
+		auto dataSize = static_cast<uint64_t>(stream.Stride) * header->VertexCount;
+		// sizes of buffers are int32_t
+		if (stream.Stride <= 0 || dataSize > INT32_MAX || stream.DataOffset % MeshFileDataAlignment != 0 || stream.DataOffset > size_ ||
+			dataSize > size_ - stream.DataOffset)
+		{
+			return false;
+		}
+	}
+
+	auto indexDataSize = static_cast<uint64_t>(header->IndexStride) * header->IndexCount;
+	if (indexDataSize > INT32_MAX || header->IndexDataOffset % MeshFileDataAlignment != 0 || header->IndexDataOffset > size_ ||
+		indexDataSize > size_ - header->IndexDataOffset)
+	{
+		return false;
+	}
+
+	for (int32_t i = 0; i < header->AttributeCount; i++)
+	{
+		const auto& attribute = attributes[i];
+		if (attribute.Format < 0 || attribute.Format > static_cast<int32_t>(VertexLayoutFormat::R32_UINT) || attribute.Slot < 0 ||
+			attribute.Slot >= header->VertexStreamCount || attribute.Offset < 0 ||
+			attribute.Offset + GetVertexLayoutFormatSize(static_cast<VertexLayoutFormat>(attribute.Format)) >
+				vertexStreams[attribute.Slot].Stride ||
+			memchr(attribute.Name, 0, sizeof(attribute.Name)) == nullptr)
+		{
+			return false;
+		}
+	}
+
+	for (int32_t i = 0; i < header->SubMeshCount; i++)
+	{
+		const auto& subMesh = subMeshes[i];
+		if (subMesh.IndexOffset < 0 || subMesh.IndexCount < 0 || subMesh.IndexOffset > header->IndexCount - subMesh.IndexCount)
+		{
+			return false;
+		}
+	}
+
+	header_ = header;
+	vertexStreams_ = vertexStreams;
+	attributes_ = attributes;
+	subMeshes_ = subMeshes;
+	return true;
+}
+
+void MeshFile::Prefetch(const void* data, uint64_t size) const
+{
+#ifndef _WIN32
+	if (size == 0)
+	{
+		return;
+	}
+
+	// data are aligned with MeshFileDataAlignment but pages may be larger
+	auto pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+	auto begin = reinterpret_cast<uintptr_t>(data) / pageSize * pageSize;
+	auto end = reinterpret_cast<uintptr_t>(data) + static_cast<uintptr_t>(size);
+	posix_madvise(reinterpret_cast<void*>(begin), static_cast<size_t>(end - begin), POSIX_MADV_WILLNEED);
+#endif
+}
+
+bool MeshFile::Initialize(const char* path)
+{
+	Unmap();
+
+	if (!Map(path) || !Validate())
+	{
+		Unmap();
+		return false;
+	}
+
+	return true;
+}
+
+void MeshFile::SetVertexLayouts(PipelineState* pipelineState) const
+{
+	pipelineState->VertexLayoutCount = header_->AttributeCount;
+
+	for (int32_t i = 0; i < header_->AttributeCount; i++)
+	{
+		pipelineState->VertexLayouts[i] = static_cast<VertexLayoutFormat>(attributes_[i].Format);
+		pipelineState->VertexLayoutNames[i] = attributes_[i].Name;
+		pipelineState->VertexLayoutSlots[i] = attributes_[i].Slot;
+		pipelineState->VertexLayoutOffsets[i] = attributes_[i].Offset;
+	}
+
+	for (int32_t i = 0; i < NumVertexBufferSlot; i++)
+	{
+		pipelineState->VertexStrides[i] = i < header_->VertexStreamCount ? vertexStreams_[i].Stride : -1;
+	}
+}
+
+VertexBuffer* MeshFile::CreateVertexBuffer(Graphics* graphics, int32_t stream) const
+{
+	auto size = static_cast<int64_t>(vertexStreams_[stream].Stride) * header_->VertexCount;
+	if (size == 0 || size > INT32_MAX)
+	{
+		return nullptr;
+	}
+
+	auto data = GetVertexData(stream);
+	Prefetch(data, size);
+
+	auto vb = graphics->CreateVertexBuffer(static_cast<int32_t>(size));
+	if (vb == nullptr)
+	{
+		return nullptr;
+	}
+
+	auto dst = vb->Lock();
+	if (dst == nullptr)
+	{
+		SafeRelease(vb);
+		return nullptr;
+	}
+
+	memcpy(dst, data, size);
+	vb->Unlock();
+
+	return vb;
+}
+
+IndexBuffer* MeshFile::CreateIndexBuffer(Graphics* graphics) const
+{
+	auto size = static_cast<int64_t>(header_->IndexStride) * header_->IndexCount;
+	if (size == 0 || size > INT32_MAX)
+	{
+		return nullptr;
+	}
+
+	auto data = GetIndexData();
+	Prefetch(data, size);
+
+	auto ib = graphics->CreateIndexBuffer(header_->IndexStride, header_->IndexCount);
+	if (ib == nullptr)
+	{
+		return nullptr;
+	}
+
+	auto dst = ib->Lock();
+	if (dst == nullptr)
+	{
+		SafeRelease(ib);
+		return nullptr;
+	}
+
+	memcpy(dst, data, size);
+	ib->Unlock();
+
+	return ib;
+}
+
+bool MeshFile::Save(const char* path, const MeshFileDescription& description)
+{
+	const auto& d = description;
+
+	auto streamCount = static_cast<int32_t>(d.VertexStreams.size());
+	auto attributeCount = static_cast<int32_t>(d.Attributes.size());
+
+	if (!IsLittleEndian() || d.VertexCount <= 0 || streamCount == 0 || streamCount > NumVertexBufferSlot || attributeCount > 16 ||
+		(d.IndexStride != 2 && d.IndexStride != 4) || d.IndexCount < 0 || (d.IndexCount > 0 && d.IndexData == nullptr))
+	{
+		return false;
+	}
+
+	for (const auto& stream : d.VertexStreams)
+	{
+		if (stream.Stride <= 0 || stream.Data == nullptr || static_cast<int64_t>(stream.Stride) * d.VertexCount > INT32_MAX)
+		{
+			return false;
+		}
+	}
+
+	if (static_cast<int64_t>(d.IndexStride) * d.IndexCount > INT32_MAX)
+	{
+		return false;
+	}
+
+	for (const auto& attribute : d.Attributes)
+	{
+		if (attribute.Slot < 0 || attribute.Slot >= streamCount || attribute.Offset < 0 ||
+			attribute.Offset + GetVertexLayoutFormatSize(attribute.Format) > d.VertexStreams[attribute.Slot].Stride ||
+			attribute.Name.size() >= sizeof(MeshFileAttribute::Name))
+		{
+			return false;
+		}
+	}
+
+	if (d.PositionAttribute >= attributeCount ||
+		(d.PositionAttribute >= 0 && d.Attributes[d.PositionAttribute].Format != VertexLayoutFormat::R32G32B32_FLOAT))
+	{
+		return false;
+	}
+
+	std::vector<MeshFileSubMesh> subMeshes = d.SubMeshes;
+	if (subMeshes.size() == 0)
+	{
+		MeshFileSubMesh subMesh;
+		subMesh.IndexOffset = 0;
+		subMesh.IndexCount = d.IndexCount;
+		subMeshes.push_back(subMesh);
+	}
+
+	auto subMeshCount = static_cast<int32_t>(subMeshes.size());
+
+	for (const auto& subMesh : subMeshes)
+	{
+		if (subMesh.IndexOffset < 0 || subMesh.IndexCount < 0 || subMesh.IndexOffset > d.IndexCount - subMesh.IndexCount)
+		{
+			return false;
+		}
+	}
+
+	MeshFileHeader header = {};
+	header.Magic = MeshFileMagic;
+	header.Version = MeshFileVersion;
+	header.VertexCount = d.VertexCount;
+	header.IndexCount = d.IndexCount;
+	header.IndexStride = d.IndexStride;
+	header.VertexStreamCount = streamCount;
+	header.AttributeCount = attributeCount;
+	header.SubMeshCount = subMeshCount;
+
+	// bounding boxes of vertices which are referred by each submesh
+	ResetBounds(header.BoundsMin, header.BoundsMax);
+
+	for (auto& subMesh : subMeshes)
+	{
+		ResetBounds(subMesh.BoundsMin, subMesh.BoundsMax);
+
+		if (d.PositionAttribute >= 0)
+		{
+			const auto& attribute = d.Attributes[d.PositionAttribute];
+			const auto& stream = d.VertexStreams[attribute.Slot];
+
+			for (int32_t i = subMesh.IndexOffset; i < subMesh.IndexOffset + subMesh.IndexCount; i++)
+			{
+				auto index =
+					d.IndexStride == 2 ? static_cast<const uint16_t*>(d.IndexData)[i] : static_cast<const uint32_t*>(d.IndexData)[i];
+				if (index >= static_cast<uint32_t>(d.VertexCount))
+				{
+					return false;
+				}
+
+				float position[3];
+				auto vertex = static_cast<const uint8_t*>(stream.Data) + static_cast<size_t>(index) * stream.Stride;
+				memcpy(position, vertex + attribute.Offset, sizeof(position));
+				AddBounds(subMesh.BoundsMin, subMesh.BoundsMax, position);
+				AddBounds(header.BoundsMin, header.BoundsMax, position);
+			}
+		}
+
+		FinishBounds(subMesh.BoundsMin, subMesh.BoundsMax);
+	}
+
+	FinishBounds(header.BoundsMin, header.BoundsMax);
+
+	std::vector<MeshFileVertexStream> streams(streamCount);
+	auto offset = AlignMeshFileOffset(GetMeshFileTableSize(streamCount, attributeCount, subMeshCount));
+
+	for (int32_t i = 0; i < streamCount; i++)
+	{
+		streams[i].Stride = d.VertexStreams[i].Stride;
+		streams[i].Reserved = 0;
+		streams[i].DataOffset = offset;
+		offset = AlignMeshFileOffset(offset + static_cast<uint64_t>(streams[i].Stride) * d.VertexCount);
+	}
+
+	header.IndexDataOffset = offset;
+
+	std::vector<MeshFileAttribute> attributes(attributeCount);
+	for (int32_t i = 0; i < attributeCount; i++)
+	{
+		attributes[i] = {};
+		attributes[i].Format = static_cast<int32_t>(d.Attributes[i].Format);
+		attributes[i].Slot = d.Attributes[i].Slot;
+		attributes[i].Offset = d.Attributes[i].Offset;
+		memcpy(attributes[i].Name, d.Attributes[i].Name.c_str(), d.Attributes[i].Name.size());
+	}
+
+#ifdef _WIN32
+	FILE* fp = nullptr;
+	fopen_s(&fp, path, "wb");
+#else
+	FILE* fp = fopen(path, "wb");
+#endif
+
+	if (fp == nullptr)
+	{
+		return false;
+	}
+
+	uint64_t written = 0;
+	auto write = [&](const void* data, uint64_t size) {
+		if (size > 0 && fwrite(data, static_cast<size_t>(size), 1, fp) != 1)
+		{
+			return false;
+		}
+		written += size;
+		return true;
+	};
+
+	auto pad = [&]() {
+		static const uint8_t zeros[MeshFileDataAlignment] = {};
+		return write(zeros, AlignMeshFileOffset(written) - written);
+	};
+
+	auto isSucceeded = write(&header, sizeof(header)) && write(streams.data(), sizeof(MeshFileVertexStream) * streams.size()) &&
+					   write(attributes.data(), sizeof(MeshFileAttribute) * attributes.size()) &&
+					   write(subMeshes.data(), sizeof(MeshFileSubMesh) * subMeshes.size());
+
+	for (int32_t i = 0; i < streamCount && isSucceeded; i++)
+	{
+		isSucceeded = pad() && write(d.VertexStreams[i].Data, static_cast<uint64_t>(streams[i].Stride) * d.VertexCount);
+	}
+
+	isSucceeded = isSucceeded && pad() && write(d.IndexData, static_cast<uint64_t>(d.IndexStride) * d.IndexCount);
+
+	fclose(fp);
+	return isSucceeded;
+}
+
+} // namespace LLGI
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "LLGI.Base.h"
+
+namespace LLGI
+{
+
+/**
+	@brief	a header of a binary mesh file
+	@note
+	A file consists of a header, vertex streams, attributes, submeshes and data. All values are little endian,
+	so files can't be saved or loaded on big endian hosts. Sizes of vertex streams and indices must fit in int32_t.
+	Data of each vertex stream and indices start at a multiple of MeshFileDataAlignment, so they can be read from mapped pages directly.
+*/
+struct MeshFileHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	int32_t VertexCount;
+	int32_t IndexCount;
+	int32_t IndexStride;
+	int32_t VertexStreamCount;
+	int32_t AttributeCount;
+	int32_t SubMeshCount;
+	float BoundsMin[3];
+	float BoundsMax[3];
+	uint64_t IndexDataOffset;
+};
+
+//! vertices which are bound to a slot of vertex buffers
+struct MeshFileVertexStream
+{
+	int32_t Stride;
+	int32_t Reserved;
+	uint64_t DataOffset;
+};
+
+//! an attribute of vertices which corresponds to a vertex layout of PipelineState
+struct MeshFileAttribute
+{
+	int32_t Format;
+	int32_t Slot;
+	int32_t Offset;
+	char Name[20];
+};
+
+//! a range of indices which is drawn with a material
+struct MeshFileSubMesh
+{
+	int32_t IndexOffset;
+	int32_t IndexCount;
+	float BoundsMin[3];
+	float BoundsMax[3];
+};
+
+static const uint32_t MeshFileMagic = 0x4D474C4C; // LLGM
+static const uint32_t MeshFileVersion = 1;
+static const int32_t MeshFileDataAlignment = 4096;
+
+/**
+	@brief	a description of a mesh to save with MeshFile::Save
+*/
+struct MeshFileDescription
+{
+	struct VertexStream
+	{
+		int32_t Stride = 0;
+
+		//! vertices whose size is Stride * VertexCount
+		const void* Data = nullptr;
+	};
+
+	struct Attribute
+	{
+		VertexLayoutFormat Format = VertexLayoutFormat::R32G32B32_FLOAT;
+		int32_t Slot = 0;
+		int32_t Offset = 0;
+		std::string Name;
+	};
+
+	int32_t VertexCount = 0;
+	std::vector<VertexStream> VertexStreams;
+	std::vector<Attribute> Attributes;
+
+	//! an index of a R32G32B32_FLOAT attribute to calculate bounding boxes. Bounding boxes are empty if it is negative.
+	int32_t PositionAttribute = 0;
+
+	const void* IndexData = nullptr;
+	int32_t IndexCount = 0;
+	int32_t IndexStride = 4;
+
+	//! ranges of indices. Bounding boxes are calculated when it is saved. A whole mesh is a submesh if it is empty.
+	std::vector<MeshFileSubMesh> SubMeshes;
+};
+
+/**
+	@brief	a binary mesh file which is mapped into memory
+	@note
+	Vertices and indices are copied from mapped pages into buffers without intermediate copies on heap.
+	A file is unmapped when this instance is released.
+*/
+class MeshFile : public ReferenceObject
+{
+private:
+	const uint8_t* data_ = nullptr;
+	uint64_t size_ = 0;
+
+#ifdef _WIN32
+	void* file_ = nullptr;
+	void* mapping_ = nullptr;
+#endif
+
+	const MeshFileHeader* header_ = nullptr;
+	const MeshFileVertexStream* vertexStreams_ = nullptr;
+	const MeshFileAttribute* attributes_ = nullptr;
+	const MeshFileSubMesh* subMeshes_ = nullptr;
+
+	bool Map(const char* path);
+	void Unmap();
+	bool Validate();
+
+	//! tell the os that a range will be read soon
+	void Prefetch(const void* data, uint64_t size) const;
+
+public:
+	MeshFile() = default;
+	virtual ~MeshFile();
+
+	/**
+		@brief	map a file
+		@return	false if the file is not found or it is broken or its version is different or a host is big endian
+	*/
+	bool Initialize(const char* path);
+
+	int32_t GetVertexCount() const { return header_->VertexCount; }
+
+	int32_t GetIndexCount() const { return header_->IndexCount; }
+
+	int32_t GetIndexStride() const { return header_->IndexStride; }
+
+	int32_t GetVertexStreamCount() const { return header_->VertexStreamCount; }
+
+	int32_t GetVertexStride(int32_t stream) const { return vertexStreams_[stream].Stride; }
+
+	/**
+		@brief	get mapped vertices of a stream
+		@note
+		It is valid until this instance is released.
+	*/
+	const void* GetVertexData(int32_t stream) const { return data_ + vertexStreams_[stream].DataOffset; }
+
+	const void* GetIndexData() const { return data_ + header_->IndexDataOffset; }
+
+	int32_t GetAttributeCount() const { return header_->AttributeCount; }
+
+	const MeshFileAttribute& GetAttribute(int32_t index) const { return attributes_[index]; }
+
+	int32_t GetSubMeshCount() const { return header_->SubMeshCount; }
+
+	const MeshFileSubMesh& GetSubMesh(int32_t index) const { return subMeshes_[index]; }
+
+	Vec3F GetBoundsMin() const { return Vec3F(header_->BoundsMin[0], header_->BoundsMin[1], header_->BoundsMin[2]); }
+
+	Vec3F GetBoundsMax() const { return Vec3F(header_->BoundsMax[0], header_->BoundsMax[1], header_->BoundsMax[2]); }
+
+	/**
+		@brief	set vertex layouts, slots, offsets and strides of attributes into a pipeline state
+	*/
+	void SetVertexLayouts(PipelineState* pipelineState) const;
+
+	/**
+		@brief	create a vertex buffer and copy vertices of a stream from mapped pages into it
+	*/
+	VertexBuffer* CreateVertexBuffer(Graphics* graphics, int32_t stream) const;
+
+	/**
+		@brief	create an index buffer and copy indices from mapped pages into it
+	*/
+	IndexBuffer* CreateIndexBuffer(Graphics* graphics) const;
+
+	/**
+		@brief	save a mesh as a binary mesh file
+		@return	false if the description is invalid or the file can't be written
+	*/
+	static bool Save(const char* path, const MeshFileDescription& description);
+};
+
+} // namespace LLGI
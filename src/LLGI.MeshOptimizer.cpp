@@ -0,0 +1,559 @@
+#include "LLGI.MeshOptimizer.h"
+#include <cmath>
+#include <thread>
+
+namespace LLGI
+{
+
+namespace
+{
+
+//! the size of a LRU cache which Forsyth's algorithm assumes
+const int32_t ForsythCacheSize = 32;
+
+const int32_t ForsythMaxValence = 32;
+
+struct ForsythScoreTable
+{
+	float cache[ForsythCacheSize];
+	float valence[ForsythMaxValence + 1];
+
+	ForsythScoreTable()
+	{
+		for (int32_t i = 0; i < ForsythCacheSize; i++)
+		{
+			// vertices of the last triangle get a fixed score not to prefer a strip to a fan
+			cache[i] = i < 3 ? 0.75f : powf(1.0f - static_cast<float>(i - 3) / (ForsythCacheSize - 3), 1.5f);
+		}
+
+		// boost vertices which have few remaining triangles to finish them
+		valence[0] = 0.0f;
+		for (int32_t i = 1; i <= ForsythMaxValence; i++)
+		{
+			valence[i] = 2.0f * powf(static_cast<float>(i), -0.5f);
+		}
+	}
+
+	float GetScore(int32_t cachePosition, int32_t remaining) const
+	{
+		if (remaining == 0)
+		{
+			return -1.0f;
+		}
+
+		auto score = cachePosition >= 0 ? cache[cachePosition] : 0.0f;
+		return score + valence[(std::min)(remaining, ForsythMaxValence)];
+	}
+};
+
+/**
+	@brief	a FIFO cache whose entries are expired with timestamps
+*/
+class FIFOCacheSimulator
+{
+private:
+	std::vector<uint32_t> timestamps_;
+	uint32_t time_ = 0;
+	uint32_t cacheSize_ = 0;
+
+public:
+	FIFOCacheSimulator(int32_t vertexCount, int32_t cacheSize) : timestamps_(vertexCount, 0), cacheSize_(cacheSize) { Reset(); }
+
+	void Reset() { time_ += cacheSize_ + 1; }
+
+	//! returns the number of misses
+	int32_t Access(const uint32_t* triangle)
+	{
+		int32_t misses = 0;
+		for (int32_t i = 0; i < 3; i++)
+		{
+			auto v = triangle[i];
+			if (time_ - timestamps_[v] > cacheSize_)
+			{
+				timestamps_[v] = time_++;
+				misses++;
+			}
+		}
+		return misses;
+	}
+};
+
+void ReadPosition(const void* vertices, int32_t vertexStride, int32_t positionOffset, uint32_t index, float* position)
+{
+	memcpy(position, static_cast<const uint8_t*>(vertices) + static_cast<size_t>(index) * vertexStride + positionOffset, sizeof(float) * 3);
+}
+
+} // namespace
+
+MeshOptimizationStatistics AnalyzeVertexCache(const uint32_t* indices, int32_t indexCount, int32_t vertexCount, int32_t cacheSize)
+{
+	MeshOptimizationStatistics ret;
+
+	auto triangleCount = indexCount / 3;
+	if (triangleCount == 0 || vertexCount <= 0 || cacheSize <= 0)
+	{
+		return ret;
+	}
+
+	FIFOCacheSimulator cache(vertexCount, cacheSize);
+	std::vector<bool> isReferred(vertexCount, false);
+	int32_t misses = 0;
+	int32_t referredCount = 0;
+
+	for (int32_t t = 0; t < triangleCount; t++)
+	{
+		misses += cache.Access(indices + t * 3);
+
+		for (int32_t i = 0; i < 3; i++)
+		{
+			if (!isReferred[indices[t * 3 + i]])
+			{
+				isReferred[indices[t * 3 + i]] = true;
+				referredCount++;
+			}
+		}
+	}
+
+	ret.ACMR = static_cast<float>(misses) / triangleCount;
+	ret.ATVR = static_cast<float>(misses) / referredCount;
+	return ret;
+}
+
+void OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, int32_t indexCount, int32_t vertexCount)
+{
+	static const ForsythScoreTable scoreTable;
+
+	auto triangleCount = indexCount / 3;
+	std::vector<uint32_t> source(indices, indices + triangleCount * 3);
+
+	// triangles which refer each vertex. Emitted triangles are moved behind remaining ones.
+	std::vector<int32_t> remaining(vertexCount, 0);
+	std::vector<int32_t> offsets(vertexCount + 1, 0);
+	std::vector<int32_t> adjacency(triangleCount * 3);
+
+	for (auto v : source)
+	{
+		remaining[v]++;
+	}
+
+	for (int32_t v = 0; v < vertexCount; v++)
+	{
+		offsets[v + 1] = offsets[v] + remaining[v];
+	}
+
+	{
+		std::vector<int32_t> filled(offsets.begin(), offsets.end() - 1);
+		for (int32_t i = 0; i < triangleCount * 3; i++)
+		{
+			adjacency[filled[source[i]]++] = i / 3;
+		}
+	}
+
+	std::vector<int32_t> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (int32_t v = 0; v < vertexCount; v++)
+	{
+		vertexScores[v] = scoreTable.GetScore(-1, remaining[v]);
+	}
+
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<bool> isEmitted(triangleCount, false);
+	int32_t bestTriangle = -1;
+	float bestScore = -1.0f;
+
+	for (int32_t t = 0; t < triangleCount; t++)
+	{
+		triangleScores[t] = vertexScores[source[t * 3 + 0]] + vertexScores[source[t * 3 + 1]] + vertexScores[source[t * 3 + 2]];
+		if (triangleScores[t] > bestScore)
+		{
+			bestScore = triangleScores[t];
+			bestTriangle = t;
+		}
+	}
+
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> nextCache;
+	cache.reserve(ForsythCacheSize + 3);
+	nextCache.reserve(ForsythCacheSize + 3);
+
+	int32_t cursor = 0;
+
+	for (int32_t emitted = 0; emitted < triangleCount; emitted++)
+	{
+		if (bestTriangle < 0)
+		{
+			// no triangle is adjacent to the cache, so start from a next triangle in the original order
+			while (isEmitted[cursor])
+			{
+				cursor++;
+			}
+			bestTriangle = cursor;
+		}
+
+		auto triangle = &source[bestTriangle * 3];
+		memcpy(destination + emitted * 3, triangle, sizeof(uint32_t) * 3);
+		isEmitted[bestTriangle] = true;
+
+		nextCache.clear();
+		for (int32_t i = 0; i < 3; i++)
+		{
+			auto v = triangle[i];
+
+			auto begin = adjacency.begin() + offsets[v];
+			auto it = std::find(begin, begin + remaining[v], bestTriangle);
+			std::swap(*it, *(begin + remaining[v] - 1));
+			remaining[v]--;
+
+			if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end())
+			{
+				nextCache.push_back(v);
+			}
+		}
+
+		for (auto v : cache)
+		{
+			if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end())
+			{
+				nextCache.push_back(v);
+			}
+		}
+
+		// update scores of vertices in the cache including evicted ones and triangles which refer them
+		bestTriangle = -1;
+		bestScore = -1.0f;
+
+		for (int32_t i = 0; i < static_cast<int32_t>(nextCache.size()); i++)
+		{
+			auto v = nextCache[i];
+			cachePositions[v] = i < ForsythCacheSize ? i : -1;
+			vertexScores[v] = scoreTable.GetScore(cachePositions[v], remaining[v]);
+		}
+
+		for (auto v : nextCache)
+		{
+			for (int32_t i = 0; i < remaining[v]; i++)
+			{
+				auto t = adjacency[offsets[v] + i];
+				triangleScores[t] = vertexScores[source[t * 3 + 0]] + vertexScores[source[t * 3 + 1]] + vertexScores[source[t * 3 + 2]];
+
+				if (triangleScores[t] > bestScore)
+				{
+					bestScore = triangleScores[t];
+					bestTriangle = t;
+				}
+			}
+		}
+
+		if (static_cast<int32_t>(nextCache.size()) > ForsythCacheSize)
+		{
+			nextCache.resize(ForsythCacheSize);
+		}
+		std::swap(cache, nextCache);
+	}
+}
+
+void OptimizeOverdraw(uint32_t* destination,
+					  const uint32_t* indices,
+					  int32_t indexCount,
+					  const void* vertices,
+					  int32_t vertexCount,
+					  int32_t vertexStride,
+					  int32_t positionOffset,
+					  int32_t cacheSize,
+					  float threshold)
+{
+	auto triangleCount = indexCount / 3;
+	std::vector<uint32_t> source(indices, indices + triangleCount * 3);
+
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	FIFOCacheSimulator cache(vertexCount, (std::max)(cacheSize, 3));
+
+	// a cluster can be moved without additional misses where all vertices of a triangle miss
+	std::vector<int32_t> hardBoundaries;
+	for (int32_t t = 0; t < triangleCount; t++)
+	{
+		if (cache.Access(&source[t * 3]) == 3 || t == 0)
+		{
+			hardBoundaries.push_back(t);
+		}
+	}
+	hardBoundaries.push_back(triangleCount);
+
+	// split clusters more while ACMR of each cluster is under threshold
+	std::vector<int32_t> clusters;
+	for (size_t i = 0; i + 1 < hardBoundaries.size(); i++)
+	{
+		auto begin = hardBoundaries[i];
+		auto end = hardBoundaries[i + 1];
+
+		cache.Reset();
+		int32_t misses = 0;
+		for (int32_t t = begin; t < end; t++)
+		{
+			misses += cache.Access(&source[t * 3]);
+		}
+		auto limit = threshold * misses / (end - begin);
+
+		clusters.push_back(begin);
+		cache.Reset();
+		misses = 0;
+		auto clusterBegin = begin;
+
+		for (int32_t t = begin; t < end - 1; t++)
+		{
+			misses += cache.Access(&source[t * 3]);
+
+			if (misses <= limit * (t + 1 - clusterBegin))
+			{
+				clusterBegin = t + 1;
+				clusters.push_back(clusterBegin);
+				cache.Reset();
+				misses = 0;
+			}
+		}
+	}
+	clusters.push_back(triangleCount);
+
+	auto clusterCount = static_cast<int32_t>(clusters.size()) - 1;
+
+	float meshCenter[3] = {0.0f, 0.0f, 0.0f};
+	float meshArea = 0.0f;
+
+	std::vector<float> clusterCenters(clusterCount * 3, 0.0f);
+	std::vector<float> clusterNormals(clusterCount * 3, 0.0f);
+
+	for (int32_t c = 0; c < clusterCount; c++)
+	{
+		float area = 0.0f;
+
+		for (int32_t t = clusters[c]; t < clusters[c + 1]; t++)
+		{
+			float p[3][3];
+			for (int32_t i = 0; i < 3; i++)
+			{
+				ReadPosition(vertices, vertexStride, positionOffset, source[t * 3 + i], p[i]);
+			}
+
+			float e1[3] = {p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2]};
+			float e2[3] = {p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2]};
+			float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+			auto triangleArea = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+			for (int32_t k = 0; k < 3; k++)
+			{
+				clusterCenters[c * 3 + k] += (p[0][k] + p[1][k] + p[2][k]) / 3.0f * triangleArea;
+				clusterNormals[c * 3 + k] += n[k];
+			}
+			area += triangleArea;
+		}
+
+		for (int32_t k = 0; k < 3; k++)
+		{
+			meshCenter[k] += clusterCenters[c * 3 + k];
+			clusterCenters[c * 3 + k] /= area > 0.0f ? area : 1.0f;
+		}
+		meshArea += area;
+	}
+
+	for (int32_t k = 0; k < 3; k++)
+	{
+		meshCenter[k] /= meshArea > 0.0f ? meshArea : 1.0f;
+	}
+
+	std::vector<float> sortKeys(clusterCount);
+	std::vector<int32_t> order(clusterCount);
+
+	for (int32_t c = 0; c < clusterCount; c++)
+	{
+		auto n = &clusterNormals[c * 3];
+		auto length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		float key = 0.0f;
+
+		for (int32_t k = 0; k < 3; k++)
+		{
+			key += (clusterCenters[c * 3 + k] - meshCenter[k]) * n[k];
+		}
+
+		sortKeys[c] = length > 0.0f ? key / length : 0.0f;
+		order[c] = c;
+	}
+
+	std::stable_sort(order.begin(), order.end(), [&sortKeys](int32_t a, int32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+	auto dst = destination;
+	for (auto c : order)
+	{
+		auto count = (clusters[c + 1] - clusters[c]) * 3;
+		memcpy(dst, &source[clusters[c] * 3], sizeof(uint32_t) * count);
+		dst += count;
+	}
+}
+
+int32_t OptimizeVertexFetch(
+	void* destination, uint32_t* indices, int32_t indexCount, const void* vertices, int32_t vertexCount, int32_t vertexStride)
+{
+	const uint32_t unused = 0xFFFFFFFF;
+	std::vector<uint32_t> remap(vertexCount, unused);
+	uint32_t count = 0;
+
+	auto src = static_cast<const uint8_t*>(vertices);
+	auto dst = static_cast<uint8_t*>(destination);
+
+	for (int32_t i = 0; i < indexCount; i++)
+	{
+		auto v = indices[i];
+		if (remap[v] == unused)
+		{
+			remap[v] = count;
+			memcpy(dst + static_cast<size_t>(count) * vertexStride, src + static_cast<size_t>(v) * vertexStride, vertexStride);
+			count++;
+		}
+
+		indices[i] = remap[v];
+	}
+
+	return static_cast<int32_t>(count);
+}
+
+int32_t GetIndexStride(int32_t vertexCount) { return vertexCount <= 65536 ? 2 : 4; }
+
+void PackIndices(void* destination, const uint32_t* indices, int32_t indexCount, int32_t stride)
+{
+	if (stride == 4)
+	{
+		memcpy(destination, indices, sizeof(uint32_t) * indexCount);
+		return;
+	}
+
+	auto dst = static_cast<uint16_t*>(destination);
+	for (int32_t i = 0; i < indexCount; i++)
+	{
+		dst[i] = static_cast<uint16_t>(indices[i]);
+	}
+}
+
+bool OptimizeMesh(MeshOptimizerMesh& mesh, const MeshOptimizationParameter& parameter)
+{
+	if (mesh.VertexStride <= 0 || mesh.Vertices.size() % mesh.VertexStride != 0 || mesh.Indices.size() % 3 != 0)
+	{
+		return false;
+	}
+
+	if (mesh.PositionOffset >= 0 && mesh.PositionOffset + static_cast<int32_t>(sizeof(float) * 3) > mesh.VertexStride)
+	{
+		return false;
+	}
+
+	auto vertexCount = static_cast<int32_t>(mesh.Vertices.size() / mesh.VertexStride);
+	auto indexCount = static_cast<int32_t>(mesh.Indices.size());
+
+	for (auto index : mesh.Indices)
+	{
+		if (index >= static_cast<uint32_t>(vertexCount))
+		{
+			return false;
+		}
+	}
+
+	auto indices = mesh.Indices.data();
+
+	mesh.Before = AnalyzeVertexCache(indices, indexCount, vertexCount, parameter.CacheSize);
+
+	if (parameter.IsVertexCacheOptimized)
+	{
+		OptimizeVertexCache(indices, indices, indexCount, vertexCount);
+	}
+
+	if (parameter.IsOverdrawOptimized && mesh.PositionOffset >= 0)
+	{
+		OptimizeOverdraw(indices,
+						 indices,
+						 indexCount,
+						 mesh.Vertices.data(),
+						 vertexCount,
+						 mesh.VertexStride,
+						 mesh.PositionOffset,
+						 parameter.CacheSize,
+						 parameter.OverdrawThreshold);
+	}
+
+	if (parameter.IsVertexFetchOptimized)
+	{
+		std::vector<uint8_t> vertices(mesh.Vertices.size());
+		vertexCount = OptimizeVertexFetch(vertices.data(), indices, indexCount, mesh.Vertices.data(), vertexCount, mesh.VertexStride);
+		vertices.resize(static_cast<size_t>(vertexCount) * mesh.VertexStride);
+		mesh.Vertices = std::move(vertices);
+	}
+
+	mesh.After = AnalyzeVertexCache(indices, indexCount, vertexCount, parameter.CacheSize);
+
+	mesh.IndexStride = GetIndexStride(vertexCount);
+	mesh.IndexData.resize(static_cast<size_t>(indexCount) * mesh.IndexStride);
+	PackIndices(mesh.IndexData.data(), indices, indexCount, mesh.IndexStride);
+
+	return true;
+}
+
+bool OptimizeMeshes(MeshOptimizerMesh* meshes, int32_t count, const MeshOptimizationParameter& parameter, int32_t threadCount)
+{
+	if (count <= 0)
+	{
+		return true;
+	}
+
+	if (threadCount <= 0)
+	{
+		threadCount = (std::max)(static_cast<int32_t>(std::thread::hardware_concurrency()), 1);
+	}
+	threadCount = (std::min)(threadCount, count);
+
+	std::vector<int32_t> order(count);
+	for (int32_t i = 0; i < count; i++)
+	{
+		order[i] = i;
+	}
+
+	std::stable_sort(order.begin(), order.end(), [meshes](int32_t a, int32_t b) {
+		return meshes[a].Indices.size() > meshes[b].Indices.size();
+	});
+
+	std::atomic<int32_t> next(0);
+	std::atomic<bool> isSucceeded(true);
+
+	auto work = [&]() {
+		while (true)
+		{
+			auto i = next.fetch_add(1);
+			if (i >= count)
+			{
+				break;
+			}
+
+			if (!OptimizeMesh(meshes[order[i]], parameter))
+			{
+				isSucceeded = false;
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int32_t i = 1; i < threadCount; i++)
+	{
+		threads.emplace_back(work);
+	}
+
+	work();
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	return isSucceeded;
+}
+
+} // namespace LLGI
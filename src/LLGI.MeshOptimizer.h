@@ -0,0 +1,129 @@
+#pragma once
+
+#include "LLGI.Base.h"
+
+namespace LLGI
+{
+
+/**
+	@brief	statistics of a triangle list on a simulated FIFO post-transform cache
+*/
+struct MeshOptimizationStatistics
+{
+	//! average cache miss ratio. The number of transformed vertices per triangle. 0.5 is ideal and 3 is the worst.
+	float ACMR = 0.0f;
+
+	//! average transform to vertex ratio. The number of transformed vertices per referred vertex. 1 is ideal.
+	float ATVR = 0.0f;
+};
+
+struct MeshOptimizationParameter
+{
+	//! the size of a FIFO cache which is simulated to split clusters and to analyze
+	int32_t CacheSize = 16;
+
+	//! how much ACMR is allowed to increase to split clusters for overdraw optimization
+	float OverdrawThreshold = 1.05f;
+
+	bool IsVertexCacheOptimized = true;
+	bool IsOverdrawOptimized = true;
+	bool IsVertexFetchOptimized = true;
+};
+
+/**
+	@brief	a mesh which is optimized with OptimizeMesh
+*/
+struct MeshOptimizerMesh
+{
+	//! vertices which are packed with VertexStride
+	std::vector<uint8_t> Vertices;
+	int32_t VertexStride = 0;
+
+	//! an offset of a position(float3) in a vertex. Overdraw is not optimized if it is negative.
+	int32_t PositionOffset = 0;
+
+	//! indices of a triangle list
+	std::vector<uint32_t> Indices;
+
+	//! the stride of IndexData(2 or 4) which is selected after optimization
+	int32_t IndexStride = 4;
+
+	//! indices which are packed with IndexStride to copy into IndexBuffer
+	std::vector<uint8_t> IndexData;
+
+	MeshOptimizationStatistics Before;
+	MeshOptimizationStatistics After;
+};
+
+/**
+	@brief	simulate a FIFO post-transform cache
+	@param	vertexCount	the number of vertices which indices refer
+*/
+MeshOptimizationStatistics AnalyzeVertexCache(const uint32_t* indices, int32_t indexCount, int32_t vertexCount, int32_t cacheSize = 16);
+
+/**
+	@brief	reorder triangles to reuse transformed vertices
+	@param	destination	reordered indices. It may be the same as indices.
+	@note
+	It is Tom Forsyth's linear-speed vertex cache optimization and works well regardless of the cache size of gpus.
+*/
+void OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, int32_t indexCount, int32_t vertexCount);
+
+/**
+	@brief	reorder clusters of triangles to draw outer triangles first
+	@param	destination	reordered indices. It may be the same as indices.
+	@param	positionOffset	an offset of a position(float3) in a vertex
+	@param	threshold	how much ACMR is allowed to increase by splitting clusters
+	@note
+	Call it after OptimizeVertexCache. Clusters are split where the cache is flushed, so ACMR is kept under threshold.
+	Clusters which face outside from the center of the mesh are drawn first, so they occlude inner triangles by early depth tests.
+*/
+void OptimizeOverdraw(uint32_t* destination,
+					  const uint32_t* indices,
+					  int32_t indexCount,
+					  const void* vertices,
+					  int32_t vertexCount,
+					  int32_t vertexStride,
+					  int32_t positionOffset,
+					  int32_t cacheSize = 16,
+					  float threshold = 1.05f);
+
+/**
+	@brief	reorder vertices in order of use to read vertex memory sequentially
+	@param	destination	reordered vertices. It must not overlap vertices.
+	@param	indices	indices which are rewritten to refer reordered vertices
+	@return	the number of reordered vertices. Vertices which are not referred are removed.
+*/
+int32_t OptimizeVertexFetch(
+	void* destination, uint32_t* indices, int32_t indexCount, const void* vertices, int32_t vertexCount, int32_t vertexStride);
+
+/**
+	@brief	get the smallest stride of indices(2 or 4) which can refer all vertices
+*/
+int32_t GetIndexStride(int32_t vertexCount);
+
+/**
+	@brief	pack indices with a stride to copy into IndexBuffer
+	@param	stride	2 or 4
+*/
+void PackIndices(void* destination, const uint32_t* indices, int32_t indexCount, int32_t stride);
+
+/**
+	@brief	optimize a mesh for post-transform cache, overdraw and vertex fetch and select the stride of indices
+	@return	false if the mesh is invalid. It is not changed.
+*/
+bool OptimizeMesh(MeshOptimizerMesh& mesh, const MeshOptimizationParameter& parameter = MeshOptimizationParameter());
+
+/**
+	@brief	optimize meshes in parallel
+	@param	threadCount	the number of threads. The number of cores is used if it is 0 or less.
+	@return	false if some meshes are invalid
+	@note
+	Large meshes are processed first to balance loads between threads.
+*/
+bool OptimizeMeshes(MeshOptimizerMesh* meshes,
+					int32_t count,
+					const MeshOptimizationParameter& parameter = MeshOptimizationParameter(),
+					int32_t threadCount = 0);
+
+} // namespace LLGI
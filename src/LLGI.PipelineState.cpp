@@ -5,15 +5,97 @@
 namespace LLGI
 {
 
+int32_t GetVertexLayoutFormatSize(VertexLayoutFormat format)
+{
+	switch (format)
+	{
+	case VertexLayoutFormat::R32G32B32_FLOAT:
+		return sizeof(float) * 3;
+	case VertexLayoutFormat::R32G32B32A32_FLOAT:
+		return sizeof(float) * 4;
+	case VertexLayoutFormat::R8G8B8A8_UNORM:
+	case VertexLayoutFormat::R8G8B8A8_UINT:
+		return 4;
+	case VertexLayoutFormat::R32G32_FLOAT:
+		return sizeof(float) * 2;
+	case VertexLayoutFormat::R16G16_FLOAT:
+	case VertexLayoutFormat::R16G16_SNORM:
+	case VertexLayoutFormat::R16G16_UNORM:
+	case VertexLayoutFormat::R8G8B8A8_SNORM:
+	case VertexLayoutFormat::R10G10B10A2_UNORM:
+	case VertexLayoutFormat::R32_UINT:
+		return 4;
+	case VertexLayoutFormat::R16G16B16A16_FLOAT:
+	case VertexLayoutFormat::R16G16B16A16_SNORM:
+	case VertexLayoutFormat::R16G16B16A16_UNORM:
+	case VertexLayoutFormat::R16G16B16A16_UINT:
+		return 8;
+	}
+
+	return 0;
+}
+
+PipelineState::PipelineState()
+{
+	VertexLayoutOffsets.fill(-1);
+	VertexStrides.fill(-1);
+}
+
 void PipelineState::SetShader(ShaderStageType stage, Shader* shader) {}
 
 void PipelineState::SetRenderPassPipelineState(RenderPassPipelineState* renderPassPipelineState)
 {
 
 	SafeAddRef(renderPassPipelineState);
-	renderPassPipelineState_ = CreateSharedPtr(renderPassPipelineState);
+	renderPassPipelineState_ = CreateRef(renderPassPipelineState);
 }
 
 void PipelineState::Compile() {}
 
+int32_t PipelineState::GetVertexLayoutOffset(int32_t index) const
+{
+	if (VertexLayoutOffsets[index] >= 0)
+	{
+		return VertexLayoutOffsets[index];
+	}
+
+	int32_t offset = 0;
+	for (int i = 0; i < index; i++)
+	{
+		if (VertexLayoutSlots[i] == VertexLayoutSlots[index])
+		{
+			offset = (VertexLayoutOffsets[i] >= 0 ? VertexLayoutOffsets[i] : offset) + GetVertexLayoutFormatSize(VertexLayouts[i]);
+		}
+	}
+	return offset;
+}
+
+int32_t PipelineState::GetVertexStride(int32_t slot) const
+{
+	if (VertexStrides[slot] >= 0)
+	{
+		return VertexStrides[slot];
+	}
+
+	int32_t stride = 0;
+	for (int i = 0; i < VertexLayoutCount; i++)
+	{
+		if (VertexLayoutSlots[i] == slot)
+		{
+			stride = (std::max)(stride, GetVertexLayoutOffset(i) + GetVertexLayoutFormatSize(VertexLayouts[i]));
+		}
+	}
+	return stride;
+}
+
+int32_t PipelineState::GetPushConstantOffset(ShaderStageType stage) const
+{
+	int32_t offset = 0;
+	for (int i = 0; i < static_cast<int>(stage); i++)
+	{
+		offset += PushConstantSizes[i];
+	}
+	return offset;
+}
+
 } // namespace LLGI
\ No newline at end of file
@@ -6,13 +6,16 @@
 namespace LLGI
 {
 
+//! the size of an attribute in bytes
+int32_t GetVertexLayoutFormatSize(VertexLayoutFormat format);
+
 class PipelineState : public ReferenceObject
 {
 protected:
-	std::shared_ptr<RenderPassPipelineState> renderPassPipelineState_ = nullptr;
+	Ref<RenderPassPipelineState> renderPassPipelineState_;
 
 public:
-	PipelineState() = default;
+	PipelineState();
 	virtual ~PipelineState() = default;
 
 	CullingMode Culling = CullingMode::Clockwise;
@@ -37,6 +40,51 @@ public:
 	std::array<VertexLayoutFormat, 16> VertexLayouts;
 	int32_t VertexLayoutCount = 0;
 
+	/**
+		@brief	slots of vertex buffers which attributes are read from
+		@note
+		Attributes in the same slot are interleaved in order. For example, positions in slot 0 and other attributes in slot 1
+		allow a depth only pass to read positions only.
+	*/
+	std::array<int32_t, 16> VertexLayoutSlots = {};
+
+	/**
+		@brief	explicit offsets of attributes in bytes, or -1
+		@note
+		An attribute with -1 is placed just after a previous attribute in the same slot.
+	*/
+	std::array<int32_t, 16> VertexLayoutOffsets;
+
+	/**
+		@brief	explicit strides of slots in bytes, or -1
+		@note
+		A slot with -1 has a stride which contains all attributes in the slot without padding.
+		On DirectX12, a slot with -1 uses a stride which is passed into CommandList::SetVertexBuffer instead.
+	*/
+	std::array<int32_t, NumVertexBufferSlot> VertexStrides;
+
+	//! an offset of an attribute from the beginning of a vertex in its slot
+	int32_t GetVertexLayoutOffset(int32_t index) const;
+
+	//! the stride of vertices in a slot
+	int32_t GetVertexStride(int32_t slot) const;
+
+	/**
+		@brief	sizes of push constants for each stage in bytes
+		@note
+		Push constants are packed in stage order and must fit in MaxPushConstantSize in total.
+		On Vulkan, a block in a pixel shader starts from GetPushConstantOffset(ShaderStageType::Pixel).
+	*/
+	std::array<int32_t, static_cast<int>(ShaderStageType::Max)> PushConstantSizes = {};
+
+	int32_t GetPushConstantOffset(ShaderStageType stage) const;
+
+	/**
+		@brief	set a shader of a stage
+		@note
+		A pipeline state with a compute shader is compiled into a compute pipeline. Don't set other stages with it.
+		A compute pipeline doesn't require a RenderPassPipelineState and is used with CommandList::Dispatch.
+	*/
 	virtual void SetShader(ShaderStageType stage, Shader* shader);
 
 	virtual void SetRenderPassPipelineState(RenderPassPipelineState* renderPassPipelineState);
@@ -3,7 +3,11 @@
 namespace LLGI
 {
 
-bool Platform::NewFrame() { return false; }
+bool Platform::NewFrame() { return ProcessEvents() && AcquireScreen(); }
+
+bool Platform::ProcessEvents() { return false; }
+
+bool Platform::AcquireScreen() { return false; }
 
 void Platform::Present() {}
 
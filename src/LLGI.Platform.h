@@ -15,7 +15,27 @@ public:
 	Platform() = default;
 	virtual ~Platform() = default;
 
+	/**
+		@brief	process messages of a window and acquire an image of a screen
+		@return	false if the window is closed
+	*/
 	virtual bool NewFrame();
+
+	/**
+		@brief	process messages of a window
+		@return	false if the window is closed
+		@note
+		Call it on the thread which created the window.
+	*/
+	virtual bool ProcessEvents();
+
+	/**
+		@brief	acquire an image of a screen which is drawn in a current frame
+		@note
+		It doesn't process messages, so it can be called on another thread than ProcessEvents.
+	*/
+	virtual bool AcquireScreen();
+
 	virtual void Present();
 	virtual Graphics* CreateGraphics();
 	virtual DeviceType GetDeviceType() const { return DeviceType::Default; }
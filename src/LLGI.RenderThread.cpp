@@ -0,0 +1,274 @@
+#include "LLGI.RenderThread.h"
+#include "LLGI.CommandPacketList.h"
+#include "LLGI.Graphics.h"
+#include "LLGI.Platform.h"
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace LLGI
+{
+
+namespace
+{
+
+int64_t GetTime()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double ToSeconds(int64_t time) { return time / 1000000000.0; }
+
+void SetCurrentThreadAffinity(int32_t cpuCore)
+{
+	if (cpuCore < 0)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpuCore);
+#elif defined(__linux__)
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(cpuCore, &cpuSet);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#endif
+	// threads are not pinned on other platforms
+}
+
+} // namespace
+
+RenderThread::RenderThread() : isTerminated_(false), isRunning_(false), frameCount_(0), presentBlockingTime_(0), idleTime_(0) {}
+
+RenderThread::~RenderThread()
+{
+	if (thread_.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			isTerminated_ = true;
+		}
+		frameQueued_.notify_all();
+
+		// frames which are handed off are processed before the thread finishes
+		thread_.join();
+	}
+
+	ReleaseFrame(recordingFrame_);
+
+	SafeRelease(graphics_);
+	SafeRelease(platform_);
+}
+
+bool RenderThread::Initialize(Platform* platform, Graphics* graphics, const RenderThreadParameter& parameter)
+{
+	if (platform == nullptr || graphics == nullptr || parameter.QueueDepth <= 0 || thread_.joinable())
+	{
+		return false;
+	}
+
+	SafeAssign(platform_, platform);
+	SafeAssign(graphics_, graphics);
+	queue_.reset(new SingleProducerSingleConsumerQueue<Frame>(parameter.QueueDepth));
+	isRunning_ = true;
+
+	auto cpuCore = parameter.CpuCore;
+	thread_ = std::thread([this, cpuCore]() { Run(cpuCore); });
+
+	return true;
+}
+
+void RenderThread::Run(int32_t cpuCore)
+{
+	SetCurrentThreadAffinity(cpuCore);
+
+	std::vector<CommandList*> commandLists;
+
+	while (true)
+	{
+		{
+			auto start = GetTime();
+			std::unique_lock<std::mutex> lock(mutex_);
+			frameQueued_.wait(lock, [this]() { return isTerminated_ || !queue_->IsEmpty(); });
+			idleTime_ += GetTime() - start;
+
+			isProcessing_ = true;
+		}
+
+		Frame frame;
+		if (!queue_->Pop(frame))
+		{
+			// terminated and all frames are processed
+			std::lock_guard<std::mutex> lock(mutex_);
+			isProcessing_ = false;
+			break;
+		}
+
+		if (isRunning_)
+		{
+			ProcessFrame(frame, commandLists);
+		}
+
+		ReleaseFrame(frame);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			isProcessing_ = false;
+		}
+		frameProcessed_.notify_all();
+	}
+
+	graphics_->WaitFinish();
+
+	for (auto commandList : commandLists)
+	{
+		commandList->Release();
+	}
+}
+
+void RenderThread::ProcessFrame(const Frame& frame, std::vector<CommandList*>& commandLists)
+{
+	// an image of a screen is acquired here and messages are processed on an application thread
+	auto start = GetTime();
+	if (!platform_->AcquireScreen())
+	{
+		isRunning_ = false;
+		return;
+	}
+	presentBlockingTime_ += GetTime() - start;
+
+	graphics_->NewFrame();
+
+	for (auto& upload : frame.uploads)
+	{
+		upload();
+	}
+
+	for (int32_t i = 0; i < frame.packetListCount; i++)
+	{
+		if (static_cast<size_t>(i) >= commandLists.size())
+		{
+			auto commandList = graphics_->CreateCommandList();
+			if (commandList == nullptr)
+			{
+				break;
+			}
+			commandLists.push_back(commandList);
+		}
+
+		frame.packetLists[i]->Translate(commandLists[i], nullptr, graphics_);
+		graphics_->Execute(commandLists[i]);
+	}
+
+	start = GetTime();
+	platform_->Present();
+	presentBlockingTime_ += GetTime() - start;
+
+	frameCount_++;
+}
+
+void RenderThread::ReleaseFrame(Frame& frame)
+{
+	for (int32_t i = 0; i < frame.packetListCount; i++)
+	{
+		SafeRelease(frame.packetLists[i]);
+	}
+	frame.packetListCount = 0;
+	frame.uploads.clear();
+}
+
+void RenderThread::Execute(CommandPacketList* packets)
+{
+	assert(packets != nullptr);
+	assert(recordingFrame_.packetListCount < MaxPacketListCount);
+
+	if (recordingFrame_.packetListCount >= MaxPacketListCount)
+	{
+		return;
+	}
+
+	SafeAddRef(packets);
+	recordingFrame_.packetLists[recordingFrame_.packetListCount] = packets;
+	recordingFrame_.packetListCount++;
+}
+
+void RenderThread::Upload(const std::function<void()>& upload)
+{
+	assert(upload != nullptr);
+	recordingFrame_.uploads.push_back(upload);
+}
+
+bool RenderThread::Present()
+{
+	if (!isRunning_ || queue_ == nullptr)
+	{
+		ReleaseFrame(recordingFrame_);
+		return false;
+	}
+
+	if (!platform_->ProcessEvents())
+	{
+		isRunning_ = false;
+		ReleaseFrame(recordingFrame_);
+		return false;
+	}
+
+	// the queue is pushed without locks and the mutex is used only to sleep
+	if (!queue_->Push(std::move(recordingFrame_)))
+	{
+		auto start = GetTime();
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			frameProcessed_.wait(lock, [this]() { return !queue_->IsFull() || !isRunning_; });
+		}
+
+		submissionBlockingTime_ += GetTime() - start;
+
+		if (!isRunning_ || !queue_->Push(std::move(recordingFrame_)))
+		{
+			ReleaseFrame(recordingFrame_);
+			return false;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+	}
+	frameQueued_.notify_one();
+
+	// references are moved to the queue
+	recordingFrame_.packetListCount = 0;
+	recordingFrame_.uploads.clear();
+	return true;
+}
+
+void RenderThread::Wait()
+{
+	if (queue_ == nullptr)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	frameProcessed_.wait(lock, [this]() { return queue_->IsEmpty() && !isProcessing_; });
+}
+
+RenderThreadStatistics RenderThread::GetStatistics() const
+{
+	RenderThreadStatistics ret;
+	ret.FrameCount = frameCount_;
+	ret.QueuedFrameCount = queue_ != nullptr ? static_cast<int32_t>(queue_->GetCount()) : 0;
+	ret.SubmissionBlockingTime = ToSeconds(submissionBlockingTime_);
+	ret.PresentBlockingTime = ToSeconds(presentBlockingTime_);
+	ret.IdleTime = ToSeconds(idleTime_);
+	return ret;
+}
+
+} // namespace LLGI
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "LLGI.Base.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace LLGI
+{
+
+class CommandPacketList;
+
+/**
+	@brief	a lock free ring buffer which is pushed by a thread and popped by another thread
+*/
+template <typename T> class SingleProducerSingleConsumerQueue
+{
+private:
+	std::vector<T> buffer_;
+	std::atomic<size_t> head_;
+	std::atomic<size_t> tail_;
+
+public:
+	explicit SingleProducerSingleConsumerQueue(size_t capacity) : buffer_(capacity + 1), head_(0), tail_(0) {}
+
+	//! called by a producer. It returns false if the queue is full.
+	bool Push(const T& value)
+	{
+		T copied = value;
+		return Push(std::move(copied));
+	}
+
+	//! called by a producer. It returns false if the queue is full and value is not moved then.
+	bool Push(T&& value)
+	{
+		auto tail = tail_.load(std::memory_order_relaxed);
+		auto next = (tail + 1) % buffer_.size();
+		if (next == head_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		buffer_[tail] = std::move(value);
+		tail_.store(next, std::memory_order_release);
+		return true;
+	}
+
+	//! called by a consumer. It returns false if the queue is empty. A value is moved out of the queue.
+	bool Pop(T& value)
+	{
+		auto head = head_.load(std::memory_order_relaxed);
+		if (head == tail_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		value = std::move(buffer_[head]);
+		head_.store((head + 1) % buffer_.size(), std::memory_order_release);
+		return true;
+	}
+
+	bool IsEmpty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+	size_t GetCount() const
+	{
+		auto head = head_.load(std::memory_order_acquire);
+		auto tail = tail_.load(std::memory_order_acquire);
+		return (tail + buffer_.size() - head) % buffer_.size();
+	}
+
+	bool IsFull() const { return (tail_.load(std::memory_order_acquire) + 1) % buffer_.size() == head_.load(std::memory_order_acquire); }
+
+	size_t GetCapacity() const { return buffer_.size() - 1; }
+};
+
+struct RenderThreadParameter
+{
+	//! the number of frames which an application thread can hand off before the render thread processes them
+	int32_t QueueDepth = 2;
+
+	//! an index of a cpu core which the render thread runs on. It is not pinned if it is negative.
+	int32_t CpuCore = -1;
+};
+
+struct RenderThreadStatistics
+{
+	//! the number of frames which are presented
+	int64_t FrameCount = 0;
+
+	//! the number of frames which are handed off and are not presented yet
+	int32_t QueuedFrameCount = 0;
+
+	//! time in seconds which an application thread waits because the queue is full
+	double SubmissionBlockingTime = 0.0;
+
+	//! time in seconds which the render thread waits in Platform::AcquireScreen and Platform::Present, which includes vsync
+	double PresentBlockingTime = 0.0;
+
+	//! time in seconds which the render thread waits for frames from an application thread
+	double IdleTime = 0.0;
+};
+
+/**
+	@brief	a dedicated thread which translates, submits and presents frames which are recorded on an application thread
+	@note
+	An application records commands into CommandPacketList, and hands them off with Execute and Present instead of
+	Graphics::Execute and Platform::Present. Platform::AcquireScreen, Graphics::NewFrame, Graphics::Execute and Platform::Present
+	are called on the render thread, so an application thread doesn't wait for vsync unless QueueDepth frames are queued.
+	Messages of a window are processed in Present on an application thread, which should be the thread which created the window.
+	Use CommandPacketList::BeginScreenRenderPass to draw into a screen. Packet lists are read until they are translated,
+	so use QueueDepth + 2 sets of them for queued frames, a processed frame and a recorded frame.
+	Graphics is not thread safe, so don't lock or update resources on an application thread after Initialize. Use Upload instead.
+	Resources which are used by packets must not be released until the render thread is idle.
+*/
+class RenderThread : public ReferenceObject
+{
+public:
+	static const int32_t MaxPacketListCount = 16;
+
+private:
+	struct Frame
+	{
+		std::array<CommandPacketList*, MaxPacketListCount> packetLists;
+		int32_t packetListCount = 0;
+
+		//! functions which are called before packets are translated
+		std::vector<std::function<void()>> uploads;
+	};
+
+	Platform* platform_ = nullptr;
+	Graphics* graphics_ = nullptr;
+	std::unique_ptr<SingleProducerSingleConsumerQueue<Frame>> queue_;
+
+	//! a frame which is built by Execute on an application thread
+	Frame recordingFrame_;
+
+	std::thread thread_;
+	std::mutex mutex_;
+	std::condition_variable frameQueued_;
+	std::condition_variable frameProcessed_;
+	std::atomic<bool> isTerminated_;
+	std::atomic<bool> isRunning_;
+	bool isProcessing_ = false;
+
+	std::atomic<int64_t> frameCount_;
+	std::atomic<int64_t> presentBlockingTime_;
+	std::atomic<int64_t> idleTime_;
+	int64_t submissionBlockingTime_ = 0;
+
+	void Run(int32_t cpuCore);
+	void ProcessFrame(const Frame& frame, std::vector<CommandList*>& commandLists);
+	void ReleaseFrame(Frame& frame);
+
+public:
+	RenderThread();
+	virtual ~RenderThread();
+
+	/**
+		@brief	start the render thread
+		@note
+		Create resources which need a screen, like pipeline states, before it because Graphics is used on the render thread after it.
+	*/
+	bool Initialize(Platform* platform, Graphics* graphics, const RenderThreadParameter& parameter = RenderThreadParameter());
+
+	/**
+		@brief	add packets which are recorded into a current frame
+		@note
+		Packets are translated and executed in the order of calls.
+	*/
+	void Execute(CommandPacketList* packets);
+
+	/**
+		@brief	add a function which updates resources into a current frame
+		@note
+		It is called on the render thread after Graphics::NewFrame and before packets of the frame are translated,
+		so resources can be locked and updated in it. Captured data must be kept until it is called.
+	*/
+	void Upload(const std::function<void()>& upload);
+
+	/**
+		@brief	hand off a current frame to the render thread
+		@return	false if the window is closed
+		@note
+		It waits only if QueueDepth frames are queued.
+	*/
+	bool Present();
+
+	//! wait until all frames which are handed off are presented
+	void Wait();
+
+	//! whether the window is not closed
+	bool GetIsRunning() const { return isRunning_; }
+
+	RenderThreadStatistics GetStatistics() const;
+};
+
+} // namespace LLGI
@@ -0,0 +1,293 @@
+#include "LLGI.ResourcePool.h"
+#include "LLGI.ConstantBuffer.h"
+#include "LLGI.Graphics.h"
+#include "LLGI.IndexBuffer.h"
+#include "LLGI.Texture.h"
+#include "LLGI.VertexBuffer.h"
+
+namespace LLGI
+{
+
+namespace
+{
+
+int64_t GetTextureMemorySizeWithMipMaps(TextureFormatType format, const Vec2I& size, int32_t mipMapCount, int32_t arrayLayerCount)
+{
+	if (mipMapCount == 0)
+	{
+		mipMapCount = GetMaximumMipMapCount(size);
+	}
+
+	int64_t ret = 0;
+	for (int32_t i = 0; i < mipMapCount; i++)
+	{
+		auto mipSize = Vec2I((std::max)(size.X >> i, 1), (std::max)(size.Y >> i, 1));
+		ret += GetTextureMemorySize(format, mipSize);
+	}
+
+	return ret * arrayLayerCount;
+}
+
+} // namespace
+
+ResourcePool::~ResourcePool()
+{
+	Clear();
+
+	for (auto& entry : lentResources_)
+	{
+		SafeRelease(entry.resource);
+	}
+	lentResources_.clear();
+
+	SafeRelease(graphics_);
+}
+
+bool ResourcePool::Initialize(Graphics* graphics, int32_t frameCount, int64_t budget)
+{
+	if (graphics == nullptr || frameCount <= 0 || budget < 0)
+	{
+		return false;
+	}
+
+	SafeAssign(graphics_, graphics);
+	frameCount_ = frameCount;
+	budget_ = budget;
+
+	return true;
+}
+
+ReferenceObject* ResourcePool::Acquire(const Key& key)
+{
+	auto it = retainedResources_.find(key);
+	if (it == retainedResources_.end() || it->second.empty())
+	{
+		statistics_.MissCount++;
+		return nullptr;
+	}
+
+	// the oldest one is the most likely to be finished on gpu
+	auto entry = it->second.front();
+	if (frame_ - entry.releasedFrame < frameCount_)
+	{
+		statistics_.MissCount++;
+		return nullptr;
+	}
+
+	it->second.pop_front();
+	statistics_.HitCount++;
+	statistics_.RetainedCount--;
+	statistics_.RetainedSize -= entry.size;
+
+	// the pool keeps its reference and an application gets another one
+	lentResources_.push_back(entry);
+	entry.resource->AddRef();
+	return entry.resource;
+}
+
+void ResourcePool::Lend(ReferenceObject* resource, const Key& key, int64_t size)
+{
+	Entry entry;
+	entry.resource = resource;
+	entry.key = key;
+	entry.size = size;
+	resource->AddRef();
+	lentResources_.push_back(entry);
+}
+
+void ResourcePool::EvictOverBudget()
+{
+	while (statistics_.RetainedSize > budget_)
+	{
+		// find the resource which was released first
+		std::deque<Entry>* oldest = nullptr;
+		for (auto& resources : retainedResources_)
+		{
+			if (!resources.second.empty() && (oldest == nullptr || resources.second.front().releasedFrame < oldest->front().releasedFrame))
+			{
+				oldest = &resources.second;
+			}
+		}
+
+		if (oldest == nullptr)
+		{
+			break;
+		}
+
+		auto entry = oldest->front();
+		oldest->pop_front();
+		statistics_.RetainedCount--;
+		statistics_.RetainedSize -= entry.size;
+		SafeRelease(entry.resource);
+	}
+}
+
+void ResourcePool::NewFrame()
+{
+	frame_++;
+
+	// a resource is released by an application when only the pool holds it
+	for (size_t i = 0; i < lentResources_.size();)
+	{
+		auto& entry = lentResources_[i];
+		if (entry.resource->GetRef() > 1)
+		{
+			i++;
+			continue;
+		}
+
+		entry.releasedFrame = frame_;
+		retainedResources_[entry.key].push_back(entry);
+		statistics_.RetainedCount++;
+		statistics_.RetainedSize += entry.size;
+
+		entry = lentResources_.back();
+		lentResources_.pop_back();
+	}
+
+	EvictOverBudget();
+}
+
+VertexBuffer* ResourcePool::CreateVertexBuffer(int32_t size)
+{
+	Key key = {ResourceType::VertexBuffer, GetSizeClass(size), 0, 0, 0};
+
+	auto resource = Acquire(key);
+	if (resource != nullptr)
+	{
+		return static_cast<VertexBuffer*>(resource);
+	}
+
+	auto vb = graphics_->CreateVertexBuffer(key.size);
+	if (vb != nullptr)
+	{
+		Lend(vb, key, key.size);
+	}
+	return vb;
+}
+
+IndexBuffer* ResourcePool::CreateIndexBuffer(int32_t stride, int32_t count)
+{
+	Key key = {ResourceType::IndexBuffer, GetSizeClass(count), 0, stride, 0};
+
+	auto resource = Acquire(key);
+	if (resource != nullptr)
+	{
+		return static_cast<IndexBuffer*>(resource);
+	}
+
+	auto ib = graphics_->CreateIndexBuffer(stride, key.size);
+	if (ib != nullptr)
+	{
+		Lend(ib, key, static_cast<int64_t>(key.size) * stride);
+	}
+	return ib;
+}
+
+ConstantBuffer* ResourcePool::CreateConstantBuffer(int32_t size, ConstantBufferType type)
+{
+	Key key = {ResourceType::ConstantBuffer, GetSizeClass(size), 0, 0, static_cast<int32_t>(type)};
+
+	auto resource = Acquire(key);
+	if (resource != nullptr)
+	{
+		return static_cast<ConstantBuffer*>(resource);
+	}
+
+	auto cb = graphics_->CreateConstantBuffer(key.size, type);
+	if (cb != nullptr)
+	{
+		Lend(cb, key, key.size);
+	}
+	return cb;
+}
+
+Texture* ResourcePool::CreateTexture(const Vec2I& size, bool isRenderPass, bool isDepthBuffer)
+{
+	Key key = {ResourceType::Texture, size.X, size.Y, -1, (isRenderPass ? 1 : 0) | (isDepthBuffer ? 2 : 0)};
+
+	auto resource = Acquire(key);
+	if (resource != nullptr)
+	{
+		return static_cast<Texture*>(resource);
+	}
+
+	auto texture = graphics_->CreateTexture(size, isRenderPass, isDepthBuffer);
+	if (texture != nullptr)
+	{
+		Lend(texture, key, GetTextureMemorySizeWithMipMaps(TextureFormatType::R8G8B8A8_UNORM, size, 1, 1));
+	}
+	return texture;
+}
+
+Texture* ResourcePool::CreateTexture(const TextureInitializationParameter& parameter)
+{
+	if (parameter.IsStreamed)
+	{
+		return graphics_->CreateTexture(parameter);
+	}
+
+	// the usage contains the number of mip levels and array layers
+	Key key = {ResourceType::Texture,
+			   parameter.Size.X,
+			   parameter.Size.Y,
+			   static_cast<int32_t>(parameter.Format),
+			   4 | (parameter.MipMapCount << 8) | (parameter.ArrayLayerCount << 16)};
+
+	auto resource = Acquire(key);
+	if (resource != nullptr)
+	{
+		return static_cast<Texture*>(resource);
+	}
+
+	auto texture = graphics_->CreateTexture(parameter);
+	if (texture != nullptr)
+	{
+		Lend(texture,
+			 key,
+			 GetTextureMemorySizeWithMipMaps(parameter.Format, parameter.Size, parameter.MipMapCount, parameter.ArrayLayerCount));
+	}
+	return texture;
+}
+
+void ResourcePool::Clear()
+{
+	for (auto& resources : retainedResources_)
+	{
+		for (auto& entry : resources.second)
+		{
+			SafeRelease(entry.resource);
+		}
+	}
+
+	retainedResources_.clear();
+	statistics_.RetainedCount = 0;
+	statistics_.RetainedSize = 0;
+}
+
+void ResourcePool::SetBudget(int64_t budget)
+{
+	budget_ = (std::max)(budget, static_cast<int64_t>(0));
+	EvictOverBudget();
+}
+
+int32_t ResourcePool::GetSizeClass(int32_t size)
+{
+	const int32_t minSize = 256;
+	if (size <= minSize)
+	{
+		return minSize;
+	}
+
+	// four classes between powers of two
+	int32_t power = minSize;
+	while (power <= size / 2)
+	{
+		power *= 2;
+	}
+
+	auto step = power / 4;
+	return (size + step - 1) / step * step;
+}
+
+} // namespace LLGI
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "LLGI.Base.h"
+#include <unordered_map>
+
+namespace LLGI
+{
+
+struct ResourcePoolStatistics
+{
+	//! the number of resources which are reused
+	int32_t HitCount = 0;
+
+	//! the number of resources which are created
+	int32_t MissCount = 0;
+
+	//! the number of resources which are released by an application and kept in the pool
+	int32_t RetainedCount = 0;
+
+	//! the size of resources which are kept in the pool in bytes
+	int64_t RetainedSize = 0;
+
+	float GetHitRate() const { return HitCount + MissCount > 0 ? static_cast<float>(HitCount) / (HitCount + MissCount) : 0.0f; }
+};
+
+/**
+	@brief	a class to recycle buffers and textures which are created and released frequently
+	@note
+	Resources which are created by this class are kept when an application releases them and handed out again after frames
+	which may use them are finished. They are grouped by a type, a size class, a format and a usage.
+	Sizes of buffers are rounded up to size classes, so GetSize and GetCount may return larger values than requested.
+	Contents of a reused resource are undefined.
+	Release it before Graphics because resources in it hold Graphics.
+	It is not thread safe.
+*/
+class ResourcePool : public ReferenceObject
+{
+private:
+	enum class ResourceType
+	{
+		VertexBuffer,
+		IndexBuffer,
+		ConstantBuffer,
+		Texture,
+	};
+
+	struct Key
+	{
+		ResourceType type;
+		int32_t size;
+		int32_t height;
+		int32_t format;
+		int32_t usage;
+
+		bool operator==(const Key& value) const
+		{
+			return type == value.type && size == value.size && height == value.height && format == value.format && usage == value.usage;
+		}
+
+		struct Hash
+		{
+			typedef std::size_t result_type;
+
+			std::size_t operator()(const Key& key) const
+			{
+				std::size_t hash = 0;
+				HashCombine(hash, std::hash<int32_t>()(static_cast<int32_t>(key.type)));
+				HashCombine(hash, std::hash<int32_t>()(key.size));
+				HashCombine(hash, std::hash<int32_t>()(key.height));
+				HashCombine(hash, std::hash<int32_t>()(key.format));
+				HashCombine(hash, std::hash<int32_t>()(key.usage));
+				return hash;
+			}
+		};
+	};
+
+	struct Entry
+	{
+		ReferenceObject* resource = nullptr;
+		Key key;
+		int64_t size = 0;
+		int64_t releasedFrame = 0;
+	};
+
+	Graphics* graphics_ = nullptr;
+	int32_t frameCount_ = 0;
+	int64_t budget_ = 0;
+	int64_t frame_ = 0;
+
+	//! resources which an application may hold. The pool holds a reference of each one.
+	std::vector<Entry> lentResources_;
+
+	//! resources which are released by an application in order of release for each key
+	std::unordered_map<Key, std::deque<Entry>, Key::Hash> retainedResources_;
+
+	ResourcePoolStatistics statistics_;
+
+	ReferenceObject* Acquire(const Key& key);
+	void Lend(ReferenceObject* resource, const Key& key, int64_t size);
+	void EvictOverBudget();
+
+public:
+	ResourcePool() = default;
+	virtual ~ResourcePool();
+
+	/**
+		@param	graphics	graphics to create resources
+		@param	frameCount	the number of frames which gpu may be processing at the same time
+		@param	budget	the maximum size of resources which are kept in the pool in bytes
+	*/
+	bool Initialize(Graphics* graphics, int32_t frameCount, int64_t budget = 64 * 1024 * 1024);
+
+	/**
+		@brief	collect resources which are released by an application and release resources over the budget
+		@note
+		Call it once per frame after Graphics::NewFrame.
+	*/
+	void NewFrame();
+
+	VertexBuffer* CreateVertexBuffer(int32_t size);
+
+	IndexBuffer* CreateIndexBuffer(int32_t stride, int32_t count);
+
+	ConstantBuffer* CreateConstantBuffer(int32_t size, ConstantBufferType type = ConstantBufferType::LongTime);
+
+	Texture* CreateTexture(const Vec2I& size, bool isRenderPass, bool isDepthBuffer);
+
+	/**
+		@brief	create a texture
+		@note
+		Streamed textures are not recycled because they have states of uploads.
+	*/
+	Texture* CreateTexture(const TextureInitializationParameter& parameter);
+
+	//! release all resources which are kept in the pool
+	void Clear();
+
+	void SetBudget(int64_t budget);
+
+	int64_t GetBudget() const { return budget_; }
+
+	const ResourcePoolStatistics& GetStatistics() const { return statistics_; }
+
+	//! a size class which a size of a buffer is rounded up to. It wastes 25% at most.
+	static int32_t GetSizeClass(int32_t size);
+};
+
+} // namespace LLGI
@@ -0,0 +1,196 @@
+#include "LLGI.SpriteBatch.h"
+#include "LLGI.CommandList.h"
+#include "LLGI.Graphics.h"
+#include "LLGI.IndexBuffer.h"
+#include "LLGI.PipelineState.h"
+#include "LLGI.Texture.h"
+#include <functional>
+
+namespace LLGI
+{
+
+SpriteBatch::~SpriteBatch()
+{
+	SafeRelease(indexBuffer_);
+	SafeRelease(graphics_);
+}
+
+bool SpriteBatch::Initialize(Graphics* graphics)
+{
+	SafeAssign(graphics_, graphics);
+
+	// sprites would be dropped in Draw without transient buffers
+	if (!graphics_->IsTransientBufferSupported())
+	{
+		return false;
+	}
+
+	// indexes are shared by all draw calls because vertices of each draw call start from an offset
+	indexBuffer_ = graphics_->CreateIndexBuffer(2, MaxSpriteCountPerDraw * 6);
+	if (indexBuffer_ == nullptr)
+	{
+		return false;
+	}
+
+	auto indexes = static_cast<uint16_t*>(indexBuffer_->Lock());
+	if (indexes == nullptr)
+	{
+		return false;
+	}
+
+	for (int32_t i = 0; i < MaxSpriteCountPerDraw; i++)
+	{
+		indexes[i * 6 + 0] = static_cast<uint16_t>(i * 4 + 0);
+		indexes[i * 6 + 1] = static_cast<uint16_t>(i * 4 + 1);
+		indexes[i * 6 + 2] = static_cast<uint16_t>(i * 4 + 2);
+		indexes[i * 6 + 3] = static_cast<uint16_t>(i * 4 + 0);
+		indexes[i * 6 + 4] = static_cast<uint16_t>(i * 4 + 2);
+		indexes[i * 6 + 5] = static_cast<uint16_t>(i * 4 + 3);
+	}
+
+	indexBuffer_->Unlock();
+
+	vertices_.reserve(MaxSpriteCountPerDraw * 4);
+	textures_.reserve(MaxSpriteCountPerDraw);
+	order_.reserve(MaxSpriteCountPerDraw);
+
+	return true;
+}
+
+void SpriteBatch::Begin(CommandList* commandList, PipelineState* pipelineState, bool isSortedByTexture)
+{
+	commandList_ = commandList;
+	pipelineState_ = pipelineState;
+	isSortedByTexture_ = isSortedByTexture;
+	drawCallCount_ = 0;
+
+	vertices_.clear();
+	textures_.clear();
+}
+
+void SpriteBatch::SetPipelineState(PipelineState* pipelineState)
+{
+	if (pipelineState_ == pipelineState)
+	{
+		return;
+	}
+
+	Flush();
+	pipelineState_ = pipelineState;
+}
+
+void SpriteBatch::Draw(Texture* texture, const SpriteVertex* vertices)
+{
+	if (static_cast<int32_t>(textures_.size()) >= MaxSpriteCount)
+	{
+		Flush();
+	}
+
+	vertices_.insert(vertices_.end(), vertices, vertices + 4);
+	textures_.push_back(texture);
+}
+
+void SpriteBatch::Draw(Texture* texture,
+					   const Vec2F& position,
+					   const Vec2F& size,
+					   const Vec2F& uvPosition,
+					   const Vec2F& uvSize,
+					   const Color8& color,
+					   float z)
+{
+	SpriteVertex vertices[4];
+
+	vertices[0].Pos = Vec3F(position.X, position.Y, z);
+	vertices[1].Pos = Vec3F(position.X + size.X, position.Y, z);
+	vertices[2].Pos = Vec3F(position.X + size.X, position.Y + size.Y, z);
+	vertices[3].Pos = Vec3F(position.X, position.Y + size.Y, z);
+
+	vertices[0].UV = Vec2F(uvPosition.X, uvPosition.Y);
+	vertices[1].UV = Vec2F(uvPosition.X + uvSize.X, uvPosition.Y);
+	vertices[2].UV = Vec2F(uvPosition.X + uvSize.X, uvPosition.Y + uvSize.Y);
+	vertices[3].UV = Vec2F(uvPosition.X, uvPosition.Y + uvSize.Y);
+
+	for (auto& v : vertices)
+	{
+		v.Color = color;
+	}
+
+	Draw(texture, vertices);
+}
+
+void SpriteBatch::Draw(int32_t first, int32_t count)
+{
+	auto transient = graphics_->AllocateTransientVertices(static_cast<int32_t>(sizeof(SpriteVertex)) * 4 * count);
+	if (transient.vertexBuffer == nullptr)
+	{
+		return;
+	}
+
+	auto dst = static_cast<SpriteVertex*>(transient.data);
+	for (int32_t i = 0; i < count; i++)
+	{
+		memcpy(dst + i * 4, &vertices_[order_[first + i] * 4], sizeof(SpriteVertex) * 4);
+	}
+
+	commandList_->SetIndexBuffer(indexBuffer_);
+
+	// a draw call per a run of the same texture
+	int32_t runStart = 0;
+	for (int32_t i = 1; i <= count; i++)
+	{
+		if (i < count && textures_[order_[first + i]] == textures_[order_[first + runStart]])
+			continue;
+
+		auto offset = transient.offset + static_cast<int32_t>(sizeof(SpriteVertex)) * 4 * runStart;
+		commandList_->SetVertexBuffer(transient.vertexBuffer, sizeof(SpriteVertex), offset);
+		commandList_->SetTexture(textures_[order_[first + runStart]], WrapMode, MinMagFilter, 0, ShaderStageType::Pixel);
+		commandList_->Draw((i - runStart) * 2);
+		drawCallCount_++;
+
+		runStart = i;
+	}
+}
+
+void SpriteBatch::Flush()
+{
+	if (textures_.size() == 0 || commandList_ == nullptr || pipelineState_ == nullptr)
+	{
+		vertices_.clear();
+		textures_.clear();
+		return;
+	}
+
+	auto spriteCount = static_cast<int32_t>(textures_.size());
+
+	order_.resize(spriteCount);
+	for (int32_t i = 0; i < spriteCount; i++)
+	{
+		order_[i] = i;
+	}
+
+	if (isSortedByTexture_)
+	{
+		std::stable_sort(
+			order_.begin(), order_.end(), [this](int32_t a, int32_t b) { return std::less<Texture*>()(textures_[a], textures_[b]); });
+	}
+
+	commandList_->SetPipelineState(pipelineState_);
+
+	const int32_t maxCount = MaxSpriteCountPerDraw;
+	for (int32_t first = 0; first < spriteCount; first += maxCount)
+	{
+		Draw(first, (std::min)(spriteCount - first, maxCount));
+	}
+
+	vertices_.clear();
+	textures_.clear();
+}
+
+void SpriteBatch::End()
+{
+	Flush();
+	commandList_ = nullptr;
+	pipelineState_ = nullptr;
+}
+
+} // namespace LLGI
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "LLGI.Base.h"
+
+namespace LLGI
+{
+
+/**
+	@brief	a vertex of a sprite
+	@note
+	A pipeline state for sprites has R32G32B32_FLOAT, R32G32_FLOAT and R8G8B8A8_UNORM as a vertex layout.
+*/
+struct SpriteVertex
+{
+	Vec3F Pos;
+	Vec2F UV;
+	Color8 Color;
+};
+
+/**
+	@brief	a class to draw many quads with a few draw calls
+	@note
+	Sprites are accumulated and written into transient vertex buffers of Graphics when they are flushed.
+	They are flushed when a pipeline state is changed, when End is called or when it reaches capacity.
+	A flush issues a draw call for each run of sprites with the same texture.
+	Textures are not held, so they must not be disposed before the sprites are flushed.
+	It is not supported on backends without transient buffers, such as Metal.
+*/
+class SpriteBatch : public ReferenceObject
+{
+private:
+	Graphics* graphics_ = nullptr;
+	IndexBuffer* indexBuffer_ = nullptr;
+
+	CommandList* commandList_ = nullptr;
+	PipelineState* pipelineState_ = nullptr;
+	bool isSortedByTexture_ = false;
+
+	std::vector<SpriteVertex> vertices_;
+	std::vector<Texture*> textures_;
+	std::vector<int32_t> order_;
+
+	int32_t drawCallCount_ = 0;
+
+	void Draw(int32_t first, int32_t count);
+
+public:
+	//! the maximum number of sprites in a draw call
+	static const int32_t MaxSpriteCountPerDraw = 16384;
+
+	//! the maximum number of sprites which are accumulated before they are flushed
+	static const int32_t MaxSpriteCount = MaxSpriteCountPerDraw * 8;
+
+	TextureWrapMode WrapMode = TextureWrapMode::Clamp;
+	TextureMinMagFilter MinMagFilter = TextureMinMagFilter::Linear;
+
+	SpriteBatch() = default;
+	virtual ~SpriteBatch();
+
+	/**
+		@brief	initialize
+		@return	false if it fails or if Graphics does not support transient buffers
+	*/
+	bool Initialize(Graphics* graphics);
+
+	/**
+		@brief	start to accumulate sprites
+		@param	commandList	a command list which is inside a render pass
+		@param	pipelineState	a pipeline state to draw sprites
+		@param	isSortedByTexture	whether sprites are sorted by texture when they are flushed.
+		The order of sprites with the same texture is kept.
+	*/
+	void Begin(CommandList* commandList, PipelineState* pipelineState, bool isSortedByTexture = false);
+
+	/**
+		@brief	change a pipeline state
+		@note
+		Accumulated sprites are flushed with the previous pipeline state.
+	*/
+	void SetPipelineState(PipelineState* pipelineState);
+
+	/**
+		@brief	add a sprite
+		@param	texture	a texture which is bound at unit 0 of a pixel shader
+		@param	vertices	left-top, right-top, right-bottom and left-bottom vertices
+	*/
+	void Draw(Texture* texture, const SpriteVertex* vertices);
+
+	/**
+		@brief	add an axis aligned sprite
+		@param	texture	a texture which is bound at unit 0 of a pixel shader
+		@param	position	a position of left-top
+		@param	size	a size of the sprite
+		@param	uvPosition	a uv of left-top
+		@param	uvSize	a size of uv
+		@param	color	a color which is multiplied
+		@param	z	a depth of the sprite
+	*/
+	void Draw(Texture* texture,
+			  const Vec2F& position,
+			  const Vec2F& size,
+			  const Vec2F& uvPosition,
+			  const Vec2F& uvSize,
+			  const Color8& color = Color8(),
+			  float z = 0.5f);
+
+	/**
+		@brief	draw accumulated sprites
+	*/
+	void Flush();
+
+	/**
+		@brief	flush sprites and finish to accumulate
+	*/
+	void End();
+
+	//! the number of draw calls since Begin
+	int32_t GetDrawCallCount() const { return drawCallCount_; }
+};
+
+} // namespace LLGI
@@ -0,0 +1,13 @@
+#include "LLGI.StorageBuffer.h"
+
+namespace LLGI
+{
+void* StorageBuffer::Lock() { return nullptr; }
+
+void* StorageBuffer::Lock(int32_t offset, int32_t size) { return nullptr; }
+
+void StorageBuffer::Unlock() {}
+
+int32_t StorageBuffer::GetSize() { return 0; }
+
+} // namespace LLGI
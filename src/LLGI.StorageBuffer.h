@@ -0,0 +1,27 @@
+
+#pragma once
+
+#include "LLGI.Base.h"
+
+namespace LLGI
+{
+
+/**
+	@brief	a buffer which compute shaders read and write
+	@note
+	It is bound with CommandList::SetStorageBuffer.
+*/
+class StorageBuffer : public ReferenceObject
+{
+private:
+public:
+	StorageBuffer() = default;
+	virtual ~StorageBuffer() = default;
+
+	virtual void* Lock();
+	virtual void* Lock(int32_t offset, int32_t size);
+	virtual void Unlock();
+	virtual int32_t GetSize();
+};
+
+} // namespace LLGI
@@ -3,14 +3,88 @@
 namespace LLGI
 {
 
+bool IsCompressedFormat(TextureFormatType format)
+{
+	switch (format)
+	{
+	case TextureFormatType::BC1:
+	case TextureFormatType::BC2:
+	case TextureFormatType::BC3:
+	case TextureFormatType::BC4:
+	case TextureFormatType::BC5:
+	case TextureFormatType::BC6H:
+	case TextureFormatType::BC7:
+	case TextureFormatType::ETC2_RGB8:
+	case TextureFormatType::ETC2_RGBA8:
+	case TextureFormatType::ASTC_4x4:
+		return true;
+	default:
+		return false;
+	}
+}
+
+int32_t GetTextureMemorySize(TextureFormatType format, Vec2I size)
+{
+	if (IsCompressedFormat(format))
+	{
+		auto blockCount = ((size.X + 3) / 4) * ((size.Y + 3) / 4);
+
+		switch (format)
+		{
+		case TextureFormatType::BC1:
+		case TextureFormatType::BC4:
+		case TextureFormatType::ETC2_RGB8:
+			return blockCount * 8;
+		default:
+			return blockCount * 16;
+		}
+	}
+
+	switch (format)
+	{
+	case TextureFormatType::R8_UNORM:
+		return size.X * size.Y;
+	case TextureFormatType::R8G8_UNORM:
+		return size.X * size.Y * 2;
+	case TextureFormatType::R16G16B16A16_FLOAT:
+		return size.X * size.Y * 8;
+	default:
+		return size.X * size.Y * 4;
+	}
+}
+
+int32_t GetMaximumMipMapCount(Vec2I size)
+{
+	int32_t count = 1;
+	auto length = std::max(size.X, size.Y);
+	while (length > 1)
+	{
+		length /= 2;
+		count++;
+	}
+	return count;
+}
+
 void* Texture::Lock() { return nullptr; }
 
 void Texture::Unlock() {}
 
+bool Texture::UpdateRegion(const Vec2I& position, const Vec2I& size, const void* data) { return false; }
+
 Vec2I Texture::GetSizeAs2D() { return Vec2I(); }
 
 bool Texture::IsRenderTexture() const { return false; }
 
 bool Texture::IsDepthTexture() const { return false; }
 
+TextureFormatType Texture::GetFormat() const { return TextureFormatType::R8G8B8A8_UNORM; }
+
+int32_t Texture::GetMipMapCount() const { return 1; }
+
+int32_t Texture::GetArrayLayerCount() const { return 1; }
+
+bool Texture::IsStreamed() const { return false; }
+
+int32_t Texture::GetResidentMipMap() const { return 0; }
+
 } // namespace LLGI
\ No newline at end of file
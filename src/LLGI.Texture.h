@@ -6,6 +6,23 @@
 namespace LLGI
 {
 
+/**
+	@brief	get whether a format is compressed with 4x4 blocks
+*/
+bool IsCompressedFormat(TextureFormatType format);
+
+/**
+	@brief	get the size of a mip level in bytes
+	@param	format	the format of a texture
+	@param	size	the size of the mip level
+*/
+int32_t GetTextureMemorySize(TextureFormatType format, Vec2I size);
+
+/**
+	@brief	get the number of mip levels of a full mip chain
+*/
+int32_t GetMaximumMipMapCount(Vec2I size);
+
 class Texture : public ReferenceObject
 {
 private:
@@ -13,11 +30,46 @@ public:
 	Texture() = default;
 	virtual ~Texture() = default;
 
+	/**
+		@brief	map memory to upload
+		@note
+		Data are packed for each array layer in order.
+		An array layer contains mip levels which are uploaded, the first level only unless the format is compressed.
+	*/
 	virtual void* Lock();
 	virtual void Unlock();
+
+	/**
+		@brief	upload a rectangle of the first mip level without changing other pixels
+		@param	position	the left-top of the rectangle
+		@param	size	the size of the rectangle
+		@param	data	pixels of the rectangle which are packed without padding
+		@return	false if it is not supported. Then upload the whole texture with Lock and Unlock.
+		@note
+		The whole texture must be uploaded with Lock and Unlock before it. Generated mip levels are not updated.
+		It doesn't wait gpu. Pixels are updated for command lists which are executed after it.
+	*/
+	virtual bool UpdateRegion(const Vec2I& position, const Vec2I& size, const void* data);
 	virtual Vec2I GetSizeAs2D();
 	virtual bool IsRenderTexture() const;
 	virtual bool IsDepthTexture() const;
+	virtual TextureFormatType GetFormat() const;
+	virtual int32_t GetMipMapCount() const;
+	virtual int32_t GetArrayLayerCount() const;
+
+	/**
+		@brief	get whether mip levels are uploaded with Graphics::RequestTextureMipMap
+	*/
+	virtual bool IsStreamed() const;
+
+	/**
+		@brief	get the finest mip level which can be sampled
+		@note
+		Levels are resident from the coarsest one continuously, and sampling is clamped to them.
+		It returns GetMipMapCount() if no level is resident.
+		It is always 0 unless a texture is streamed.
+	*/
+	virtual int32_t GetResidentMipMap() const;
 };
 
 } // namespace LLGI
\ No newline at end of file
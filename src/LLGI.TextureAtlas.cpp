@@ -0,0 +1,332 @@
+#include "LLGI.TextureAtlas.h"
+#include "LLGI.Graphics.h"
+#include "LLGI.Texture.h"
+
+namespace LLGI
+{
+
+TextureAtlas::~TextureAtlas()
+{
+	for (auto& page : pages_)
+	{
+		SafeRelease(page.texture);
+	}
+	pages_.clear();
+
+	SafeRelease(graphics_);
+}
+
+bool TextureAtlas::Initialize(Graphics* graphics, const Vec2I& pageSize, int32_t maxPageCount, int32_t padding)
+{
+	if (graphics == nullptr || pageSize.X <= 0 || pageSize.Y <= 0 || maxPageCount <= 0 || padding < 0)
+	{
+		return false;
+	}
+
+	SafeAssign(graphics_, graphics);
+	pageSize_ = pageSize;
+	maxPageCount_ = maxPageCount;
+	padding_ = padding;
+
+	return true;
+}
+
+bool TextureAtlas::AddPage()
+{
+	if (static_cast<int32_t>(pages_.size()) >= maxPageCount_)
+	{
+		return false;
+	}
+
+	Page page;
+	page.texture = graphics_->CreateTexture(pageSize_, false, false);
+	if (page.texture == nullptr)
+	{
+		return false;
+	}
+
+	page.pixels.resize(pageSize_.X * pageSize_.Y, Color8(0, 0, 0, 0));
+
+	// the whole page is uploaded once so that rectangles can be updated partially
+	auto buf = static_cast<Color8*>(page.texture->Lock());
+	if (buf != nullptr)
+	{
+		memcpy(buf, page.pixels.data(), page.pixels.size() * sizeof(Color8));
+		page.texture->Unlock();
+	}
+
+	ResetPage(page);
+	pages_.push_back(std::move(page));
+	return true;
+}
+
+void TextureAtlas::ResetPage(Page& page)
+{
+	page.skyline.clear();
+	page.skyline.push_back(SkylineNode{0, 0, pageSize_.X});
+	page.freeRects.clear();
+	page.allocatedRects.clear();
+}
+
+bool TextureAtlas::AllocateFromFreeRects(Page& page, const Vec2I& size, Vec2I& position)
+{
+	// the smallest rectangle which contains the size is reused
+	int32_t bestIndex = -1;
+	int32_t bestArea = 0;
+
+	for (size_t i = 0; i < page.freeRects.size(); i++)
+	{
+		const auto& rectSize = page.freeRects[i].second;
+		if (rectSize.X < size.X || rectSize.Y < size.Y)
+			continue;
+
+		auto area = rectSize.X * rectSize.Y;
+		if (bestIndex < 0 || area < bestArea)
+		{
+			bestIndex = static_cast<int32_t>(i);
+			bestArea = area;
+		}
+	}
+
+	if (bestIndex < 0)
+	{
+		return false;
+	}
+
+	position = page.freeRects[bestIndex].first;
+	page.freeRects.erase(page.freeRects.begin() + bestIndex);
+	return true;
+}
+
+int32_t TextureAtlas::FitSkyline(const Page& page, int32_t index, const Vec2I& size) const
+{
+	const auto& node = page.skyline[index];
+	if (node.x + size.X > pageSize_.X)
+	{
+		return -1;
+	}
+
+	// the rectangle is placed on the highest node under it
+	int32_t y = 0;
+	int32_t widthLeft = size.X;
+	for (int32_t i = index; widthLeft > 0; i++)
+	{
+		y = (std::max)(y, page.skyline[i].y);
+		widthLeft -= page.skyline[i].width;
+	}
+
+	if (y + size.Y > pageSize_.Y)
+	{
+		return -1;
+	}
+
+	return y;
+}
+
+bool TextureAtlas::AllocateFromSkyline(Page& page, const Vec2I& size, Vec2I& position)
+{
+	int32_t bestIndex = -1;
+	int32_t bestBottom = 0;
+	int32_t bestWidth = 0;
+
+	for (size_t i = 0; i < page.skyline.size(); i++)
+	{
+		auto y = FitSkyline(page, static_cast<int32_t>(i), size);
+		if (y < 0)
+			continue;
+
+		// bottom-left rule
+		auto bottom = y + size.Y;
+		if (bestIndex < 0 || bottom < bestBottom || (bottom == bestBottom && page.skyline[i].width < bestWidth))
+		{
+			bestIndex = static_cast<int32_t>(i);
+			bestBottom = bottom;
+			bestWidth = page.skyline[i].width;
+			position = Vec2I(page.skyline[i].x, y);
+		}
+	}
+
+	if (bestIndex < 0)
+	{
+		return false;
+	}
+
+	page.skyline.insert(page.skyline.begin() + bestIndex, SkylineNode{position.X, position.Y + size.Y, size.X});
+
+	// shrink nodes which are covered by the new node
+	for (size_t i = bestIndex + 1; i < page.skyline.size();)
+	{
+		auto& prev = page.skyline[i - 1];
+		auto& node = page.skyline[i];
+
+		auto overlap = prev.x + prev.width - node.x;
+		if (overlap <= 0)
+			break;
+
+		node.x += overlap;
+		node.width -= overlap;
+
+		if (node.width <= 0)
+		{
+			page.skyline.erase(page.skyline.begin() + i);
+			continue;
+		}
+
+		break;
+	}
+
+	// merge nodes with the same height
+	for (size_t i = 1; i < page.skyline.size();)
+	{
+		if (page.skyline[i - 1].y == page.skyline[i].y)
+		{
+			page.skyline[i - 1].width += page.skyline[i].width;
+			page.skyline.erase(page.skyline.begin() + i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	return true;
+}
+
+bool TextureAtlas::Allocate(const Vec2I& size, TextureAtlasRegion& region)
+{
+	region = TextureAtlasRegion();
+
+	if (graphics_ == nullptr || size.X <= 0 || size.Y <= 0)
+	{
+		return false;
+	}
+
+	auto paddedSize = Vec2I(size.X + padding_ * 2, size.Y + padding_ * 2);
+	if (paddedSize.X > pageSize_.X || paddedSize.Y > pageSize_.Y)
+	{
+		return false;
+	}
+
+	for (int32_t pass = 0; pass < 2; pass++)
+	{
+		for (size_t i = 0; i < pages_.size(); i++)
+		{
+			Vec2I position;
+			auto found = pass == 0 ? AllocateFromFreeRects(pages_[i], paddedSize, position)
+								   : AllocateFromSkyline(pages_[i], paddedSize, position);
+			if (!found)
+				continue;
+
+			pages_[i].allocatedRects[GetRectKey(position)] = paddedSize;
+
+			region.Page = static_cast<int32_t>(i);
+			region.Position = Vec2I(position.X + padding_, position.Y + padding_);
+			region.Size = size;
+			auto pageSize = Vec2F(static_cast<float>(pageSize_.X), static_cast<float>(pageSize_.Y));
+			region.UVPosition = Vec2F(region.Position.X / pageSize.X, region.Position.Y / pageSize.Y);
+			region.UVSize = Vec2F(size.X / pageSize.X, size.Y / pageSize.Y);
+			return true;
+		}
+	}
+
+	if (!AddPage())
+	{
+		return false;
+	}
+
+	return Allocate(size, region);
+}
+
+void TextureAtlas::Free(const TextureAtlasRegion& region)
+{
+	if (!region.IsValid() || region.Page >= static_cast<int32_t>(pages_.size()))
+	{
+		return;
+	}
+
+	auto& page = pages_[region.Page];
+	auto position = Vec2I(region.Position.X - padding_, region.Position.Y - padding_);
+	auto size = Vec2I(region.Size.X + padding_ * 2, region.Size.Y + padding_ * 2);
+
+	// a rectangle which is freed twice or is in a cleared page is not freed again
+	auto it = page.allocatedRects.find(GetRectKey(position));
+	if (it == page.allocatedRects.end() || it->second.X != size.X || it->second.Y != size.Y)
+	{
+		return;
+	}
+
+	page.allocatedRects.erase(it);
+	if (page.allocatedRects.empty())
+	{
+		ResetPage(page);
+		return;
+	}
+
+	page.freeRects.push_back(std::make_pair(position, size));
+}
+
+void TextureAtlas::Update(const TextureAtlasRegion& region, const void* data)
+{
+	if (!region.IsValid() || region.Page >= static_cast<int32_t>(pages_.size()) || data == nullptr)
+	{
+		return;
+	}
+
+	auto& page = pages_[region.Page];
+	auto src = static_cast<const Color8*>(data);
+
+	for (int32_t y = 0; y < region.Size.Y; y++)
+	{
+		memcpy(&page.pixels[(region.Position.Y + y) * pageSize_.X + region.Position.X],
+			   src + y * region.Size.X,
+			   sizeof(Color8) * region.Size.X);
+	}
+
+	auto regionMax = Vec2I(region.Position.X + region.Size.X, region.Position.Y + region.Size.Y);
+
+	if (page.isDirty)
+	{
+		page.dirtyMin = Vec2I((std::min)(page.dirtyMin.X, region.Position.X), (std::min)(page.dirtyMin.Y, region.Position.Y));
+		page.dirtyMax = Vec2I((std::max)(page.dirtyMax.X, regionMax.X), (std::max)(page.dirtyMax.Y, regionMax.Y));
+	}
+	else
+	{
+		page.dirtyMin = region.Position;
+		page.dirtyMax = regionMax;
+		page.isDirty = true;
+	}
+}
+
+void TextureAtlas::Flush()
+{
+	std::vector<Color8> regionPixels;
+
+	for (auto& page : pages_)
+	{
+		if (!page.isDirty)
+			continue;
+
+		auto size = Vec2I(page.dirtyMax.X - page.dirtyMin.X, page.dirtyMax.Y - page.dirtyMin.Y);
+
+		regionPixels.resize(size.X * size.Y);
+		for (int32_t y = 0; y < size.Y; y++)
+		{
+			memcpy(&regionPixels[y * size.X], &page.pixels[(page.dirtyMin.Y + y) * pageSize_.X + page.dirtyMin.X], sizeof(Color8) * size.X);
+		}
+
+		// upload the whole page if partial updates are not supported
+		if (!page.texture->UpdateRegion(page.dirtyMin, size, regionPixels.data()))
+		{
+			auto buf = page.texture->Lock();
+			if (buf != nullptr)
+			{
+				memcpy(buf, page.pixels.data(), page.pixels.size() * sizeof(Color8));
+				page.texture->Unlock();
+			}
+		}
+
+		page.isDirty = false;
+	}
+}
+
+} // namespace LLGI
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "LLGI.Base.h"
+#include <unordered_map>
+
+namespace LLGI
+{
+
+/**
+	@brief	a rectangle which is allocated in TextureAtlas
+	@note
+	A uv in the rectangle is UVPosition + uv * UVSize.
+*/
+struct TextureAtlasRegion
+{
+	int32_t Page = -1;
+	Vec2I Position;
+	Vec2I Size;
+	Vec2F UVPosition;
+	Vec2F UVSize;
+
+	bool IsValid() const { return Page >= 0; }
+};
+
+/**
+	@brief	a class to pack many small images into a few RGBA8 textures
+	@note
+	Rectangles are packed with a skyline in each page and a page is added when they don't fit into existing pages.
+	Freed rectangles are reused by rectangles which fit into them, and a page is cleared when all rectangles in it are freed.
+	Space is reclaimed per page, so freed space which is not reused is not returned to the skyline until the page is cleared.
+	Pixels are kept on cpu and rectangles which are updated are uploaded when Flush is called.
+*/
+class TextureAtlas : public ReferenceObject
+{
+private:
+	struct SkylineNode
+	{
+		int32_t x;
+		int32_t y;
+		int32_t width;
+	};
+
+	struct Page
+	{
+		Texture* texture = nullptr;
+		std::vector<SkylineNode> skyline;
+
+		//! rectangles which are freed including padding
+		std::vector<std::pair<Vec2I, Vec2I>> freeRects;
+
+		//! sizes including padding of rectangles which are not freed, keyed by positions including padding
+		std::unordered_map<uint64_t, Vec2I> allocatedRects;
+
+		std::vector<Color8> pixels;
+		Vec2I dirtyMin;
+		Vec2I dirtyMax;
+		bool isDirty = false;
+	};
+
+	Graphics* graphics_ = nullptr;
+	Vec2I pageSize_;
+	int32_t maxPageCount_ = 0;
+	int32_t padding_ = 0;
+
+	std::vector<Page> pages_;
+
+	bool AddPage();
+	bool AllocateFromFreeRects(Page& page, const Vec2I& size, Vec2I& position);
+	bool AllocateFromSkyline(Page& page, const Vec2I& size, Vec2I& position);
+	int32_t FitSkyline(const Page& page, int32_t index, const Vec2I& size) const;
+	void ResetPage(Page& page);
+
+	static uint64_t GetRectKey(const Vec2I& position)
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(position.X)) << 32) | static_cast<uint32_t>(position.Y);
+	}
+
+public:
+	TextureAtlas() = default;
+	virtual ~TextureAtlas();
+
+	/**
+		@param	graphics	graphics to create pages
+		@param	pageSize	the size of a page
+		@param	maxPageCount	the maximum number of pages
+		@param	padding	the number of pixels between rectangles to prevent bleeding with linear filtering
+	*/
+	bool Initialize(Graphics* graphics, const Vec2I& pageSize, int32_t maxPageCount = 8, int32_t padding = 1);
+
+	/**
+		@brief	allocate a rectangle
+		@param	size	the size of the rectangle
+		@param	region	an allocated rectangle
+		@return	false if there is no space
+	*/
+	bool Allocate(const Vec2I& size, TextureAtlasRegion& region);
+
+	/**
+		@brief	free a rectangle
+		@note
+		Pixels in the rectangle are kept until it is reused. A rectangle which is already freed is ignored.
+	*/
+	void Free(const TextureAtlasRegion& region);
+
+	/**
+		@brief	write pixels into a rectangle
+		@param	region	an allocated rectangle
+		@param	data	RGBA8 pixels whose size is the same as the rectangle
+	*/
+	void Update(const TextureAtlasRegion& region, const void* data);
+
+	/**
+		@brief	upload updated pixels
+		@note
+		A rectangle which contains updated pixels is uploaded in each page.
+		Call it before commands which use pages are executed.
+	*/
+	void Flush();
+
+	int32_t GetPageCount() const { return static_cast<int32_t>(pages_.size()); }
+
+	/**
+		@brief	get a texture of a page
+		@note
+		Don't release it.
+	*/
+	Texture* GetTexture(int32_t page) const { return pages_[page].texture; }
+
+	Vec2I GetPageSize() const { return pageSize_; }
+};
+
+} // namespace LLGI
@@ -81,9 +81,9 @@ void CommandList_Impl::SetScissor(int32_t x, int32_t y, int32_t width, int32_t h
 	[renderEncoder setScissorRect:rect];
 }
 
-void CommandList_Impl::SetVertexBuffer(Buffer_Impl* vertexBuffer, int32_t stride, int32_t offset)
+void CommandList_Impl::SetVertexBuffer(Buffer_Impl* vertexBuffer, int32_t stride, int32_t offset, int32_t slot)
 {
-	[renderEncoder setVertexBuffer:vertexBuffer->buffer offset:offset atIndex:0];
+	[renderEncoder setVertexBuffer:vertexBuffer->buffer offset:offset atIndex:GetVertexBufferIndexMetal(slot)];
 }
 
 CommandListMetal::CommandListMetal() { impl = new CommandList_Impl(); }
@@ -152,7 +152,7 @@ void CommandListMetal::SetScissor(int32_t x, int32_t y, int32_t width, int32_t h
 void CommandListMetal::Draw(int32_t pritimiveCount)
 {
 	BindingVertexBuffer vb_;
-	IndexBuffer* ib_ = nullptr;
+	BindingIndexBuffer ib_;
 	PipelineState* pip_ = nullptr;
 
 	bool isVBDirtied = false;
@@ -164,16 +164,21 @@ void CommandListMetal::Draw(int32_t pritimiveCount)
 	GetCurrentPipelineState(pip_, isPipDirtied);
 
 	assert(vb_.vertexBuffer != nullptr);
-	assert(ib_ != nullptr);
+	assert(ib_.indexBuffer != nullptr);
 	assert(pip_ != nullptr);
 
-	auto vb = static_cast<VertexBufferMetal*>(vb_.vertexBuffer);
-	auto ib = static_cast<IndexBufferMetal*>(ib_);
+	auto ib = static_cast<IndexBufferMetal*>(ib_.indexBuffer);
 	auto pip = static_cast<PipelineStateMetal*>(pip_);
 
-	if (isVBDirtied)
+	// assign vertex buffers
+	for (int32_t slot = 0; slot < NumVertexBufferSlot; slot++)
 	{
-		impl->SetVertexBuffer(vb->GetImpl(), vb_.stride, vb_.offset);
+		GetCurrentVertexBuffer(slot, vb_, isVBDirtied);
+		if (vb_.vertexBuffer == nullptr || !isVBDirtied)
+			continue;
+
+		auto vb = static_cast<VertexBufferMetal*>(vb_.vertexBuffer);
+		impl->SetVertexBuffer(vb->GetImpl(), vb_.stride, vb_.offset, slot);
 	}
 
 	// assign constant buffer
@@ -193,6 +198,29 @@ void CommandListMetal::Draw(int32_t pritimiveCount)
 		[impl->renderEncoder setFragmentBuffer:pcb_->GetImpl()->buffer offset:0 atIndex:1];
 	}
 
+	// assign push constants (buffer index 2)
+	for (int stage_ind = 0; stage_ind < (int32_t)ShaderStageType::Max; stage_ind++)
+	{
+		const void* data = nullptr;
+		int32_t size = 0;
+		bool isDirtied = false;
+		GetCurrentPushConstants(static_cast<ShaderStageType>(stage_ind), data, size, isDirtied);
+
+		size = std::min(size, pip->PushConstantSizes[stage_ind]);
+		if (size == 0 || !(isDirtied || isPipDirtied))
+			continue;
+
+		if (stage_ind == (int32_t)ShaderStageType::Vertex)
+		{
+			[impl->renderEncoder setVertexBytes:data length:size atIndex:2];
+		}
+
+		if (stage_ind == (int32_t)ShaderStageType::Pixel)
+		{
+			[impl->renderEncoder setFragmentBytes:data length:size atIndex:2];
+		}
+	}
+
 	// Assign textures
 	for (int stage_ind = 0; stage_ind < (int32_t)ShaderStageType::Max; stage_ind++)
 	{
@@ -248,7 +276,7 @@ void CommandListMetal::Draw(int32_t pritimiveCount)
 									indexCount:pritimiveCount * indexPerPrim
 									 indexType:indexType
 								   indexBuffer:ib->GetImpl()->buffer
-							 indexBufferOffset:0];
+							 indexBufferOffset:ib_.offset];
 }
 
 void CommandListMetal::BeginRenderPass(RenderPass* renderPass)
@@ -80,7 +80,7 @@ class GraphicsMetal : public Graphics
 	std::unordered_map<RenderPassPipelineStateMetalKey, std::weak_ptr<RenderPassPipelineStateMetal>, RenderPassPipelineStateMetalKey::Hash>
 		renderPassPipelineStates;
 
-	std::shared_ptr<RenderPassMetal> renderPass_ = nullptr;
+	Ref<RenderPassMetal> renderPass_;
 	std::function<GraphicsView()> getGraphicsView_;
 
 public:
@@ -147,7 +147,7 @@ bool GraphicsMetal::Initialize(std::function<GraphicsView()> getGraphicsView)
 		return false;
 	}
 
-	renderPass_ = std::make_shared<RenderPassMetal>(this, false);
+	renderPass_ = CreateRef(new RenderPassMetal(this, false));
 
 	return true;
 }
@@ -177,7 +177,7 @@ RenderPass* GraphicsMetal::GetCurrentScreen(const Color8& clearColor, bool isCol
 	renderPass_->SetIsColorCleared(isColorCleared);
 	renderPass_->SetIsDepthCleared(isDepthCleared);
     renderPass_->GetImpl()->UpdateTarget(impl);
-	return renderPass_.get();
+	return renderPass_.Get();
 }
 
 VertexBuffer* GraphicsMetal::CreateVertexBuffer(int32_t size)
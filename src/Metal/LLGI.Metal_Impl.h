@@ -11,6 +11,13 @@ namespace LLGI
 struct CommandList_Impl;
 struct Buffer_Impl;
 struct Texture_Impl;
+
+/**
+	@brief	a buffer index of a vertex buffer slot
+	@note
+	Indexes 1 and 2 are used by a constant buffer and push constants.
+*/
+inline int32_t GetVertexBufferIndexMetal(int32_t slot) { return slot == 0 ? 0 : slot + 2; }
     
 struct Graphics_Impl
 {
@@ -60,7 +67,7 @@ struct CommandList_Impl
 	void BeginRenderPass(RenderPass_Impl* renderPass);
 	void EndRenderPass();
 	void SetScissor(int32_t x, int32_t y, int32_t width, int32_t height);
-	void SetVertexBuffer(Buffer_Impl* vertexBuffer, int32_t stride, int32_t offset);
+	void SetVertexBuffer(Buffer_Impl* vertexBuffer, int32_t stride, int32_t offset, int32_t slot);
 };
 
 struct Shader_Impl
@@ -27,7 +27,7 @@ public:
 
 	std::array<Shader*, static_cast<int>(ShaderStageType::Max)> GetShaders() const { return shaders; }
 
-	RenderPassPipelineState* GetRenderPassPipelineState() const { return renderPassPipelineState_.get(); }
+	RenderPassPipelineState* GetRenderPassPipelineState() const { return renderPassPipelineState_.Get(); }
 
 	PipelineState_Impl* GetImpl() { return impl; }
 };
@@ -8,6 +8,45 @@
 namespace LLGI
 {
 
+static MTLVertexFormat ConvertVertexLayoutFormat(VertexLayoutFormat format)
+{
+	switch (format)
+	{
+	case VertexLayoutFormat::R32G32B32_FLOAT:
+		return MTLVertexFormatFloat3;
+	case VertexLayoutFormat::R32G32B32A32_FLOAT:
+		return MTLVertexFormatFloat4;
+	case VertexLayoutFormat::R8G8B8A8_UNORM:
+		return MTLVertexFormatUChar4Normalized;
+	case VertexLayoutFormat::R8G8B8A8_UINT:
+		return MTLVertexFormatUChar4;
+	case VertexLayoutFormat::R32G32_FLOAT:
+		return MTLVertexFormatFloat2;
+	case VertexLayoutFormat::R16G16_FLOAT:
+		return MTLVertexFormatHalf2;
+	case VertexLayoutFormat::R16G16B16A16_FLOAT:
+		return MTLVertexFormatHalf4;
+	case VertexLayoutFormat::R16G16_SNORM:
+		return MTLVertexFormatShort2Normalized;
+	case VertexLayoutFormat::R16G16B16A16_SNORM:
+		return MTLVertexFormatShort4Normalized;
+	case VertexLayoutFormat::R16G16_UNORM:
+		return MTLVertexFormatUShort2Normalized;
+	case VertexLayoutFormat::R16G16B16A16_UNORM:
+		return MTLVertexFormatUShort4Normalized;
+	case VertexLayoutFormat::R8G8B8A8_SNORM:
+		return MTLVertexFormatChar4Normalized;
+	case VertexLayoutFormat::R10G10B10A2_UNORM:
+		return MTLVertexFormatUInt1010102Normalized;
+	case VertexLayoutFormat::R16G16B16A16_UINT:
+		return MTLVertexFormatUShort4;
+	case VertexLayoutFormat::R32_UINT:
+		return MTLVertexFormatUInt;
+	}
+
+	return MTLVertexFormatInvalid;
+}
+
 PipelineState_Impl::PipelineState_Impl() {}
 
 PipelineState_Impl::~PipelineState_Impl()
@@ -40,50 +79,27 @@ void PipelineState_Impl::Compile(PipelineState* self, Graphics_Impl* graphics)
 	// vertex layout
 	MTLVertexDescriptor* vertexDescriptor = [MTLVertexDescriptor vertexDescriptor];
 
-	int vertexOffset = 0;
+	std::array<bool, NumVertexBufferSlot> isSlotUsed;
+	isSlotUsed.fill(false);
+
 	for (int i = 0; i < self_->VertexLayoutCount; i++)
 	{
-		vertexDescriptor.attributes[i].offset = vertexOffset;
-
-		if (self_->VertexLayouts[i] == VertexLayoutFormat::R32G32B32_FLOAT)
-		{
-			vertexDescriptor.attributes[i].format = MTLVertexFormatFloat3;
-			vertexDescriptor.attributes[i].bufferIndex = 0;
-			vertexOffset += sizeof(float) * 3;
-		}
-
-        if (self_->VertexLayouts[i] == VertexLayoutFormat::R32G32B32A32_FLOAT)
-        {
-            vertexDescriptor.attributes[i].format = MTLVertexFormatFloat4;
-            vertexDescriptor.attributes[i].bufferIndex = 0;
-            vertexOffset += sizeof(float) * 4;
-        }
-
-		if (self_->VertexLayouts[i] == VertexLayoutFormat::R32G32_FLOAT)
-		{
-			vertexDescriptor.attributes[i].format = MTLVertexFormatFloat2;
-			vertexDescriptor.attributes[i].bufferIndex = 0;
-			vertexOffset += sizeof(float) * 2;
-		}
-
-		if (self_->VertexLayouts[i] == VertexLayoutFormat::R8G8B8A8_UINT)
-		{
-			vertexDescriptor.attributes[i].format = MTLVertexFormatUChar4;
-			vertexDescriptor.attributes[i].bufferIndex = 0;
-			vertexOffset += sizeof(float);
-		}
-
-		if (self_->VertexLayouts[i] == VertexLayoutFormat::R8G8B8A8_UNORM)
-		{
-			vertexDescriptor.attributes[i].format = MTLVertexFormatUChar4Normalized;
-			vertexDescriptor.attributes[i].bufferIndex = 0;
-			vertexOffset += sizeof(float);
-		}
+		vertexDescriptor.attributes[i].offset = self_->GetVertexLayoutOffset(i);
+		vertexDescriptor.attributes[i].format = ConvertVertexLayoutFormat(self_->VertexLayouts[i]);
+		vertexDescriptor.attributes[i].bufferIndex = GetVertexBufferIndexMetal(self_->VertexLayoutSlots[i]);
+		isSlotUsed[self_->VertexLayoutSlots[i]] = true;
 	}
 
-	vertexDescriptor.layouts[0].stepRate = 1;
-	vertexDescriptor.layouts[0].stepFunction = MTLVertexStepFunctionPerVertex;
-	vertexDescriptor.layouts[0].stride = vertexOffset;
+	for (int slot = 0; slot < NumVertexBufferSlot; slot++)
+	{
+		if (!isSlotUsed[slot])
+			continue;
+
+		auto index = GetVertexBufferIndexMetal(slot);
+		vertexDescriptor.layouts[index].stepRate = 1;
+		vertexDescriptor.layouts[index].stepFunction = MTLVertexStepFunctionPerVertex;
+		vertexDescriptor.layouts[index].stride = self_->GetVertexStride(slot);
+	}
 
 	pipelineStateDescriptor.vertexDescriptor = vertexDescriptor;
 
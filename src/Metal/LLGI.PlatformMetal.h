@@ -15,7 +15,8 @@ class PlatformMetal : public Platform
 public:
 	PlatformMetal();
 	~PlatformMetal();
-	bool NewFrame() override;
+	bool ProcessEvents() override;
+	bool AcquireScreen() override;
 	void Present() override;
 	Graphics* CreateGraphics() override;
     
@@ -138,7 +138,7 @@ struct PlatformMetal_Impl
 		pool = [[NSAutoreleasePool alloc] init];
 	}
 
-	bool newFrame()
+	bool processEvents()
 	{
 		for (;;)
 		{
@@ -154,13 +154,12 @@ struct PlatformMetal_Impl
 
 		gc();
 
-		if (!window.isVisible)
-		{
-			return false;
-		}
+		return window.isVisible;
+	}
 
+	bool acquireScreen()
+	{
 		drawable = layer.nextDrawable;
-
 		return true;
 	}
 
@@ -181,7 +180,9 @@ PlatformMetal::PlatformMetal()
 
 PlatformMetal::~PlatformMetal() { delete impl; }
 
-bool PlatformMetal::NewFrame() { return impl->newFrame(); }
+bool PlatformMetal::ProcessEvents() { return impl->processEvents(); }
+
+bool PlatformMetal::AcquireScreen() { return impl->acquireScreen(); }
 
 void PlatformMetal::Present() { impl->preset(); }
 
@@ -4,10 +4,12 @@
 namespace LLGI
 {
 
-Buffer::Buffer(GraphicsVulkan* graphics)
+Buffer::Buffer(GraphicsVulkan* graphics, bool isStrongRef) : graphics_(graphics), isStrongRef_(isStrongRef)
 {
-	SafeAddRef(graphics);
-	graphics_ = CreateSharedPtr(graphics);
+	if (isStrongRef_)
+	{
+		SafeAddRef(graphics_);
+	}
 }
 
 Buffer::~Buffer()
@@ -18,6 +20,11 @@ Buffer::~Buffer()
 		graphics_->GetDevice().freeMemory(devMem);
 		buffer = nullptr;
 	}
+
+	if (isStrongRef_)
+	{
+		SafeRelease(graphics_);
+	}
 }
 
 void SetImageLayout(vk::CommandBuffer cmdbuffer,
@@ -19,13 +19,17 @@ class PipelineStateVulkan;
 
 class Buffer
 {
-	std::shared_ptr<GraphicsVulkan> graphics_;
+	GraphicsVulkan* graphics_ = nullptr;
+	bool isStrongRef_ = false;
 
 public:
 	vk::Buffer buffer;
 	vk::DeviceMemory devMem;
 
-	Buffer(GraphicsVulkan* graphics);
+	/**
+		@param	isStrongRef	whether to hold a reference of graphics. It is false when graphics owns this buffer.
+	*/
+	Buffer(GraphicsVulkan* graphics, bool isStrongRef = true);
 	virtual ~Buffer();
 };
 
@@ -3,97 +3,217 @@
 #include "LLGI.GraphicsVulkan.h"
 #include "LLGI.IndexBufferVulkan.h"
 #include "LLGI.PipelineStateVulkan.h"
+#include "LLGI.StorageBufferVulkan.h"
 #include "LLGI.TextureVulkan.h"
 #include "LLGI.VertexBufferVulkan.h"
 
 namespace LLGI
 {
 
-DescriptorPoolVulkan::DescriptorPoolVulkan(std::shared_ptr<GraphicsVulkan> graphics, int32_t size, int stage)
-	: graphics_(graphics), size_(size), stage_(stage)
+DescriptorPoolVulkan::DescriptorPoolVulkan(Ref<GraphicsVulkan> graphics, int32_t size, int stage)
+	: graphics_(std::move(graphics)), size_(size), stage_(stage)
+{
+	descriptorPools_.push_back(CreatePool());
+}
+
+DescriptorPoolVulkan ::~DescriptorPoolVulkan()
+{
+	for (auto& descriptorPool : descriptorPools_)
+	{
+		graphics_->GetDevice().destroyDescriptorPool(descriptorPool);
+	}
+	descriptorPools_.clear();
+}
+
+vk::DescriptorPool DescriptorPoolVulkan::CreatePool()
 {
 	std::array<vk::DescriptorPoolSize, 3> poolSizes;
 	poolSizes[0].type = vk::DescriptorType::eUniformBufferDynamic;
-	poolSizes[0].descriptorCount = size * stage;
+	poolSizes[0].descriptorCount = size_ * stage_;
 	poolSizes[1].type = vk::DescriptorType::eCombinedImageSampler;
-	poolSizes[1].descriptorCount = size * stage;
+	poolSizes[1].descriptorCount = size_ * stage_;
+	poolSizes[2].type = vk::DescriptorType::eStorageBuffer;
+	poolSizes[2].descriptorCount = size_ * stage_;
 
 	vk::DescriptorPoolCreateInfo poolInfo;
-	poolInfo.poolSizeCount = 2;
+	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
 	poolInfo.pPoolSizes = poolSizes.data();
-	poolInfo.maxSets = size * stage;
+	poolInfo.maxSets = size_ * stage_;
 
-	descriptorPool = graphics_->GetDevice().createDescriptorPool(poolInfo);
+	return graphics_->GetDevice().createDescriptorPool(poolInfo);
 }
 
-DescriptorPoolVulkan ::~DescriptorPoolVulkan()
+bool DescriptorPoolVulkan::Get(PipelineStateVulkan* pip, vk::DescriptorSet* descriptorSets)
 {
-	if (descriptorPool != nullptr)
+	// a set for bindless textures is not allocated from this pool
+	auto setCount = pip->GetDescriptorSetLayout().size();
+	if (pip->GetBindlessSetIndex() >= 0)
 	{
-		graphics_->GetDevice().destroyDescriptorPool(descriptorPool);
-		descriptorPool = nullptr;
+		setCount--;
 	}
-}
 
-const std::vector<vk::DescriptorSet>& DescriptorPoolVulkan::Get(PipelineStateVulkan* pip)
-{
-	if (cache.size() < static_cast<size_t>(offset))
+	// sets are written into given memory directly instead of a vector which is returned
+	if (setCount > 0)
 	{
-		offset++;
-		return cache[offset - 1];
+		vk::DescriptorSetAllocateInfo allocateInfo;
+		allocateInfo.descriptorSetCount = static_cast<uint32_t>(setCount);
+		allocateInfo.pSetLayouts = (pip->GetDescriptorSetLayout().data());
+
+		auto isPoolEmpty = false;
+		while (true)
+		{
+			allocateInfo.descriptorPool = descriptorPools_[currentPoolIndex_];
+			auto result = graphics_->GetDevice().allocateDescriptorSets(&allocateInfo, descriptorSets);
+			if (result == vk::Result::eSuccess)
+			{
+				break;
+			}
+
+			// a pool is full, so sets are allocated from a next pool. Sets which don't fit into an empty pool are not retried.
+			auto isFull = result == vk::Result::eErrorOutOfPoolMemory || result == vk::Result::eErrorFragmentedPool;
+			if (!isFull || isPoolEmpty)
+			{
+				return false;
+			}
+
+			currentPoolIndex_++;
+			isPoolEmpty = currentPoolIndex_ == descriptorPools_.size();
+			if (isPoolEmpty)
+			{
+				descriptorPools_.push_back(CreatePool());
+			}
+		}
 	}
 
-	// TODO : improve it
-	vk::DescriptorSetAllocateInfo allocateInfo;
-	allocateInfo.descriptorPool = descriptorPool;
-	allocateInfo.descriptorSetCount = 2;
-	allocateInfo.pSetLayouts = (pip->GetDescriptorSetLayout().data());
+	if (pip->GetBindlessSetIndex() >= 0)
+	{
+		descriptorSets[setCount] = graphics_->GetBindlessDescriptorSet();
+	}
 
-	std::vector<vk::DescriptorSet> descriptorSets = graphics_->GetDevice().allocateDescriptorSets(allocateInfo);
-	cache.push_back(descriptorSets);
-	offset++;
-	return cache[offset - 1];
+	return true;
 }
 
-void DescriptorPoolVulkan::Reset() { offset = 0; }
+void DescriptorPoolVulkan::Reset()
+{
+	// sets which were allocated in a previous frame are returned to the pools at once
+	for (auto& descriptorPool : descriptorPools_)
+	{
+		graphics_->GetDevice().resetDescriptorPool(descriptorPool);
+	}
+	currentPoolIndex_ = 0;
+}
 
 CommandListVulkan::CommandListVulkan() {}
 
 CommandListVulkan::~CommandListVulkan()
 {
+	// buffers are freed with the pool
 	commandBuffers.clear();
+	if (commandPool_ != nullptr)
+	{
+		graphics_->GetDevice().destroyCommandPool(commandPool_);
+		commandPool_ = nullptr;
+	}
 
 	descriptorPools.clear();
 }
 
-bool CommandListVulkan::Initialize(GraphicsVulkan* graphics)
+bool CommandListVulkan::CreateCommandPool(uint32_t queueFamilyIndex)
+{
+	vk::CommandPoolCreateInfo poolInfo;
+	poolInfo.queueFamilyIndex = queueFamilyIndex;
+	poolInfo.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+	commandPool_ = graphics_->GetDevice().createCommandPool(poolInfo);
+	return commandPool_ != nullptr;
+}
+
+bool CommandListVulkan::Initialize(GraphicsVulkan* graphics, bool isCompute)
 {
 	SafeAddRef(graphics);
-	graphics_ = CreateSharedPtr(graphics);
+	graphics_ = CreateRef(graphics);
+	isCompute_ = isCompute;
+
+	if (!CreateCommandPool(isCompute_ ? graphics->GetComputeQueueFamilyIndex() : graphics->GetQueueFamilyIndex()))
+	{
+		return false;
+	}
 
 	vk::CommandBufferAllocateInfo allocInfo;
-	allocInfo.commandPool = graphics->GetCommandPool();
+	allocInfo.commandPool = commandPool_;
 	allocInfo.commandBufferCount = graphics->GetSwapBufferCount();
 	commandBuffers = graphics->GetDevice().allocateCommandBuffers(allocInfo);
 
 	for (size_t i = 0; i < static_cast<size_t>(graphics_->GetSwapBufferCount()); i++)
 	{
-		auto dp = std::make_shared<DescriptorPoolVulkan>(graphics_, 10000, 2);
-		descriptorPools.push_back(dp);
+		descriptorPools.push_back(CreateRef(new DescriptorPoolVulkan(graphics_, 10000, 2)));
 	}
 
 	return true;
 }
 
+bool CommandListVulkan::InitializeAsBundle(GraphicsVulkan* graphics,
+										   RenderPassPipelineStateVulkan* renderPassPipelineState,
+										   const Vec2I& viewportSize)
+{
+	SafeAddRef(graphics);
+	graphics_ = CreateRef(graphics);
+
+	SafeAddRef(renderPassPipelineState);
+	bundleRenderPassPipelineState_ = CreateRef(renderPassPipelineState);
+	bundleViewportSize_ = viewportSize;
+	isBundle_ = true;
+
+	if (!CreateCommandPool(graphics->GetQueueFamilyIndex()))
+	{
+		return false;
+	}
+
+	// a bundle is executed in any frame, so it has a buffer and sets which are kept until it is recorded again
+	vk::CommandBufferAllocateInfo allocInfo;
+	allocInfo.commandPool = commandPool_;
+	allocInfo.level = vk::CommandBufferLevel::eSecondary;
+	allocInfo.commandBufferCount = 1;
+	commandBuffers = graphics->GetDevice().allocateCommandBuffers(allocInfo);
+
+	descriptorPools.push_back(CreateRef(new DescriptorPoolVulkan(graphics_, 10000, 2)));
+
+	return true;
+}
+
+int32_t CommandListVulkan::GetCurrentBufferIndex() const { return isBundle_ ? 0 : graphics_->GetCurrentSwapBufferIndex(); }
+
 void CommandListVulkan::Begin()
 {
-	auto& cmdBuffer = commandBuffers[graphics_->GetCurrentSwapBufferIndex()];
+	auto& cmdBuffer = commandBuffers[GetCurrentBufferIndex()];
 
 	cmdBuffer.reset(vk::CommandBufferResetFlagBits::eReleaseResources);
-	vk::CommandBufferBeginInfo cmdBufInfo;
-	cmdBuffer.begin(cmdBufInfo);
 
-	auto& dp = descriptorPools[graphics_->GetCurrentSwapBufferIndex()];
+	if (isBundle_)
+	{
+		vk::CommandBufferInheritanceInfo inheritanceInfo;
+		inheritanceInfo.renderPass = bundleRenderPassPipelineState_->GetRenderPass();
+		inheritanceInfo.subpass = 0;
+
+		vk::CommandBufferBeginInfo cmdBufInfo;
+		cmdBufInfo.flags = vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eSimultaneousUse;
+		cmdBufInfo.pInheritanceInfo = &inheritanceInfo;
+		cmdBuffer.begin(cmdBufInfo);
+
+		// dynamic states are not inherited from a primary command buffer
+		vk::Viewport viewport =
+			vk::Viewport(0.0f, 0.0f, static_cast<float>(bundleViewportSize_.X), static_cast<float>(bundleViewportSize_.Y), 0.0f, 1.0f);
+		cmdBuffer.setViewport(0, viewport);
+
+		vk::Rect2D scissor = vk::Rect2D(vk::Offset2D(), vk::Extent2D(bundleViewportSize_.X, bundleViewportSize_.Y));
+		cmdBuffer.setScissor(0, scissor);
+	}
+	else
+	{
+		vk::CommandBufferBeginInfo cmdBufInfo;
+		cmdBuffer.begin(cmdBufInfo);
+	}
+
+	auto& dp = descriptorPools[GetCurrentBufferIndex()];
 	dp->Reset();
 
 	CommandList::Begin();
@@ -101,13 +221,15 @@ void CommandListVulkan::Begin()
 
 void CommandListVulkan::End()
 {
-	auto& cmdBuffer = commandBuffers[graphics_->GetCurrentSwapBufferIndex()];
+	auto& cmdBuffer = commandBuffers[GetCurrentBufferIndex()];
 	cmdBuffer.end();
 }
 
 void CommandListVulkan::SetScissor(int32_t x, int32_t y, int32_t width, int32_t height)
 {
-	auto& cmdBuffer = commandBuffers[graphics_->GetCurrentSwapBufferIndex()];
+	BeginCurrentRenderPass(vk::SubpassContents::eInline);
+
+	auto& cmdBuffer = commandBuffers[GetCurrentBufferIndex()];
 
 	vk::Rect2D scissor = vk::Rect2D(vk::Offset2D(x, y), vk::Extent2D(width, height));
 	cmdBuffer.setScissor(0, scissor);
@@ -115,39 +237,45 @@ void CommandListVulkan::SetScissor(int32_t x, int32_t y, int32_t width, int32_t
 
 void CommandListVulkan::Draw(int32_t pritimiveCount)
 {
-	BindingVertexBuffer vb_;
-	IndexBuffer* ib_ = nullptr;
+	BindingIndexBuffer ib_;
 	PipelineState* pip_ = nullptr;
 
-	bool isVBDirtied = false;
 	bool isIBDirtied = false;
 	bool isPipDirtied = false;
 
-	GetCurrentVertexBuffer(vb_, isVBDirtied);
 	GetCurrentIndexBuffer(ib_, isIBDirtied);
 	GetCurrentPipelineState(pip_, isPipDirtied);
 
-	assert(vb_.vertexBuffer != nullptr);
-	assert(ib_ != nullptr);
+	assert(ib_.indexBuffer != nullptr);
 	assert(pip_ != nullptr);
 
-	auto vb = static_cast<VertexBufferVulkan*>(vb_.vertexBuffer);
-	auto ib = static_cast<IndexBufferVulkan*>(ib_);
+	auto ib = static_cast<IndexBufferVulkan*>(ib_.indexBuffer);
 	auto pip = static_cast<PipelineStateVulkan*>(pip_);
 
-	auto& cmdBuffer = commandBuffers[graphics_->GetCurrentSwapBufferIndex()];
+	BeginCurrentRenderPass(vk::SubpassContents::eInline);
+
+	auto& cmdBuffer = commandBuffers[GetCurrentBufferIndex()];
 
-	// assign a vertex buffer
-	if (isVBDirtied)
+	// assign vertex buffers
+	for (int32_t slot = 0; slot < NumVertexBufferSlot; slot++)
 	{
+		BindingVertexBuffer vb_;
+		bool isVBDirtied = false;
+		GetCurrentVertexBuffer(slot, vb_, isVBDirtied);
+
+		assert(slot != 0 || vb_.vertexBuffer != nullptr);
+		if (vb_.vertexBuffer == nullptr || !isVBDirtied)
+			continue;
+
+		auto vb = static_cast<VertexBufferVulkan*>(vb_.vertexBuffer);
 		vk::DeviceSize vertexOffsets = vb_.offset;
-		cmdBuffer.bindVertexBuffers(0, 1, &(vb->GetBuffer()), &vertexOffsets);
+		cmdBuffer.bindVertexBuffers(slot, 1, &(vb->GetBuffer()), &vertexOffsets);
 	}
 
 	// assign an index vuffer
 	if (isIBDirtied)
 	{
-		vk::DeviceSize indexOffset = 0;
+		vk::DeviceSize indexOffset = ib_.offset;
 		vk::IndexType indexType = vk::IndexType::eUint16;
 
 		if (ib->GetStride() == 2)
@@ -158,173 +286,318 @@ void CommandListVulkan::Draw(int32_t pritimiveCount)
 		cmdBuffer.bindIndexBuffer(ib->GetBuffer(), indexOffset, indexType);
 	}
 
-	auto& dp = descriptorPools[graphics_->GetCurrentSwapBufferIndex()];
+	// states are kept dirty, so they are bound by a next draw
+	if (!BindDescriptorSets(pip, isPipDirtied, vk::PipelineBindPoint::eGraphics))
+	{
+		return;
+	}
 
-	std::vector<vk::DescriptorSet> descriptorSets = dp->Get(pip);
-	/*
-	vk::DescriptorSetAllocateInfo allocateInfo;
-	allocateInfo.descriptorPool = descriptorPool;
-	allocateInfo.descriptorSetCount = 2;
-	allocateInfo.pSetLayouts = (pip->GetDescriptorSetLayout().data());
+	// assign a pipeline
+	if (isPipDirtied)
+	{
+		cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pip->GetPipeline());
+	}
 
-	std::vector<vk::DescriptorSet> descriptorSets = graphics_->GetDevice().allocateDescriptorSets(allocateInfo);
-	*/
+	PushConstants(pip, isPipDirtied);
 
-	std::array<vk::WriteDescriptorSet, 16> writeDescriptorSets;
-	int writeDescriptorIndex = 0;
+	// draw
+	int indexPerPrim = 0;
+	if (pip->Topology == TopologyType::Triangle)
+		indexPerPrim = 3;
+	if (pip->Topology == TopologyType::Line)
+		indexPerPrim = 2;
 
-	std::array<vk::DescriptorBufferInfo, 16> descriptorBufferInfos;
-	int descriptorBufferIndex = 0;
+	cmdBuffer.drawIndexed(indexPerPrim * pritimiveCount, 1, 0, 0, 0);
 
-	std::array<vk::DescriptorImageInfo, 16> descriptorImageInfos;
-	int descriptorImageIndex = 0;
+	CommandList::Draw(pritimiveCount);
+}
 
-	std::array<bool, static_cast<int>(ShaderStageType::Max)> stages;
-	stages.fill(false);
+bool CommandListVulkan::BindDescriptorSets(PipelineStateVulkan* pip, bool isPipDirtied, vk::PipelineBindPoint bindPoint)
+{
+	auto& cmdBuffer = commandBuffers[GetCurrentBufferIndex()];
+
+	auto& dp = descriptorPools[GetCurrentBufferIndex()];
+
+	// when only bindless textures are used, a set is bound when a pipeline is changed
+	auto hasOwnedSets = pip->GetDescriptorSetLayout().size() > (pip->GetBindlessSetIndex() >= 0 ? 1 : 0);
 
-	ConstantBuffer* vcb = nullptr;
-	GetCurrentConstantBuffer(ShaderStageType::Vertex, vcb);
-	if (vcb != nullptr)
+	if (hasOwnedSets || (pip->GetBindlessSetIndex() >= 0 && isPipDirtied))
 	{
-		stages[0] = true;
+		auto descriptorSetCount = static_cast<uint32_t>(pip->GetDescriptorSetLayout().size());
+		auto descriptorSets = GetFrameAllocator().Allocate<vk::DescriptorSet>(descriptorSetCount);
+		if (!dp->Get(pip, descriptorSets))
+		{
+			return false;
+		}
 
-		descriptorBufferInfos[descriptorBufferIndex].buffer = (static_cast<ConstantBufferVulkan*>(vcb)->GetBuffer());
-		descriptorBufferInfos[descriptorBufferIndex].offset = 0;
-		descriptorBufferInfos[descriptorBufferIndex].range = vcb->GetSize();
+		const int32_t stageCount = static_cast<int32_t>(ShaderStageType::Max);
 
-		vk::WriteDescriptorSet desc;
-		desc.descriptorType = vk::DescriptorType::eUniformBufferDynamic;
-		desc.dstSet = descriptorSets[0];
-		desc.dstBinding = 0;
-		desc.dstArrayElement = 0;
-		desc.pBufferInfo = &(descriptorBufferInfos[descriptorBufferIndex]);
-		desc.descriptorCount = 1;
+		std::array<vk::WriteDescriptorSet, stageCount * (NumTexture + NumStorageBuffer + 1)> writeDescriptorSets;
+		int writeDescriptorIndex = 0;
 
-		writeDescriptorSets[writeDescriptorIndex] = desc;
+		std::array<vk::DescriptorBufferInfo, stageCount * (NumStorageBuffer + 1)> descriptorBufferInfos;
+		int descriptorBufferIndex = 0;
 
-		descriptorBufferIndex++;
-		writeDescriptorIndex++;
-	}
+		std::array<vk::DescriptorImageInfo, stageCount * NumTexture> descriptorImageInfos;
+		int descriptorImageIndex = 0;
 
-	ConstantBuffer* pcb = nullptr;
-	GetCurrentConstantBuffer(ShaderStageType::Pixel, pcb);
-	if (pcb != nullptr)
-	{
-		stages[1] = true;
-
-		descriptorBufferInfos[descriptorBufferIndex].buffer = (static_cast<ConstantBufferVulkan*>(pcb)->GetBuffer());
-		descriptorBufferInfos[descriptorBufferIndex].offset = 0;
-		descriptorBufferInfos[descriptorBufferIndex].range = pcb->GetSize();
-		vk::WriteDescriptorSet desc;
-		desc.descriptorType = vk::DescriptorType::eUniformBufferDynamic;
-		desc.dstSet = descriptorSets[1];
-		desc.dstBinding = 0;
-		desc.dstArrayElement = 0;
-		desc.pBufferInfo = &(descriptorBufferInfos[descriptorBufferIndex]);
-		desc.descriptorCount = 1;
-
-		writeDescriptorSets[writeDescriptorIndex] = desc;
-
-		descriptorBufferIndex++;
-		writeDescriptorIndex++;
-	}
+		const auto& bindings = pip->GetDescriptorBindings();
+		auto isWritten = GetFrameAllocator().Allocate<bool>(bindings.size());
 
-	// Assign textures
-	for (int stage_ind = 0; stage_ind < (int32_t)ShaderStageType::Max; stage_ind++)
-	{
-		for (int unit_ind = 0; unit_ind < currentTextures[stage_ind].size(); unit_ind++)
+		// assign constant buffers to bindings which are used by shaders
+		for (int stage_ind = 0; stage_ind < (int32_t)ShaderStageType::Max; stage_ind++)
 		{
-			if (currentTextures[stage_ind][unit_ind].texture == nullptr)
+			const auto& location = pip->GetConstantBufferLocation(static_cast<ShaderStageType>(stage_ind));
+			if (!location.IsValid())
 				continue;
 
-			stages[stage_ind] = true;
-
-			auto texture = (TextureVulkan*)currentTextures[stage_ind][unit_ind].texture;
-			auto wm = (int32_t)currentTextures[stage_ind][unit_ind].wrapMode;
-			auto mm = (int32_t)currentTextures[stage_ind][unit_ind].minMagFilter;
+			ConstantBuffer* cb = nullptr;
+			GetCurrentConstantBuffer(static_cast<ShaderStageType>(stage_ind), cb);
+			if (cb == nullptr)
+				continue;
 
-			vk::DescriptorImageInfo imageInfo;
-			imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-			imageInfo.imageView = texture->GetView();
-			imageInfo.sampler = graphics_->GetDefaultSampler();
-			descriptorImageInfos[descriptorImageIndex] = imageInfo;
+			descriptorBufferInfos[descriptorBufferIndex].buffer = (static_cast<ConstantBufferVulkan*>(cb)->GetBuffer());
+			descriptorBufferInfos[descriptorBufferIndex].offset = 0;
+			descriptorBufferInfos[descriptorBufferIndex].range = cb->GetSize();
 
 			vk::WriteDescriptorSet desc;
-			desc.dstSet = descriptorSets[stage_ind];
-			desc.dstBinding = unit_ind + 1;
+			desc.descriptorType = vk::DescriptorType::eUniformBufferDynamic;
+			desc.dstSet = descriptorSets[location.set];
+			desc.dstBinding = location.binding;
 			desc.dstArrayElement = 0;
-			desc.pImageInfo = &descriptorImageInfos[descriptorImageIndex];
+			desc.pBufferInfo = &(descriptorBufferInfos[descriptorBufferIndex]);
 			desc.descriptorCount = 1;
-			desc.descriptorType = vk::DescriptorType::eCombinedImageSampler;
 
 			writeDescriptorSets[writeDescriptorIndex] = desc;
+			isWritten[location.index] = true;
 
-			descriptorImageIndex++;
+			descriptorBufferIndex++;
 			writeDescriptorIndex++;
 		}
-	}
 
-	graphics_->GetDevice().updateDescriptorSets(writeDescriptorIndex, writeDescriptorSets.data(), 0, nullptr);
+		// Assign textures
+		for (int stage_ind = 0; stage_ind < (int32_t)ShaderStageType::Max; stage_ind++)
+		{
+			for (int unit_ind = 0; unit_ind < currentTextures[stage_ind].size(); unit_ind++)
+			{
+				if (currentTextures[stage_ind][unit_ind].texture == nullptr)
+					continue;
+
+				const auto& location = pip->GetTextureLocation(static_cast<ShaderStageType>(stage_ind), unit_ind);
+				if (!location.IsValid())
+					continue;
+
+				auto texture = (TextureVulkan*)currentTextures[stage_ind][unit_ind].texture;
+				auto wrapMode = currentTextures[stage_ind][unit_ind].wrapMode;
+				auto minMagFilter = currentTextures[stage_ind][unit_ind].minMagFilter;
+
+				vk::DescriptorImageInfo imageInfo;
+				imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+				imageInfo.imageView = texture->GetView();
+				// streamed textures are not sampled at levels which are not uploaded yet
+				auto minLod = static_cast<float>((std::min)(texture->GetResidentMipMap(), texture->GetMipMapCount() - 1));
+				imageInfo.sampler = graphics_->GetSampler(wrapMode, minMagFilter, minLod);
+				descriptorImageInfos[descriptorImageIndex] = imageInfo;
+
+				vk::WriteDescriptorSet desc;
+				desc.dstSet = descriptorSets[location.set];
+				desc.dstBinding = location.binding;
+				desc.dstArrayElement = 0;
+				desc.pImageInfo = &descriptorImageInfos[descriptorImageIndex];
+				desc.descriptorCount = 1;
+				desc.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+
+				writeDescriptorSets[writeDescriptorIndex] = desc;
+				isWritten[location.index] = true;
+
+				descriptorImageIndex++;
+				writeDescriptorIndex++;
+			}
+		}
 
-	std::array<vk::DescriptorSet, static_cast<int>(ShaderStageType::Max)> descriptorSets_;
-	std::array<uint32_t, static_cast<int>(ShaderStageType::Max)> offsets_;
-	int descriptorIndex = 0;
-	int firstSet = -1;
+		// assign storage buffers
+		for (int stage_ind = 0; stage_ind < (int32_t)ShaderStageType::Max; stage_ind++)
+		{
+			for (int unit_ind = 0; unit_ind < NumStorageBuffer; unit_ind++)
+			{
+				if (currentStorageBuffers[stage_ind][unit_ind] == nullptr)
+					continue;
+
+				const auto& location = pip->GetStorageBufferLocation(static_cast<ShaderStageType>(stage_ind), unit_ind);
+				if (!location.IsValid())
+					continue;
+
+				auto sb = static_cast<StorageBufferVulkan*>(currentStorageBuffers[stage_ind][unit_ind]);
+
+				descriptorBufferInfos[descriptorBufferIndex].buffer = sb->GetBuffer();
+				descriptorBufferInfos[descriptorBufferIndex].offset = 0;
+				descriptorBufferInfos[descriptorBufferIndex].range = sb->GetSize();
+
+				vk::WriteDescriptorSet desc;
+				desc.descriptorType = vk::DescriptorType::eStorageBuffer;
+				desc.dstSet = descriptorSets[location.set];
+				desc.dstBinding = location.binding;
+				desc.dstArrayElement = 0;
+				desc.pBufferInfo = &(descriptorBufferInfos[descriptorBufferIndex]);
+				desc.descriptorCount = 1;
+
+				writeDescriptorSets[writeDescriptorIndex] = desc;
+				isWritten[location.index] = true;
+
+				descriptorBufferIndex++;
+				writeDescriptorIndex++;
+			}
+		}
 
-	for (int i = 0; i < static_cast<int>(ShaderStageType::Max); i++)
-	{
-		if (!stages[i])
-			continue;
+		// bindings which are not bound refer default resources because all bindings of a set must be valid
+		auto defaultWriteDescriptorSets = GetFrameAllocator().Allocate<vk::WriteDescriptorSet>(bindings.size());
+		int defaultWriteDescriptorIndex = 0;
 
-		descriptorSets_[descriptorIndex] = descriptorSets[i];
-		offsets_[descriptorIndex] = 0;
+		for (size_t i = 0; i < bindings.size(); i++)
+		{
+			const auto& binding = bindings[i];
+
+			// elements of an array except the first are not bound by resources
+			if (isWritten[i] && binding.count == 1)
+				continue;
+
+			vk::WriteDescriptorSet desc;
+			desc.descriptorType = binding.type;
+			desc.dstSet = descriptorSets[binding.set];
+			desc.dstBinding = binding.binding;
+			desc.dstArrayElement = 0;
+			desc.descriptorCount = binding.count;
+
+			if (binding.type == vk::DescriptorType::eCombinedImageSampler)
+			{
+				auto imageInfos = GetFrameAllocator().Allocate<vk::DescriptorImageInfo>(binding.count);
+				for (int32_t j = 0; j < binding.count; j++)
+				{
+					imageInfos[j].imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+					imageInfos[j].imageView = graphics_->GetDefaultImageView();
+					imageInfos[j].sampler = graphics_->GetDefaultSampler();
+				}
+				desc.pImageInfo = imageInfos;
+			}
+			else
+			{
+				auto bufferInfos = GetFrameAllocator().Allocate<vk::DescriptorBufferInfo>(binding.count);
+				for (int32_t j = 0; j < binding.count; j++)
+				{
+					bufferInfos[j].buffer = graphics_->GetDefaultBuffer();
+					bufferInfos[j].offset = 0;
+					bufferInfos[j].range = GraphicsVulkan::DefaultBufferSize;
+				}
+				desc.pBufferInfo = bufferInfos;
+			}
+
+			defaultWriteDescriptorSets[defaultWriteDescriptorIndex] = desc;
+			defaultWriteDescriptorIndex++;
+		}
 
-		if (firstSet < 0)
+		// writes are applied in order, so resources which are bound overwrite default resources
+		if (defaultWriteDescriptorIndex > 0)
 		{
-			firstSet = i;
+			graphics_->GetDevice().updateDescriptorSets(defaultWriteDescriptorIndex, defaultWriteDescriptorSets, 0, nullptr);
 		}
 
-		descriptorIndex++;
+		if (writeDescriptorIndex > 0)
+		{
+			graphics_->GetDevice().updateDescriptorSets(writeDescriptorIndex, writeDescriptorSets.data(), 0, nullptr);
+		}
+
+		cmdBuffer.bindDescriptorSets(bindPoint,
+									 pip->GetPipelineLayout(),
+									 0,
+									 descriptorSetCount,
+									 descriptorSets,
+									 static_cast<uint32_t>(pip->GetDynamicOffsets().size()),
+									 pip->GetDynamicOffsets().data());
+	}
+
+	return true;
+}
+
+void CommandListVulkan::PushConstants(PipelineStateVulkan* pip, bool isPipDirtied)
+{
+	auto& cmdBuffer = commandBuffers[GetCurrentBufferIndex()];
+
+	for (int stage_ind = 0; stage_ind < (int32_t)ShaderStageType::Max; stage_ind++)
+	{
+		const void* data = nullptr;
+		int32_t size = 0;
+		bool isDirtied = false;
+		GetCurrentPushConstants(static_cast<ShaderStageType>(stage_ind), data, size, isDirtied);
+
+		size = (std::min)(size, pip->PushConstantSizes[stage_ind]);
+		if (size == 0 || !(isDirtied || isPipDirtied))
+			continue;
+
+		auto stage = static_cast<ShaderStageType>(stage_ind);
+		cmdBuffer.pushConstants(
+			pip->GetPipelineLayout(), PipelineStateVulkan::GetShaderStageFlag(stage), pip->GetPushConstantOffset(stage), size, data);
 	}
+}
 
-	if (firstSet >= 0)
+void CommandListVulkan::Dispatch(int32_t x, int32_t y, int32_t z)
+{
+	PipelineState* pip_ = nullptr;
+	bool isPipDirtied = false;
+	GetCurrentPipelineState(pip_, isPipDirtied);
+
+	assert(pip_ != nullptr);
+	assert(currentRenderPass_ == nullptr);
+
+	auto pip = static_cast<PipelineStateVulkan*>(pip_);
+	assert(pip->IsCompute());
+
+	auto& cmdBuffer = commandBuffers[GetCurrentBufferIndex()];
+
+	if (!BindDescriptorSets(pip, isPipDirtied, vk::PipelineBindPoint::eCompute))
 	{
-		cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
-									 pip->GetPipelineLayout(),
-									 firstSet,
-									 descriptorIndex,
-									 descriptorSets_.data(),
-									 descriptorIndex,
-									 offsets_.data());
+		return;
 	}
 
-	// assign a pipeline
 	if (isPipDirtied)
 	{
-		cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pip->GetPipeline());
+		cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, pip->GetPipeline());
 	}
 
-	// draw
-	int indexPerPrim = 0;
-	if (pip->Topology == TopologyType::Triangle)
-		indexPerPrim = 3;
-	if (pip->Topology == TopologyType::Line)
-		indexPerPrim = 2;
+	PushConstants(pip, isPipDirtied);
 
-	cmdBuffer.drawIndexed(indexPerPrim * pritimiveCount, 1, 0, 0, 0);
+	cmdBuffer.dispatch(x, y, z);
 
-	CommandList::Draw(pritimiveCount);
+	// make writes visible to following draws and dispatches
+	vk::MemoryBarrier memoryBarrier;
+	memoryBarrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+	memoryBarrier.dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite |
+								  vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead |
+								  vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eTransferRead;
+
+	vk::PipelineStageFlags dstStage = vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eDrawIndirect |
+									  vk::PipelineStageFlagBits::eTransfer;
+
+	// graphics stages are not supported on the compute queue, and draws wait for it with a semaphore
+	if (!isCompute_)
+	{
+		dstStage |= vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eVertexShader |
+					vk::PipelineStageFlagBits::eFragmentShader;
+	}
+
+	cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, dstStage, vk::DependencyFlags(), memoryBarrier, nullptr, nullptr);
+
+	CommandList::Dispatch(x, y, z);
 }
 
 void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
 {
+	assert(!isBundle_);
+	assert(!isCompute_);
+
 	auto renderPass_ = static_cast<RenderPassVulkan*>(renderPass);
 
-	vk::ClearColorValue clearColor(std::array<float, 4>{renderPass_->GetClearColor().R / 255.0f,
-														renderPass_->GetClearColor().G / 255.0f,
-														renderPass_->GetClearColor().B / 255.0f,
-														renderPass_->GetClearColor().A / 255.0f});
-	vk::ClearDepthStencilValue clearDepth(1.0f, 0);
+	// load and store ops may be changed after pipeline states are created
+	renderPass_->UpdateRenderPassPipelineState();
 
 	vk::ImageSubresourceRange colorSubRange;
 	colorSubRange.aspectMask = vk::ImageAspectFlagBits::eColor;
@@ -336,7 +609,7 @@ void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
 	depthSubRange.levelCount = 1;
 	depthSubRange.layerCount = 1;
 
-	auto& cmdBuffer = commandBuffers[graphics_->GetCurrentSwapBufferIndex()];
+	auto& cmdBuffer = commandBuffers[GetCurrentBufferIndex()];
 
 	/*
 	// to make screen clear
@@ -372,38 +645,177 @@ void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
 				   depthSubRange);
 	*/
 
-	vk::ClearValue clear_values[2];
-	clear_values[0].color = clearColor;
-	clear_values[1].depthStencil = clearDepth;
+	// a swapchain image which is loaded first is transited because a render pass loads it as a presented image
+	if (renderPass_->GetIsScreen() && !renderPass_->GetIsScreenImageUsed())
+	{
+		if (renderPass_->GetColorLoadOp() == AttachmentLoadOp::Load)
+		{
+			vk::ImageMemoryBarrier imageBarrier;
+			imageBarrier.oldLayout = vk::ImageLayout::eUndefined;
+			imageBarrier.newLayout = vk::ImageLayout::ePresentSrcKHR;
+			imageBarrier.image = renderPass_->colorBuffers[0];
+			imageBarrier.subresourceRange = colorSubRange;
+			cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eColorAttachmentOutput,
+									  vk::PipelineStageFlagBits::eColorAttachmentOutput,
+									  vk::DependencyFlags(),
+									  nullptr,
+									  nullptr,
+									  imageBarrier);
+		}
+
+		renderPass_->SetIsScreenImageUsed(true);
+	}
+
+	// offscreen textures are transited into attachments because they may be read by shaders or loaded
+	if (!renderPass_->GetIsScreen())
+	{
+		std::array<ResourceBarrier, 5> barriers;
+		int32_t barrierCount = 0;
+
+		for (int32_t i = 0; i < renderPass_->GetColorBufferCount(); i++)
+		{
+			barriers[barrierCount].texture = renderPass_->GetColorBuffer(i);
+			barriers[barrierCount].state = ResourceState::RenderTarget;
+			barrierCount++;
+		}
+
+		if (renderPass_->GetDepthBuffer() != nullptr)
+		{
+			barriers[barrierCount].texture = renderPass_->GetDepthBuffer();
+			barriers[barrierCount].state = ResourceState::DepthWrite;
+			barrierCount++;
+		}
+
+		ResourceBarriers(barriers.data(), barrierCount);
+	}
+
+	// a render pass is begun with a draw or a bundle because contents of a subpass are decided with it
+	currentRenderPass_ = renderPass_;
+	isRenderPassBegun_ = false;
+}
+
+void CommandListVulkan::BeginCurrentRenderPass(vk::SubpassContents contents)
+{
+	// a bundle is recorded in a render pass which is begun by a primary command buffer
+	if (isBundle_ || currentRenderPass_ == nullptr)
+		return;
+
+	if (isRenderPassBegun_)
+	{
+		// bundles and other commands can't be mixed in a subpass
+		assert(subpassContents_ == contents);
+		return;
+	}
+
+	auto renderPass_ = currentRenderPass_;
+	auto& cmdBuffer = commandBuffers[GetCurrentBufferIndex()];
+
+	vk::ClearColorValue clearColor(std::array<float, 4>{renderPass_->GetClearColor().R / 255.0f,
+														renderPass_->GetClearColor().G / 255.0f,
+														renderPass_->GetClearColor().B / 255.0f,
+														renderPass_->GetClearColor().A / 255.0f});
+	vk::ClearDepthStencilValue clearDepth(1.0f, 0);
+
+	// a clear value for each attachment
+	std::array<vk::ClearValue, 5> clear_values;
+	for (int32_t i = 0; i < renderPass_->GetColorBufferCount(); i++)
+	{
+		clear_values[i].color = clearColor;
+	}
+	clear_values[renderPass_->GetColorBufferCount()].depthStencil = clearDepth;
 
 	// begin renderpass
 	vk::RenderPassBeginInfo renderPassBeginInfo;
 	renderPassBeginInfo.framebuffer = renderPass_->frameBuffer;
 	renderPassBeginInfo.renderPass = renderPass_->renderPassPipelineState->GetRenderPass();
 	renderPassBeginInfo.renderArea.extent = vk::Extent2D(renderPass_->GetImageSize().X, renderPass_->GetImageSize().Y);
-	renderPassBeginInfo.clearValueCount = 2;
-	renderPassBeginInfo.pClearValues = clear_values;
-	cmdBuffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
+	renderPassBeginInfo.clearValueCount = renderPass_->GetColorBufferCount() + 1;
+	renderPassBeginInfo.pClearValues = clear_values.data();
+	cmdBuffer.beginRenderPass(renderPassBeginInfo, contents);
 
-	vk::Viewport viewport = vk::Viewport(
-		0.0f, 0.0f, static_cast<float>(renderPass_->GetImageSize().X), static_cast<float>(renderPass_->GetImageSize().Y), 0.0f, 1.0f);
-	cmdBuffer.setViewport(0, viewport);
+	isRenderPassBegun_ = true;
+	subpassContents_ = contents;
 
-	vk::Rect2D scissor = vk::Rect2D(vk::Offset2D(), vk::Extent2D(renderPass_->GetImageSize().X, renderPass_->GetImageSize().Y));
-	cmdBuffer.setScissor(0, scissor);
+	// only vkCmdExecuteCommands is allowed in a subpass whose contents are secondary command buffers
+	if (contents == vk::SubpassContents::eInline)
+	{
+		vk::Viewport viewport = vk::Viewport(
+			0.0f, 0.0f, static_cast<float>(renderPass_->GetImageSize().X), static_cast<float>(renderPass_->GetImageSize().Y), 0.0f, 1.0f);
+		cmdBuffer.setViewport(0, viewport);
+
+		vk::Rect2D scissor = vk::Rect2D(vk::Offset2D(), vk::Extent2D(renderPass_->GetImageSize().X, renderPass_->GetImageSize().Y));
+		cmdBuffer.setScissor(0, scissor);
+	}
 }
 
 void CommandListVulkan::EndRenderPass()
 {
-	auto& cmdBuffer = commandBuffers[graphics_->GetCurrentSwapBufferIndex()];
+	auto& cmdBuffer = commandBuffers[GetCurrentBufferIndex()];
+
+	// a render pass without commands is begun to clear attachments
+	BeginCurrentRenderPass(vk::SubpassContents::eInline);
 
 	// end renderpass
 	cmdBuffer.endRenderPass();
+
+	// color buffers are transited into final layouts of offscreen render passes
+	if (currentRenderPass_ != nullptr && !currentRenderPass_->GetIsScreen())
+	{
+		for (int32_t i = 0; i < currentRenderPass_->GetColorBufferCount(); i++)
+		{
+			currentRenderPass_->GetColorBuffer(i)->SetLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+		}
+	}
+
+	currentRenderPass_ = nullptr;
+}
+
+void CommandListVulkan::ResourceBarriers(const ResourceBarrier* barriers, int32_t count)
+{
+	auto& cmdBuffer = commandBuffers[GetCurrentBufferIndex()];
+
+	auto imageBarriers = GetFrameAllocator().Allocate<vk::ImageMemoryBarrier>(count);
+	uint32_t imageBarrierCount = 0;
+
+	vk::PipelineStageFlags srcStage;
+	vk::PipelineStageFlags dstStage;
+
+	for (int32_t i = 0; i < count; i++)
+	{
+		auto texture = static_cast<TextureVulkan*>(barriers[i].texture);
+		if (texture == nullptr)
+			continue;
+
+		vk::ImageMemoryBarrier barrier;
+		if (texture->CreateImageMemoryBarrier(barriers[i].state, barrier, srcStage, dstStage))
+		{
+			imageBarriers[imageBarrierCount] = barrier;
+			imageBarrierCount++;
+		}
+	}
+
+	if (imageBarrierCount == 0)
+		return;
+
+	cmdBuffer.pipelineBarrier(srcStage, dstStage, vk::DependencyFlags(), 0, nullptr, 0, nullptr, imageBarrierCount, imageBarriers);
+}
+
+void CommandListVulkan::ExecuteBundle(CommandList* bundle)
+{
+	assert(currentRenderPass_ != nullptr);
+
+	BeginCurrentRenderPass(vk::SubpassContents::eSecondaryCommandBuffers);
+
+	auto& cmdBuffer = commandBuffers[GetCurrentBufferIndex()];
+	auto bundle_ = static_cast<CommandListVulkan*>(bundle);
+	cmdBuffer.executeCommands(bundle_->GetCommandBuffer());
+
+	CommandList::ExecuteBundle(bundle);
 }
 
 vk::CommandBuffer CommandListVulkan::GetCommandBuffer() const
 {
-	auto& cmdBuffer = commandBuffers[graphics_->GetCurrentSwapBufferIndex()];
+	auto& cmdBuffer = commandBuffers[GetCurrentBufferIndex()];
 	return cmdBuffer;
 }
 
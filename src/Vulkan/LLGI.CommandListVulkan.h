@@ -6,44 +6,101 @@
 namespace LLGI
 {
 
-class DescriptorPoolVulkan
+class RenderPassVulkan;
+class RenderPassPipelineStateVulkan;
+
+class DescriptorPoolVulkan : public ReferenceObject
 {
 private:
-	std::shared_ptr<GraphicsVulkan> graphics_;
-	vk::DescriptorPool descriptorPool = nullptr;
+	Ref<GraphicsVulkan> graphics_;
+
+	//! pools are chained when a pool runs out in a frame
+	std::vector<vk::DescriptorPool> descriptorPools_;
+	size_t currentPoolIndex_ = 0;
 	int32_t size_ = 0;
 	int32_t stage_ = 0;
-	int32_t offset = 0;
-	std::vector<std::vector<vk::DescriptorSet>> cache;
+
+	vk::DescriptorPool CreatePool();
 
 public:
-	DescriptorPoolVulkan(std::shared_ptr<GraphicsVulkan> graphics, int32_t size, int stage);
+	DescriptorPoolVulkan(Ref<GraphicsVulkan> graphics, int32_t size, int stage);
 	virtual ~DescriptorPoolVulkan();
-	const std::vector<vk::DescriptorSet>& Get(PipelineStateVulkan* pip);
+
+	/**
+		@brief	allocate descriptor sets for a pipeline state
+		@param	descriptorSets	memory for sets whose count is the number of descriptor set layouts of the pipeline state
+		@note
+		@return	false if sets can't be allocated even from a new pool
+		@note
+		A new pool is added when sets can't be allocated from existing pools.
+	*/
+	bool Get(PipelineStateVulkan* pip, vk::DescriptorSet* descriptorSets);
 	void Reset();
 };
 
 class CommandListVulkan : public CommandList
 {
 private:
-	std::shared_ptr<GraphicsVulkan> graphics_;
+	Ref<GraphicsVulkan> graphics_;
+
+	//! a pool which only this list uses, so that lists can be recorded on different threads
+	vk::CommandPool commandPool_ = nullptr;
 	std::vector<vk::CommandBuffer> commandBuffers;	
-	std::vector<std::shared_ptr<DescriptorPoolVulkan>> descriptorPools;
+	std::vector<Ref<DescriptorPoolVulkan>> descriptorPools;
+
+	//! a render pass which is begun and is not ended
+	RenderPassVulkan* currentRenderPass_ = nullptr;
+
+	//! whether vkCmdBeginRenderPass of currentRenderPass_ is recorded
+	bool isRenderPassBegun_ = false;
+	vk::SubpassContents subpassContents_ = vk::SubpassContents::eInline;
+
+	Ref<RenderPassPipelineStateVulkan> bundleRenderPassPipelineState_;
+	Vec2I bundleViewportSize_;
+
+	//! whether it is recorded into buffers of the compute queue
+	bool isCompute_ = false;
+
+	bool CreateCommandPool(uint32_t queueFamilyIndex);
+
+	//! an index of a command buffer and a descriptor pool which are used in the current frame
+	int32_t GetCurrentBufferIndex() const;
+
+	//! record vkCmdBeginRenderPass of currentRenderPass_ if it is not recorded
+	void BeginCurrentRenderPass(vk::SubpassContents contents);
+
+	//! write resources into descriptor sets and bind them. It returns false if sets can't be allocated.
+	bool BindDescriptorSets(PipelineStateVulkan* pip, bool isPipDirtied, vk::PipelineBindPoint bindPoint);
+
+	void PushConstants(PipelineStateVulkan* pip, bool isPipDirtied);
 
 public:
 	CommandListVulkan();
 	virtual ~CommandListVulkan();
 
-	bool Initialize(GraphicsVulkan* graphics);
+	/**
+		@param	isCompute	whether it is executed on a dedicated compute queue with GraphicsVulkan::ExecuteCompute
+	*/
+	bool Initialize(GraphicsVulkan* graphics, bool isCompute = false);
+
+	/**
+		@brief	initialize as a bundle which is recorded into a secondary command buffer
+	*/
+	bool InitializeAsBundle(GraphicsVulkan* graphics, RenderPassPipelineStateVulkan* renderPassPipelineState, const Vec2I& viewportSize);
 
 	void Begin() override;
 	void End() override;
 
 	void SetScissor(int32_t x, int32_t y, int32_t width, int32_t height) override;
 	void Draw(int32_t pritimiveCount) override;
+	void Dispatch(int32_t x, int32_t y, int32_t z) override;
 	void BeginRenderPass(RenderPass* renderPass) override;
 	void EndRenderPass() override;
+	void ResourceBarriers(const ResourceBarrier* barriers, int32_t count) override;
+	void ExecuteBundle(CommandList* bundle) override;
 	vk::CommandBuffer GetCommandBuffer() const;
+
+	bool IsCompute() const { return isCompute_; }
 };
 
 } // namespace LLGI
\ No newline at end of file
@@ -14,7 +14,7 @@ bool ConstantBufferVulkan::Initialize(GraphicsVulkan* graphics, int32_t size, Co
 
 	// TODO : shortTime
 	SafeAddRef(graphics);
-	graphics_ = CreateSharedPtr(graphics);
+	graphics_ = CreateRef(graphics);
 
 	buffer = std::unique_ptr<Buffer>(new Buffer(graphics));
 	memSize = size;
@@ -22,6 +22,7 @@ bool ConstantBufferVulkan::Initialize(GraphicsVulkan* graphics, int32_t size, Co
 		vk::BufferCreateInfo IndexBufferInfo;
 		IndexBufferInfo.size = size;
 		IndexBufferInfo.usage = vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eTransferDst;
+		graphics_->SetSharingMode(IndexBufferInfo);
 		buffer->buffer = graphics_->GetDevice().createBuffer(IndexBufferInfo);
 
 		vk::MemoryRequirements memReqs = graphics_->GetDevice().getBufferMemoryRequirements(buffer->buffer);
@@ -11,7 +11,7 @@ namespace LLGI
 class ConstantBufferVulkan : public ConstantBuffer
 {
 private:
-	std::shared_ptr<GraphicsVulkan> graphics_;
+	Ref<GraphicsVulkan> graphics_;
 	std::unique_ptr<Buffer> buffer;
 	int memSize = 0;
 	void* data = nullptr;
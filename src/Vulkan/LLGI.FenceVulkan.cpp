@@ -0,0 +1,188 @@
+#include "LLGI.FenceVulkan.h"
+
+namespace LLGI
+{
+
+FenceVulkan::~FenceVulkan()
+{
+	if (graphics_ == nullptr)
+	{
+		return;
+	}
+
+	// a semaphore and fences must not be destroyed while they are pending
+	Wait(signaledValue_);
+
+	auto device = graphics_->GetDevice();
+
+	if (semaphore_ != nullptr)
+	{
+		device.destroySemaphore(semaphore_);
+		semaphore_ = nullptr;
+	}
+
+	for (auto& pendingFence : pendingFences_)
+	{
+		device.destroyFence(pendingFence.fence);
+	}
+	pendingFences_.clear();
+
+	for (auto& fence : freeFences_)
+	{
+		device.destroyFence(fence);
+	}
+	freeFences_.clear();
+}
+
+bool FenceVulkan::Initialize(GraphicsVulkan* graphics, bool isTimeline)
+{
+	SafeAddRef(graphics);
+	graphics_ = CreateRef(graphics);
+
+	if (!isTimeline)
+	{
+		return true;
+	}
+
+	auto device = graphics_->GetDevice();
+
+	getSemaphoreCounterValue_ = (PFN_vkGetSemaphoreCounterValueKHR)device.getProcAddr("vkGetSemaphoreCounterValueKHR");
+	waitSemaphores_ = (PFN_vkWaitSemaphoresKHR)device.getProcAddr("vkWaitSemaphoresKHR");
+
+	if (getSemaphoreCounterValue_ == nullptr || waitSemaphores_ == nullptr)
+	{
+		return false;
+	}
+
+	vk::SemaphoreTypeCreateInfoKHR typeCreateInfo;
+	typeCreateInfo.semaphoreType = vk::SemaphoreTypeKHR::eTimeline;
+	typeCreateInfo.initialValue = 0;
+
+	vk::SemaphoreCreateInfo createInfo;
+	createInfo.pNext = &typeCreateInfo;
+	semaphore_ = device.createSemaphore(createInfo);
+
+	isTimeline_ = true;
+
+	return true;
+}
+
+uint64_t FenceVulkan::Signal(vk::Queue queue, const std::vector<vk::Semaphore>& waitSemaphores)
+{
+	signaledValue_++;
+	auto value = signaledValue_;
+
+	std::vector<vk::PipelineStageFlags> waitStages(waitSemaphores.size(), vk::PipelineStageFlagBits::eAllCommands);
+
+	// an empty submission is executed after commands which are submitted before it
+	vk::SubmitInfo submitInfo;
+	submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+	submitInfo.pWaitSemaphores = waitSemaphores.data();
+	submitInfo.pWaitDstStageMask = waitStages.data();
+
+	if (isTimeline_)
+	{
+		vk::TimelineSemaphoreSubmitInfoKHR timelineSubmitInfo;
+		timelineSubmitInfo.signalSemaphoreValueCount = 1;
+		timelineSubmitInfo.pSignalSemaphoreValues = &value;
+
+		submitInfo.pNext = &timelineSubmitInfo;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &semaphore_;
+		queue.submit(submitInfo, VK_NULL_HANDLE);
+		return value;
+	}
+
+	// collect completed fences to reuse them
+	GetCompletedValue();
+
+	vk::Fence fence;
+	if (freeFences_.empty())
+	{
+		fence = graphics_->GetDevice().createFence(vk::FenceCreateInfo());
+	}
+	else
+	{
+		fence = freeFences_.back();
+		freeFences_.pop_back();
+	}
+
+	queue.submit(submitInfo, fence);
+
+	PendingFence pendingFence;
+	pendingFence.fence = fence;
+	pendingFence.value = value;
+	pendingFences_.push_back(pendingFence);
+
+	return value;
+}
+
+uint64_t FenceVulkan::GetCompletedValue()
+{
+	auto device = graphics_->GetDevice();
+
+	if (isTimeline_)
+	{
+		uint64_t value = 0;
+		if (getSemaphoreCounterValue_(static_cast<VkDevice>(device), static_cast<VkSemaphore>(semaphore_), &value) == VK_SUCCESS)
+		{
+			completedValue_ = value;
+		}
+		return completedValue_;
+	}
+
+	while (!pendingFences_.empty() && device.getFenceStatus(pendingFences_.front().fence) == vk::Result::eSuccess)
+	{
+		auto& pendingFence = pendingFences_.front();
+		completedValue_ = pendingFence.value;
+		device.resetFences(pendingFence.fence);
+		freeFences_.push_back(pendingFence.fence);
+		pendingFences_.pop_front();
+	}
+
+	return completedValue_;
+}
+
+bool FenceVulkan::Wait(uint64_t value, int32_t timeout)
+{
+	if (GetCompletedValue() >= value)
+	{
+		return true;
+	}
+
+	// it would wait forever
+	if (value > signaledValue_)
+	{
+		return false;
+	}
+
+	auto timeoutNanoseconds = timeout < 0 ? UINT64_MAX : static_cast<uint64_t>(timeout) * 1000 * 1000;
+	auto device = graphics_->GetDevice();
+
+	if (isTimeline_)
+	{
+		VkSemaphoreWaitInfoKHR waitInfo = {};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+		waitInfo.semaphoreCount = 1;
+		auto semaphore = static_cast<VkSemaphore>(semaphore_);
+		waitInfo.pSemaphores = &semaphore;
+		waitInfo.pValues = &value;
+		waitSemaphores_(static_cast<VkDevice>(device), &waitInfo, timeoutNanoseconds);
+	}
+	else
+	{
+		// fences are signaled in order, so the first one which reaches the value is enough
+		auto it = std::find_if(pendingFences_.begin(), pendingFences_.end(), [value](const PendingFence& pendingFence) {
+			return pendingFence.value >= value;
+		});
+
+		if (it != pendingFences_.end())
+		{
+			device.waitForFences(it->fence, VK_TRUE, timeoutNanoseconds);
+		}
+	}
+
+	return GetCompletedValue() >= value;
+}
+
+} // namespace LLGI
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "../LLGI.Fence.h"
+#include "LLGI.BaseVulkan.h"
+#include "LLGI.GraphicsVulkan.h"
+
+namespace LLGI
+{
+
+/**
+	@brief	a fence which is a timeline semaphore if VK_KHR_timeline_semaphore is enabled
+	@note
+	Otherwise a binary fence is submitted per signal and they are recycled when they are completed.
+*/
+class FenceVulkan : public Fence
+{
+private:
+	struct PendingFence
+	{
+		vk::Fence fence;
+		uint64_t value;
+	};
+
+	Ref<GraphicsVulkan> graphics_;
+	bool isTimeline_ = false;
+
+	vk::Semaphore semaphore_ = nullptr;
+	PFN_vkGetSemaphoreCounterValueKHR getSemaphoreCounterValue_ = nullptr;
+	PFN_vkWaitSemaphoresKHR waitSemaphores_ = nullptr;
+
+	//! fences which are submitted in order of values
+	std::deque<PendingFence> pendingFences_;
+	std::vector<vk::Fence> freeFences_;
+	uint64_t completedValue_ = 0;
+
+public:
+	FenceVulkan() = default;
+	virtual ~FenceVulkan();
+
+	bool Initialize(GraphicsVulkan* graphics, bool isTimeline);
+
+	/**
+		@brief	submit a signal to a queue after semaphores are signaled
+		@return	a signaled value
+	*/
+	uint64_t Signal(vk::Queue queue, const std::vector<vk::Semaphore>& waitSemaphores);
+
+	uint64_t GetCompletedValue() override;
+
+	bool Wait(uint64_t value, int32_t timeout = -1) override;
+
+	bool GetIsTimeline() const { return isTimeline_; }
+};
+
+} // namespace LLGI
@@ -2,15 +2,45 @@
 #include "LLGI.BaseVulkan.h"
 #include "LLGI.CommandListVulkan.h"
 #include "LLGI.ConstantBufferVulkan.h"
+#include "LLGI.FenceVulkan.h"
 #include "LLGI.IndexBufferVulkan.h"
 #include "LLGI.PipelineStateVulkan.h"
 #include "LLGI.ShaderVulkan.h"
+#include "LLGI.StorageBufferVulkan.h"
 #include "LLGI.TextureVulkan.h"
 #include "LLGI.VertexBufferVulkan.h"
 
 namespace LLGI
 {
 
+static vk::AttachmentLoadOp ConvertLoadOp(AttachmentLoadOp loadOp)
+{
+	switch (loadOp)
+	{
+	case AttachmentLoadOp::Clear:
+		return vk::AttachmentLoadOp::eClear;
+	case AttachmentLoadOp::Load:
+		return vk::AttachmentLoadOp::eLoad;
+	case AttachmentLoadOp::DontCare:
+		return vk::AttachmentLoadOp::eDontCare;
+	}
+
+	return vk::AttachmentLoadOp::eClear;
+}
+
+static vk::AttachmentStoreOp ConvertStoreOp(AttachmentStoreOp storeOp)
+{
+	switch (storeOp)
+	{
+	case AttachmentStoreOp::Store:
+		return vk::AttachmentStoreOp::eStore;
+	case AttachmentStoreOp::DontCare:
+		return vk::AttachmentStoreOp::eDontCare;
+	}
+
+	return vk::AttachmentStoreOp::eStore;
+}
+
 RenderPassVulkan::RenderPassVulkan(GraphicsVulkan* graphics, bool isStrongRef) : graphics_(graphics), isStrongRef_(isStrongRef)
 {
 	if (isStrongRef_)
@@ -21,7 +51,7 @@ RenderPassVulkan::RenderPassVulkan(GraphicsVulkan* graphics, bool isStrongRef) :
 
 RenderPassVulkan::~RenderPassVulkan()
 {
-	if (frameBuffer != nullptr)
+	if (frameBuffer != nullptr && isFrameBufferOwned_)
 	{
 		graphics_->GetDevice().destroyFramebuffer(frameBuffer);
 	}
@@ -41,10 +71,13 @@ bool RenderPassVulkan::Initialize(const vk::Image& imageColor,
 {
 	imageSize_ = imageSize;
 
-	bool hasDepth = true;
-	bool isPresentMode = true;
+	key_.isPresentMode = true;
+	key_.hasDepth = true;
+	key_.format = format;
+	colorBufferCount_ = 1;
+	isFrameBufferOwned_ = true;
 
-	this->renderPassPipelineState = graphics_->CreateRenderPassPipelineState(isPresentMode, hasDepth, format);
+	this->renderPassPipelineState = graphics_->CreateRenderPassPipelineState(key_);
 
 	std::array<vk::ImageView, 2> views;
 	views[0] = imageColorView;
@@ -66,68 +99,109 @@ bool RenderPassVulkan::Initialize(const vk::Image& imageColor,
 	return true;
 }
 
-bool RenderPassVulkan::Initialize(const TextureVulkan** textures, int32_t textureCount, TextureVulkan* depthTexture)
+bool RenderPassVulkan::Initialize(TextureVulkan** textures, int32_t textureCount, TextureVulkan* depthTexture)
 {
-	throw "Not inplemented";
-
-	if (textureCount == 0)
+	if (textureCount <= 0 || textureCount > static_cast<int32_t>(colorBufferPtrs.size()) || textures[0] == nullptr)
 		return false;
 
+	imageSize_ = textures[0]->GetSizeAs2D();
+	vk::Format format = textures[0]->GetVulkanFormat();
+
+	FramebufferVulkanKey framebufferKey;
+	framebufferKey.colorCount = textureCount;
+	framebufferKey.width = imageSize_.X;
+	framebufferKey.height = imageSize_.Y;
+
+	// all color buffers must have the same size and format
+	for (int32_t i = 0; i < textureCount; i++)
+	{
+		auto texture = textures[i];
+		if (texture == nullptr || !texture->IsRenderTexture() || texture->GetVulkanFormat() != format)
+			return false;
+
+		auto size = texture->GetSizeAs2D();
+		if (size.X != imageSize_.X || size.Y != imageSize_.Y)
+			return false;
+
+		framebufferKey.colors[i] = texture->GetView();
+	}
+
+	if (depthTexture != nullptr)
+	{
+		auto size = depthTexture->GetSizeAs2D();
+		if (!depthTexture->IsDepthTexture() || size.X != imageSize_.X || size.Y != imageSize_.Y)
+			return false;
+
+		framebufferKey.depth = depthTexture->GetView();
+	}
+
 	for (int32_t i = 0; i < textureCount; i++)
 	{
-		auto texture = const_cast<TextureVulkan*>(textures[i]);
+		auto texture = textures[i];
 		SafeAddRef(texture);
-		colorBufferPtrs[i] = CreateSharedPtr(texture);
+		colorBufferPtrs[i] = CreateRef(texture);
+		colorBuffers[i] = texture->GetImage();
 	}
 
 	if (depthTexture != nullptr)
 	{
 		SafeAddRef(depthTexture);
-		depthBufferPtr = CreateSharedPtr(depthTexture);
+		depthBufferPtr = CreateRef(depthTexture);
+		depthBuffer = depthTexture->GetImage();
+
+		// transient depth buffers are not stored by default
+		if (depthTexture->IsTransient())
+		{
+			SetDepthStoreOp(AttachmentStoreOp::DontCare);
+		}
 	}
 	else
 	{
-		depthBufferPtr.reset();
+		depthBufferPtr.Reset();
 	}
 
-	// TODO : make const
-	imageSize_ = ((TextureVulkan*)textures[0])->GetSizeAs2D();
+	colorBufferCount_ = textureCount;
 
-	vk::Format format = textures[0]->GetVulkanFormat();
+	key_.isPresentMode = false;
+	key_.hasDepth = depthTexture != nullptr;
+	key_.format = format;
+	key_.colorCount = textureCount;
 
-	bool hasDepth = depthTexture != nullptr;
-	bool isPresentMode = false;
+	this->renderPassPipelineState = graphics_->CreateRenderPassPipelineState(key_);
+	if (this->renderPassPipelineState == nullptr)
+		return false;
 
-	/*
+	frameBuffer = graphics_->GetFramebuffer(renderPassPipelineState->GetRenderPass(), framebufferKey);
+	isFrameBufferOwned_ = false;
 
-	// TODO : MRT
-	this->renderPassPipelineState = graphics_->CreateRenderPassPipelineState(isPresentMode, hasDepth, format);
+	return frameBuffer != nullptr;
+}
 
-	std::array<vk::ImageView, 2> views;
-	views[0] = imageColorView;
-	views[1] = imageDepthView;
+Vec2I RenderPassVulkan::GetImageSize() const { return imageSize_; }
 
-	vk::FramebufferCreateInfo framebufferCreateInfo;
-	framebufferCreateInfo.renderPass = renderPassPipelineState->GetRenderPass();
-	framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(views.size());
-	framebufferCreateInfo.pAttachments = views.data();
-	framebufferCreateInfo.width = imageSize.X;
-	framebufferCreateInfo.height = imageSize.Y;
-	framebufferCreateInfo.layers = 1;
+void RenderPassVulkan::UpdateRenderPassPipelineState()
+{
+	auto key = key_;
+	key.colorLoadOp = ConvertLoadOp(GetColorLoadOp());
+	key.colorStoreOp = ConvertStoreOp(GetColorStoreOp());
+	key.depthLoadOp = ConvertLoadOp(GetDepthLoadOp());
+	key.depthStoreOp = ConvertStoreOp(GetDepthStoreOp());
 
-	frameBuffer = graphics_->GetDevice().createFramebuffer(framebufferCreateInfo);
+	if (key == key_ && renderPassPipelineState != nullptr)
+		return;
 
-	colorBuffers[0] = imageColor;
-	depthBuffer = imageDepth;
+	auto state = graphics_->CreateRenderPassPipelineState(key);
+	if (state == nullptr)
+		return;
 
-	return true;
-	*/
+	key_ = key;
+	renderPassPipelineState = state;
 }
 
-Vec2I RenderPassVulkan::GetImageSize() const { return imageSize_; }
-
 RenderPassPipelineState* RenderPassVulkan::CreateRenderPassPipelineState()
 {
+	UpdateRenderPassPipelineState();
+
 	auto ret = renderPassPipelineState.get();
 	SafeAddRef(ret);
 	return ret;
@@ -146,31 +220,43 @@ RenderPassPipelineStateVulkan::~RenderPassPipelineStateVulkan()
 vk::RenderPass RenderPassPipelineStateVulkan::GetRenderPass() const { return renderPass; }
 
 GraphicsVulkan::GraphicsVulkan(const vk::Device& device,
-							   const vk::Queue& quque,
-							   const vk::CommandPool& commandPool,
+							   const PlatformQueues& queues,
 							   const vk::PhysicalDevice& pysicalDevice,
 							   const PlatformView& platformView,
-							   std::function<void(vk::CommandBuffer&)> addCommand,
+							   const PlatformFeatures& features,
+							   std::function<void(vk::CommandBuffer&, const std::vector<vk::Semaphore>&)> addCommand,
 							   std::function<void(PlatformStatus&)> getStatus)
 	: vkDevice(device)
-	, vkQueue(quque)
-	, vkCmdPool(commandPool)
+	, vkQueue(queues.graphics.queue)
+	, vkCmdPool(queues.graphics.commandPool)
 	, vkPysicalDevice(pysicalDevice)
+	, queues_(queues)
+	, features_(features)
 	, addCommand_(addCommand)
 	, getStatus_(getStatus)
 {
 	swapBufferCount_ = platformView.colors.size();
 
+	for (auto familyIndex : {queues_.graphics.familyIndex, queues_.transfer.familyIndex, queues_.compute.familyIndex})
+	{
+		if (std::find(queueFamilyIndexes_.begin(), queueFamilyIndexes_.end(), familyIndex) == queueFamilyIndexes_.end())
+		{
+			queueFamilyIndexes_.push_back(familyIndex);
+		}
+	}
+
+	semaphoreFrames_.resize(swapBufferCount_);
+
 	for (size_t i = 0; i < static_cast<size_t>(swapBufferCount_); i++)
 	{
-		auto renderPass = std::make_shared<RenderPassVulkan>(this, false);
+		auto renderPass = CreateRef(new RenderPassVulkan(this, false));
 		renderPass->Initialize(platformView.colors[i],
 							   platformView.depths[i],
 							   platformView.colorViews[i],
 							   platformView.depthViews[i],
 							   platformView.imageSize,
 							   platformView.format);
-		renderPasses.push_back(renderPass);
+		renderPasses.push_back(std::move(renderPass));
 	}
 
 	vk::SamplerCreateInfo samplerInfo;
@@ -191,10 +277,65 @@ GraphicsVulkan::GraphicsVulkan(const vk::Device& device,
 	samplerInfo.maxLod = 0.0f;
 
 	defaultSampler = vkDevice.createSampler(samplerInfo);
+
+	InitializeDefaultResources();
+
+	if (features_.isDescriptorIndexingEnabled)
+	{
+		InitializeBindlessTextures();
+	}
+
+	InitializeTransientBuffers(swapBufferCount_);
+
+	textureStreamingFrames_.resize(swapBufferCount_);
 }
 
 GraphicsVulkan::~GraphicsVulkan()
 {
+	DisposeTextureStreaming();
+
+	for (auto& frame : textureStreamingFrames_)
+	{
+		DisposeTextureStreamingFrame(frame);
+	}
+	textureStreamingFrames_.clear();
+
+	for (auto& frame : semaphoreFrames_)
+	{
+		for (auto& semaphore : frame.semaphores)
+		{
+			vkDevice.destroySemaphore(semaphore);
+		}
+
+		for (auto& fence : frame.computeFences)
+		{
+			vkDevice.destroyFence(fence);
+		}
+	}
+	semaphoreFrames_.clear();
+
+	DisposeTransientBuffers();
+	DisposeBindlessTextures();
+
+	for (auto& sampler : samplers_)
+	{
+		vkDevice.destroySampler(sampler.second);
+	}
+	samplers_.clear();
+
+	for (auto& framebuffer : framebuffers_)
+	{
+		vkDevice.destroyFramebuffer(framebuffer.second);
+	}
+	framebuffers_.clear();
+
+	for (auto& pending : pendingFramebuffers_)
+	{
+		vkDevice.destroyFramebuffer(pending.framebuffer);
+	}
+	pendingFramebuffers_.clear();
+
+	DisposeDefaultResources();
 
 	if (defaultSampler != nullptr)
 	{
@@ -204,32 +345,281 @@ GraphicsVulkan::~GraphicsVulkan()
 
 void GraphicsVulkan::NewFrame()
 {
+	// updates which are recorded after the last command list are not lost
+	SubmitUpdateCommandBuffer();
+
 	currentSwapBufferIndex = (currentSwapBufferIndex + 1) % swapBufferCount_;
 
 	PlatformStatus status;
 	getStatus_(status);
 
 	assert(currentSwapBufferIndex == status.currentSwapBufferIndex);
+
+	frameCount_++;
+
+	NewTransientBufferFrame();
+
+	// semaphores which are not waited in a previous frame must be waited before they are signaled again
+	if (!waitSemaphores_.empty())
+	{
+		std::vector<vk::PipelineStageFlags> waitStages(waitSemaphores_.size(), vk::PipelineStageFlagBits::eAllCommands);
+		vk::SubmitInfo submitInfo;
+		submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores_.size());
+		submitInfo.pWaitSemaphores = waitSemaphores_.data();
+		submitInfo.pWaitDstStageMask = waitStages.data();
+		vkQueue.submit(submitInfo, VK_NULL_HANDLE);
+		waitSemaphores_.clear();
+	}
+
+	// compute of a frame of the same index is not waited by the graphics queue, so it is waited here
+	auto& semaphoreFrame = semaphoreFrames_[currentSwapBufferIndex];
+	for (size_t i = 0; i < semaphoreFrame.usedComputeFenceCount; i++)
+	{
+		vkDevice.waitForFences(semaphoreFrame.computeFences[i], VK_TRUE, UINT64_MAX);
+		vkDevice.resetFences(semaphoreFrame.computeFences[i]);
+	}
+	semaphoreFrame.usedComputeFenceCount = 0;
+
+	// a frame of the same index is finished, so its semaphores are unsignaled
+	semaphoreFrame.usedCount = 0;
+
+	// uploads are submitted before command lists of this frame
+	auto& streamingFrame = textureStreamingFrames_[currentSwapBufferIndex];
+	ResetTextureStreamingFrame(streamingFrame);
+
+	ProcessTextureStreaming();
+
+	if (streamingFrame.commandBuffer)
+	{
+		streamingFrame.commandBuffer.end();
+
+		if (streamingFrame.acquireCommandBuffer)
+		{
+			// levels are copied while the graphics queue renders and become readable after the copy
+			auto semaphore = GetSemaphore();
+			vk::SubmitInfo submitInfo;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &streamingFrame.commandBuffer;
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores = &semaphore;
+			queues_.transfer.queue.submit(submitInfo, VK_NULL_HANDLE);
+			waitSemaphores_.push_back(semaphore);
+
+			streamingFrame.acquireCommandBuffer.end();
+			SubmitToGraphicsQueue(streamingFrame.acquireCommandBuffer);
+		}
+		else
+		{
+			SubmitToGraphicsQueue(streamingFrame.commandBuffer);
+		}
+	}
+
+	// textures are released after frames which may refer them are finished
+	auto it = pendingBindlessTextures_.begin();
+	while (it != pendingBindlessTextures_.end())
+	{
+		if (frameCount_ - it->releasedFrame >= swapBufferCount_)
+		{
+			SafeRelease(it->texture);
+			freeBindlessIndexes_.push_back(it->index);
+			it = pendingBindlessTextures_.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+
+	// framebuffers are destroyed in the same way
+	std::lock_guard<std::mutex> framebuffersLock(framebuffersMutex_);
+	auto fit = pendingFramebuffers_.begin();
+	while (fit != pendingFramebuffers_.end())
+	{
+		if (frameCount_ - fit->releasedFrame >= swapBufferCount_)
+		{
+			vkDevice.destroyFramebuffer(fit->framebuffer);
+			fit = pendingFramebuffers_.erase(fit);
+		}
+		else
+		{
+			fit++;
+		}
+	}
 }
 
 void GraphicsVulkan::SetWindowSize(const Vec2I& windowSize) { throw "Not inplemented"; }
 
 void GraphicsVulkan::Execute(CommandList* commandList)
 {
+	assert(!commandList->IsBundle());
+
 	auto commandList_ = static_cast<CommandListVulkan*>(commandList);
-	addCommand_(commandList_->GetCommandBuffer());
+	assert(!commandList_->IsCompute());
+
+	auto commandBuffer = commandList_->GetCommandBuffer();
+	SubmitToGraphicsQueue(commandBuffer);
 }
 
-void GraphicsVulkan::WaitFinish() { vkQueue.waitIdle(); }
+void GraphicsVulkan::ExecuteCompute(CommandList* commandList)
+{
+	if (!HasDedicatedComputeQueue())
+	{
+		Execute(commandList);
+		return;
+	}
+
+	auto commandList_ = static_cast<CommandListVulkan*>(commandList);
+	assert(commandList_->IsCompute());
+
+	// compute reads results of uploads and commands which are submitted to the graphics queue before it
+	SubmitUpdateCommandBuffer();
+
+	auto graphicsSemaphore = GetSemaphore();
+	std::vector<vk::PipelineStageFlags> graphicsWaitStages(waitSemaphores_.size(), vk::PipelineStageFlagBits::eAllCommands);
+	vk::SubmitInfo graphicsSubmitInfo;
+	graphicsSubmitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores_.size());
+	graphicsSubmitInfo.pWaitSemaphores = waitSemaphores_.data();
+	graphicsSubmitInfo.pWaitDstStageMask = graphicsWaitStages.data();
+	graphicsSubmitInfo.signalSemaphoreCount = 1;
+	graphicsSubmitInfo.pSignalSemaphores = &graphicsSemaphore;
+	vkQueue.submit(graphicsSubmitInfo, VK_NULL_HANDLE);
+	waitSemaphores_.clear();
+
+	auto commandBuffer = commandList_->GetCommandBuffer();
+	auto semaphore = GetSemaphore();
+	vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eAllCommands;
+
+	vk::SubmitInfo submitInfo;
+	submitInfo.waitSemaphoreCount = 1;
+	submitInfo.pWaitSemaphores = &graphicsSemaphore;
+	submitInfo.pWaitDstStageMask = &waitStage;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &semaphore;
+
+	// the command buffer and descriptor sets of the list are reused after the fence is signaled
+	queues_.compute.queue.submit(submitInfo, GetComputeFence());
+
+	// results are read by following command lists
+	waitSemaphores_.push_back(semaphore);
+}
+
+uint64_t GraphicsVulkan::Signal(Fence* fence)
+{
+	if (fence == nullptr)
+	{
+		return 0;
+	}
+
+	// it is signaled after uploads and compute which following commands wait
+	SubmitUpdateCommandBuffer();
+	auto value = static_cast<FenceVulkan*>(fence)->Signal(vkQueue, waitSemaphores_);
+	waitSemaphores_.clear();
+	return value;
+}
+
+void GraphicsVulkan::WaitFinish()
+{
+	// textures of requests hold this instance, so they are released before it is released
+	DisposeTextureStreaming();
+
+	if (currentSwapBufferIndex >= 0)
+	{
+		SubmitUpdateCommandBuffer();
+	}
+
+	if (HasDedicatedTransferQueue())
+	{
+		queues_.transfer.queue.waitIdle();
+	}
+
+	if (HasDedicatedComputeQueue())
+	{
+		queues_.compute.queue.waitIdle();
+	}
+
+	vkQueue.waitIdle();
+
+	// framebuffers which are disposed are not used after queues are idle
+	std::lock_guard<std::mutex> lock(framebuffersMutex_);
+	for (auto& pending : pendingFramebuffers_)
+	{
+		vkDevice.destroyFramebuffer(pending.framebuffer);
+	}
+	pendingFramebuffers_.clear();
+}
+
+vk::Semaphore GraphicsVulkan::GetSemaphore()
+{
+	auto& frame = semaphoreFrames_[currentSwapBufferIndex];
+	if (frame.usedCount == frame.semaphores.size())
+	{
+		frame.semaphores.push_back(vkDevice.createSemaphore(vk::SemaphoreCreateInfo()));
+	}
+
+	auto semaphore = frame.semaphores[frame.usedCount];
+	frame.usedCount++;
+	return semaphore;
+}
+
+vk::Fence GraphicsVulkan::GetComputeFence()
+{
+	auto& frame = semaphoreFrames_[currentSwapBufferIndex];
+	if (frame.usedComputeFenceCount == frame.computeFences.size())
+	{
+		frame.computeFences.push_back(vkDevice.createFence(vk::FenceCreateInfo()));
+	}
+
+	auto fence = frame.computeFences[frame.usedComputeFenceCount];
+	frame.usedComputeFenceCount++;
+	return fence;
+}
+
+void GraphicsVulkan::SubmitToGraphicsQueue(vk::CommandBuffer& commandBuffer)
+{
+	SubmitUpdateCommandBuffer();
+
+	addCommand_(commandBuffer, waitSemaphores_);
+	waitSemaphores_.clear();
+}
+
+void GraphicsVulkan::SetSharingMode(vk::BufferCreateInfo& info) const
+{
+	if (queueFamilyIndexes_.size() > 1)
+	{
+		info.sharingMode = vk::SharingMode::eConcurrent;
+		info.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilyIndexes_.size());
+		info.pQueueFamilyIndices = queueFamilyIndexes_.data();
+	}
+	else
+	{
+		info.sharingMode = vk::SharingMode::eExclusive;
+	}
+}
+
+void GraphicsVulkan::SetSharingMode(vk::ImageCreateInfo& info) const
+{
+	if (queueFamilyIndexes_.size() > 1)
+	{
+		info.sharingMode = vk::SharingMode::eConcurrent;
+		info.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilyIndexes_.size());
+		info.pQueueFamilyIndices = queueFamilyIndexes_.data();
+	}
+	else
+	{
+		info.sharingMode = vk::SharingMode::eExclusive;
+	}
+}
 
 RenderPass* GraphicsVulkan::GetCurrentScreen(const Color8& clearColor, bool isColorCleared, bool isDepthCleared)
 {
-	auto currentRenderPass = renderPasses[currentSwapBufferIndex];
+	auto currentRenderPass = renderPasses[currentSwapBufferIndex].Get();
 
 	currentRenderPass->SetClearColor(clearColor);
 	currentRenderPass->SetIsColorCleared(isColorCleared);
 	currentRenderPass->SetIsDepthCleared(isDepthCleared);
-	return currentRenderPass.get();
+	return currentRenderPass;
 }
 
 VertexBuffer* GraphicsVulkan::CreateVertexBuffer(int32_t size)
@@ -244,6 +634,212 @@ VertexBuffer* GraphicsVulkan::CreateVertexBuffer(int32_t size)
 	return obj;
 }
 
+VertexBuffer* GraphicsVulkan::CreateTransientVertexBuffer(int32_t size)
+{
+	auto obj = new VertexBufferVulkan();
+	if (!obj->InitializeAsTransient(this, size))
+	{
+		SafeRelease(obj);
+		return nullptr;
+	}
+
+	return obj;
+}
+
+IndexBuffer* GraphicsVulkan::CreateTransientIndexBuffer(int32_t stride, int32_t count)
+{
+	auto obj = new IndexBufferVulkan();
+	if (!obj->InitializeAsTransient(this, stride, count))
+	{
+		SafeRelease(obj);
+		return nullptr;
+	}
+
+	return obj;
+}
+
+void GraphicsVulkan::ResetTextureStreamingFrame(TextureStreamingFrame& frame)
+{
+	if (frame.commandBuffer)
+	{
+		vkDevice.freeCommandBuffers(queues_.transfer.commandPool, frame.commandBuffer);
+		frame.commandBuffer = nullptr;
+	}
+
+	if (frame.acquireCommandBuffer)
+	{
+		vkDevice.freeCommandBuffers(vkCmdPool, frame.acquireCommandBuffer);
+		frame.acquireCommandBuffer = nullptr;
+	}
+
+	for (auto& commandBuffer : frame.updateCommandBuffers)
+	{
+		vkDevice.freeCommandBuffers(vkCmdPool, commandBuffer);
+	}
+	frame.updateCommandBuffers.clear();
+
+	// the frame is finished, so regions can be overwritten
+	for (auto& page : frame.stagingPages)
+	{
+		page.offset = 0;
+	}
+}
+
+void GraphicsVulkan::DisposeTextureStreamingFrame(TextureStreamingFrame& frame)
+{
+	ResetTextureStreamingFrame(frame);
+
+	for (auto& page : frame.stagingPages)
+	{
+		vkDevice.unmapMemory(page.buffer->devMem);
+	}
+	frame.stagingPages.clear();
+}
+
+GraphicsVulkan::StagingPage* GraphicsVulkan::AllocateStagingRegion(TextureStreamingFrame& frame, int32_t size, int32_t& offset)
+{
+	// offsets of copies must be multiples of texel block sizes
+	const int32_t alignment = 16;
+
+	for (auto& page : frame.stagingPages)
+	{
+		auto aligned = (page.offset + alignment - 1) / alignment * alignment;
+		if (aligned + size <= page.size)
+		{
+			offset = aligned;
+			page.offset = aligned + size;
+			return &page;
+		}
+	}
+
+	// a large level occupies a page
+	StagingPage page;
+	const int32_t pageSize = StagingPageSize;
+	page.size = (std::max)(size, pageSize);
+
+	// staging buffers are owned by this instance
+	page.buffer = std::unique_ptr<Buffer>(new Buffer(this, false));
+
+	vk::BufferCreateInfo bufferInfo;
+	bufferInfo.size = page.size;
+	bufferInfo.usage = vk::BufferUsageFlagBits::eTransferSrc;
+	page.buffer->buffer = vkDevice.createBuffer(bufferInfo);
+
+	vk::MemoryRequirements memReqs = vkDevice.getBufferMemoryRequirements(page.buffer->buffer);
+	vk::MemoryAllocateInfo memAlloc;
+	memAlloc.allocationSize = memReqs.size;
+	memAlloc.memoryTypeIndex =
+		GetMemoryTypeIndex(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+	page.buffer->devMem = vkDevice.allocateMemory(memAlloc);
+	vkDevice.bindBufferMemory(page.buffer->buffer, page.buffer->devMem, 0);
+
+	// pages are kept mapped until they are disposed
+	page.data = static_cast<uint8_t*>(vkDevice.mapMemory(page.buffer->devMem, 0, page.size, vk::MemoryMapFlags()));
+	page.offset = size;
+	frame.stagingPages.push_back(std::move(page));
+
+	offset = 0;
+	return &frame.stagingPages.back();
+}
+
+vk::CommandBuffer GraphicsVulkan::GetUpdateCommandBuffer()
+{
+	auto& frame = textureStreamingFrames_[currentSwapBufferIndex];
+
+	if (!isUpdateCommandBufferRecording_)
+	{
+		vk::CommandBufferAllocateInfo cmdBufInfo;
+		cmdBufInfo.commandPool = vkCmdPool;
+		cmdBufInfo.level = vk::CommandBufferLevel::ePrimary;
+		cmdBufInfo.commandBufferCount = 1;
+		auto commandBuffer = vkDevice.allocateCommandBuffers(cmdBufInfo)[0];
+
+		vk::CommandBufferBeginInfo cmdBufferBeginInfo;
+		cmdBufferBeginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+		commandBuffer.begin(cmdBufferBeginInfo);
+
+		frame.updateCommandBuffers.push_back(commandBuffer);
+		isUpdateCommandBufferRecording_ = true;
+	}
+
+	return frame.updateCommandBuffers.back();
+}
+
+void GraphicsVulkan::SubmitUpdateCommandBuffer()
+{
+	if (!isUpdateCommandBufferRecording_)
+		return;
+
+	isUpdateCommandBufferRecording_ = false;
+
+	auto& commandBuffer = textureStreamingFrames_[currentSwapBufferIndex].updateCommandBuffers.back();
+	commandBuffer.end();
+	addCommand_(commandBuffer, waitSemaphores_);
+	waitSemaphores_.clear();
+}
+
+void GraphicsVulkan::SubmitAndWait(vk::CommandBuffer commandBuffer)
+{
+	if (currentSwapBufferIndex >= 0)
+	{
+		SubmitUpdateCommandBuffer();
+	}
+
+	vk::SubmitInfo submitInfo;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+
+	auto fence = vkDevice.createFence(vk::FenceCreateInfo());
+	vkQueue.submit(submitInfo, fence);
+	vkDevice.waitForFences(fence, VK_TRUE, UINT64_MAX);
+	vkDevice.destroyFence(fence);
+}
+
+uint8_t* GraphicsVulkan::AllocateStagingMemory(int32_t size, vk::Buffer& buffer, int32_t& offset)
+{
+	auto page = AllocateStagingRegion(textureStreamingFrames_[currentSwapBufferIndex], size, offset);
+	buffer = page->buffer->buffer;
+	return page->data + offset;
+}
+
+bool GraphicsVulkan::UploadTextureMipMap(Texture* texture, int32_t mipLevel, const void* data, int32_t size)
+{
+	auto& frame = textureStreamingFrames_[currentSwapBufferIndex];
+
+	int32_t offset = 0;
+	auto page = AllocateStagingRegion(frame, size, offset);
+	memcpy(page->data + offset, data, size);
+
+	if (!frame.commandBuffer)
+	{
+		vk::CommandBufferBeginInfo cmdBufferBeginInfo;
+		cmdBufferBeginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+
+		vk::CommandBufferAllocateInfo cmdBufInfo;
+		cmdBufInfo.commandPool = queues_.transfer.commandPool;
+		cmdBufInfo.level = vk::CommandBufferLevel::ePrimary;
+		cmdBufInfo.commandBufferCount = 1;
+		frame.commandBuffer = vkDevice.allocateCommandBuffers(cmdBufInfo)[0];
+		frame.commandBuffer.begin(cmdBufferBeginInfo);
+
+		// shader stages are not supported on the transfer queue
+		if (HasDedicatedTransferQueue())
+		{
+			cmdBufInfo.commandPool = vkCmdPool;
+			frame.acquireCommandBuffer = vkDevice.allocateCommandBuffers(cmdBufInfo)[0];
+			frame.acquireCommandBuffer.begin(cmdBufferBeginInfo);
+		}
+	}
+
+	static_cast<TextureVulkan*>(texture)->UploadMipMap(frame.commandBuffer,
+													   page->buffer->buffer,
+													   offset,
+													   mipLevel,
+													   frame.acquireCommandBuffer ? &frame.acquireCommandBuffer : nullptr);
+
+	return true;
+}
+
 IndexBuffer* GraphicsVulkan::CreateIndexBuffer(int32_t stride, int32_t count)
 {
 
@@ -294,6 +890,39 @@ CommandList* GraphicsVulkan::CreateCommandList()
 	return nullptr;
 }
 
+CommandList* GraphicsVulkan::CreateCommandBundle(RenderPassPipelineState* renderPassPipelineState, const Vec2I& viewportSize)
+{
+	auto commandList = new CommandListVulkan();
+	if (commandList->InitializeAsBundle(this, static_cast<RenderPassPipelineStateVulkan*>(renderPassPipelineState), viewportSize))
+	{
+		return commandList;
+	}
+	SafeRelease(commandList);
+	return nullptr;
+}
+
+CommandList* GraphicsVulkan::CreateComputeCommandList()
+{
+	auto commandList = new CommandListVulkan();
+	if (commandList->Initialize(this, HasDedicatedComputeQueue()))
+	{
+		return commandList;
+	}
+	SafeRelease(commandList);
+	return nullptr;
+}
+
+Fence* GraphicsVulkan::CreateFence()
+{
+	auto fence = new FenceVulkan();
+	if (fence->Initialize(this, features_.isTimelineSemaphoreEnabled))
+	{
+		return fence;
+	}
+	SafeRelease(fence);
+	return nullptr;
+}
+
 ConstantBuffer* GraphicsVulkan::CreateConstantBuffer(int32_t size, ConstantBufferType type)
 {
 	if (type == ConstantBufferType::ShortTime)
@@ -310,15 +939,23 @@ ConstantBuffer* GraphicsVulkan::CreateConstantBuffer(int32_t size, ConstantBuffe
 	return obj;
 }
 
-RenderPass* GraphicsVulkan::CreateRenderPass(const Texture** textures, int32_t textureCount, Texture* depthTexture)
+StorageBuffer* GraphicsVulkan::CreateStorageBuffer(int32_t size)
 {
-	throw "Not inplemented";
+	auto obj = new StorageBufferVulkan();
+	if (!obj->Initialize(this, size))
+	{
+		SafeRelease(obj);
+		return nullptr;
+	}
 
-	if (textureCount > 1)
-		throw "Not inplemented";
+	return obj;
+}
 
+RenderPass* GraphicsVulkan::CreateRenderPass(const Texture** textures, int32_t textureCount, Texture* depthTexture)
+{
 	auto renderPass = new RenderPassVulkan(this, true);
-	if (!renderPass->Initialize((const TextureVulkan**)textures, textureCount, (TextureVulkan*)depthTexture))
+	// the render pass holds textures, so they are not const in it
+	if (!renderPass->Initialize((TextureVulkan**)textures, textureCount, (TextureVulkan*)depthTexture))
 	{
 		SafeRelease(renderPass);
 	}
@@ -337,8 +974,313 @@ Texture* GraphicsVulkan::CreateTexture(const Vec2I& size, bool isRenderPass, boo
 	return obj;
 }
 
+Texture* GraphicsVulkan::CreateDepthTexture(const Vec2I& size, bool isTransient)
+{
+	auto obj = new TextureVulkan(this);
+	if (!obj->InitializeAsDepthBuffer(size, isTransient))
+	{
+		SafeRelease(obj);
+		return nullptr;
+	}
+
+	return obj;
+}
+
 Texture* GraphicsVulkan::CreateTexture(uint64_t id) { throw "Not inplemented"; }
 
+Texture* GraphicsVulkan::CreateTexture(const TextureInitializationParameter& parameter)
+{
+	auto obj = new TextureVulkan(this);
+	if (!obj->Initialize(parameter))
+	{
+		SafeRelease(obj);
+		return nullptr;
+	}
+
+	return obj;
+}
+
+vk::Sampler GraphicsVulkan::GetSampler(const SamplerVulkanKey& key)
+{
+	std::lock_guard<std::mutex> lock(samplersMutex_);
+
+	auto it = samplers_.find(key);
+	if (it != samplers_.end())
+	{
+		return it->second;
+	}
+
+	vk::SamplerCreateInfo samplerInfo;
+	samplerInfo.magFilter = key.magFilter;
+	samplerInfo.minFilter = key.minFilter;
+	samplerInfo.mipmapMode = key.mipmapMode;
+	samplerInfo.addressModeU = key.addressModeU;
+	samplerInfo.addressModeV = key.addressModeV;
+	samplerInfo.addressModeW = key.addressModeW;
+	samplerInfo.anisotropyEnable = key.anisotropyEnable;
+	samplerInfo.maxAnisotropy = key.maxAnisotropy;
+	samplerInfo.compareEnable = key.compareEnable;
+	samplerInfo.compareOp = key.compareOp;
+	samplerInfo.mipLodBias = 0.0f;
+	samplerInfo.minLod = key.minLod;
+	samplerInfo.maxLod = key.maxLod;
+	samplerInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
+	samplerInfo.unnormalizedCoordinates = false;
+
+	auto sampler = vkDevice.createSampler(samplerInfo);
+	samplers_[key] = sampler;
+	return sampler;
+}
+
+vk::Sampler GraphicsVulkan::GetSampler(TextureWrapMode wrapMode, TextureMinMagFilter minMagFilter, float minLod)
+{
+	SamplerVulkanKey key;
+	key.minLod = minLod;
+
+	auto filter = minMagFilter == TextureMinMagFilter::Linear ? vk::Filter::eLinear : vk::Filter::eNearest;
+	key.magFilter = filter;
+	key.minFilter = filter;
+	key.mipmapMode =
+		minMagFilter == TextureMinMagFilter::Linear ? vk::SamplerMipmapMode::eLinear : vk::SamplerMipmapMode::eNearest;
+
+	auto addressMode = wrapMode == TextureWrapMode::Repeat ? vk::SamplerAddressMode::eRepeat : vk::SamplerAddressMode::eClampToEdge;
+	key.addressModeU = addressMode;
+	key.addressModeV = addressMode;
+	key.addressModeW = addressMode;
+
+	return GetSampler(key);
+}
+
+int32_t GraphicsVulkan::RegisterBindlessTexture(Texture* texture)
+{
+	if (bindlessDescriptorSet_ == nullptr || texture == nullptr)
+		return -1;
+
+	int32_t index = -1;
+	if (freeBindlessIndexes_.size() > 0)
+	{
+		index = freeBindlessIndexes_.back();
+		freeBindlessIndexes_.pop_back();
+	}
+	else if (bindlessTextures_.size() < static_cast<size_t>(MaxBindlessTextureCount))
+	{
+		index = static_cast<int32_t>(bindlessTextures_.size());
+		bindlessTextures_.push_back(nullptr);
+	}
+	else
+	{
+		return -1;
+	}
+
+	SafeAddRef(texture);
+	bindlessTextures_[index] = texture;
+
+	// it can be updated while the set is bound because of update after bind
+	vk::DescriptorImageInfo imageInfo;
+	imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+	imageInfo.imageView = static_cast<TextureVulkan*>(texture)->GetView();
+	imageInfo.sampler = defaultSampler;
+
+	vk::WriteDescriptorSet desc;
+	desc.dstSet = bindlessDescriptorSet_;
+	desc.dstBinding = 0;
+	desc.dstArrayElement = index;
+	desc.pImageInfo = &imageInfo;
+	desc.descriptorCount = 1;
+	desc.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+	vkDevice.updateDescriptorSets(1, &desc, 0, nullptr);
+
+	return index;
+}
+
+void GraphicsVulkan::UnregisterBindlessTexture(int32_t index)
+{
+	if (index < 0 || static_cast<size_t>(index) >= bindlessTextures_.size() || bindlessTextures_[index] == nullptr)
+		return;
+
+	PendingBindlessTexture pending;
+	pending.index = index;
+	pending.texture = bindlessTextures_[index];
+	pending.releasedFrame = frameCount_;
+	pendingBindlessTextures_.push_back(pending);
+
+	bindlessTextures_[index] = nullptr;
+}
+
+bool GraphicsVulkan::InitializeBindlessTextures()
+{
+	vk::DescriptorSetLayoutBinding binding;
+	binding.binding = 0;
+	binding.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+	binding.descriptorCount = MaxBindlessTextureCount;
+	binding.stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+	binding.pImmutableSamplers = nullptr;
+
+	// unregistered elements are not written
+	vk::DescriptorBindingFlagsEXT bindingFlags =
+		vk::DescriptorBindingFlagBitsEXT::eUpdateAfterBind | vk::DescriptorBindingFlagBitsEXT::ePartiallyBound;
+
+	vk::DescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo;
+	bindingFlagsInfo.bindingCount = 1;
+	bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+	vk::DescriptorSetLayoutCreateInfo layoutInfo;
+	layoutInfo.pNext = &bindingFlagsInfo;
+	layoutInfo.flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPoolEXT;
+	layoutInfo.bindingCount = 1;
+	layoutInfo.pBindings = &binding;
+	bindlessDescriptorSetLayout_ = vkDevice.createDescriptorSetLayout(layoutInfo);
+
+	vk::DescriptorPoolSize poolSize;
+	poolSize.type = vk::DescriptorType::eCombinedImageSampler;
+	poolSize.descriptorCount = MaxBindlessTextureCount;
+
+	vk::DescriptorPoolCreateInfo poolInfo;
+	poolInfo.flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBindEXT;
+	poolInfo.poolSizeCount = 1;
+	poolInfo.pPoolSizes = &poolSize;
+	poolInfo.maxSets = 1;
+	bindlessDescriptorPool_ = vkDevice.createDescriptorPool(poolInfo);
+
+	vk::DescriptorSetAllocateInfo allocateInfo;
+	allocateInfo.descriptorPool = bindlessDescriptorPool_;
+	allocateInfo.descriptorSetCount = 1;
+	allocateInfo.pSetLayouts = &bindlessDescriptorSetLayout_;
+	bindlessDescriptorSet_ = vkDevice.allocateDescriptorSets(allocateInfo)[0];
+
+	return true;
+}
+
+void GraphicsVulkan::DisposeBindlessTextures()
+{
+	for (auto& pending : pendingBindlessTextures_)
+	{
+		SafeRelease(pending.texture);
+	}
+	pendingBindlessTextures_.clear();
+
+	for (auto& texture : bindlessTextures_)
+	{
+		SafeRelease(texture);
+	}
+	bindlessTextures_.clear();
+	freeBindlessIndexes_.clear();
+
+	if (bindlessDescriptorPool_ != nullptr)
+	{
+		vkDevice.destroyDescriptorPool(bindlessDescriptorPool_);
+		bindlessDescriptorPool_ = nullptr;
+		bindlessDescriptorSet_ = nullptr;
+	}
+
+	if (bindlessDescriptorSetLayout_ != nullptr)
+	{
+		vkDevice.destroyDescriptorSetLayout(bindlessDescriptorSetLayout_);
+		bindlessDescriptorSetLayout_ = nullptr;
+	}
+}
+
+bool GraphicsVulkan::InitializeDefaultResources()
+{
+	// a buffer is read as zero
+	defaultBuffer_ = std::unique_ptr<Buffer>(new Buffer(this, false));
+
+	{
+		vk::BufferCreateInfo bufferInfo;
+		bufferInfo.size = DefaultBufferSize;
+		bufferInfo.usage = vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer;
+		SetSharingMode(bufferInfo);
+		defaultBuffer_->buffer = vkDevice.createBuffer(bufferInfo);
+
+		vk::MemoryRequirements memReqs = vkDevice.getBufferMemoryRequirements(defaultBuffer_->buffer);
+		vk::MemoryAllocateInfo memAlloc;
+		memAlloc.allocationSize = memReqs.size;
+		memAlloc.memoryTypeIndex = GetMemoryTypeIndex(
+			memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+		defaultBuffer_->devMem = vkDevice.allocateMemory(memAlloc);
+		vkDevice.bindBufferMemory(defaultBuffer_->buffer, defaultBuffer_->devMem, 0);
+
+		auto dst = vkDevice.mapMemory(defaultBuffer_->devMem, 0, DefaultBufferSize, vk::MemoryMapFlags());
+		memset(dst, 0, DefaultBufferSize);
+		vkDevice.unmapMemory(defaultBuffer_->devMem);
+	}
+
+	// a texture is cleared with transparent black
+	{
+		vk::ImageCreateInfo imageInfo;
+		imageInfo.imageType = vk::ImageType::e2D;
+		imageInfo.format = vk::Format::eR8G8B8A8Unorm;
+		imageInfo.extent = vk::Extent3D(1, 1, 1);
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.samples = vk::SampleCountFlagBits::e1;
+		imageInfo.tiling = vk::ImageTiling::eOptimal;
+		imageInfo.usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+		imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+		SetSharingMode(imageInfo);
+		defaultImage_ = vkDevice.createImage(imageInfo);
+
+		vk::MemoryRequirements memReqs = vkDevice.getImageMemoryRequirements(defaultImage_);
+		vk::MemoryAllocateInfo memAlloc;
+		memAlloc.allocationSize = memReqs.size;
+		memAlloc.memoryTypeIndex = GetMemoryTypeIndex(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+		defaultImageMemory_ = vkDevice.allocateMemory(memAlloc);
+		vkDevice.bindImageMemory(defaultImage_, defaultImageMemory_, 0);
+
+		vk::ImageSubresourceRange range(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+
+		vk::ImageViewCreateInfo viewInfo;
+		viewInfo.image = defaultImage_;
+		viewInfo.viewType = vk::ImageViewType::e2D;
+		viewInfo.format = imageInfo.format;
+		viewInfo.subresourceRange = range;
+		defaultImageView_ = vkDevice.createImageView(viewInfo);
+
+		vk::CommandBufferAllocateInfo cmdBufInfo;
+		cmdBufInfo.commandPool = vkCmdPool;
+		cmdBufInfo.level = vk::CommandBufferLevel::ePrimary;
+		cmdBufInfo.commandBufferCount = 1;
+		auto commandBuffer = vkDevice.allocateCommandBuffers(cmdBufInfo)[0];
+
+		vk::CommandBufferBeginInfo cmdBufferBeginInfo;
+		cmdBufferBeginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+		commandBuffer.begin(cmdBufferBeginInfo);
+		SetImageLayout(commandBuffer, defaultImage_, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, range);
+		commandBuffer.clearColorImage(
+			defaultImage_, vk::ImageLayout::eTransferDstOptimal, vk::ClearColorValue(std::array<float, 4>{0.0f, 0.0f, 0.0f, 0.0f}), range);
+		SetImageLayout(commandBuffer, defaultImage_, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, range);
+		commandBuffer.end();
+
+		vk::SubmitInfo submitInfo;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+		vkQueue.submit(submitInfo, VK_NULL_HANDLE);
+		vkQueue.waitIdle();
+		vkDevice.freeCommandBuffers(vkCmdPool, commandBuffer);
+	}
+
+	return true;
+}
+
+void GraphicsVulkan::DisposeDefaultResources()
+{
+	defaultBuffer_.reset();
+
+	if (defaultImageView_ != nullptr)
+	{
+		vkDevice.destroyImageView(defaultImageView_);
+		defaultImageView_ = nullptr;
+	}
+
+	if (defaultImage_ != nullptr)
+	{
+		vkDevice.destroyImage(defaultImage_);
+		vkDevice.freeMemory(defaultImageMemory_);
+		defaultImage_ = nullptr;
+		defaultImageMemory_ = nullptr;
+	}
+}
+
 std::shared_ptr<RenderPassPipelineStateVulkan>
 GraphicsVulkan::CreateRenderPassPipelineState(bool isPresentMode, bool hasDepth, vk::Format format)
 {
@@ -346,6 +1288,17 @@ GraphicsVulkan::CreateRenderPassPipelineState(bool isPresentMode, bool hasDepth,
 	key.isPresentMode = isPresentMode;
 	key.hasDepth = hasDepth;
 	key.format = format;
+	return CreateRenderPassPipelineState(key);
+}
+
+std::shared_ptr<RenderPassPipelineStateVulkan> GraphicsVulkan::CreateRenderPassPipelineState(const RenderPassPipelineStateVulkanKey& key)
+{
+	// render passes are begun while command lists are recorded on other threads
+	std::lock_guard<std::mutex> lock(renderPassPipelineStatesMutex_);
+
+	auto isPresentMode = key.isPresentMode;
+	auto hasDepth = key.hasDepth;
+	auto format = key.format;
 
 	// already?
 	{
@@ -361,63 +1314,76 @@ GraphicsVulkan::CreateRenderPassPipelineState(bool isPresentMode, bool hasDepth,
 	}
 
 	// settings
-	std::array<vk::AttachmentDescription, 2> attachmentDescs;
-	std::array<vk::AttachmentReference, 2> attachmentRefs;
-
-	// color buffer
-	attachmentDescs[0].format = format;
-	attachmentDescs[0].samples = vk::SampleCountFlagBits::e1;
+	auto colorCount = key.colorCount;
+	std::vector<vk::AttachmentDescription> attachmentDescs;
+	std::vector<vk::AttachmentReference> colorReferences;
+	vk::AttachmentReference depthReference;
 
-	// attachmentDescs[0].loadOp = vk::AttachmentLoadOp::eDontCare;
+	// color buffers
+	for (int32_t i = 0; i < colorCount; i++)
+	{
+		vk::AttachmentDescription attachmentDesc;
+		attachmentDesc.format = format;
+		attachmentDesc.samples = vk::SampleCountFlagBits::e1;
+		attachmentDesc.loadOp = key.colorLoadOp;
+		attachmentDesc.storeOp = key.colorStoreOp;
+		attachmentDesc.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
+		attachmentDesc.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
+
+		// offscreen textures are transited before render passes to load them and read from shaders after render passes
+		if (isPresentMode)
+		{
+			attachmentDesc.finalLayout = vk::ImageLayout::ePresentSrcKHR;
+		}
+		else
+		{
+			attachmentDesc.finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+		}
 
-	// TODO : improve it
-	attachmentDescs[0].loadOp = vk::AttachmentLoadOp::eClear;
+		// contents are discarded with an undefined layout, so a layout is specified only when they are loaded
+		if (key.colorLoadOp == vk::AttachmentLoadOp::eLoad)
+		{
+			attachmentDesc.initialLayout = isPresentMode ? vk::ImageLayout::ePresentSrcKHR : vk::ImageLayout::eColorAttachmentOptimal;
+		}
+		else
+		{
+			attachmentDesc.initialLayout = vk::ImageLayout::eUndefined;
+		}
 
-	attachmentDescs[0].storeOp = vk::AttachmentStoreOp::eStore;
-	attachmentDescs[0].stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
-	attachmentDescs[0].stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
-	attachmentDescs[0].initialLayout = vk::ImageLayout::eUndefined;
+		attachmentDescs.push_back(attachmentDesc);
 
-	if (isPresentMode)
-	{
-		attachmentDescs[0].finalLayout = vk::ImageLayout::ePresentSrcKHR;
-	}
-	else
-	{
-		attachmentDescs[0].finalLayout = vk::ImageLayout::eColorAttachmentOptimal;
+		vk::AttachmentReference colorReference;
+		colorReference.attachment = static_cast<uint32_t>(i);
+		colorReference.layout = vk::ImageLayout::eColorAttachmentOptimal;
+		colorReferences.push_back(colorReference);
 	}
 
 	// depth buffer
 	if (hasDepth)
 	{
-		attachmentDescs[1].format = vk::Format::eD32SfloatS8Uint;
-		attachmentDescs[1].samples = vk::SampleCountFlagBits::e1;
-
-		// attachmentDescs[1].loadOp = vk::AttachmentLoadOp::eDontCare;
-		// TODO : improve it
-		attachmentDescs[1].loadOp = vk::AttachmentLoadOp::eClear;
-		attachmentDescs[1].storeOp = vk::AttachmentStoreOp::eStore;
-		attachmentDescs[1].stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
-		attachmentDescs[1].stencilStoreOp = vk::AttachmentStoreOp::eStore;
-		attachmentDescs[1].initialLayout = vk::ImageLayout::eUndefined;
-		attachmentDescs[1].finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+		vk::AttachmentDescription attachmentDesc;
+		attachmentDesc.format = vk::Format::eD32SfloatS8Uint;
+		attachmentDesc.samples = vk::SampleCountFlagBits::e1;
+		attachmentDesc.loadOp = key.depthLoadOp;
+		attachmentDesc.storeOp = key.depthStoreOp;
+		attachmentDesc.stencilLoadOp = key.depthLoadOp;
+		attachmentDesc.stencilStoreOp = key.depthStoreOp;
+		attachmentDesc.finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+		attachmentDesc.initialLayout =
+			key.depthLoadOp == vk::AttachmentLoadOp::eLoad ? attachmentDesc.finalLayout : vk::ImageLayout::eUndefined;
+		attachmentDescs.push_back(attachmentDesc);
+
+		depthReference.attachment = static_cast<uint32_t>(colorCount);
+		depthReference.layout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
 	}
 
-	vk::AttachmentReference& colorReference = attachmentRefs[0];
-	colorReference.attachment = 0;
-	colorReference.layout = vk::ImageLayout::eColorAttachmentOptimal;
-
-	vk::AttachmentReference& depthReference = attachmentRefs[1];
-	depthReference.attachment = 1;
-	depthReference.layout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
-
 	std::array<vk::SubpassDescription, 1> subpasses;
 	{
 		vk::SubpassDescription& subpass = subpasses[0];
 		subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
-		subpass.colorAttachmentCount = 1;
-		subpass.pColorAttachments = &attachmentRefs[0];
-		subpass.pDepthStencilAttachment = &attachmentRefs[1];
+		subpass.colorAttachmentCount = static_cast<uint32_t>(colorReferences.size());
+		subpass.pColorAttachments = colorReferences.data();
+		subpass.pDepthStencilAttachment = hasDepth ? &depthReference : nullptr;
 	}
 
 	std::array<vk::SubpassDependency, 1> subpassDepends;
@@ -434,12 +1400,15 @@ GraphicsVulkan::CreateRenderPassPipelineState(bool isPresentMode, bool hasDepth,
 		dependency.dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
 		*/
 
+		// attachments which are written by a previous render pass are loaded or cleared after the writes finish
 		dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
 		dependency.dstSubpass = 0;
-		dependency.srcAccessMask = static_cast<vk::AccessFlagBits>(0);
-		dependency.dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-		dependency.srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-		dependency.dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+		dependency.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+		dependency.dstAccessMask = vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite |
+								   vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+		dependency.srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eEarlyFragmentTests |
+								  vk::PipelineStageFlagBits::eLateFragmentTests;
+		dependency.dstStageMask = dependency.srcStageMask;
 	}
 
 	{
@@ -449,11 +1418,8 @@ GraphicsVulkan::CreateRenderPassPipelineState(bool isPresentMode, bool hasDepth,
 		renderPassInfo.subpassCount = (uint32_t)subpasses.size();
 		renderPassInfo.pSubpasses = subpasses.data();
 
-		// based on official
-		// renderPassInfo.dependencyCount = (uint32_t)subpassDepends.size();
-		// renderPassInfo.pDependencies = subpassDepends.data();
-		renderPassInfo.dependencyCount = 0;
-		renderPassInfo.pDependencies = nullptr;
+		renderPassInfo.dependencyCount = (uint32_t)subpassDepends.size();
+		renderPassInfo.pDependencies = subpassDepends.data();
 
 		auto renderPass = GetDevice().createRenderPass(renderPassInfo);
 		if (renderPass == nullptr)
@@ -463,6 +1429,7 @@ GraphicsVulkan::CreateRenderPassPipelineState(bool isPresentMode, bool hasDepth,
 
 		std::shared_ptr<RenderPassPipelineStateVulkan> ret = std::make_shared<RenderPassPipelineStateVulkan>(this);
 		ret->renderPass = renderPass;
+		ret->key = key;
 
 		renderPassPipelineStates[key] = ret;
 
@@ -470,6 +1437,73 @@ GraphicsVulkan::CreateRenderPassPipelineState(bool isPresentMode, bool hasDepth,
 	}
 }
 
+vk::Framebuffer GraphicsVulkan::GetFramebuffer(vk::RenderPass renderPass, const FramebufferVulkanKey& key)
+{
+	std::lock_guard<std::mutex> lock(framebuffersMutex_);
+
+	auto it = framebuffers_.find(key);
+	if (it != framebuffers_.end())
+	{
+		return it->second;
+	}
+
+	std::vector<vk::ImageView> views;
+	for (int32_t i = 0; i < key.colorCount; i++)
+	{
+		views.push_back(key.colors[i]);
+	}
+
+	if (key.depth)
+	{
+		views.push_back(key.depth);
+	}
+
+	vk::FramebufferCreateInfo framebufferCreateInfo;
+	framebufferCreateInfo.renderPass = renderPass;
+	framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(views.size());
+	framebufferCreateInfo.pAttachments = views.data();
+	framebufferCreateInfo.width = key.width;
+	framebufferCreateInfo.height = key.height;
+	framebufferCreateInfo.layers = 1;
+
+	auto framebuffer = vkDevice.createFramebuffer(framebufferCreateInfo);
+	if (!framebuffer)
+	{
+		return nullptr;
+	}
+
+	framebuffers_[key] = framebuffer;
+	return framebuffer;
+}
+
+void GraphicsVulkan::DisposeFramebuffers(vk::ImageView view)
+{
+	std::lock_guard<std::mutex> lock(framebuffersMutex_);
+
+	for (auto it = framebuffers_.begin(); it != framebuffers_.end();)
+	{
+		const auto& key = it->first;
+		auto isContained = key.depth == view;
+		for (int32_t i = 0; i < key.colorCount; i++)
+		{
+			isContained |= key.colors[i] == view;
+		}
+
+		if (isContained)
+		{
+			PendingFramebuffer pending;
+			pending.framebuffer = it->second;
+			pending.releasedFrame = frameCount_;
+			pendingFramebuffers_.push_back(pending);
+			it = framebuffers_.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+}
+
 int32_t GraphicsVulkan::GetCurrentSwapBufferIndex() const
 {
 	assert(currentSwapBufferIndex >= 0);
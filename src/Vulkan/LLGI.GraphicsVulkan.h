@@ -3,6 +3,7 @@
 #include "../LLGI.Graphics.h"
 #include "LLGI.BaseVulkan.h"
 #include <functional>
+#include <mutex>
 #include <unordered_map>
 
 namespace LLGI
@@ -12,6 +13,82 @@ class RenderPassVulkan;
 class RenderPassPipelineStateVulkan;
 class TextureVulkan;
 
+struct RenderPassPipelineStateVulkanKey
+{
+	bool isPresentMode;
+	bool hasDepth;
+	vk::Format format;
+
+	//! the number of color buffers which have the same format
+	int32_t colorCount = 1;
+
+	vk::AttachmentLoadOp colorLoadOp = vk::AttachmentLoadOp::eClear;
+	vk::AttachmentStoreOp colorStoreOp = vk::AttachmentStoreOp::eStore;
+	vk::AttachmentLoadOp depthLoadOp = vk::AttachmentLoadOp::eClear;
+	vk::AttachmentStoreOp depthStoreOp = vk::AttachmentStoreOp::eStore;
+
+	bool operator==(const RenderPassPipelineStateVulkanKey& value) const
+	{
+		return (isPresentMode == value.isPresentMode && hasDepth == value.hasDepth && format == value.format &&
+				colorCount == value.colorCount && colorLoadOp == value.colorLoadOp && colorStoreOp == value.colorStoreOp &&
+				depthLoadOp == value.depthLoadOp && depthStoreOp == value.depthStoreOp);
+	}
+
+	bool operator!=(const RenderPassPipelineStateVulkanKey& value) const { return !(*this == value); }
+
+	struct Hash
+	{
+		typedef std::size_t result_type;
+
+		std::size_t operator()(const RenderPassPipelineStateVulkanKey& key) const
+		{
+			return std::hash<std::int32_t>()(static_cast<int>(key.format)) + std::hash<bool>()(key.isPresentMode) +
+				   std::hash<bool>()(key.hasDepth) + std::hash<std::int32_t>()(key.colorCount << 4) +
+				   std::hash<std::int32_t>()(static_cast<int>(key.colorLoadOp) << 8) +
+				   std::hash<std::int32_t>()(static_cast<int>(key.colorStoreOp) << 12) +
+				   std::hash<std::int32_t>()(static_cast<int>(key.depthLoadOp) << 16) +
+				   std::hash<std::int32_t>()(static_cast<int>(key.depthStoreOp) << 20);
+		}
+	};
+};
+
+/**
+	@brief	a description of a framebuffer which is shared between render passes with the same attachments
+*/
+struct FramebufferVulkanKey
+{
+	std::array<vk::ImageView, 4> colors;
+	int32_t colorCount = 0;
+	vk::ImageView depth = nullptr;
+	int32_t width = 0;
+	int32_t height = 0;
+
+	bool operator==(const FramebufferVulkanKey& value) const
+	{
+		return colors == value.colors && colorCount == value.colorCount && depth == value.depth && width == value.width &&
+			   height == value.height;
+	}
+
+	struct Hash
+	{
+		typedef std::size_t result_type;
+
+		std::size_t operator()(const FramebufferVulkanKey& key) const
+		{
+			std::size_t hash = 0;
+			for (int32_t i = 0; i < key.colorCount; i++)
+			{
+				HashCombine(hash, std::hash<VkImageView>()(static_cast<VkImageView>(key.colors[i])));
+			}
+			HashCombine(hash, std::hash<VkImageView>()(static_cast<VkImageView>(key.depth)));
+			HashCombine(hash, std::hash<int32_t>()(key.colorCount));
+			HashCombine(hash, std::hash<int32_t>()(key.width));
+			HashCombine(hash, std::hash<int32_t>()(key.height));
+			return hash;
+		}
+	};
+};
+
 class RenderPassVulkan : public RenderPass
 {
 private:
@@ -19,8 +96,18 @@ private:
 	bool isStrongRef_ = false;
 	Vec2I imageSize_;
 
-	std::array<std::shared_ptr<TextureVulkan>, 4> colorBufferPtrs;
-	std::shared_ptr<TextureVulkan> depthBufferPtr;
+	//! a framebuffer for offscreen is owned by graphics
+	bool isFrameBufferOwned_ = false;
+	int32_t colorBufferCount_ = 0;
+
+	std::array<Ref<TextureVulkan>, 4> colorBufferPtrs;
+	Ref<TextureVulkan> depthBufferPtr;
+
+	//! a key of renderPassPipelineState with load and store ops which were used last
+	RenderPassPipelineStateVulkanKey key_;
+
+	//! a swapchain image is undefined until it is rendered first
+	bool isScreenImageUsed_ = false;
 
 public:
 	std::shared_ptr<RenderPassPipelineStateVulkan> renderPassPipelineState;
@@ -46,10 +133,29 @@ public:
 	/**
 		@brief	initialize for offscreen
 	*/
-	bool Initialize(const TextureVulkan** textures, int32_t textureCount, TextureVulkan* depthTexture);
+	bool Initialize(TextureVulkan** textures, int32_t textureCount, TextureVulkan* depthTexture);
 
 	Vec2I GetImageSize() const;
 
+	bool GetIsScreen() const { return key_.isPresentMode; }
+
+	bool GetIsScreenImageUsed() const { return isScreenImageUsed_; }
+
+	void SetIsScreenImageUsed(bool isUsed) { isScreenImageUsed_ = isUsed; }
+
+	int32_t GetColorBufferCount() const { return colorBufferCount_; }
+
+	TextureVulkan* GetColorBuffer(int32_t index) const { return colorBufferPtrs[index].Get(); }
+
+	TextureVulkan* GetDepthBuffer() const { return depthBufferPtr.Get(); }
+
+	/**
+		@brief	replace renderPassPipelineState if load and store ops are changed
+		@note
+		A framebuffer is reused because it is compatible with render passes which differ only in load and store ops.
+	*/
+	void UpdateRenderPassPipelineState();
+
 	RenderPassPipelineState* CreateRenderPassPipelineState() override;
 };
 
@@ -65,28 +171,58 @@ public:
 
 	vk::RenderPass renderPass;
 
+	RenderPassPipelineStateVulkanKey key;
+
 	vk::RenderPass GetRenderPass() const;
 };
 
-struct RenderPassPipelineStateVulkanKey
-{
-	bool isPresentMode;
-	bool hasDepth;
-	vk::Format format;
 
-	bool operator==(const RenderPassPipelineStateVulkanKey& value) const
+/**
+	@brief	a description of a sampler which is shared between command lists
+*/
+struct SamplerVulkanKey
+{
+	vk::Filter magFilter = vk::Filter::eLinear;
+	vk::Filter minFilter = vk::Filter::eLinear;
+	vk::SamplerMipmapMode mipmapMode = vk::SamplerMipmapMode::eLinear;
+	vk::SamplerAddressMode addressModeU = vk::SamplerAddressMode::eRepeat;
+	vk::SamplerAddressMode addressModeV = vk::SamplerAddressMode::eRepeat;
+	vk::SamplerAddressMode addressModeW = vk::SamplerAddressMode::eRepeat;
+	bool anisotropyEnable = false;
+	float maxAnisotropy = 1.0f;
+	bool compareEnable = false;
+	vk::CompareOp compareOp = vk::CompareOp::eAlways;
+	float minLod = 0.0f;
+	float maxLod = VK_LOD_CLAMP_NONE;
+
+	bool operator==(const SamplerVulkanKey& value) const
 	{
-		return (isPresentMode == value.isPresentMode && hasDepth == value.hasDepth && format == value.format);
+		return magFilter == value.magFilter && minFilter == value.minFilter && mipmapMode == value.mipmapMode &&
+			   addressModeU == value.addressModeU && addressModeV == value.addressModeV && addressModeW == value.addressModeW &&
+			   anisotropyEnable == value.anisotropyEnable && maxAnisotropy == value.maxAnisotropy &&
+			   compareEnable == value.compareEnable && compareOp == value.compareOp && minLod == value.minLod && maxLod == value.maxLod;
 	}
 
 	struct Hash
 	{
 		typedef std::size_t result_type;
 
-		std::size_t operator()(const RenderPassPipelineStateVulkanKey& key) const
+		std::size_t operator()(const SamplerVulkanKey& key) const
 		{
-			return std::hash<std::int32_t>()(static_cast<int>(key.format)) + std::hash<bool>()(key.isPresentMode) +
-				   std::hash<bool>()(key.hasDepth);
+			std::size_t hash = 0;
+			HashCombine(hash, std::hash<int32_t>()(static_cast<int32_t>(key.magFilter)));
+			HashCombine(hash, std::hash<int32_t>()(static_cast<int32_t>(key.minFilter)));
+			HashCombine(hash, std::hash<int32_t>()(static_cast<int32_t>(key.mipmapMode)));
+			HashCombine(hash, std::hash<int32_t>()(static_cast<int32_t>(key.addressModeU)));
+			HashCombine(hash, std::hash<int32_t>()(static_cast<int32_t>(key.addressModeV)));
+			HashCombine(hash, std::hash<int32_t>()(static_cast<int32_t>(key.addressModeW)));
+			HashCombine(hash, std::hash<bool>()(key.anisotropyEnable));
+			HashCombine(hash, std::hash<float>()(key.maxAnisotropy));
+			HashCombine(hash, std::hash<bool>()(key.compareEnable));
+			HashCombine(hash, std::hash<int32_t>()(static_cast<int32_t>(key.compareOp)));
+			HashCombine(hash, std::hash<float>()(key.minLod));
+			HashCombine(hash, std::hash<float>()(key.maxLod));
+			return hash;
 		}
 	};
 };
@@ -113,6 +249,37 @@ public:
 	int currentSwapBufferIndex;
 };
 
+class PlatformFeatures
+{
+public:
+	//! whether VK_EXT_descriptor_indexing is enabled to make bindless textures
+	bool isDescriptorIndexingEnabled = false;
+
+	//! whether VK_KHR_timeline_semaphore is enabled to make fences
+	bool isTimelineSemaphoreEnabled = false;
+};
+
+class PlatformQueue
+{
+public:
+	vk::Queue queue = nullptr;
+	uint32_t familyIndex = 0;
+	vk::CommandPool commandPool = nullptr;
+};
+
+/**
+	@brief	queues which graphics uses
+	@note
+	transfer and compute have the same values as graphics if the device doesn't have dedicated queue families.
+*/
+class PlatformQueues
+{
+public:
+	PlatformQueue graphics;
+	PlatformQueue transfer;
+	PlatformQueue compute;
+};
+
 class GraphicsVulkan : public Graphics
 {
 private:
@@ -123,27 +290,148 @@ private:
 					   std::weak_ptr<RenderPassPipelineStateVulkan>,
 					   RenderPassPipelineStateVulkanKey::Hash>
 		renderPassPipelineStates;
+	std::mutex renderPassPipelineStatesMutex_;
 
-	std::vector<std::shared_ptr<RenderPassVulkan>> renderPasses;
+	std::vector<Ref<RenderPassVulkan>> renderPasses;
 	vk::Image currentColorBuffer;
 
+	std::unordered_map<FramebufferVulkanKey, vk::Framebuffer, FramebufferVulkanKey::Hash> framebuffers_;
+
+	//! it guards framebuffers_ and pendingFramebuffers_
+	std::mutex framebuffersMutex_;
+
+	struct PendingFramebuffer
+	{
+		vk::Framebuffer framebuffer;
+		int64_t releasedFrame;
+	};
+
+	//! framebuffers which may be used by frames in flight
+	std::vector<PendingFramebuffer> pendingFramebuffers_;
+
 	vk::Device vkDevice;
 	vk::Queue vkQueue;
 	vk::CommandPool vkCmdPool;
 	vk::PhysicalDevice vkPysicalDevice;
 
+	PlatformQueues queues_;
+
+	//! distinct queue families which resources are shared among
+	std::vector<uint32_t> queueFamilyIndexes_;
+
+	//! semaphores which are signaled by other queues in a frame
+	struct SemaphoreFrame
+	{
+		std::vector<vk::Semaphore> semaphores;
+		size_t usedCount = 0;
+
+		//! fences of submissions to the compute queue, which are waited before compute lists of the frame are recorded again
+		std::vector<vk::Fence> computeFences;
+		size_t usedComputeFenceCount = 0;
+	};
+
+	std::vector<SemaphoreFrame> semaphoreFrames_;
+
+	//! semaphores which the next submission to the graphics queue waits
+	std::vector<vk::Semaphore> waitSemaphores_;
+
+	vk::Semaphore GetSemaphore();
+
+	vk::Fence GetComputeFence();
+
+	//! submit a command buffer to the graphics queue after submissions of other queues
+	void SubmitToGraphicsQueue(vk::CommandBuffer& commandBuffer);
+
 	vk::Sampler defaultSampler = nullptr;
 
-	std::function<void(vk::CommandBuffer&)> addCommand_;
+	//! resources which are written into bindings which are not bound
+	std::unique_ptr<Buffer> defaultBuffer_;
+	vk::Image defaultImage_ = nullptr;
+	vk::DeviceMemory defaultImageMemory_ = nullptr;
+	vk::ImageView defaultImageView_ = nullptr;
+
+	bool InitializeDefaultResources();
+	void DisposeDefaultResources();
+
+	std::unordered_map<SamplerVulkanKey, vk::Sampler, SamplerVulkanKey::Hash> samplers_;
+	std::mutex samplersMutex_;
+
+	struct PendingBindlessTexture
+	{
+		int32_t index;
+		Texture* texture;
+		int64_t releasedFrame;
+	};
+
+	PlatformFeatures features_;
+	int64_t frameCount_ = 0;
+
+	vk::DescriptorSetLayout bindlessDescriptorSetLayout_ = nullptr;
+	vk::DescriptorPool bindlessDescriptorPool_ = nullptr;
+	vk::DescriptorSet bindlessDescriptorSet_ = nullptr;
+	std::vector<Texture*> bindlessTextures_;
+	std::vector<int32_t> freeBindlessIndexes_;
+	std::vector<PendingBindlessTexture> pendingBindlessTextures_;
+
+	bool InitializeBindlessTextures();
+	void DisposeBindlessTextures();
+
+	//! a staging buffer which is mapped persistently and is suballocated in a frame
+	struct StagingPage
+	{
+		std::unique_ptr<Buffer> buffer;
+		uint8_t* data = nullptr;
+		int32_t size = 0;
+		int32_t offset = 0;
+	};
+
+	//! commands and staging buffers to upload streamed textures in a frame
+	struct TextureStreamingFrame
+	{
+		vk::CommandBuffer commandBuffer = nullptr;
+
+		//! commands to make uploaded levels readable on the graphics queue when they are copied on the transfer queue
+		vk::CommandBuffer acquireCommandBuffer = nullptr;
+
+		//! commands to update regions of textures, which are submitted before the next command list
+		std::vector<vk::CommandBuffer> updateCommandBuffers;
+
+		//! pages are kept and reused when a frame of the same index comes around
+		std::vector<StagingPage> stagingPages;
+	};
+
+	//! whether the last buffer of updateCommandBuffers is being recorded
+	bool isUpdateCommandBufferRecording_ = false;
+
+	void SubmitUpdateCommandBuffer();
+
+	std::vector<TextureStreamingFrame> textureStreamingFrames_;
+
+	//! the default size of a staging page, which is the same as the default streaming budget
+	static const int32_t StagingPageSize = 4 * 1024 * 1024;
+
+	void ResetTextureStreamingFrame(TextureStreamingFrame& frame);
+
+	void DisposeTextureStreamingFrame(TextureStreamingFrame& frame);
+
+	//! allocate a region of a staging page in the current frame
+	StagingPage* AllocateStagingRegion(TextureStreamingFrame& frame, int32_t size, int32_t& offset);
+
+	std::function<void(vk::CommandBuffer&, const std::vector<vk::Semaphore>&)> addCommand_;
 	std::function<void(PlatformStatus&)> getStatus_;
 
+protected:
+	VertexBuffer* CreateTransientVertexBuffer(int32_t size) override;
+	IndexBuffer* CreateTransientIndexBuffer(int32_t stride, int32_t count) override;
+	bool UploadTextureMipMap(Texture* texture, int32_t mipLevel, const void* data, int32_t size) override;
+
 public:
 	GraphicsVulkan(const vk::Device& device,
-				   const vk::Queue& quque,
-				   const vk::CommandPool& commandPool,
+				   const PlatformQueues& queues,
 				   const vk::PhysicalDevice& pysicalDevice,
 				   const PlatformView& platformView,
-				   std::function<void(vk::CommandBuffer&)> addCommand,
+				   const PlatformFeatures& features,
+				   std::function<void(vk::CommandBuffer&, const std::vector<vk::Semaphore>&)> addCommand,
 				   std::function<void(PlatformStatus&)> getStatus);
 
 	virtual ~GraphicsVulkan();
@@ -154,6 +442,10 @@ public:
 
 	void Execute(CommandList* commandList) override;
 
+	void ExecuteCompute(CommandList* commandList) override;
+
+	uint64_t Signal(Fence* fence) override;
+
 	void WaitFinish() override;
 
 	RenderPass* GetCurrentScreen(const Color8& clearColor, bool isColorCleared, bool isDepthCleared) override;
@@ -162,16 +454,49 @@ public:
 	Shader* CreateShader(DataStructure* data, int32_t count) override;
 	PipelineState* CreatePiplineState() override;
 	CommandList* CreateCommandList() override;
+	CommandList* CreateCommandBundle(RenderPassPipelineState* renderPassPipelineState, const Vec2I& viewportSize) override;
+	CommandList* CreateComputeCommandList() override;
+	Fence* CreateFence() override;
 	ConstantBuffer* CreateConstantBuffer(int32_t size, ConstantBufferType type = ConstantBufferType::LongTime) override;
+	StorageBuffer* CreateStorageBuffer(int32_t size) override;
 	RenderPass* CreateRenderPass(const Texture** textures, int32_t textureCount, Texture* depthTexture) override;
 	Texture* CreateTexture(const Vec2I& size, bool isRenderPass, bool isDepthBuffer) override;
+	Texture* CreateDepthTexture(const Vec2I& size, bool isTransient) override;
 	Texture* CreateTexture(uint64_t id) override;
+	Texture* CreateTexture(const TextureInitializationParameter& parameter) override;
+
+	int32_t RegisterBindlessTexture(Texture* texture) override;
+	void UnregisterBindlessTexture(int32_t index) override;
 
 	std::shared_ptr<RenderPassPipelineStateVulkan> CreateRenderPassPipelineState(bool isPresentMode, bool hasDepth, vk::Format format);
 
+	std::shared_ptr<RenderPassPipelineStateVulkan> CreateRenderPassPipelineState(const RenderPassPipelineStateVulkanKey& key);
+
 	vk::Device GetDevice() const { return vkDevice; }
 	vk::CommandPool GetCommandPool() const { return vkCmdPool; }
 	vk::Queue GetQueue() const { return vkQueue; }
+	uint32_t GetQueueFamilyIndex() const { return queues_.graphics.familyIndex; }
+
+	//! a queue to upload resources. It is the graphics queue if the device doesn't have a dedicated one.
+	vk::Queue GetTransferQueue() const { return queues_.transfer.queue; }
+	vk::CommandPool GetTransferCommandPool() const { return queues_.transfer.commandPool; }
+
+	vk::Queue GetComputeQueue() const { return queues_.compute.queue; }
+	vk::CommandPool GetComputeCommandPool() const { return queues_.compute.commandPool; }
+	uint32_t GetComputeQueueFamilyIndex() const { return queues_.compute.familyIndex; }
+
+	bool HasDedicatedTransferQueue() const { return queues_.transfer.familyIndex != queues_.graphics.familyIndex; }
+	bool HasDedicatedComputeQueue() const { return queues_.compute.familyIndex != queues_.graphics.familyIndex; }
+
+	/**
+		@brief	make a buffer accessible from all queues which graphics uses
+		@note
+		Resources are shared concurrently instead of transferring ownership between queue families.
+	*/
+	void SetSharingMode(vk::BufferCreateInfo& info) const;
+
+	void SetSharingMode(vk::ImageCreateInfo& info) const;
+	vk::PhysicalDevice GetPhysicalDevice() const { return vkPysicalDevice; }
 
 	int32_t GetCurrentSwapBufferIndex() const;
 	int32_t GetSwapBufferCount() const;
@@ -179,6 +504,76 @@ public:
 
 	//! temp
 	vk::Sampler& GetDefaultSampler() { return defaultSampler; };
+
+	//! the size of GetDefaultBuffer in bytes
+	static const int32_t DefaultBufferSize = 256;
+
+	/**
+		@brief	a zero buffer which is bound to uniform and storage buffers which are not set
+	*/
+	vk::Buffer GetDefaultBuffer() const { return defaultBuffer_->buffer; }
+
+	/**
+		@brief	a 1x1 transparent black 2D texture which is bound to textures which are not set
+	*/
+	vk::ImageView GetDefaultImageView() const { return defaultImageView_; }
+
+	/**
+		@brief	get a sampler which is created once per description and shared
+		@note
+		Samplers are destroyed with this instance. It can be called while command lists are recorded on other threads.
+	*/
+	vk::Sampler GetSampler(const SamplerVulkanKey& key);
+
+	/**
+		@param	minLod	the finest mip level which is sampled
+	*/
+	vk::Sampler GetSampler(TextureWrapMode wrapMode, TextureMinMagFilter minMagFilter, float minLod = 0.0f);
+
+	/**
+		@brief	get a framebuffer which is created once per set of attachments and shared
+		@param	renderPass	a render pass which is compatible with the framebuffer
+		@note
+		Framebuffers are destroyed after frames in flight are finished when their attachments are disposed.
+		It can be called while command lists are recorded on other threads.
+	*/
+	vk::Framebuffer GetFramebuffer(vk::RenderPass renderPass, const FramebufferVulkanKey& key);
+
+	/**
+		@brief	get a command buffer on the graphics queue to update resources in the current frame
+		@note
+		Commands are submitted before the next command list or at the next frame. Don't wait for them.
+	*/
+	vk::CommandBuffer GetUpdateCommandBuffer();
+
+	/**
+		@brief	submit a command buffer on the graphics queue after updates and wait only for it
+		@note
+		Use it to read contents back on cpu.
+	*/
+	void SubmitAndWait(vk::CommandBuffer commandBuffer);
+
+	/**
+		@brief	allocate coherent memory to copy from which is valid in the current frame
+		@param	buffer	a buffer which contains the memory
+		@param	offset	an offset of the memory in the buffer, which is a multiple of 16
+	*/
+	uint8_t* AllocateStagingMemory(int32_t size, vk::Buffer& buffer, int32_t& offset);
+
+	//! destroy framebuffers which contain a view after frames which may use them are finished
+	void DisposeFramebuffers(vk::ImageView view);
+
+	//! the maximum number of textures in a bindless texture array
+	static const int32_t MaxBindlessTextureCount = 4096;
+
+	/**
+		@brief	a layout of a set which contains a runtime sized array of combined image samplers at binding 0
+		@note
+		It is nullptr when descriptor indexing is not enabled.
+	*/
+	vk::DescriptorSetLayout GetBindlessDescriptorSetLayout() const { return bindlessDescriptorSetLayout_; }
+
+	vk::DescriptorSet GetBindlessDescriptorSet() const { return bindlessDescriptorSet_; }
 };
 
 } // namespace LLGI
\ No newline at end of file
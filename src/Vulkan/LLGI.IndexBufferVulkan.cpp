@@ -10,7 +10,7 @@ bool IndexBufferVulkan::Initialize(GraphicsVulkan* graphics, int32_t stride, int
 	memSize = count_ * stride_;
 
 	SafeAddRef(graphics);
-	graphics_ = CreateSharedPtr(graphics);
+	graphics_ = graphics;
 
 	cpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics));
 	gpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics));
@@ -35,6 +35,7 @@ bool IndexBufferVulkan::Initialize(GraphicsVulkan* graphics, int32_t stride, int
 		vk::BufferCreateInfo IndexBufferInfo;
 		IndexBufferInfo.size = memSize;
 		IndexBufferInfo.usage = vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst;
+		graphics_->SetSharingMode(IndexBufferInfo);
 		gpuBuf->buffer = graphics_->GetDevice().createBuffer(IndexBufferInfo);
 
 		vk::MemoryRequirements memReqs = graphics_->GetDevice().getBufferMemoryRequirements(gpuBuf->buffer);
@@ -48,30 +49,89 @@ bool IndexBufferVulkan::Initialize(GraphicsVulkan* graphics, int32_t stride, int
 	return true;
 }
 
+bool IndexBufferVulkan::InitializeAsTransient(GraphicsVulkan* graphics, int32_t stride, int32_t count)
+{
+	stride_ = stride;
+	count_ = count;
+	memSize = count_ * stride_;
+
+	graphics_ = graphics;
+
+	gpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics, false));
+
+	// create a buffer which is visible from both cpu and gpu
+	{
+		vk::BufferCreateInfo IndexBufferInfo;
+		IndexBufferInfo.size = memSize;
+		IndexBufferInfo.usage = vk::BufferUsageFlagBits::eIndexBuffer;
+		gpuBuf->buffer = graphics_->GetDevice().createBuffer(IndexBufferInfo);
+
+		vk::MemoryRequirements memReqs = graphics_->GetDevice().getBufferMemoryRequirements(gpuBuf->buffer);
+		vk::MemoryAllocateInfo memAlloc;
+		memAlloc.allocationSize = memReqs.size;
+		memAlloc.memoryTypeIndex = graphics_->GetMemoryTypeIndex(
+			memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+		gpuBuf->devMem = graphics_->GetDevice().allocateMemory(memAlloc);
+		graphics_->GetDevice().bindBufferMemory(gpuBuf->buffer, gpuBuf->devMem, 0);
+	}
+
+	isTransient_ = true;
+
+	return true;
+}
+
 IndexBufferVulkan::IndexBufferVulkan() {}
 
-IndexBufferVulkan ::~IndexBufferVulkan() {}
+IndexBufferVulkan ::~IndexBufferVulkan()
+{
+	if (!isTransient_)
+	{
+		SafeRelease(graphics_);
+	}
+}
 
 void* IndexBufferVulkan::Lock()
 {
+	if (isTransient_)
+	{
+		data = graphics_->GetDevice().mapMemory(gpuBuf->devMem, 0, memSize, vk::MemoryMapFlags());
+		return data;
+	}
+
 	data = graphics_->GetDevice().mapMemory(cpuBuf->devMem, 0, memSize, vk::MemoryMapFlags());
 	return data;
 }
 
 void* IndexBufferVulkan::Lock(int32_t offset, int32_t size)
 {
+	if (isTransient_)
+	{
+		data = graphics_->GetDevice().mapMemory(gpuBuf->devMem, offset, size, vk::MemoryMapFlags());
+		return data;
+	}
+
 	data = graphics_->GetDevice().mapMemory(cpuBuf->devMem, offset, size, vk::MemoryMapFlags());
 	return data;
 }
 
 void IndexBufferVulkan::Unlock()
 {
+	// gpu reads transient buffers directly
+	if (isTransient_)
+	{
+		graphics_->GetDevice().unmapMemory(gpuBuf->devMem);
+		return;
+	}
 
 	graphics_->GetDevice().unmapMemory(cpuBuf->devMem);
 
+	// a first upload doesn't race with draws which read the buffer, so it is copied on the transfer queue
+	auto queue = isUploaded_ ? graphics_->GetQueue() : graphics_->GetTransferQueue();
+	auto commandPool = isUploaded_ ? graphics_->GetCommandPool() : graphics_->GetTransferCommandPool();
+
 	// copy buffer
 	vk::CommandBufferAllocateInfo cmdBufInfo;
-	cmdBufInfo.commandPool = graphics_->GetCommandPool();
+	cmdBufInfo.commandPool = commandPool;
 	cmdBufInfo.level = vk::CommandBufferLevel::ePrimary;
 	cmdBufInfo.commandBufferCount = 1;
 	vk::CommandBuffer copyCommandBuffer = graphics_->GetDevice().allocateCommandBuffers(cmdBufInfo)[0];
@@ -91,10 +151,12 @@ void IndexBufferVulkan::Unlock()
 	copySubmitInfo.commandBufferCount = 1;
 	copySubmitInfo.pCommandBuffers = &copyCommandBuffer;
 
-	graphics_->GetQueue().submit(copySubmitInfo, VK_NULL_HANDLE);
-	graphics_->GetQueue().waitIdle();
+	queue.submit(copySubmitInfo, VK_NULL_HANDLE);
+	queue.waitIdle();
+
+	graphics_->GetDevice().freeCommandBuffers(commandPool, copyCommandBuffer);
 
-	graphics_->GetDevice().freeCommandBuffers(graphics_->GetCommandPool(), copyCommandBuffer);
+	isUploaded_ = true;
 }
 
 int32_t IndexBufferVulkan::GetStride() { return stride_; }
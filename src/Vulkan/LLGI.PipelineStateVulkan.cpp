@@ -1,17 +1,11 @@
 #include "LLGI.PipelineStateVulkan.h"
 #include "LLGI.ShaderVulkan.h"
+#include <map>
 
 namespace LLGI
 {
 
-PipelineStateVulkan::PipelineStateVulkan()
-{
-	shaders.fill(0);
-	for (auto i = 0; i < descriptorSetLayouts.size(); i++)
-	{
-		descriptorSetLayouts[i] = nullptr;
-	}
-}
+PipelineStateVulkan::PipelineStateVulkan() { shaders.fill(0); }
 
 PipelineStateVulkan ::~PipelineStateVulkan()
 {
@@ -20,11 +14,24 @@ PipelineStateVulkan ::~PipelineStateVulkan()
 		SafeRelease(shader);
 	}
 
-	for (auto i = 0; i < descriptorSetLayouts.size(); i++)
+	DisposePipeline();
+
+	SafeRelease(graphics_);
+}
+
+void PipelineStateVulkan::DisposePipeline()
+{
+	for (size_t i = 0; i < descriptorSetLayouts.size(); i++)
 	{
+		// a layout for bindless textures is owned by GraphicsVulkan
+		if (static_cast<int32_t>(i) == bindlessSetIndex_)
+			continue;
+
 		graphics_->GetDevice().destroyDescriptorSetLayout(descriptorSetLayouts[i]);
-		descriptorSetLayouts[i] = nullptr;
 	}
+	descriptorSetLayouts.clear();
+	descriptorBindings_.clear();
+	bindlessSetIndex_ = -1;
 
 	if (pipelineLayout != nullptr)
 	{
@@ -38,7 +45,7 @@ PipelineStateVulkan ::~PipelineStateVulkan()
 		pipeline = nullptr;
 	}
 
-	SafeRelease(graphics_);
+	isCompute_ = false;
 }
 
 bool PipelineStateVulkan::Initialize(GraphicsVulkan* graphics)
@@ -49,6 +56,56 @@ bool PipelineStateVulkan::Initialize(GraphicsVulkan* graphics)
 	return true;
 }
 
+vk::ShaderStageFlagBits PipelineStateVulkan::GetShaderStageFlag(ShaderStageType stage)
+{
+	if (stage == ShaderStageType::Pixel)
+		return vk::ShaderStageFlagBits::eFragment;
+	if (stage == ShaderStageType::Compute)
+		return vk::ShaderStageFlagBits::eCompute;
+	return vk::ShaderStageFlagBits::eVertex;
+}
+
+static vk::Format ConvertVertexLayoutFormat(VertexLayoutFormat format)
+{
+	switch (format)
+	{
+	case VertexLayoutFormat::R32G32B32_FLOAT:
+		return vk::Format::eR32G32B32Sfloat;
+	case VertexLayoutFormat::R32G32B32A32_FLOAT:
+		return vk::Format::eR32G32B32A32Sfloat;
+	case VertexLayoutFormat::R8G8B8A8_UNORM:
+		return vk::Format::eR8G8B8A8Unorm;
+	case VertexLayoutFormat::R8G8B8A8_UINT:
+		return vk::Format::eR8G8B8A8Uint;
+	case VertexLayoutFormat::R32G32_FLOAT:
+		return vk::Format::eR32G32Sfloat;
+	case VertexLayoutFormat::R16G16_FLOAT:
+		return vk::Format::eR16G16Sfloat;
+	case VertexLayoutFormat::R16G16B16A16_FLOAT:
+		return vk::Format::eR16G16B16A16Sfloat;
+	case VertexLayoutFormat::R16G16_SNORM:
+		return vk::Format::eR16G16Snorm;
+	case VertexLayoutFormat::R16G16B16A16_SNORM:
+		return vk::Format::eR16G16B16A16Snorm;
+	case VertexLayoutFormat::R16G16_UNORM:
+		return vk::Format::eR16G16Unorm;
+	case VertexLayoutFormat::R16G16B16A16_UNORM:
+		return vk::Format::eR16G16B16A16Unorm;
+	case VertexLayoutFormat::R8G8B8A8_SNORM:
+		return vk::Format::eR8G8B8A8Snorm;
+	case VertexLayoutFormat::R10G10B10A2_UNORM:
+		// the same bit layout as DXGI_FORMAT_R10G10B10A2_UNORM and MTLVertexFormatUInt1010102Normalized
+		return vk::Format::eA2B10G10R10UnormPack32;
+	case VertexLayoutFormat::R16G16B16A16_UINT:
+		return vk::Format::eR16G16B16A16Uint;
+	case VertexLayoutFormat::R32_UINT:
+		return vk::Format::eR32Uint;
+	}
+
+	assert(0);
+	return vk::Format::eUndefined;
+}
+
 void PipelineStateVulkan::SetShader(ShaderStageType stage, Shader* shader)
 {
 
@@ -59,6 +116,15 @@ void PipelineStateVulkan::SetShader(ShaderStageType stage, Shader* shader)
 
 void PipelineStateVulkan::Compile()
 {
+	// objects which were compiled before are replaced
+	DisposePipeline();
+
+	if (shaders[static_cast<int>(ShaderStageType::Compute)] != nullptr)
+	{
+		CompileCompute();
+		return;
+	}
+
 	vk::GraphicsPipelineCreateInfo graphicsPipelineInfo;
 
 	std::vector<vk::PipelineShaderStageCreateInfo> shaderStageInfos;
@@ -69,15 +135,11 @@ void PipelineStateVulkan::Compile()
 	for (size_t i = 0; i < this->shaders.size(); i++)
 	{
 		auto shader = static_cast<ShaderVulkan*>(shaders[i]);
+		if (shader == nullptr)
+			continue;
 
 		vk::PipelineShaderStageCreateInfo info;
-
-		if (i == static_cast<int>(ShaderStageType::Vertex))
-			info.stage = vk::ShaderStageFlagBits::eVertex;
-
-		if (i == static_cast<int>(ShaderStageType::Pixel))
-			info.stage = vk::ShaderStageFlagBits::eFragment;
-
+		info.stage = GetShaderStageFlag(static_cast<ShaderStageType>(i));
 		info.module = shader->GetShaderModule();
 		info.pName = mainName.c_str();
 		shaderStageInfos.push_back(info);
@@ -90,47 +152,35 @@ void PipelineStateVulkan::Compile()
 	std::vector<vk::VertexInputBindingDescription> bindDescs;
 	std::vector<vk::VertexInputAttributeDescription> attribDescs;
 
-	int vertexOffset = 0;
+	std::array<bool, NumVertexBufferSlot> isSlotUsed;
+	isSlotUsed.fill(false);
+
 	for (int i = 0; i < VertexLayoutCount; i++)
 	{
 		vk::VertexInputAttributeDescription attribDesc;
 
-		attribDesc.binding = 0;
+		assert(0 <= VertexLayoutSlots[i] && VertexLayoutSlots[i] < NumVertexBufferSlot);
+		attribDesc.binding = VertexLayoutSlots[i];
 		attribDesc.location = i;
-		attribDesc.offset = vertexOffset;
-
-		if (VertexLayouts[i] == VertexLayoutFormat::R32G32B32_FLOAT)
-		{
-			attribDesc.format = vk::Format::eR32G32B32Sfloat;
-			vertexOffset += sizeof(float) * 3;
-		}
-
-		if (VertexLayouts[i] == VertexLayoutFormat::R32G32_FLOAT)
-		{
-			attribDesc.format = vk::Format::eR32G32Sfloat;
-			vertexOffset += sizeof(float) * 2;
-		}
-
-		if (VertexLayouts[i] == VertexLayoutFormat::R8G8B8A8_UINT)
-		{
-			attribDesc.format = vk::Format::eR8G8B8A8Uint;
-			vertexOffset += sizeof(float);
-		}
-
-		if (VertexLayouts[i] == VertexLayoutFormat::R8G8B8A8_UNORM)
-		{
-			attribDesc.format = vk::Format::eR8G8B8A8Unorm;
-			vertexOffset += sizeof(float);
-		}
+		attribDesc.offset = GetVertexLayoutOffset(i);
+		attribDesc.format = ConvertVertexLayoutFormat(VertexLayouts[i]);
+		isSlotUsed[VertexLayoutSlots[i]] = true;
 
 		attribDescs.push_back(attribDesc);
 	}
 
-	vk::VertexInputBindingDescription bindDesc;
-	bindDesc.binding = 0;
-	bindDesc.stride = vertexOffset;
-	bindDesc.inputRate = vk::VertexInputRate::eVertex;
-	bindDescs.push_back(bindDesc);
+	// a binding is created for each slot which is read
+	for (int slot = 0; slot < NumVertexBufferSlot; slot++)
+	{
+		if (!isSlotUsed[slot])
+			continue;
+
+		vk::VertexInputBindingDescription bindDesc;
+		bindDesc.binding = slot;
+		bindDesc.stride = GetVertexStride(slot);
+		bindDesc.inputRate = vk::VertexInputRate::eVertex;
+		bindDescs.push_back(bindDesc);
+	}
 
 	vk::PipelineVertexInputStateCreateInfo inputStateInfo;
 	inputStateInfo.pVertexBindingDescriptions = bindDescs.data();
@@ -281,11 +331,16 @@ void PipelineStateVulkan::Compile()
 		blendInfo.blendEnable = false;
 	}
 
+	// the same blending is used for all color buffers
+	assert(renderPassPipelineState_ != nullptr);
+	auto colorCount = static_cast<RenderPassPipelineStateVulkan*>(renderPassPipelineState_.Get())->key.colorCount;
+	std::vector<vk::PipelineColorBlendAttachmentState> blendInfos(colorCount, blendInfo);
+
 	vk::PipelineColorBlendStateCreateInfo colorBlendInfo;
 	colorBlendInfo.logicOpEnable = VK_FALSE;
 	colorBlendInfo.logicOp = vk::LogicOp::eCopy;
-	colorBlendInfo.attachmentCount = 1;
-	colorBlendInfo.pAttachments = &blendInfo;
+	colorBlendInfo.attachmentCount = static_cast<uint32_t>(blendInfos.size());
+	colorBlendInfo.pAttachments = blendInfos.data();
 	colorBlendInfo.blendConstants[0] = 0.0f;
 	colorBlendInfo.blendConstants[1] = 0.0f;
 	colorBlendInfo.blendConstants[2] = 0.0f;
@@ -304,40 +359,236 @@ void PipelineStateVulkan::Compile()
 
 	// setup a render pass
 	assert(renderPassPipelineState_ != nullptr);
-	graphicsPipelineInfo.renderPass = static_cast<RenderPassPipelineStateVulkan*>(renderPassPipelineState_.get())->GetRenderPass();
+	graphicsPipelineInfo.renderPass = static_cast<RenderPassPipelineStateVulkan*>(renderPassPipelineState_.Get())->GetRenderPass();
+
+	// setup a pipeline layout
+	if (!CreatePipelineLayout())
+		return;
+
+	graphicsPipelineInfo.layout = pipelineLayout;
+
+	// setup a pipeline
+	pipeline = graphics_->GetDevice().createGraphicsPipeline(nullptr, graphicsPipelineInfo);
+}
+
+void PipelineStateVulkan::CompileCompute()
+{
+	if (!CreatePipelineLayout())
+		return;
+
+	auto shader = static_cast<ShaderVulkan*>(shaders[static_cast<int>(ShaderStageType::Compute)]);
+
+	vk::ComputePipelineCreateInfo computePipelineInfo;
+	computePipelineInfo.stage.stage = vk::ShaderStageFlagBits::eCompute;
+	computePipelineInfo.stage.module = shader->GetShaderModule();
+	computePipelineInfo.stage.pName = "main";
+	computePipelineInfo.layout = pipelineLayout;
+
+	pipeline = graphics_->GetDevice().createComputePipeline(nullptr, computePipelineInfo);
+	isCompute_ = true;
+}
 
+bool PipelineStateVulkan::CreatePipelineLayout()
+{
 	// uniform layout info
-	std::array<vk::DescriptorSetLayoutBinding, 2> uboLayoutBindings;
-	uboLayoutBindings[0].binding = 0;
-	uboLayoutBindings[0].descriptorType = vk::DescriptorType::eUniformBufferDynamic;
-	uboLayoutBindings[0].descriptorCount = 1;
-	uboLayoutBindings[0].stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
-	uboLayoutBindings[0].pImmutableSamplers = nullptr;
-
-	uboLayoutBindings[1].binding = 1;
-	uboLayoutBindings[1].descriptorType = vk::DescriptorType::eCombinedImageSampler;
-	uboLayoutBindings[1].descriptorCount = 1;
-	uboLayoutBindings[1].stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
-	uboLayoutBindings[1].pImmutableSamplers = nullptr;
-
-	vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutInfo;
-	descriptorSetLayoutInfo.bindingCount = 2;
-	descriptorSetLayoutInfo.pBindings = uboLayoutBindings.data();
-
-	descriptorSetLayouts[0] = graphics_->GetDevice().createDescriptorSetLayout(descriptorSetLayoutInfo);
-	descriptorSetLayouts[1] = graphics_->GetDevice().createDescriptorSetLayout(descriptorSetLayoutInfo);
+	if (!CreateLayouts())
+		return false;
+
+	// push constants
+	std::array<vk::PushConstantRange, static_cast<int>(ShaderStageType::Max)> pushConstantRanges;
+	uint32_t pushConstantRangeCount = 0;
+
+	for (int i = 0; i < static_cast<int>(ShaderStageType::Max); i++)
+	{
+		if (PushConstantSizes[i] == 0)
+			continue;
+
+		auto stage = static_cast<ShaderStageType>(i);
+		assert(PushConstantSizes[i] % 4 == 0);
+		assert(GetPushConstantOffset(stage) + PushConstantSizes[i] <= MaxPushConstantSize);
+
+		pushConstantRanges[pushConstantRangeCount].stageFlags = GetShaderStageFlag(stage);
+		pushConstantRanges[pushConstantRangeCount].offset = GetPushConstantOffset(stage);
+		pushConstantRanges[pushConstantRangeCount].size = PushConstantSizes[i];
+		pushConstantRangeCount++;
+	}
 
 	vk::PipelineLayoutCreateInfo layoutInfo = {};
-	layoutInfo.setLayoutCount = 2;
+	layoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
 	layoutInfo.pSetLayouts = descriptorSetLayouts.data();
-	layoutInfo.pushConstantRangeCount = 0;
-	layoutInfo.pPushConstantRanges = nullptr;
+	layoutInfo.pushConstantRangeCount = pushConstantRangeCount;
+	layoutInfo.pPushConstantRanges = pushConstantRanges.data();
 
 	pipelineLayout = graphics_->GetDevice().createPipelineLayout(layoutInfo);
-	graphicsPipelineInfo.layout = pipelineLayout;
+	return true;
+}
 
-	// setup a pipeline
-	pipeline = graphics_->GetDevice().createGraphicsPipeline(nullptr, graphicsPipelineInfo);
+bool PipelineStateVulkan::CreateLayouts()
+{
+	// merge resources which are reflected from shaders
+	std::map<std::pair<int32_t, int32_t>, vk::DescriptorSetLayoutBinding> bindings;
+	bindlessSetIndex_ = -1;
+
+	for (size_t i = 0; i < shaders.size(); i++)
+	{
+		auto shader = static_cast<ShaderVulkan*>(shaders[i]);
+		constantBufferLocations_[i] = DescriptorLocationVulkan();
+		textureLocations_[i].fill(DescriptorLocationVulkan());
+		storageBufferLocations_[i].fill(DescriptorLocationVulkan());
+
+		if (shader == nullptr)
+			continue;
+
+		auto stageFlag = GetShaderStageFlag(static_cast<ShaderStageType>(i));
+		int32_t storageBufferUnit = 0;
+
+		for (const auto& resource : shader->GetReflection().GetBindings())
+		{
+			// a runtime sized array of textures refers textures registered to GraphicsVulkan
+			if (resource.count == 0)
+			{
+				if (resource.type != ShaderResourceTypeVulkan::CombinedImageSampler || graphics_->GetBindlessDescriptorSetLayout() == nullptr)
+					return false;
+
+				bindlessSetIndex_ = resource.set;
+				continue;
+			}
+
+			auto type = vk::DescriptorType::eCombinedImageSampler;
+			if (resource.type == ShaderResourceTypeVulkan::UniformBuffer)
+				type = vk::DescriptorType::eUniformBufferDynamic;
+			if (resource.type == ShaderResourceTypeVulkan::StorageBuffer)
+				type = vk::DescriptorType::eStorageBuffer;
+
+			auto key = std::make_pair(resource.set, resource.binding);
+			auto it = bindings.find(key);
+
+			if (it != bindings.end())
+			{
+				// a binding which is shared between stages must be same
+				if (it->second.descriptorType != type || it->second.descriptorCount != static_cast<uint32_t>(resource.count))
+				{
+					return false;
+				}
+
+				it->second.stageFlags |= stageFlag;
+			}
+			else
+			{
+				vk::DescriptorSetLayoutBinding binding;
+				binding.binding = resource.binding;
+				binding.descriptorType = type;
+				binding.descriptorCount = resource.count;
+				binding.stageFlags = stageFlag;
+				binding.pImmutableSamplers = nullptr;
+				bindings[key] = binding;
+			}
+
+			DescriptorLocationVulkan location;
+			location.set = resource.set;
+			location.binding = resource.binding;
+
+			if (resource.type == ShaderResourceTypeVulkan::UniformBuffer && !constantBufferLocations_[i].IsValid())
+			{
+				constantBufferLocations_[i] = location;
+			}
+
+			// a texture unit is bound to binding unit + 1
+			auto unit = resource.binding - 1;
+			if (resource.type == ShaderResourceTypeVulkan::CombinedImageSampler && 0 <= unit && unit < NumTexture &&
+				!textureLocations_[i][unit].IsValid())
+			{
+				textureLocations_[i][unit] = location;
+			}
+
+			// a storage buffer unit is an index among storage buffers which are ordered by set and binding
+			if (resource.type == ShaderResourceTypeVulkan::StorageBuffer)
+			{
+				if (storageBufferUnit < NumStorageBuffer)
+				{
+					storageBufferLocations_[i][storageBufferUnit] = location;
+				}
+				storageBufferUnit++;
+			}
+		}
+	}
+
+	auto setCount = bindings.empty() ? 0 : bindings.rbegin()->first.first + 1;
+
+	// a set for bindless textures must be a last set and not contain other bindings
+	if (bindlessSetIndex_ >= 0)
+	{
+		if (bindlessSetIndex_ < setCount)
+			return false;
+
+		setCount = bindlessSetIndex_ + 1;
+	}
+
+	std::vector<std::vector<vk::DescriptorSetLayoutBinding>> setBindings(setCount);
+
+	// offsets are ordered by set and binding
+	dynamicOffsets_.clear();
+	descriptorBindings_.clear();
+
+	std::map<std::pair<int32_t, int32_t>, int32_t> bindingIndexes;
+
+	for (const auto& binding : bindings)
+	{
+		setBindings[binding.first.first].push_back(binding.second);
+
+		DescriptorBindingVulkan descriptorBinding;
+		descriptorBinding.set = binding.first.first;
+		descriptorBinding.binding = binding.first.second;
+		descriptorBinding.count = static_cast<int32_t>(binding.second.descriptorCount);
+		descriptorBinding.type = binding.second.descriptorType;
+		bindingIndexes[binding.first] = static_cast<int32_t>(descriptorBindings_.size());
+		descriptorBindings_.push_back(descriptorBinding);
+
+		if (binding.second.descriptorType == vk::DescriptorType::eUniformBufferDynamic)
+		{
+			dynamicOffsets_.resize(dynamicOffsets_.size() + binding.second.descriptorCount, 0);
+		}
+	}
+
+	auto setIndex = [&bindingIndexes](DescriptorLocationVulkan& location) {
+		if (location.IsValid())
+		{
+			location.index = bindingIndexes[std::make_pair(location.set, location.binding)];
+		}
+	};
+
+	for (size_t i = 0; i < shaders.size(); i++)
+	{
+		setIndex(constantBufferLocations_[i]);
+
+		for (auto& location : textureLocations_[i])
+		{
+			setIndex(location);
+		}
+
+		for (auto& location : storageBufferLocations_[i])
+		{
+			setIndex(location);
+		}
+	}
+
+	// sets which are not used are created as empty sets
+	for (int32_t i = 0; i < setCount; i++)
+	{
+		if (i == bindlessSetIndex_)
+		{
+			descriptorSetLayouts.push_back(graphics_->GetBindlessDescriptorSetLayout());
+			continue;
+		}
+
+		const auto& setBinding = setBindings[i];
+		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutInfo;
+		descriptorSetLayoutInfo.bindingCount = static_cast<uint32_t>(setBinding.size());
+		descriptorSetLayoutInfo.pBindings = setBinding.data();
+		descriptorSetLayouts.push_back(graphics_->GetDevice().createDescriptorSetLayout(descriptorSetLayoutInfo));
+	}
+
+	return true;
 }
 
-} // namespace LLGI
\ No newline at end of file
+} // namespace LLGI
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include "../LLGI.CommandList.h"
 #include "../LLGI.PipelineState.h"
 #include "LLGI.BaseVulkan.h"
 #include "LLGI.GraphicsVulkan.h"
@@ -8,6 +9,25 @@
 namespace LLGI
 {
 
+struct DescriptorLocationVulkan
+{
+	int32_t set = -1;
+	int32_t binding = -1;
+
+	//! an index in PipelineStateVulkan::GetDescriptorBindings
+	int32_t index = -1;
+
+	bool IsValid() const { return set >= 0; }
+};
+
+struct DescriptorBindingVulkan
+{
+	int32_t set = 0;
+	int32_t binding = 0;
+	int32_t count = 1;
+	vk::DescriptorType type = vk::DescriptorType::eUniformBufferDynamic;
+};
+
 class PipelineStateVulkan : public PipelineState
 {
 private:
@@ -16,7 +36,25 @@ private:
 
 	vk::Pipeline pipeline = nullptr;
 	vk::PipelineLayout pipelineLayout = nullptr;
-	std::array<vk::DescriptorSetLayout, 2> descriptorSetLayouts;
+	std::vector<vk::DescriptorSetLayout> descriptorSetLayouts;
+	std::vector<DescriptorBindingVulkan> descriptorBindings_;
+	std::vector<uint32_t> dynamicOffsets_;
+	int32_t bindlessSetIndex_ = -1;
+
+	std::array<DescriptorLocationVulkan, static_cast<int>(ShaderStageType::Max)> constantBufferLocations_;
+	std::array<std::array<DescriptorLocationVulkan, NumTexture>, static_cast<int>(ShaderStageType::Max)> textureLocations_;
+	std::array<std::array<DescriptorLocationVulkan, NumStorageBuffer>, static_cast<int>(ShaderStageType::Max)> storageBufferLocations_;
+	bool isCompute_ = false;
+
+	bool CreateLayouts();
+
+	//! destroy layouts and a pipeline which were compiled
+	void DisposePipeline();
+
+	//! create descriptor set layouts and a pipeline layout with push constants
+	bool CreatePipelineLayout();
+
+	void CompileCompute();
 
 public:
 	PipelineStateVulkan();
@@ -29,9 +67,60 @@ public:
 
 	vk::Pipeline GetPipeline() const { return pipeline; }
 
+	//! whether it is compiled into a compute pipeline
+	bool IsCompute() const { return isCompute_; }
+
 	vk::PipelineLayout GetPipelineLayout() const { return pipelineLayout; }
 
-	const std::array<vk::DescriptorSetLayout, 2>& GetDescriptorSetLayout() const { return descriptorSetLayouts; }
+	const std::vector<vk::DescriptorSetLayout>& GetDescriptorSetLayout() const { return descriptorSetLayouts; }
+
+	/**
+		@brief	an index of a set which is GraphicsVulkan::GetBindlessDescriptorSet, or -1
+		@note
+		A runtime sized array of textures in shaders is regarded as bindless textures. It must be in the last set.
+	*/
+	int32_t GetBindlessSetIndex() const { return bindlessSetIndex_; }
+
+	/**
+		@brief	all bindings except bindless textures, which are ordered by set and binding
+		@note
+		Bindings which are not bound by resources refer default resources of GraphicsVulkan.
+	*/
+	const std::vector<DescriptorBindingVulkan>& GetDescriptorBindings() const { return descriptorBindings_; }
+
+	/**
+		@brief	zero offsets for all dynamic uniform buffers in the layout
+	*/
+	const std::vector<uint32_t>& GetDynamicOffsets() const { return dynamicOffsets_; }
+
+	/**
+		@brief	shader stage flags which are used in this pipeline
+	*/
+	static vk::ShaderStageFlagBits GetShaderStageFlag(ShaderStageType stage);
+
+	/**
+		@brief	a location of the uniform buffer which is bound by SetConstantBuffer
+	*/
+	const DescriptorLocationVulkan& GetConstantBufferLocation(ShaderStageType stage) const
+	{
+		return constantBufferLocations_[static_cast<int>(stage)];
+	}
+
+	/**
+		@brief	a location of the sampler which is bound by SetTexture
+	*/
+	const DescriptorLocationVulkan& GetTextureLocation(ShaderStageType stage, int32_t unit) const
+	{
+		return textureLocations_[static_cast<int>(stage)][unit];
+	}
+
+	/**
+		@brief	a location of the storage buffer which is bound by SetStorageBuffer
+	*/
+	const DescriptorLocationVulkan& GetStorageBufferLocation(ShaderStageType stage, int32_t unit) const
+	{
+		return storageBufferLocations_[static_cast<int>(stage)][unit];
+	}
 };
 
 } // namespace LLGI
@@ -232,6 +232,20 @@ void PlatformVulkan::SetImageBarrior(vk::CommandBuffer cmdbuffer,
 							  imageMemoryBarrier);
 }
 
+int32_t PlatformVulkan::FindQueueFamily(vk::QueueFlags flags, vk::QueueFlags excludedFlags)
+{
+	auto queueProps = vkPhysicalDevice.getQueueFamilyProperties();
+	for (size_t i = 0; i < queueProps.size(); i++)
+	{
+		if ((queueProps[i].queueFlags & flags) == flags && !(queueProps[i].queueFlags & excludedFlags))
+		{
+			return static_cast<int32_t>(i);
+		}
+	}
+
+	return -1;
+}
+
 void PlatformVulkan::Reset()
 {
 	if (vkDevice != nullptr)
@@ -274,6 +288,18 @@ void PlatformVulkan::Reset()
 			vkRenderComplete = nullptr;
 		}
 
+		if (queues_.transfer.commandPool != vkCmdPool)
+		{
+			vkDevice.destroyCommandPool(queues_.transfer.commandPool);
+		}
+
+		if (queues_.compute.commandPool != vkCmdPool)
+		{
+			vkDevice.destroyCommandPool(queues_.compute.commandPool);
+		}
+
+		queues_ = PlatformQueues();
+
 		if (vkCmdPool != nullptr)
 		{
 			vkDevice.destroyCommandPool(vkCmdPool);
@@ -362,7 +388,18 @@ bool PlatformVulkan::Initialize(Vec2I windowSize)
 	vk::ApplicationInfo appInfo;
 	appInfo.pApplicationName = "Vulkan";
 	appInfo.pEngineName = "Vulkan";
-	appInfo.apiVersion = VK_API_VERSION_1_0;
+
+	// vkEnumerateInstanceVersion doesn't exist in loaders of Vulkan 1.0
+	uint32_t instanceVersion = VK_API_VERSION_1_0;
+	auto enumerateInstanceVersion =
+		reinterpret_cast<PFN_vkEnumerateInstanceVersion>(vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion"));
+	if (enumerateInstanceVersion == nullptr || enumerateInstanceVersion(&instanceVersion) != VK_SUCCESS)
+	{
+		instanceVersion = VK_API_VERSION_1_0;
+	}
+
+	// 1.1 is required only to query features for bindless textures and fences
+	appInfo.apiVersion = instanceVersion >= VK_API_VERSION_1_1 ? VK_API_VERSION_1_1 : VK_API_VERSION_1_0;
 
 	// specify extension
 	const std::vector<const char*> extensions = {
@@ -450,22 +487,123 @@ bool PlatformVulkan::Initialize(Vec2I windowSize)
 			return false;
 		}
 
+		// find dedicated queues to overlap uploads and compute with rendering
+		auto transferQueueInd = FindQueueFamily(vk::QueueFlagBits::eTransfer, vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute);
+		auto computeQueueInd = FindQueueFamily(vk::QueueFlagBits::eCompute, vk::QueueFlagBits::eGraphics);
+
+		if (transferQueueInd < 0)
+		{
+			transferQueueInd = graphicsQueueInd;
+		}
+
+		if (computeQueueInd < 0)
+		{
+			computeQueueInd = graphicsQueueInd;
+		}
+
 		float queuePriorities[] = {0.0f};
-		vk::DeviceQueueCreateInfo queueCreateInfo;
-		queueCreateInfo.queueFamilyIndex = graphicsQueueInd;
-		queueCreateInfo.queueCount = 1;
-		queueCreateInfo.pQueuePriorities = queuePriorities;
+		std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
+		for (auto queueInd : {graphicsQueueInd, transferQueueInd, computeQueueInd})
+		{
+			auto it = std::find_if(queueCreateInfos.begin(), queueCreateInfos.end(), [queueInd](const vk::DeviceQueueCreateInfo& info) {
+				return info.queueFamilyIndex == static_cast<uint32_t>(queueInd);
+			});
+
+			if (it != queueCreateInfos.end())
+				continue;
+
+			vk::DeviceQueueCreateInfo queueCreateInfo;
+			queueCreateInfo.queueFamilyIndex = queueInd;
+			queueCreateInfo.queueCount = 1;
+			queueCreateInfo.pQueuePriorities = queuePriorities;
+			queueCreateInfos.push_back(queueCreateInfo);
+		}
 
-		const std::vector<const char*> enabledExtensions = {
+		std::vector<const char*> enabledExtensions = {
 			VK_KHR_SWAPCHAIN_EXTENSION_NAME,
 #if defined(_DEBUG)
 		// VK_EXT_DEBUG_MARKER_EXTENSION_NAME,
 #endif
 		};
+
+		// check descriptor indexing for bindless textures and timeline semaphores for fences
+		vk::PhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures;
+		vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures;
+		vk::PhysicalDeviceFeatures2 deviceFeatures2;
+		indexingFeatures.pNext = &timelineFeatures;
+		deviceFeatures2.pNext = &indexingFeatures;
+
+		bool hasDescriptorIndexing = false;
+		bool hasTimelineSemaphore = false;
+		for (const auto& extension : vkPhysicalDevice.enumerateDeviceExtensionProperties())
+		{
+			if (strcmp(extension.extensionName, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) == 0)
+			{
+				hasDescriptorIndexing = true;
+			}
+
+			if (strcmp(extension.extensionName, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) == 0)
+			{
+				hasTimelineSemaphore = true;
+			}
+		}
+
+		if ((hasDescriptorIndexing || hasTimelineSemaphore) && deviceProperties.apiVersion >= VK_API_VERSION_1_1 &&
+			appInfo.apiVersion >= VK_API_VERSION_1_1)
+		{
+			vkPhysicalDevice.getFeatures2(&deviceFeatures2);
+
+			// an index of bindless textures is dynamically uniform, so non uniform indexing is not required
+			features_.isDescriptorIndexingEnabled = hasDescriptorIndexing && indexingFeatures.runtimeDescriptorArray &&
+													indexingFeatures.descriptorBindingPartiallyBound &&
+													indexingFeatures.descriptorBindingSampledImageUpdateAfterBind;
+
+			features_.isTimelineSemaphoreEnabled = hasTimelineSemaphore && timelineFeatures.timelineSemaphore;
+		}
+
+		// enable only features which are used
+		void* enabledFeatures = nullptr;
+
+		if (features_.isTimelineSemaphoreEnabled)
+		{
+			vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR enabledTimelineFeatures;
+			enabledTimelineFeatures.timelineSemaphore = true;
+			timelineFeatures = enabledTimelineFeatures;
+			timelineFeatures.pNext = enabledFeatures;
+			enabledFeatures = &timelineFeatures;
+
+			enabledExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+		}
+
+		if (features_.isDescriptorIndexingEnabled)
+		{
+			vk::PhysicalDeviceDescriptorIndexingFeaturesEXT enabledIndexingFeatures;
+			enabledIndexingFeatures.runtimeDescriptorArray = true;
+			enabledIndexingFeatures.descriptorBindingPartiallyBound = true;
+			enabledIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = true;
+			indexingFeatures = enabledIndexingFeatures;
+			indexingFeatures.pNext = enabledFeatures;
+			enabledFeatures = &indexingFeatures;
+
+			enabledExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+		}
+
+		deviceFeatures2.features = deviceFeatures;
+		deviceFeatures2.pNext = enabledFeatures;
+
 		vk::DeviceCreateInfo deviceCreateInfo;
-		deviceCreateInfo.queueCreateInfoCount = 1;
-		deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
-		deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
+		deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
+		deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
+
+		if (enabledFeatures != nullptr)
+		{
+			deviceCreateInfo.pNext = &deviceFeatures2;
+			deviceCreateInfo.pEnabledFeatures = nullptr;
+		}
+		else
+		{
+			deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
+		}
 		deviceCreateInfo.enabledExtensionCount = enabledExtensions.size();
 		deviceCreateInfo.ppEnabledExtensionNames = enabledExtensions.data();
 		deviceCreateInfo.enabledLayerCount = validationLayers.size();
@@ -503,6 +641,28 @@ bool PlatformVulkan::Initialize(Vec2I windowSize)
 		cmdPoolInfo.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
 		vkCmdPool = vkDevice.createCommandPool(cmdPoolInfo);
 
+		queues_.graphics.queue = vkQueue;
+		queues_.graphics.familyIndex = graphicsQueueInd;
+		queues_.graphics.commandPool = vkCmdPool;
+		queues_.transfer = queues_.graphics;
+		queues_.compute = queues_.graphics;
+
+		if (transferQueueInd != graphicsQueueInd)
+		{
+			cmdPoolInfo.queueFamilyIndex = transferQueueInd;
+			queues_.transfer.queue = vkDevice.getQueue(transferQueueInd, 0);
+			queues_.transfer.familyIndex = transferQueueInd;
+			queues_.transfer.commandPool = vkDevice.createCommandPool(cmdPoolInfo);
+		}
+
+		if (computeQueueInd != graphicsQueueInd)
+		{
+			cmdPoolInfo.queueFamilyIndex = computeQueueInd;
+			queues_.compute.queue = vkDevice.getQueue(computeQueueInd, 0);
+			queues_.compute.familyIndex = computeQueueInd;
+			queues_.compute.commandPool = vkDevice.createCommandPool(cmdPoolInfo);
+		}
+
 		// get supported formats
 		auto surfaceFormats = vkPhysicalDevice.getSurfaceFormatsKHR(surface);
 
@@ -617,13 +777,10 @@ bool PlatformVulkan::Initialize(Vec2I windowSize)
 	}
 }
 
-bool PlatformVulkan::NewFrame()
-{
-	if (!window->DoEvent())
-	{
-		return false;
-	}
+bool PlatformVulkan::ProcessEvents() { return window->DoEvent(); }
 
+bool PlatformVulkan::AcquireScreen()
+{
 	AcquireNextImage(vkPresentComplete);
 	executedCommandCount = 0;
 	return true;
@@ -720,9 +877,15 @@ Graphics* PlatformVulkan::CreateGraphics()
 
 	auto getStatus = [this](PlatformStatus& status) -> void { status.currentSwapBufferIndex = this->frameIndex; };
 
-	auto addCommand = [this](vk::CommandBuffer& commandBuffer) -> void {
+	auto addCommand = [this](vk::CommandBuffer& commandBuffer, const std::vector<vk::Semaphore>& waitSemaphores) -> void {
+
+		// commands wait for uploads and compute on other queues
+		std::vector<vk::PipelineStageFlags> waitStages(waitSemaphores.size(), vk::PipelineStageFlagBits::eAllCommands);
 
 		vk::SubmitInfo copySubmitInfo;
+		copySubmitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+		copySubmitInfo.pWaitSemaphores = waitSemaphores.data();
+		copySubmitInfo.pWaitDstStageMask = waitStages.data();
 		copySubmitInfo.commandBufferCount = 1;
 		copySubmitInfo.pCommandBuffers = &commandBuffer;
 		vkQueue.submit(copySubmitInfo, VK_NULL_HANDLE);
@@ -730,7 +893,7 @@ Graphics* PlatformVulkan::CreateGraphics()
 		this->executedCommandCount++;
 	};
 
-	auto graphics = new GraphicsVulkan(vkDevice, vkQueue, vkCmdPool, vkPhysicalDevice, platformView, addCommand, getStatus);
+	auto graphics = new GraphicsVulkan(vkDevice, queues_, vkPhysicalDevice, platformView, features_, addCommand, getStatus);
 
 	return graphics;
 }
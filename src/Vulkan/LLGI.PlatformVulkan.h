@@ -4,6 +4,7 @@
 
 #include "../LLGI.Platform.h"
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.GraphicsVulkan.h"
 
 #ifdef _WIN32
 #include "../Win/LLGI.WindowWin.h"
@@ -50,6 +51,9 @@ private:
 	vk::Queue vkQueue = nullptr;
 	vk::CommandPool vkCmdPool = nullptr;
 
+	//! queues which are passed to graphics. transfer and compute are graphics when there are no dedicated families.
+	PlatformQueues queues_;
+
 	Vec2I windowSize_;
 
 	//! to check to finish present
@@ -73,6 +77,8 @@ private:
 
 	int32_t executedCommandCount = 0;
 
+	PlatformFeatures features_;
+
 #ifdef _WIN32
 	std::shared_ptr<WindowWin> window = nullptr;
 #endif
@@ -108,13 +114,20 @@ private:
 
 	void Reset();
 
+	/**
+		@brief	find a queue family which supports flags and doesn't support excluded flags
+		@return	-1 if it is not found
+	*/
+	int32_t FindQueueFamily(vk::QueueFlags flags, vk::QueueFlags excludedFlags);
+
 public:
 	PlatformVulkan();
 	virtual ~PlatformVulkan();
 
 	bool Initialize(Vec2I windowSize);
 
-	bool NewFrame() override;
+	bool ProcessEvents() override;
+	bool AcquireScreen() override;
 	void Present() override;
 	Graphics* CreateGraphics() override;
 
@@ -0,0 +1,211 @@
+#include "LLGI.ShaderReflectionVulkan.h"
+#include <algorithm>
+
+namespace LLGI
+{
+
+namespace
+{
+
+// subset of spirv.h which is required to reflect descriptors
+const uint32_t SpvMagicNumber = 0x07230203;
+const uint32_t SpvHeaderWordCount = 5;
+
+const uint32_t SpvOpTypeImage = 25;
+const uint32_t SpvOpTypeSampledImage = 27;
+const uint32_t SpvOpTypeArray = 28;
+const uint32_t SpvOpTypeRuntimeArray = 29;
+const uint32_t SpvOpTypeStruct = 30;
+const uint32_t SpvOpTypePointer = 32;
+const uint32_t SpvOpConstant = 43;
+const uint32_t SpvOpVariable = 59;
+const uint32_t SpvOpDecorate = 71;
+
+const uint32_t SpvDecorationBlock = 2;
+const uint32_t SpvDecorationBufferBlock = 3;
+const uint32_t SpvDecorationBinding = 33;
+const uint32_t SpvDecorationDescriptorSet = 34;
+
+const uint32_t SpvStorageClassUniformConstant = 0;
+const uint32_t SpvStorageClassUniform = 2;
+const uint32_t SpvStorageClassStorageBuffer = 12;
+
+struct SpvId
+{
+	uint32_t opcode = 0;
+
+	//! a pointee or an element type
+	uint32_t typeId = 0;
+
+	uint32_t storageClass = 0;
+
+	//! an array length id or a constant value
+	uint32_t value = 0;
+
+	int32_t set = -1;
+	int32_t binding = -1;
+	bool isBlock = false;
+	bool isBufferBlock = false;
+};
+
+} // namespace
+
+bool ShaderReflectionVulkan::Reflect(const void* code, int32_t size)
+{
+	bindings_.clear();
+
+	if (code == nullptr || size < static_cast<int32_t>(SpvHeaderWordCount * sizeof(uint32_t)) || size % sizeof(uint32_t) != 0)
+		return false;
+
+	auto words = static_cast<const uint32_t*>(code);
+	auto wordCount = static_cast<uint32_t>(size / sizeof(uint32_t));
+
+	if (words[0] != SpvMagicNumber)
+		return false;
+
+	auto idBound = words[3];
+	std::vector<SpvId> ids(idBound);
+	std::vector<uint32_t> variables;
+
+	uint32_t offset = SpvHeaderWordCount;
+	while (offset < wordCount)
+	{
+		auto opcode = words[offset] & 0xFFFF;
+		auto count = words[offset] >> 16;
+
+		if (count == 0 || offset + count > wordCount)
+			return false;
+
+		auto operands = words + offset + 1;
+
+		switch (opcode)
+		{
+		case SpvOpDecorate:
+			if (count >= 3 && operands[0] < idBound)
+			{
+				auto& id = ids[operands[0]];
+				if (operands[1] == SpvDecorationBlock)
+					id.isBlock = true;
+				if (operands[1] == SpvDecorationBufferBlock)
+					id.isBufferBlock = true;
+				if (operands[1] == SpvDecorationBinding && count >= 4)
+					id.binding = static_cast<int32_t>(operands[2]);
+				if (operands[1] == SpvDecorationDescriptorSet && count >= 4)
+					id.set = static_cast<int32_t>(operands[2]);
+			}
+			break;
+		case SpvOpTypeImage:
+		case SpvOpTypeSampledImage:
+		case SpvOpTypeStruct:
+			if (count >= 2 && operands[0] < idBound)
+			{
+				ids[operands[0]].opcode = opcode;
+			}
+			break;
+		case SpvOpTypeArray:
+		case SpvOpTypeRuntimeArray:
+			if (count >= 3 && operands[0] < idBound)
+			{
+				ids[operands[0]].opcode = opcode;
+				ids[operands[0]].typeId = operands[1];
+				ids[operands[0]].value = opcode == SpvOpTypeArray && count >= 4 ? operands[2] : 0;
+			}
+			break;
+		case SpvOpTypePointer:
+			if (count >= 4 && operands[0] < idBound)
+			{
+				ids[operands[0]].opcode = opcode;
+				ids[operands[0]].storageClass = operands[1];
+				ids[operands[0]].typeId = operands[2];
+			}
+			break;
+		case SpvOpConstant:
+			if (count >= 4 && operands[1] < idBound)
+			{
+				ids[operands[1]].opcode = opcode;
+				ids[operands[1]].typeId = operands[0];
+				ids[operands[1]].value = operands[2];
+			}
+			break;
+		case SpvOpVariable:
+			if (count >= 4 && operands[1] < idBound)
+			{
+				ids[operands[1]].opcode = opcode;
+				ids[operands[1]].typeId = operands[0];
+				ids[operands[1]].storageClass = operands[2];
+				variables.push_back(operands[1]);
+			}
+			break;
+		default:
+			break;
+		}
+
+		offset += count;
+	}
+
+	for (auto variableId : variables)
+	{
+		const auto& variable = ids[variableId];
+
+		if (variable.storageClass != SpvStorageClassUniform && variable.storageClass != SpvStorageClassUniformConstant &&
+			variable.storageClass != SpvStorageClassStorageBuffer)
+			continue;
+
+		if (variable.typeId >= idBound || ids[variable.typeId].opcode != SpvOpTypePointer)
+			continue;
+
+		ShaderResourceBindingVulkan binding;
+		binding.set = (std::max)(variable.set, 0);
+		binding.binding = (std::max)(variable.binding, 0);
+
+		// unwrap arrays
+		auto typeId = ids[variable.typeId].typeId;
+		while (typeId < idBound && (ids[typeId].opcode == SpvOpTypeArray || ids[typeId].opcode == SpvOpTypeRuntimeArray))
+		{
+			if (ids[typeId].opcode == SpvOpTypeRuntimeArray)
+			{
+				binding.count = 0;
+			}
+			else if (ids[typeId].value < idBound)
+			{
+				binding.count *= static_cast<int32_t>(ids[ids[typeId].value].value);
+			}
+
+			typeId = ids[typeId].typeId;
+		}
+
+		if (typeId >= idBound)
+			continue;
+
+		const auto& type = ids[typeId];
+
+		if (variable.storageClass == SpvStorageClassUniform && type.opcode == SpvOpTypeStruct && type.isBlock)
+		{
+			binding.type = ShaderResourceTypeVulkan::UniformBuffer;
+		}
+		else if (type.opcode == SpvOpTypeStruct && (type.isBufferBlock || variable.storageClass == SpvStorageClassStorageBuffer))
+		{
+			// a buffer block is decorated with BufferBlock in old SPIR-V or is in StorageBuffer class
+			binding.type = ShaderResourceTypeVulkan::StorageBuffer;
+		}
+		else if (variable.storageClass == SpvStorageClassUniformConstant && type.opcode == SpvOpTypeSampledImage)
+		{
+			binding.type = ShaderResourceTypeVulkan::CombinedImageSampler;
+		}
+		else
+		{
+			// separated images and samplers are not supported
+			continue;
+		}
+
+		bindings_.push_back(binding);
+	}
+
+	std::sort(bindings_.begin(), bindings_.end(), [](const ShaderResourceBindingVulkan& a, const ShaderResourceBindingVulkan& b) {
+		return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+	});
+
+	return true;
+}
+
+} // namespace LLGI
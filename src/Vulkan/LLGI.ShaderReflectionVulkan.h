@@ -0,0 +1,45 @@
+#pragma once
+
+#include "../LLGI.Base.h"
+
+namespace LLGI
+{
+
+enum class ShaderResourceTypeVulkan
+{
+	UniformBuffer,
+	CombinedImageSampler,
+	StorageBuffer,
+};
+
+struct ShaderResourceBindingVulkan
+{
+	int32_t set = 0;
+	int32_t binding = 0;
+
+	//! 0 means a runtime sized array
+	int32_t count = 1;
+
+	ShaderResourceTypeVulkan type = ShaderResourceTypeVulkan::UniformBuffer;
+};
+
+/**
+	@brief	a resource interface which is reflected from SPIR-V
+*/
+class ShaderReflectionVulkan
+{
+private:
+	std::vector<ShaderResourceBindingVulkan> bindings_;
+
+public:
+	/**
+		@brief	parse SPIR-V and collect descriptor bindings
+		@param	code	SPIR-V binary
+		@param	size	size of the binary in bytes
+	*/
+	bool Reflect(const void* code, int32_t size);
+
+	const std::vector<ShaderResourceBindingVulkan>& GetBindings() const { return bindings_; }
+};
+
+} // namespace LLGI
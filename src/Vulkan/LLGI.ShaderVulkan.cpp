@@ -26,6 +26,9 @@ bool ShaderVulkan::Initialize(GraphicsVulkan* graphics, DataStructure* data, int
 	buffer.resize(data[0].Size);
 	memcpy(buffer.data(), data[0].Data, data[0].Size);
 
+	if (!reflection_.Reflect(buffer.data(), static_cast<int32_t>(buffer.size())))
+		return false;
+
 	SafeAddRef(graphics);
 	SafeRelease(graphics_);
 	graphics_ = graphics;
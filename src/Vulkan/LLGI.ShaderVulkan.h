@@ -4,6 +4,7 @@
 #include "../LLGI.Shader.h"
 #include "LLGI.BaseVulkan.h"
 #include "LLGI.GraphicsVulkan.h"
+#include "LLGI.ShaderReflectionVulkan.h"
 
 namespace LLGI
 {
@@ -14,6 +15,7 @@ private:
 	GraphicsVulkan* graphics_ = nullptr;
 	std::vector<uint8_t> buffer;
 	vk::ShaderModule shaderModule;
+	ShaderReflectionVulkan reflection_;
 
 public:
 	ShaderVulkan();
@@ -22,6 +24,8 @@ public:
 	bool Initialize(GraphicsVulkan* graphics, DataStructure* data, int count);
 
 	vk::ShaderModule GetShaderModule() const;
+
+	const ShaderReflectionVulkan& GetReflection() const { return reflection_; }
 };
 
 
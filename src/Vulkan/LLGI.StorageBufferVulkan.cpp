@@ -0,0 +1,189 @@
+#include "LLGI.StorageBufferVulkan.h"
+
+namespace LLGI
+{
+
+static const vk::PipelineStageFlags ShaderStages =
+	vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eComputeShader;
+
+void StorageBufferVulkan::ReadBack(int32_t offset, int32_t size)
+{
+	vk::CommandBufferAllocateInfo cmdBufInfo;
+	cmdBufInfo.commandPool = graphics_->GetCommandPool();
+	cmdBufInfo.level = vk::CommandBufferLevel::ePrimary;
+	cmdBufInfo.commandBufferCount = 1;
+	vk::CommandBuffer copyCommandBuffer = graphics_->GetDevice().allocateCommandBuffers(cmdBufInfo)[0];
+
+	vk::CommandBufferBeginInfo cmdBufferBeginInfo;
+	cmdBufferBeginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+	copyCommandBuffer.begin(cmdBufferBeginInfo);
+
+	vk::BufferMemoryBarrier barrier;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.buffer = gpuBuf->buffer;
+	barrier.offset = offset;
+	barrier.size = size;
+	barrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+	barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+	copyCommandBuffer.pipelineBarrier(ShaderStages, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), nullptr, barrier, nullptr);
+
+	vk::BufferCopy copyRegion;
+	copyRegion.srcOffset = offset;
+	copyRegion.dstOffset = offset;
+	copyRegion.size = size;
+	copyCommandBuffer.copyBuffer(gpuBuf->buffer, cpuBuf->buffer, copyRegion);
+
+	barrier.buffer = cpuBuf->buffer;
+	barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+	barrier.dstAccessMask = vk::AccessFlagBits::eHostRead;
+	copyCommandBuffer.pipelineBarrier(
+		vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, vk::DependencyFlags(), nullptr, barrier, nullptr);
+
+	copyCommandBuffer.end();
+
+	graphics_->SubmitAndWait(copyCommandBuffer);
+
+	graphics_->GetDevice().freeCommandBuffers(graphics_->GetCommandPool(), copyCommandBuffer);
+}
+
+void StorageBufferVulkan::Upload(int32_t offset, int32_t size)
+{
+	// a buffer on cpu is copied after previous updates in the frame, so it is not waited
+	auto isInFrame = graphics_->GetCurrentSwapBufferIndex() >= 0;
+
+	vk::CommandBuffer copyCommandBuffer;
+	if (isInFrame)
+	{
+		copyCommandBuffer = graphics_->GetUpdateCommandBuffer();
+	}
+	else
+	{
+		vk::CommandBufferAllocateInfo cmdBufInfo;
+		cmdBufInfo.commandPool = graphics_->GetCommandPool();
+		cmdBufInfo.level = vk::CommandBufferLevel::ePrimary;
+		cmdBufInfo.commandBufferCount = 1;
+		copyCommandBuffer = graphics_->GetDevice().allocateCommandBuffers(cmdBufInfo)[0];
+
+		vk::CommandBufferBeginInfo cmdBufferBeginInfo;
+		cmdBufferBeginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+		copyCommandBuffer.begin(cmdBufferBeginInfo);
+	}
+
+	vk::BufferMemoryBarrier barrier;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.buffer = gpuBuf->buffer;
+	barrier.offset = offset;
+	barrier.size = size;
+	barrier.srcAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
+	barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
+	copyCommandBuffer.pipelineBarrier(ShaderStages, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), nullptr, barrier, nullptr);
+
+	vk::BufferCopy copyRegion;
+	copyRegion.srcOffset = offset;
+	copyRegion.dstOffset = offset;
+	copyRegion.size = size;
+	copyCommandBuffer.copyBuffer(cpuBuf->buffer, gpuBuf->buffer, copyRegion);
+
+	barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+	barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
+	copyCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, ShaderStages, vk::DependencyFlags(), nullptr, barrier, nullptr);
+
+	if (!isInFrame)
+	{
+		copyCommandBuffer.end();
+		graphics_->SubmitAndWait(copyCommandBuffer);
+		graphics_->GetDevice().freeCommandBuffers(graphics_->GetCommandPool(), copyCommandBuffer);
+	}
+}
+
+bool StorageBufferVulkan::Initialize(GraphicsVulkan* graphics, int32_t size)
+{
+	SafeAddRef(graphics);
+	graphics_ = CreateRef(graphics);
+
+	cpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics));
+	gpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics));
+
+	// create a buffer on cpu which is used to upload and read back
+	{
+		vk::BufferCreateInfo storageBufferInfo;
+		storageBufferInfo.size = size;
+		storageBufferInfo.usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst;
+		cpuBuf->buffer = graphics_->GetDevice().createBuffer(storageBufferInfo);
+
+		vk::MemoryRequirements memReqs = graphics_->GetDevice().getBufferMemoryRequirements(cpuBuf->buffer);
+		vk::MemoryAllocateInfo memAlloc;
+		memAlloc.allocationSize = memReqs.size;
+		memAlloc.memoryTypeIndex = graphics_->GetMemoryTypeIndex(
+			memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+		cpuBuf->devMem = graphics_->GetDevice().allocateMemory(memAlloc);
+		graphics_->GetDevice().bindBufferMemory(cpuBuf->buffer, cpuBuf->devMem, 0);
+	}
+
+	// create a buffer on gpu
+	{
+		vk::BufferCreateInfo storageBufferInfo;
+		storageBufferInfo.size = size;
+		storageBufferInfo.usage = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc |
+								  vk::BufferUsageFlagBits::eTransferDst;
+		graphics_->SetSharingMode(storageBufferInfo);
+		gpuBuf->buffer = graphics_->GetDevice().createBuffer(storageBufferInfo);
+
+		vk::MemoryRequirements memReqs = graphics_->GetDevice().getBufferMemoryRequirements(gpuBuf->buffer);
+		vk::MemoryAllocateInfo memAlloc;
+		memAlloc.allocationSize = memReqs.size;
+		memAlloc.memoryTypeIndex = graphics_->GetMemoryTypeIndex(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+		gpuBuf->devMem = graphics_->GetDevice().allocateMemory(memAlloc);
+		graphics_->GetDevice().bindBufferMemory(gpuBuf->buffer, gpuBuf->devMem, 0);
+	}
+
+	memSize = size;
+
+	data = static_cast<uint8_t*>(graphics_->GetDevice().mapMemory(cpuBuf->devMem, 0, memSize, vk::MemoryMapFlags()));
+
+	return true;
+}
+
+StorageBufferVulkan::StorageBufferVulkan() {}
+
+StorageBufferVulkan::~StorageBufferVulkan()
+{
+	if (data != nullptr)
+	{
+		graphics_->GetDevice().unmapMemory(cpuBuf->devMem);
+		data = nullptr;
+	}
+}
+
+void* StorageBufferVulkan::Lock() { return Lock(0, memSize); }
+
+void* StorageBufferVulkan::Lock(int32_t offset, int32_t size)
+{
+	if (offset < 0 || size <= 0 || offset + size > memSize)
+	{
+		return nullptr;
+	}
+
+	ReadBack(offset, size);
+
+	lockedOffset_ = offset;
+	lockedSize_ = size;
+	return data + offset;
+}
+
+void StorageBufferVulkan::Unlock()
+{
+	if (lockedSize_ == 0)
+	{
+		return;
+	}
+
+	Upload(lockedOffset_, lockedSize_);
+	lockedSize_ = 0;
+}
+
+int32_t StorageBufferVulkan::GetSize() { return memSize; }
+
+} // namespace LLGI
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../LLGI.StorageBuffer.h"
+#include "LLGI.BaseVulkan.h"
+#include "LLGI.GraphicsVulkan.h"
+
+namespace LLGI
+{
+
+class StorageBufferVulkan : public StorageBuffer
+{
+private:
+	Ref<GraphicsVulkan> graphics_;
+	std::unique_ptr<Buffer> cpuBuf;
+	std::unique_ptr<Buffer> gpuBuf;
+
+	//! a buffer on cpu is mapped until it is disposed
+	uint8_t* data = nullptr;
+	int32_t memSize = 0;
+
+	int32_t lockedOffset_ = 0;
+	int32_t lockedSize_ = 0;
+
+	//! read a range back from a buffer on gpu and wait only for it
+	void ReadBack(int32_t offset, int32_t size);
+
+	//! upload a range into a buffer on gpu with commands in the current frame
+	void Upload(int32_t offset, int32_t size);
+
+public:
+	bool Initialize(GraphicsVulkan* graphics, int32_t size);
+
+	StorageBufferVulkan();
+	virtual ~StorageBufferVulkan();
+
+	/**
+		@brief	map a buffer to read and write
+		@note
+		Only a locked range is read back and is uploaded by Unlock.
+		Call Graphics::WaitFinish before it to read results of Dispatch.
+	*/
+	void* Lock() override;
+	void* Lock(int32_t offset, int32_t size) override;
+	void Unlock() override;
+	int32_t GetSize() override;
+
+	vk::Buffer GetBuffer() { return gpuBuf->buffer; }
+};
+
+} // namespace LLGI
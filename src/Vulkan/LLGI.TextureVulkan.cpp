@@ -10,6 +10,11 @@ TextureVulkan::~TextureVulkan()
 {
 	if (image != nullptr)
 	{
+		if (isRenderPass_ || isDepthBuffer_)
+		{
+			graphics_->DisposeFramebuffers(view);
+		}
+
 		graphics_->GetDevice().destroyImageView(view);
 		graphics_->GetDevice().destroyImage(image);
 		graphics_->GetDevice().freeMemory(devMem);
@@ -21,74 +26,240 @@ TextureVulkan::~TextureVulkan()
 	SafeRelease(graphics_);
 }
 
-bool TextureVulkan::Initialize(const Vec2I& size, bool isRenderPass, bool isDepthBuffer)
+vk::Format TextureVulkan::ConvertFormat(TextureFormatType format)
 {
-	if (isRenderPass)
-		throw "Not implemented";
+	switch (format)
+	{
+	case TextureFormatType::R8G8B8A8_UNORM:
+		return vk::Format::eR8G8B8A8Unorm;
+	case TextureFormatType::R8_UNORM:
+		return vk::Format::eR8Unorm;
+	case TextureFormatType::R8G8_UNORM:
+		return vk::Format::eR8G8Unorm;
+	case TextureFormatType::R16G16B16A16_FLOAT:
+		return vk::Format::eR16G16B16A16Sfloat;
+	case TextureFormatType::R32_FLOAT:
+		return vk::Format::eR32Sfloat;
+	case TextureFormatType::BC1:
+		return vk::Format::eBc1RgbaUnormBlock;
+	case TextureFormatType::BC2:
+		return vk::Format::eBc2UnormBlock;
+	case TextureFormatType::BC3:
+		return vk::Format::eBc3UnormBlock;
+	case TextureFormatType::BC4:
+		return vk::Format::eBc4UnormBlock;
+	case TextureFormatType::BC5:
+		return vk::Format::eBc5UnormBlock;
+	case TextureFormatType::BC6H:
+		return vk::Format::eBc6HUfloatBlock;
+	case TextureFormatType::BC7:
+		return vk::Format::eBc7UnormBlock;
+	case TextureFormatType::ETC2_RGB8:
+		return vk::Format::eEtc2R8G8B8UnormBlock;
+	case TextureFormatType::ETC2_RGBA8:
+		return vk::Format::eEtc2R8G8B8A8UnormBlock;
+	case TextureFormatType::ASTC_4x4:
+		return vk::Format::eAstc4x4UnormBlock;
+	}
 
-	if (isDepthBuffer)
-		throw "Not implemented";
+	return vk::Format::eUndefined;
+}
 
+bool TextureVulkan::Initialize(const Vec2I& size, bool isRenderPass, bool isDepthBuffer)
+{
 	if (isDepthBuffer)
 	{
-		isDepthBuffer_ = isDepthBuffer;
-		// CreateDepthBuffer(this->image, this->view, this->devMem, graphics_->GetDevice(), ...)
+		return InitializeAsDepthBuffer(size, false);
 	}
 
-	cpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics_));
+	if (isRenderPass)
+	{
+		return InitializeAsRenderTexture(size);
+	}
 
-	vk::Format format = vk::Format::eR8G8B8A8Unorm;
+	TextureInitializationParameter parameter;
+	parameter.Size = size;
+	return Initialize(parameter);
+}
 
-	// image
-	vk::ImageCreateInfo imageCreateInfo;
+bool TextureVulkan::InitializeAsAttachment(
+	const Vec2I& size, vk::Format format, vk::ImageUsageFlags usage, vk::ImageAspectFlags aspect, bool isLazilyAllocated)
+{
+	auto device = graphics_->GetDevice();
 
+	vk::ImageCreateInfo imageCreateInfo;
 	imageCreateInfo.imageType = vk::ImageType::e2D;
-	imageCreateInfo.extent.width = size.X;
-	imageCreateInfo.extent.height = size.Y;
-	imageCreateInfo.extent.depth = 1;
+	imageCreateInfo.extent = vk::Extent3D(size.X, size.Y, 1);
 	imageCreateInfo.mipLevels = 1;
 	imageCreateInfo.arrayLayers = 1;
 	imageCreateInfo.format = format;
 	imageCreateInfo.tiling = vk::ImageTiling::eOptimal;
 	imageCreateInfo.initialLayout = vk::ImageLayout::eUndefined;
+	imageCreateInfo.usage = usage;
+	imageCreateInfo.sharingMode = vk::SharingMode::eExclusive;
+	imageCreateInfo.samples = vk::SampleCountFlagBits::e1;
 
-	if (isRenderPass)
+	image = device.createImage(imageCreateInfo);
+
+	{
+		vk::MemoryRequirements memReqs = device.getImageMemoryRequirements(image);
+		vk::MemoryAllocateInfo memAlloc;
+		memAlloc.allocationSize = memReqs.size;
+
+		// lazily allocated memory is not found on most desktop gpus
+		auto memoryProperties = graphics_->GetPhysicalDevice().getMemoryProperties();
+		auto properties = vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		if (isLazilyAllocated)
+		{
+			for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+			{
+				if ((memReqs.memoryTypeBits & (1 << i)) &&
+					(memoryProperties.memoryTypes[i].propertyFlags & vk::MemoryPropertyFlagBits::eLazilyAllocated))
+				{
+					properties |= vk::MemoryPropertyFlagBits::eLazilyAllocated;
+					break;
+				}
+			}
+		}
+
+		memAlloc.memoryTypeIndex = graphics_->GetMemoryTypeIndex(memReqs.memoryTypeBits, properties);
+		devMem = device.allocateMemory(memAlloc);
+		device.bindImageMemory(image, devMem, 0);
+	}
+
+	{
+		vk::ImageViewCreateInfo imageViewInfo;
+		imageViewInfo.image = image;
+		imageViewInfo.viewType = vk::ImageViewType::e2D;
+		imageViewInfo.format = format;
+		imageViewInfo.subresourceRange.aspectMask = aspect;
+		imageViewInfo.subresourceRange.baseMipLevel = 0;
+		imageViewInfo.subresourceRange.levelCount = 1;
+		imageViewInfo.subresourceRange.baseArrayLayer = 0;
+		imageViewInfo.subresourceRange.layerCount = 1;
+		view = device.createImageView(imageViewInfo);
+	}
+
+	textureSize = size;
+	vkTextureFormat = format;
+	return true;
+}
+
+bool TextureVulkan::InitializeAsRenderTexture(const Vec2I& size)
+{
+	if (size.X <= 0 || size.Y <= 0)
+		return false;
+
+	auto format = vk::Format::eR8G8B8A8Unorm;
+
+	auto formatProperties = graphics_->GetPhysicalDevice().getFormatProperties(format);
+	if (!(formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eColorAttachment))
+		return false;
+
+	auto usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferSrc |
+				 vk::ImageUsageFlagBits::eTransferDst;
+
+	if (!InitializeAsAttachment(size, format, usage, vk::ImageAspectFlagBits::eColor, false))
+		return false;
+
+	isRenderPass_ = true;
+	return true;
+}
+
+bool TextureVulkan::InitializeAsDepthBuffer(const Vec2I& size, bool isTransient)
+{
+	if (size.X <= 0 || size.Y <= 0)
+		return false;
+
+	// the same format as render passes
+	auto format = vk::Format::eD32SfloatS8Uint;
+
+	auto formatProperties = graphics_->GetPhysicalDevice().getFormatProperties(format);
+	if (!(formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eDepthStencilAttachment))
+		return false;
+
+	// a transient image can't be sampled, but it may not be backed by memory on tile based gpus
+	vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eDepthStencilAttachment;
+	if (isTransient)
 	{
-		isRenderPass_ = isRenderPass;
-		imageCreateInfo.usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled;
+		usage |= vk::ImageUsageFlagBits::eTransientAttachment;
 	}
 	else
 	{
-		imageCreateInfo.usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+		usage |= vk::ImageUsageFlagBits::eSampled;
 	}
 
-	imageCreateInfo.sharingMode = vk::SharingMode::eExclusive;
-	imageCreateInfo.samples = vk::SampleCountFlagBits::e1;
-	imageCreateInfo.flags = (vk::ImageCreateFlagBits)0;
+	if (!InitializeAsAttachment(size, format, usage, vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil, isTransient))
+		return false;
 
-	image = graphics_->GetDevice().createImage(imageCreateInfo);
+	isDepthBuffer_ = true;
+	isTransient_ = isTransient;
+	return true;
+}
 
-	// get device
-	auto& device = graphics_->GetDevice();
+bool TextureVulkan::Initialize(const TextureInitializationParameter& parameter)
+{
+	auto size = parameter.Size;
 
-	// calculate size
-	memorySize = size.X * size.Y * 4;
+	if (size.X <= 0 || size.Y <= 0 || parameter.ArrayLayerCount <= 0)
+		return false;
 
-	// create a buffer on cpu
+	vk::Format format = ConvertFormat(parameter.Format);
+
+	// check whether the format is supported (for example, ETC2 and ASTC are not supported on most desktop gpus)
+	auto formatProperties = graphics_->GetPhysicalDevice().getFormatProperties(format);
+	if (!(formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImage))
+		return false;
+
+	format_ = parameter.Format;
+	arrayLayerCount_ = parameter.ArrayLayerCount;
+	mipMapCount_ = parameter.MipMapCount > 0 ? (std::min)(parameter.MipMapCount, GetMaximumMipMapCount(size)) : GetMaximumMipMapCount(size);
+
+	// compressed levels and streamed levels are uploaded instead of being generated
+	if (mipMapCount_ > 1 && !IsCompressedFormat(format_) && !parameter.IsStreamed)
 	{
-		vk::BufferCreateInfo bufferInfo;
-		bufferInfo.size = memorySize;
-		bufferInfo.usage = vk::BufferUsageFlagBits::eTransferSrc;
-		cpuBuf->buffer = graphics_->GetDevice().createBuffer(bufferInfo);
+		auto blitFeatures = vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst;
 
-		vk::MemoryRequirements memReqs = graphics_->GetDevice().getBufferMemoryRequirements(cpuBuf->buffer);
-		vk::MemoryAllocateInfo memAlloc;
-		memAlloc.allocationSize = memReqs.size;
-		memAlloc.memoryTypeIndex = graphics_->GetMemoryTypeIndex(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible);
-		cpuBuf->devMem = graphics_->GetDevice().allocateMemory(memAlloc);
-		graphics_->GetDevice().bindBufferMemory(cpuBuf->buffer, cpuBuf->devMem, 0);
+		// levels can't be generated, so they would be left undefined
+		if ((formatProperties.optimalTilingFeatures & blitFeatures) != blitFeatures)
+			return false;
+
+		// integer and some float formats can be blitted only with nearest filtering
+		mipMapFilter_ = (formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)
+							? vk::Filter::eLinear
+							: vk::Filter::eNearest;
+		isMipMapGenerated_ = true;
+	}
+
+	// image
+	vk::ImageCreateInfo imageCreateInfo;
+
+	imageCreateInfo.imageType = vk::ImageType::e2D;
+	imageCreateInfo.extent.width = size.X;
+	imageCreateInfo.extent.height = size.Y;
+	imageCreateInfo.extent.depth = 1;
+	imageCreateInfo.mipLevels = mipMapCount_;
+	imageCreateInfo.arrayLayers = arrayLayerCount_;
+	imageCreateInfo.format = format;
+	imageCreateInfo.tiling = vk::ImageTiling::eOptimal;
+	imageCreateInfo.initialLayout = vk::ImageLayout::eUndefined;
+	imageCreateInfo.usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+
+	if (isMipMapGenerated_)
+	{
+		imageCreateInfo.usage |= vk::ImageUsageFlagBits::eTransferSrc;
 	}
 
+	// levels may be uploaded on the transfer queue and sampled on the compute queue
+	graphics_->SetSharingMode(imageCreateInfo);
+	imageCreateInfo.samples = vk::SampleCountFlagBits::e1;
+	imageCreateInfo.flags = (vk::ImageCreateFlagBits)0;
+
+	image = graphics_->GetDevice().createImage(imageCreateInfo);
+
+	// get device
+	auto device = graphics_->GetDevice();
+
 	// create a buffer on gpu
 	{
 		vk::MemoryRequirements memReqs = device.getImageMemoryRequirements(image);
@@ -103,30 +274,72 @@ bool TextureVulkan::Initialize(const Vec2I& size, bool isRenderPass, bool isDept
 	{
 		vk::ImageViewCreateInfo imageViewInfo;
 		imageViewInfo.image = image;
-		imageViewInfo.viewType = vk::ImageViewType::e2D;
+		imageViewInfo.viewType = arrayLayerCount_ > 1 ? vk::ImageViewType::e2DArray : vk::ImageViewType::e2D;
 		imageViewInfo.format = format;
 		imageViewInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
 		imageViewInfo.subresourceRange.baseMipLevel = 0;
-		imageViewInfo.subresourceRange.levelCount = 1;
+		imageViewInfo.subresourceRange.levelCount = mipMapCount_;
 		imageViewInfo.subresourceRange.baseArrayLayer = 0;
-		imageViewInfo.subresourceRange.layerCount = 1;
+		imageViewInfo.subresourceRange.layerCount = arrayLayerCount_;
 		view = device.createImageView(imageViewInfo);
 	}
 
 	textureSize = size;
 	vkTextureFormat = imageCreateInfo.format;
 
+	// levels are copied from buffers of graphics
+	if (parameter.IsStreamed)
+	{
+		isStreamed_ = true;
+		uploadedMipMaps_.resize(mipMapCount_, false);
+		residentMipMap_ = mipMapCount_;
+		return true;
+	}
+
+	// calculate size
+	memorySize = 0;
+	auto uploadedMipMapCount = isMipMapGenerated_ ? 1 : mipMapCount_;
+	for (int32_t mip = 0; mip < uploadedMipMapCount; mip++)
+	{
+		memorySize += GetTextureMemorySize(format_, Vec2I((std::max)(size.X >> mip, 1), (std::max)(size.Y >> mip, 1)));
+	}
+	memorySize *= arrayLayerCount_;
+
+	cpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics_));
+
+	// create a buffer on cpu
+	{
+		vk::BufferCreateInfo bufferInfo;
+		bufferInfo.size = memorySize;
+		bufferInfo.usage = vk::BufferUsageFlagBits::eTransferSrc;
+		cpuBuf->buffer = graphics_->GetDevice().createBuffer(bufferInfo);
+
+		vk::MemoryRequirements memReqs = graphics_->GetDevice().getBufferMemoryRequirements(cpuBuf->buffer);
+		vk::MemoryAllocateInfo memAlloc;
+		memAlloc.allocationSize = memReqs.size;
+		memAlloc.memoryTypeIndex = graphics_->GetMemoryTypeIndex(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible);
+		cpuBuf->devMem = graphics_->GetDevice().allocateMemory(memAlloc);
+		graphics_->GetDevice().bindBufferMemory(cpuBuf->buffer, cpuBuf->devMem, 0);
+	}
+
 	return true;
 }
 
 void* TextureVulkan::Lock()
 {
+	// streamed textures and attachments have no buffer on cpu
+	if (isStreamed_ || cpuBuf == nullptr)
+		return nullptr;
+
 	data = graphics_->GetDevice().mapMemory(cpuBuf->devMem, 0, memorySize, vk::MemoryMapFlags());
 	return data;
 }
 
 void TextureVulkan::Unlock()
 {
+	if (isStreamed_ || cpuBuf == nullptr)
+		return;
+
 	graphics_->GetDevice().unmapMemory(cpuBuf->devMem);
 
 	// copy buffer
@@ -141,30 +354,56 @@ void TextureVulkan::Unlock()
 	copyCommandBuffer.begin(cmdBufferBeginInfo);
 
 	vk::ImageLayout imageLayout = vk::ImageLayout::eTransferDstOptimal;
-	vk::BufferImageCopy imageBufferCopy;
 
-	imageBufferCopy.bufferOffset = 0;
-	imageBufferCopy.bufferRowLength = 0;
-	imageBufferCopy.bufferImageHeight = 0;
+	// regions are packed for each layer in order
+	std::vector<vk::BufferImageCopy> imageBufferCopies;
+	auto uploadedMipMapCount = isMipMapGenerated_ ? 1 : mipMapCount_;
+	vk::DeviceSize bufferOffset = 0;
 
-	imageBufferCopy.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
-	imageBufferCopy.imageSubresource.mipLevel = 0;
-	imageBufferCopy.imageSubresource.baseArrayLayer = 0;
-	imageBufferCopy.imageSubresource.layerCount = 1;
+	for (int32_t layer = 0; layer < arrayLayerCount_; layer++)
+	{
+		for (int32_t mip = 0; mip < uploadedMipMapCount; mip++)
+		{
+			auto mipSize = Vec2I((std::max)(textureSize.X >> mip, 1), (std::max)(textureSize.Y >> mip, 1));
+
+			vk::BufferImageCopy imageBufferCopy;
+
+			imageBufferCopy.bufferOffset = bufferOffset;
+			imageBufferCopy.bufferRowLength = 0;
+			imageBufferCopy.bufferImageHeight = 0;
 
-	imageBufferCopy.imageOffset = {0, 0, 0};
-	imageBufferCopy.imageExtent = {static_cast<uint32_t>(GetSizeAs2D().X), static_cast<uint32_t>(GetSizeAs2D().Y), 1};
+			imageBufferCopy.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+			imageBufferCopy.imageSubresource.mipLevel = mip;
+			imageBufferCopy.imageSubresource.baseArrayLayer = layer;
+			imageBufferCopy.imageSubresource.layerCount = 1;
+
+			imageBufferCopy.imageOffset = vk::Offset3D(0, 0, 0);
+			imageBufferCopy.imageExtent = vk::Extent3D(static_cast<uint32_t>(mipSize.X), static_cast<uint32_t>(mipSize.Y), 1);
+
+			imageBufferCopies.push_back(imageBufferCopy);
+			bufferOffset += GetTextureMemorySize(format_, mipSize);
+		}
+	}
 
 	vk::ImageSubresourceRange colorSubRange;
 	colorSubRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-	colorSubRange.levelCount = 1;
-	colorSubRange.layerCount = 1;
+	colorSubRange.levelCount = mipMapCount_;
+	colorSubRange.layerCount = arrayLayerCount_;
 
 	SetImageLayout(copyCommandBuffer, image, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, colorSubRange);
 
-	copyCommandBuffer.copyBufferToImage(cpuBuf->buffer, image, imageLayout, imageBufferCopy);
+	copyCommandBuffer.copyBufferToImage(
+		cpuBuf->buffer, image, imageLayout, static_cast<uint32_t>(imageBufferCopies.size()), imageBufferCopies.data());
 
-	SetImageLayout(copyCommandBuffer, image, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, colorSubRange);
+	if (isMipMapGenerated_)
+	{
+		GenerateMipMaps(copyCommandBuffer);
+	}
+	else
+	{
+		SetImageLayout(
+			copyCommandBuffer, image, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, colorSubRange);
+	}
 
 	copyCommandBuffer.end();
 
@@ -177,20 +416,318 @@ void TextureVulkan::Unlock()
 	graphics_->GetQueue().waitIdle();
 
 	graphics_->GetDevice().freeCommandBuffers(graphics_->GetCommandPool(), copyCommandBuffer);
+
+	isUploaded_ = true;
+	layout_ = vk::ImageLayout::eShaderReadOnlyOptimal;
 }
 
-Vec2I TextureVulkan::GetSizeAs2D() { return textureSize; }
+bool TextureVulkan::UpdateRegion(const Vec2I& position, const Vec2I& size, const void* data)
+{
+	if (!isUploaded_ || isStreamed_ || IsCompressedFormat(format_))
+		return false;
+
+	if (position.X < 0 || position.Y < 0 || size.X <= 0 || size.Y <= 0 || position.X + size.X > textureSize.X ||
+		position.Y + size.Y > textureSize.Y)
+		return false;
+
+	// commands are recorded into a frame
+	if (graphics_->GetCurrentSwapBufferIndex() < 0)
+		return false;
+
+	// pixels are copied through coherent memory of the frame instead of the buffer for Lock
+	auto regionMemorySize = GetTextureMemorySize(format_, size);
+	vk::Buffer stagingBuffer;
+	int32_t stagingOffset = 0;
+	auto dst = graphics_->AllocateStagingMemory(regionMemorySize, stagingBuffer, stagingOffset);
+	memcpy(dst, data, regionMemorySize);
+
+	// updates are batched and executed before the next command list without waiting
+	auto commandBuffer = graphics_->GetUpdateCommandBuffer();
+
+	vk::ImageSubresourceRange mipSubRange;
+	mipSubRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+	mipSubRange.baseMipLevel = 0;
+	mipSubRange.levelCount = 1;
+	mipSubRange.layerCount = 1;
+
+	// the texture may be read by command lists which are executed before
+	auto shaderStages = vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader |
+						vk::PipelineStageFlagBits::eComputeShader;
+
+	vk::ImageMemoryBarrier barrier;
+	barrier.oldLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+	barrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
+	barrier.srcAccessMask = vk::AccessFlagBits::eShaderRead;
+	barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
+	barrier.image = image;
+	barrier.subresourceRange = mipSubRange;
+	commandBuffer.pipelineBarrier(shaderStages, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), nullptr, nullptr, barrier);
 
-bool TextureVulkan::IsRenderTexture() const
+	vk::BufferImageCopy imageBufferCopy;
+	imageBufferCopy.bufferOffset = stagingOffset;
+	imageBufferCopy.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+	imageBufferCopy.imageSubresource.mipLevel = 0;
+	imageBufferCopy.imageSubresource.baseArrayLayer = 0;
+	imageBufferCopy.imageSubresource.layerCount = 1;
+	imageBufferCopy.imageOffset = vk::Offset3D(position.X, position.Y, 0);
+	imageBufferCopy.imageExtent = vk::Extent3D(static_cast<uint32_t>(size.X), static_cast<uint32_t>(size.Y), 1);
+
+	commandBuffer.copyBufferToImage(stagingBuffer, image, vk::ImageLayout::eTransferDstOptimal, imageBufferCopy);
+
+	barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+	barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+	barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+	barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+	commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, shaderStages, vk::DependencyFlags(), nullptr, nullptr, barrier);
+
+	return true;
+}
+
+void TextureVulkan::GenerateMipMaps(vk::CommandBuffer& commandBuffer)
 {
-	throw "Not inplemented";
-	return isRenderPass_;
+	vk::ImageMemoryBarrier barrier;
+	barrier.image = image;
+	barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = arrayLayerCount_;
+
+	int32_t width = textureSize.X;
+	int32_t height = textureSize.Y;
+
+	// each level is blitted from the previous level, then the previous level is made readable from shaders
+	for (int32_t mip = 1; mip < mipMapCount_; mip++)
+	{
+		barrier.subresourceRange.baseMipLevel = mip - 1;
+		barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+		barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
+		barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+		barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+		commandBuffer.pipelineBarrier(
+			vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), nullptr, nullptr, barrier);
+
+		auto nextWidth = (std::max)(width / 2, 1);
+		auto nextHeight = (std::max)(height / 2, 1);
+
+		vk::ImageBlit blit;
+		blit.srcOffsets[0] = vk::Offset3D(0, 0, 0);
+		blit.srcOffsets[1] = vk::Offset3D(width, height, 1);
+		blit.srcSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+		blit.srcSubresource.mipLevel = mip - 1;
+		blit.srcSubresource.baseArrayLayer = 0;
+		blit.srcSubresource.layerCount = arrayLayerCount_;
+		blit.dstOffsets[0] = vk::Offset3D(0, 0, 0);
+		blit.dstOffsets[1] = vk::Offset3D(nextWidth, nextHeight, 1);
+		blit.dstSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+		blit.dstSubresource.mipLevel = mip;
+		blit.dstSubresource.baseArrayLayer = 0;
+		blit.dstSubresource.layerCount = arrayLayerCount_;
+
+		commandBuffer.blitImage(
+			image, vk::ImageLayout::eTransferSrcOptimal, image, vk::ImageLayout::eTransferDstOptimal, blit, mipMapFilter_);
+
+		barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
+		barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+		barrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
+		barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+		commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+									  vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader,
+									  vk::DependencyFlags(),
+									  nullptr,
+									  nullptr,
+									  barrier);
+
+		width = nextWidth;
+		height = nextHeight;
+	}
+
+	// the last level is only written
+	barrier.subresourceRange.baseMipLevel = mipMapCount_ - 1;
+	barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+	barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+	barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+	barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+	commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+								  vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader,
+								  vk::DependencyFlags(),
+								  nullptr,
+								  nullptr,
+								  barrier);
 }
 
-bool TextureVulkan::IsDepthTexture() const
+void TextureVulkan::UploadMipMap(vk::CommandBuffer& commandBuffer,
+								 vk::Buffer buffer,
+								 int32_t bufferOffset,
+								 int32_t mipLevel,
+								 vk::CommandBuffer* acquireCommandBuffer)
 {
-	throw "Not inplemented";
-	return isDepthBuffer_;
+	if (!isStreamingLayoutInitialized_)
+	{
+		vk::ImageSubresourceRange allSubRange;
+		allSubRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+		allSubRange.levelCount = mipMapCount_;
+		allSubRange.layerCount = arrayLayerCount_;
+
+		if (acquireCommandBuffer != nullptr)
+		{
+			// levels are not read until they are uploaded, so a transition doesn't need shader stages
+			vk::ImageMemoryBarrier barrier;
+			barrier.oldLayout = vk::ImageLayout::eUndefined;
+			barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+			barrier.image = image;
+			barrier.subresourceRange = allSubRange;
+			commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+										  vk::PipelineStageFlagBits::eTransfer,
+										  vk::DependencyFlags(),
+										  nullptr,
+										  nullptr,
+										  barrier);
+		}
+		else
+		{
+			SetImageLayout(commandBuffer, image, vk::ImageLayout::eUndefined, vk::ImageLayout::eShaderReadOnlyOptimal, allSubRange);
+		}
+
+		isStreamingLayoutInitialized_ = true;
+		layout_ = vk::ImageLayout::eShaderReadOnlyOptimal;
+	}
+
+	vk::ImageSubresourceRange mipSubRange;
+	mipSubRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+	mipSubRange.baseMipLevel = mipLevel;
+	mipSubRange.levelCount = 1;
+	mipSubRange.layerCount = arrayLayerCount_;
+
+	// a previous content is discarded
+	SetImageLayout(commandBuffer, image, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, mipSubRange);
+
+	auto mipSize = Vec2I((std::max)(textureSize.X >> mipLevel, 1), (std::max)(textureSize.Y >> mipLevel, 1));
+
+	std::vector<vk::BufferImageCopy> imageBufferCopies;
+	for (int32_t layer = 0; layer < arrayLayerCount_; layer++)
+	{
+		vk::BufferImageCopy imageBufferCopy;
+		imageBufferCopy.bufferOffset = bufferOffset + static_cast<vk::DeviceSize>(GetTextureMemorySize(format_, mipSize)) * layer;
+		imageBufferCopy.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+		imageBufferCopy.imageSubresource.mipLevel = mipLevel;
+		imageBufferCopy.imageSubresource.baseArrayLayer = layer;
+		imageBufferCopy.imageSubresource.layerCount = 1;
+		imageBufferCopy.imageOffset = vk::Offset3D(0, 0, 0);
+		imageBufferCopy.imageExtent = vk::Extent3D(static_cast<uint32_t>(mipSize.X), static_cast<uint32_t>(mipSize.Y), 1);
+		imageBufferCopies.push_back(imageBufferCopy);
+	}
+
+	commandBuffer.copyBufferToImage(buffer,
+									image,
+									vk::ImageLayout::eTransferDstOptimal,
+									static_cast<uint32_t>(imageBufferCopies.size()),
+									imageBufferCopies.data());
+
+	// the graphics queue waits for the transfer queue with a semaphore before the transition
+	SetImageLayout(acquireCommandBuffer != nullptr ? *acquireCommandBuffer : commandBuffer,
+				   image,
+				   vk::ImageLayout::eTransferDstOptimal,
+				   vk::ImageLayout::eShaderReadOnlyOptimal,
+				   mipSubRange);
+
+	// a level becomes resident when all coarser levels are uploaded
+	uploadedMipMaps_[mipLevel] = true;
+	while (residentMipMap_ > 0 && uploadedMipMaps_[residentMipMap_ - 1])
+	{
+		residentMipMap_--;
+	}
+}
+
+static void GetLayoutAccess(vk::ImageLayout layout, vk::AccessFlags& access, vk::PipelineStageFlags& stage)
+{
+	switch (layout)
+	{
+	case vk::ImageLayout::eShaderReadOnlyOptimal:
+		access = vk::AccessFlagBits::eShaderRead;
+		stage = vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader;
+		break;
+	case vk::ImageLayout::eColorAttachmentOptimal:
+		access = vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite;
+		stage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+		break;
+	case vk::ImageLayout::eDepthStencilAttachmentOptimal:
+		access = vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+		stage = vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
+		break;
+	case vk::ImageLayout::eTransferSrcOptimal:
+		access = vk::AccessFlagBits::eTransferRead;
+		stage = vk::PipelineStageFlagBits::eTransfer;
+		break;
+	case vk::ImageLayout::eTransferDstOptimal:
+		access = vk::AccessFlagBits::eTransferWrite;
+		stage = vk::PipelineStageFlagBits::eTransfer;
+		break;
+	default:
+		access = vk::AccessFlags();
+		stage = vk::PipelineStageFlagBits::eTopOfPipe;
+		break;
+	}
+}
+
+bool TextureVulkan::CreateImageMemoryBarrier(ResourceState state,
+											 vk::ImageMemoryBarrier& barrier,
+											 vk::PipelineStageFlags& srcStage,
+											 vk::PipelineStageFlags& dstStage)
+{
+	vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+	switch (state)
+	{
+	case ResourceState::ShaderResource:
+		layout = vk::ImageLayout::eShaderReadOnlyOptimal;
+		break;
+	case ResourceState::RenderTarget:
+		layout = vk::ImageLayout::eColorAttachmentOptimal;
+		break;
+	case ResourceState::DepthWrite:
+		layout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+		break;
+	case ResourceState::CopySource:
+		layout = vk::ImageLayout::eTransferSrcOptimal;
+		break;
+	case ResourceState::CopyDest:
+		layout = vk::ImageLayout::eTransferDstOptimal;
+		break;
+	}
+
+	if (layout_ == layout)
+		return false;
+
+	vk::AccessFlags srcAccess;
+	vk::AccessFlags dstAccess;
+	vk::PipelineStageFlags src;
+	vk::PipelineStageFlags dst;
+	GetLayoutAccess(layout_, srcAccess, src);
+	GetLayoutAccess(layout, dstAccess, dst);
+
+	barrier = vk::ImageMemoryBarrier();
+	barrier.oldLayout = layout_;
+	barrier.newLayout = layout;
+	barrier.srcAccessMask = srcAccess;
+	barrier.dstAccessMask = dstAccess;
+	barrier.image = image;
+	barrier.subresourceRange.aspectMask = isDepthBuffer_ ? vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil
+														 : vk::ImageAspectFlagBits::eColor;
+	barrier.subresourceRange.baseMipLevel = 0;
+	barrier.subresourceRange.levelCount = mipMapCount_;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = arrayLayerCount_;
+
+	srcStage |= src;
+	dstStage |= dst;
+
+	layout_ = layout;
+	return true;
 }
 
+Vec2I TextureVulkan::GetSizeAs2D() { return textureSize; }
+
+bool TextureVulkan::IsRenderTexture() const { return isRenderPass_; }
+
+bool TextureVulkan::IsDepthTexture() const { return isDepthBuffer_; }
+
 } // namespace LLGI
@@ -18,6 +18,26 @@ private:
 	vk::Format vkTextureFormat;
 
 	Vec2I textureSize;
+	TextureFormatType format_ = TextureFormatType::R8G8B8A8_UNORM;
+	int32_t mipMapCount_ = 1;
+	int32_t arrayLayerCount_ = 1;
+
+	//! whether levels except the first are generated with blits
+	bool isMipMapGenerated_ = false;
+
+	//! a filter of blits which generate levels
+	vk::Filter mipMapFilter_ = vk::Filter::eLinear;
+
+	//! whether the whole texture is uploaded and it is in a layout to read from shaders
+	bool isUploaded_ = false;
+
+	//! a layout of all subresources which is tracked for barriers
+	vk::ImageLayout layout_ = vk::ImageLayout::eUndefined;
+
+	bool isStreamed_ = false;
+	bool isStreamingLayoutInitialized_ = false;
+	std::vector<bool> uploadedMipMaps_;
+	int32_t residentMipMap_ = 0;
 
 	int32_t memorySize = 0;
 	std::unique_ptr<Buffer> cpuBuf;
@@ -25,6 +45,12 @@ private:
 
 	bool isRenderPass_ = false;
 	bool isDepthBuffer_ = false;
+	bool isTransient_ = false;
+
+	void GenerateMipMaps(vk::CommandBuffer& commandBuffer);
+
+	bool InitializeAsAttachment(
+		const Vec2I& size, vk::Format format, vk::ImageUsageFlags usage, vk::ImageAspectFlags aspect, bool isLazilyAllocated);
 
 public:
 	TextureVulkan(GraphicsVulkan* graphics);
@@ -32,11 +58,67 @@ public:
 
 	bool Initialize(const Vec2I& size, bool isRenderPass, bool isDepthBuffer);
 
+	bool Initialize(const TextureInitializationParameter& parameter);
+
+	/**
+		@brief	initialize as a depth buffer
+		@param	isTransient	whether it is created with lazily allocated memory if possible. It can't be sampled.
+	*/
+	bool InitializeAsDepthBuffer(const Vec2I& size, bool isTransient);
+
+	//! initialize as a RGBA8 color attachment which can be sampled
+	bool InitializeAsRenderTexture(const Vec2I& size);
+
 	void* Lock() override;
 	void Unlock() override;
+	bool UpdateRegion(const Vec2I& position, const Vec2I& size, const void* data) override;
 	Vec2I GetSizeAs2D() override;
 	bool IsRenderTexture() const override;
 	bool IsDepthTexture() const override;
+	TextureFormatType GetFormat() const override { return format_; }
+	int32_t GetMipMapCount() const override { return mipMapCount_; }
+	int32_t GetArrayLayerCount() const override { return arrayLayerCount_; }
+	bool IsStreamed() const override { return isStreamed_; }
+	int32_t GetResidentMipMap() const override { return residentMipMap_; }
+
+	//! whether it is a depth buffer whose contents are not kept after a render pass
+	bool IsTransient() const { return isTransient_; }
+
+	/**
+		@brief	record commands to copy a mip level of a streamed texture from a buffer
+		@param	bufferOffset	an offset of the level in the buffer, which is a multiple of 16
+		@param	acquireCommandBuffer	commands on the graphics queue which are executed after commandBuffer when it is recorded
+										for the transfer queue. nullptr if commandBuffer is for the graphics queue.
+		@note
+		Levels which are not uploaded are kept in a layout to read from shaders, but they are not sampled because of clamped lod.
+	*/
+	void UploadMipMap(vk::CommandBuffer& commandBuffer,
+					  vk::Buffer buffer,
+					  int32_t bufferOffset,
+					  int32_t mipLevel,
+					  vk::CommandBuffer* acquireCommandBuffer = nullptr);
+
+	static vk::Format ConvertFormat(TextureFormatType format);
+
+	/**
+		@brief	make a barrier to transit into a state, which is recorded by a caller with other barriers
+		@param	srcStage	stages which the barrier waits are added
+		@param	dstStage	stages which wait the barrier are added
+		@return	false if the texture is already in the state
+	*/
+	bool CreateImageMemoryBarrier(ResourceState state,
+								  vk::ImageMemoryBarrier& barrier,
+								  vk::PipelineStageFlags& srcStage,
+								  vk::PipelineStageFlags& dstStage);
+
+	const vk::Image& GetImage() const { return image; }
+
+	/**
+		@brief	set a layout which is changed without barriers of this class
+		@note
+		For example, a render pass changes a layout of attachments into its final layout.
+	*/
+	void SetLayout(vk::ImageLayout layout) { layout_ = layout; }
 
 	const vk::ImageView& GetView() const { return view; }
 
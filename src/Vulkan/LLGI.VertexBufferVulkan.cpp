@@ -7,7 +7,7 @@ bool VertexBufferVulkan::Initialize(GraphicsVulkan* graphics, int32_t size)
 {
 
 	SafeAddRef(graphics);
-	graphics_ = CreateSharedPtr(graphics);
+	graphics_ = graphics;
 
 	cpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics));
 	gpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics));
@@ -32,6 +32,7 @@ bool VertexBufferVulkan::Initialize(GraphicsVulkan* graphics, int32_t size)
 		vk::BufferCreateInfo vertexBufferInfo;
 		vertexBufferInfo.size = size;
 		vertexBufferInfo.usage = vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst;
+		graphics_->SetSharingMode(vertexBufferInfo);
 		gpuBuf->buffer = graphics_->GetDevice().createBuffer(vertexBufferInfo);
 
 		vk::MemoryRequirements memReqs = graphics_->GetDevice().getBufferMemoryRequirements(gpuBuf->buffer);
@@ -47,29 +48,86 @@ bool VertexBufferVulkan::Initialize(GraphicsVulkan* graphics, int32_t size)
 	return true;
 }
 
+bool VertexBufferVulkan::InitializeAsTransient(GraphicsVulkan* graphics, int32_t size)
+{
+	graphics_ = graphics;
+
+	gpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics, false));
+
+	// create a buffer which is visible from both cpu and gpu
+	{
+		vk::BufferCreateInfo vertexBufferInfo;
+		vertexBufferInfo.size = size;
+		vertexBufferInfo.usage = vk::BufferUsageFlagBits::eVertexBuffer;
+		gpuBuf->buffer = graphics_->GetDevice().createBuffer(vertexBufferInfo);
+
+		vk::MemoryRequirements memReqs = graphics_->GetDevice().getBufferMemoryRequirements(gpuBuf->buffer);
+		vk::MemoryAllocateInfo memAlloc;
+		memAlloc.allocationSize = memReqs.size;
+		memAlloc.memoryTypeIndex = graphics_->GetMemoryTypeIndex(
+			memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+		gpuBuf->devMem = graphics_->GetDevice().allocateMemory(memAlloc);
+		graphics_->GetDevice().bindBufferMemory(gpuBuf->buffer, gpuBuf->devMem, 0);
+	}
+
+	memSize = size;
+	isTransient_ = true;
+
+	return true;
+}
+
 VertexBufferVulkan::VertexBufferVulkan() {}
 
-VertexBufferVulkan ::~VertexBufferVulkan() {}
+VertexBufferVulkan ::~VertexBufferVulkan()
+{
+	if (!isTransient_)
+	{
+		SafeRelease(graphics_);
+	}
+}
 
 void* VertexBufferVulkan::Lock()
 {
+	if (isTransient_)
+	{
+		data = graphics_->GetDevice().mapMemory(gpuBuf->devMem, 0, memSize, vk::MemoryMapFlags());
+		return data;
+	}
+
 	data = graphics_->GetDevice().mapMemory(cpuBuf->devMem, 0, memSize, vk::MemoryMapFlags());
 	return data;
 }
 
 void* VertexBufferVulkan::Lock(int32_t offset, int32_t size)
 {
+	if (isTransient_)
+	{
+		data = graphics_->GetDevice().mapMemory(gpuBuf->devMem, offset, size, vk::MemoryMapFlags());
+		return data;
+	}
+
 	data = graphics_->GetDevice().mapMemory(cpuBuf->devMem, offset, size, vk::MemoryMapFlags());
 	return data;
 }
 
 void VertexBufferVulkan::Unlock() { 
+
+	// gpu reads transient buffers directly
+	if (isTransient_)
+	{
+		graphics_->GetDevice().unmapMemory(gpuBuf->devMem);
+		return;
+	}
 	
 	graphics_->GetDevice().unmapMemory(cpuBuf->devMem); 
 
+	// a first upload doesn't race with draws which read the buffer, so it is copied on the transfer queue
+	auto queue = isUploaded_ ? graphics_->GetQueue() : graphics_->GetTransferQueue();
+	auto commandPool = isUploaded_ ? graphics_->GetCommandPool() : graphics_->GetTransferCommandPool();
+
 	// copy buffer
 	vk::CommandBufferAllocateInfo cmdBufInfo;
-	cmdBufInfo.commandPool = graphics_->GetCommandPool();
+	cmdBufInfo.commandPool = commandPool;
 	cmdBufInfo.level = vk::CommandBufferLevel::ePrimary;
 	cmdBufInfo.commandBufferCount = 1;
 	vk::CommandBuffer copyCommandBuffer = graphics_->GetDevice().allocateCommandBuffers(cmdBufInfo)[0];
@@ -89,10 +147,12 @@ void VertexBufferVulkan::Unlock() {
 	copySubmitInfo.commandBufferCount = 1;
 	copySubmitInfo.pCommandBuffers = &copyCommandBuffer;
 
-	graphics_->GetQueue().submit(copySubmitInfo, VK_NULL_HANDLE);
-	graphics_->GetQueue().waitIdle();
+	queue.submit(copySubmitInfo, VK_NULL_HANDLE);
+	queue.waitIdle();
 	
-	graphics_->GetDevice().freeCommandBuffers(graphics_->GetCommandPool(), copyCommandBuffer);
+	graphics_->GetDevice().freeCommandBuffers(commandPool, copyCommandBuffer);
+
+	isUploaded_ = true;
 }
 
 int32_t VertexBufferVulkan::GetSize() { return memSize; }
@@ -11,15 +11,25 @@ namespace LLGI
 class VertexBufferVulkan : public VertexBuffer
 {
 private:
-	std::shared_ptr<GraphicsVulkan> graphics_;
+	//! it is not held if this is transient
+	GraphicsVulkan* graphics_ = nullptr;
 	std::unique_ptr<Buffer> cpuBuf;
 	std::unique_ptr<Buffer> gpuBuf;
 	void* data = nullptr;
 	int32_t memSize = 0;
+	bool isTransient_ = false;
+	bool isUploaded_ = false;
 
 public:
 	bool Initialize(GraphicsVulkan* graphics, int32_t size);
 
+	/**
+		@brief	initialize as a page of transient buffers which is read by gpu directly from host visible memory
+		@note
+		It doesn't hold a reference of graphics because graphics owns it.
+	*/
+	bool InitializeAsTransient(GraphicsVulkan* graphics, int32_t size);
+
 	VertexBufferVulkan();
 	virtual ~VertexBufferVulkan();
 
@@ -3,3 +3,5 @@ glslangValidator.exe ..\GLSL\simple_constant_rectangle.frag -e main -V -l -o sim
 
 glslangValidator.exe ..\GLSL\simple_texture_rectangle.vert -e main -V -l -o simple_texture_rectangle.vert.spv
 glslangValidator.exe ..\GLSL\simple_texture_rectangle.frag -e main -V -l -o simple_texture_rectangle.frag.spv
+
+glslangValidator.exe ..\GLSL\basic.comp -e main -V -l -o basic.comp.spv
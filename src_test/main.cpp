@@ -24,12 +24,44 @@ void test_simple_constant_rectangle(LLGI::ConstantBufferType type, LLGI::DeviceT
 
 void test_simple_texture_rectangle(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
 
+void test_vertexlayout(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+void test_spritebatch(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+void test_textureatlas(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+void test_allocation(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+void test_commandbundle(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+void test_commandpacket(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+void test_renderthread(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+void test_fence(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+void test_compute(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+void test_texturestreaming(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+// Resource
+void test_resourcepool(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+// Mesh
+void test_meshoptimizer(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+void test_meshfile(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
 // Compile
 void test_compile(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
 
 // About renderPass
 void test_renderPass(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
 
+void test_renderPass_mrt(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+void test_framegraph(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
 int main()
 {
 	auto device = LLGI::DeviceType::Default;
@@ -48,9 +80,28 @@ int main()
 	// test_simple_rectangle(device);
 	// test_simple_constant_rectangle(LLGI::ConstantBufferType::LongTime, device);
 	//test_simple_texture_rectangle(device);
+	// test_vertexlayout(device);
+	// test_spritebatch(device);
+	// test_textureatlas(device);
+	// test_allocation(device);
+	// test_commandbundle(device);
+	// test_commandpacket(device);
+	// test_renderthread(device);
+	// test_fence(device);
+	// test_compute(device);
+	// test_texturestreaming(device);
+
+	// Resource
+	// test_resourcepool(device);
+
+	// Mesh
+	// test_meshoptimizer(device);
+	// test_meshfile(device);
 
 	// About renderPass
 	 test_renderPass(device);
+	// test_renderPass_mrt(device);
+	// test_framegraph(device);
 
 	return 0;
 }
@@ -0,0 +1,313 @@
+#include "test.h"
+#include <map>
+#include <new>
+
+// all allocations in this executable are counted while it is enabled
+static std::atomic<bool> isAllocationCounted(false);
+static std::atomic<int64_t> allocationCount(0);
+
+void* operator new(size_t size)
+{
+	if (isAllocationCounted)
+	{
+		allocationCount++;
+	}
+
+	auto p = malloc(size > 0 ? size : 1);
+	if (p == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void* p) noexcept { free(p); }
+
+void operator delete[](void* p) noexcept { free(p); }
+
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+static std::vector<uint8_t> LoadData(const char* path)
+{
+	std::vector<uint8_t> ret;
+
+#ifdef _WIN32
+	FILE* fp = nullptr;
+	fopen_s(&fp, path, "rb");
+
+#else
+	FILE* fp = fopen(path, "rb");
+#endif
+
+	if (fp == nullptr)
+		return ret;
+
+	fseek(fp, 0, SEEK_END);
+	auto size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	ret.resize(size);
+	fread(ret.data(), 1, size, fp);
+	fclose(fp);
+
+	return ret;
+}
+
+void test_allocation(LLGI::DeviceType deviceType)
+{
+	auto code_dx_vs = R"(
+struct VS_INPUT{
+    float3 Position : POSITION0;
+	float2 UV : UV0;
+    float4 Color : COLOR0;
+};
+struct VS_OUTPUT{
+    float4 Position : SV_POSITION;
+	float2 UV : UV0;
+    float4 Color : COLOR0;
+};
+
+VS_OUTPUT main(VS_INPUT input){
+    VS_OUTPUT output;
+
+    output.Position = float4(input.Position, 1.0f);
+	output.UV = input.UV;
+    output.Color = input.Color;
+
+    return output;
+}
+)";
+
+	auto code_dx_ps = R"(
+Texture2D txt : register(t8);
+SamplerState smp : register(s8);
+
+struct PS_INPUT
+{
+    float4  Position : SV_POSITION;
+	float2  UV : UV0;
+    float4  Color    : COLOR0;
+};
+
+float4 main(PS_INPUT input) : SV_TARGET
+{
+	return input.Color * txt.Sample(smp, input.UV);
+}
+)";
+
+	// frames which are not counted because caches and allocators grow in them
+	const int warmupFrameCount = 5;
+	const int frameCount = 15;
+	const int drawCount = 1000;
+	const int textureCount = 2;
+
+	auto compiler = LLGI::CreateCompiler(deviceType);
+
+	int count = 0;
+
+	auto platform = LLGI::CreatePlatform(deviceType);
+	auto graphics = platform->CreateGraphics();
+	auto commandList = graphics->CreateCommandList();
+	auto vb = graphics->CreateVertexBuffer(sizeof(SimpleVertex) * 4);
+	auto ib = graphics->CreateIndexBuffer(2, 6);
+
+	auto vb_buf = (SimpleVertex*)vb->Lock();
+	vb_buf[0].Pos = LLGI::Vec3F(-0.5, 0.5, 0.5);
+	vb_buf[1].Pos = LLGI::Vec3F(0.5, 0.5, 0.5);
+	vb_buf[2].Pos = LLGI::Vec3F(0.5, -0.5, 0.5);
+	vb_buf[3].Pos = LLGI::Vec3F(-0.5, -0.5, 0.5);
+
+	for (int i = 0; i < 4; i++)
+	{
+		vb_buf[i].UV = LLGI::Vec2F((i == 1 || i == 2) ? 1.0f : 0.0f, (i >= 2) ? 1.0f : 0.0f);
+		vb_buf[i].Color = LLGI::Color8(255, 255, 255, 8);
+	}
+	vb->Unlock();
+
+	auto ib_buf = (uint16_t*)ib->Lock();
+	ib_buf[0] = 0;
+	ib_buf[1] = 1;
+	ib_buf[2] = 2;
+	ib_buf[3] = 0;
+	ib_buf[4] = 2;
+	ib_buf[5] = 3;
+	ib->Unlock();
+
+	std::array<LLGI::Texture*, textureCount> textures;
+	for (int i = 0; i < textureCount; i++)
+	{
+		textures[i] = graphics->CreateTexture(LLGI::Vec2I(16, 16), false, false);
+
+		auto texture_buf = (LLGI::Color8*)textures[i]->Lock();
+		for (int p = 0; p < 16 * 16; p++)
+		{
+			texture_buf[p] = LLGI::Color8(i * 255, 255 - i * 255, 255, 255);
+		}
+		textures[i]->Unlock();
+	}
+
+	LLGI::Shader* shader_vs = nullptr;
+	LLGI::Shader* shader_ps = nullptr;
+
+	std::vector<LLGI::DataStructure> data_vs;
+	std::vector<LLGI::DataStructure> data_ps;
+
+	if (compiler == nullptr)
+	{
+		auto binary_vs = LoadData("Shaders/SPIRV/simple_texture_rectangle.vert.spv");
+		auto binary_ps = LoadData("Shaders/SPIRV/simple_texture_rectangle.frag.spv");
+
+		LLGI::DataStructure d_vs;
+		LLGI::DataStructure d_ps;
+
+		d_vs.Data = binary_vs.data();
+		d_vs.Size = binary_vs.size();
+		d_ps.Data = binary_ps.data();
+		d_ps.Size = binary_ps.size();
+
+		data_vs.push_back(d_vs);
+		data_ps.push_back(d_ps);
+
+		shader_vs = graphics->CreateShader(data_vs.data(), data_vs.size());
+		shader_ps = graphics->CreateShader(data_ps.data(), data_ps.size());
+	}
+	else
+	{
+		LLGI::CompilerResult result_vs;
+		LLGI::CompilerResult result_ps;
+
+		if (platform->GetDeviceType() == LLGI::DeviceType::Metal)
+		{
+			auto code_vs = LoadData("Shaders/Metal/simple_texture_rectangle.vert");
+			auto code_ps = LoadData("Shaders/Metal/simple_texture_rectangle.frag");
+			code_vs.push_back(0);
+			code_ps.push_back(0);
+
+			compiler->Compile(result_vs, (const char*)code_vs.data(), LLGI::ShaderStageType::Vertex);
+			compiler->Compile(result_ps, (const char*)code_ps.data(), LLGI::ShaderStageType::Pixel);
+		}
+		else if (platform->GetDeviceType() == LLGI::DeviceType::DirectX12)
+		{
+			compiler->Compile(result_vs, code_dx_vs, LLGI::ShaderStageType::Vertex);
+			assert(result_vs.Message == "");
+			compiler->Compile(result_ps, code_dx_ps, LLGI::ShaderStageType::Pixel);
+			assert(result_ps.Message == "");
+		}
+
+		for (auto& b : result_vs.Binary)
+		{
+			LLGI::DataStructure d;
+			d.Data = b.data();
+			d.Size = b.size();
+			data_vs.push_back(d);
+		}
+
+		for (auto& b : result_ps.Binary)
+		{
+			LLGI::DataStructure d;
+			d.Data = b.data();
+			d.Size = b.size();
+			data_ps.push_back(d);
+		}
+
+		shader_vs = graphics->CreateShader(data_vs.data(), data_vs.size());
+		shader_ps = graphics->CreateShader(data_ps.data(), data_ps.size());
+	}
+
+	std::map<std::shared_ptr<LLGI::RenderPassPipelineState>, std::shared_ptr<LLGI::PipelineState>> pips;
+
+	int64_t countedDrawCount = 0;
+
+	while (count < frameCount)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		graphics->NewFrame();
+
+		auto renderPass = graphics->GetCurrentScreen(LLGI::Color8(0, 0, 0, 255), true);
+		auto renderPassPipelineState = LLGI::CreateSharedPtr(renderPass->CreateRenderPassPipelineState());
+
+		if (pips.count(renderPassPipelineState) == 0)
+		{
+			auto pip = graphics->CreatePiplineState();
+			pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+			pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+			pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+			pip->VertexLayoutNames[0] = "POSITION";
+			pip->VertexLayoutNames[1] = "UV";
+			pip->VertexLayoutNames[2] = "COLOR";
+			pip->VertexLayoutCount = 3;
+
+			pip->Culling = LLGI::CullingMode::DoubleSide;
+			pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs);
+			pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps);
+			pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+			pip->Compile();
+
+			pips[renderPassPipelineState] = LLGI::CreateSharedPtr(pip);
+		}
+
+		auto pip = pips[renderPassPipelineState].get();
+
+		// recording commands in a steady state must not allocate on heap
+		isAllocationCounted = count >= warmupFrameCount;
+
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass);
+
+		for (int i = 0; i < drawCount; i++)
+		{
+			commandList->SetVertexBuffer(vb, sizeof(SimpleVertex), 0);
+			commandList->SetIndexBuffer(ib);
+			commandList->SetPipelineState(pip);
+			commandList->SetTexture(textures[i % textureCount],
+									LLGI::TextureWrapMode::Repeat,
+									LLGI::TextureMinMagFilter::Linear,
+									0,
+									LLGI::ShaderStageType::Pixel);
+			commandList->Draw(2);
+		}
+
+		commandList->EndRenderPass();
+		commandList->End();
+
+		if (isAllocationCounted)
+		{
+			countedDrawCount += drawCount;
+		}
+
+		isAllocationCounted = false;
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+	}
+
+	std::cout << "Allocation : " << allocationCount << " allocations in " << countedDrawCount << " draws" << std::endl;
+	assert(allocationCount == 0);
+
+	graphics->WaitFinish();
+
+	pips.clear();
+
+	for (auto& texture : textures)
+	{
+		LLGI::SafeRelease(texture);
+	}
+
+	LLGI::SafeRelease(shader_vs);
+	LLGI::SafeRelease(shader_ps);
+	LLGI::SafeRelease(ib);
+	LLGI::SafeRelease(vb);
+	LLGI::SafeRelease(commandList);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+
+	LLGI::SafeRelease(compiler);
+}
@@ -0,0 +1,158 @@
+#include "test.h"
+
+static std::vector<uint8_t> LoadData(const char* path)
+{
+	std::vector<uint8_t> ret;
+
+#ifdef _WIN32
+	FILE* fp = nullptr;
+	fopen_s(&fp, path, "rb");
+
+#else
+	FILE* fp = fopen(path, "rb");
+#endif
+
+	if (fp == nullptr)
+		return ret;
+
+	fseek(fp, 0, SEEK_END);
+	auto size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	ret.resize(size);
+	fread(ret.data(), 1, size, fp);
+	fclose(fp);
+
+	return ret;
+}
+
+void test_commandbundle(LLGI::DeviceType deviceType)
+{
+	// rectangles which are recorded once like static geometry
+	const int rectangleCount = 64;
+
+	int count = 0;
+
+	auto platform = LLGI::CreatePlatform(deviceType);
+	auto graphics = platform->CreateGraphics();
+	auto commandList = graphics->CreateCommandList();
+	auto vb = graphics->CreateVertexBuffer(sizeof(SimpleVertex) * 4 * rectangleCount);
+	auto ib = graphics->CreateIndexBuffer(2, 6);
+
+	auto vb_buf = (SimpleVertex*)vb->Lock();
+	for (int i = 0; i < rectangleCount; i++)
+	{
+		auto x = (i % 8) / 4.0f - 1.0f;
+		auto y = (i / 8) / 4.0f - 1.0f;
+		vb_buf[i * 4 + 0].Pos = LLGI::Vec3F(x, y + 0.2f, 0.5f);
+		vb_buf[i * 4 + 1].Pos = LLGI::Vec3F(x + 0.2f, y + 0.2f, 0.5f);
+		vb_buf[i * 4 + 2].Pos = LLGI::Vec3F(x + 0.2f, y, 0.5f);
+		vb_buf[i * 4 + 3].Pos = LLGI::Vec3F(x, y, 0.5f);
+
+		for (int v = 0; v < 4; v++)
+		{
+			vb_buf[i * 4 + v].Color = LLGI::Color8(i * 4, 255 - i * 4, 255, 255);
+		}
+	}
+	vb->Unlock();
+
+	auto ib_buf = (uint16_t*)ib->Lock();
+	ib_buf[0] = 0;
+	ib_buf[1] = 1;
+	ib_buf[2] = 2;
+	ib_buf[3] = 0;
+	ib_buf[4] = 2;
+	ib_buf[5] = 3;
+	ib->Unlock();
+
+	LLGI::DataStructure d_vs;
+	LLGI::DataStructure d_ps;
+	auto binary_vs = LoadData("Shaders/SPIRV/simple_rectangle.vert.spv");
+	auto binary_ps = LoadData("Shaders/SPIRV/simple_rectangle.frag.spv");
+	d_vs.Data = binary_vs.data();
+	d_vs.Size = binary_vs.size();
+	d_ps.Data = binary_ps.data();
+	d_ps.Size = binary_ps.size();
+
+	auto shader_vs = graphics->CreateShader(&d_vs, 1);
+	auto shader_ps = graphics->CreateShader(&d_ps, 1);
+
+	LLGI::PipelineState* pip = nullptr;
+	LLGI::CommandList* bundle = nullptr;
+
+	while (count < 1000)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		graphics->NewFrame();
+
+		auto renderPass = graphics->GetCurrentScreen(LLGI::Color8(0, 0, 0, 255), true);
+
+		if (bundle == nullptr)
+		{
+			auto renderPassPipelineState = renderPass->CreateRenderPassPipelineState();
+
+			// the size of a window which is created by CreatePlatform
+			bundle = graphics->CreateCommandBundle(renderPassPipelineState, LLGI::Vec2I(1280, 720));
+			if (bundle == nullptr)
+			{
+				std::cout << "CommandBundle : not supported" << std::endl;
+				LLGI::SafeRelease(renderPassPipelineState);
+				break;
+			}
+
+			pip = graphics->CreatePiplineState();
+			pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+			pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+			pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+			pip->VertexLayoutNames[0] = "POSITION";
+			pip->VertexLayoutNames[1] = "UV";
+			pip->VertexLayoutNames[2] = "COLOR";
+			pip->VertexLayoutCount = 3;
+			pip->Culling = LLGI::CullingMode::DoubleSide;
+			pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs);
+			pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps);
+			pip->SetRenderPassPipelineState(renderPassPipelineState);
+			pip->Compile();
+
+			LLGI::SafeRelease(renderPassPipelineState);
+
+			// recorded once and executed in each frame
+			bundle->Begin();
+			bundle->SetIndexBuffer(ib);
+			bundle->SetPipelineState(pip);
+			for (int i = 0; i < rectangleCount; i++)
+			{
+				bundle->SetVertexBuffer(vb, sizeof(SimpleVertex), sizeof(SimpleVertex) * 4 * i);
+				bundle->Draw(2);
+			}
+			bundle->End();
+
+			// the bundle holds resources which it uses
+			LLGI::SafeRelease(pip);
+		}
+
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass);
+		commandList->ExecuteBundle(bundle);
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+	}
+
+	graphics->WaitFinish();
+
+	LLGI::SafeRelease(bundle);
+	LLGI::SafeRelease(shader_vs);
+	LLGI::SafeRelease(shader_ps);
+	LLGI::SafeRelease(ib);
+	LLGI::SafeRelease(vb);
+	LLGI::SafeRelease(commandList);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
@@ -0,0 +1,156 @@
+#include "test.h"
+#include <LLGI.CommandPacketList.h>
+
+static std::vector<uint8_t> LoadData(const char* path)
+{
+	std::vector<uint8_t> ret;
+
+#ifdef _WIN32
+	FILE* fp = nullptr;
+	fopen_s(&fp, path, "rb");
+
+#else
+	FILE* fp = fopen(path, "rb");
+#endif
+
+	if (fp == nullptr)
+		return ret;
+
+	fseek(fp, 0, SEEK_END);
+	auto size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	ret.resize(size);
+	fread(ret.data(), 1, size, fp);
+	fclose(fp);
+
+	return ret;
+}
+
+void test_commandpacket(LLGI::DeviceType deviceType)
+{
+	const int rectangleCount = 64;
+
+	int count = 0;
+
+	auto platform = LLGI::CreatePlatform(deviceType);
+	auto graphics = platform->CreateGraphics();
+	auto commandList = graphics->CreateCommandList();
+	auto packets = new LLGI::CommandPacketList();
+	auto translator = new LLGI::CommandTranslator();
+	auto vb = graphics->CreateVertexBuffer(sizeof(SimpleVertex) * 4 * rectangleCount);
+	auto ib = graphics->CreateIndexBuffer(2, 6);
+
+	auto vb_buf = (SimpleVertex*)vb->Lock();
+	for (int i = 0; i < rectangleCount; i++)
+	{
+		auto x = (i % 8) / 4.0f - 1.0f;
+		auto y = (i / 8) / 4.0f - 1.0f;
+		vb_buf[i * 4 + 0].Pos = LLGI::Vec3F(x, y + 0.2f, 0.5f);
+		vb_buf[i * 4 + 1].Pos = LLGI::Vec3F(x + 0.2f, y + 0.2f, 0.5f);
+		vb_buf[i * 4 + 2].Pos = LLGI::Vec3F(x + 0.2f, y, 0.5f);
+		vb_buf[i * 4 + 3].Pos = LLGI::Vec3F(x, y, 0.5f);
+
+		for (int v = 0; v < 4; v++)
+		{
+			vb_buf[i * 4 + v].Color = LLGI::Color8(255, i * 4, 255 - i * 4, 255);
+		}
+	}
+	vb->Unlock();
+
+	auto ib_buf = (uint16_t*)ib->Lock();
+	ib_buf[0] = 0;
+	ib_buf[1] = 1;
+	ib_buf[2] = 2;
+	ib_buf[3] = 0;
+	ib_buf[4] = 2;
+	ib_buf[5] = 3;
+	ib->Unlock();
+
+	LLGI::DataStructure d_vs;
+	LLGI::DataStructure d_ps;
+	auto binary_vs = LoadData("Shaders/SPIRV/simple_rectangle.vert.spv");
+	auto binary_ps = LoadData("Shaders/SPIRV/simple_rectangle.frag.spv");
+	d_vs.Data = binary_vs.data();
+	d_vs.Size = binary_vs.size();
+	d_ps.Data = binary_ps.data();
+	d_ps.Size = binary_ps.size();
+
+	auto shader_vs = graphics->CreateShader(&d_vs, 1);
+	auto shader_ps = graphics->CreateShader(&d_ps, 1);
+
+	LLGI::PipelineState* pip = nullptr;
+
+	while (count < 1000)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		graphics->NewFrame();
+
+		auto renderPass = graphics->GetCurrentScreen(LLGI::Color8(0, 0, 0, 255), true);
+
+		if (pip == nullptr)
+		{
+			auto renderPassPipelineState = renderPass->CreateRenderPassPipelineState();
+
+			pip = graphics->CreatePiplineState();
+			pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+			pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+			pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+			pip->VertexLayoutNames[0] = "POSITION";
+			pip->VertexLayoutNames[1] = "UV";
+			pip->VertexLayoutNames[2] = "COLOR";
+			pip->VertexLayoutCount = 3;
+			pip->Culling = LLGI::CullingMode::DoubleSide;
+			pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs);
+			pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps);
+			pip->SetRenderPassPipelineState(renderPassPipelineState);
+			pip->Compile();
+
+			LLGI::SafeRelease(renderPassPipelineState);
+		}
+
+		// redundant states are set like a naive renderer and filtered by the translator
+		packets->Begin();
+		packets->BeginRenderPass(renderPass);
+		for (int i = 0; i < rectangleCount; i++)
+		{
+			packets->SetPipelineState(pip);
+			packets->SetIndexBuffer(ib);
+			packets->SetVertexBuffer(vb, sizeof(SimpleVertex), sizeof(SimpleVertex) * 4 * i);
+			packets->Draw(2);
+		}
+		packets->EndRenderPass();
+		packets->End();
+
+		translator->Submit(packets, commandList);
+
+		// an application can record other lists which don't use the render pass here, but must not begin a next frame until Wait
+
+		translator->Wait();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+	}
+
+	auto& statistics = translator->GetStatistics();
+	std::cout << "CommandPacket : " << statistics.PacketCount << " packets, " << statistics.FilteredCount << " filtered, "
+			  << statistics.InvalidCount << " invalid" << std::endl;
+	assert(statistics.InvalidCount == 0);
+
+	graphics->WaitFinish();
+
+	LLGI::SafeRelease(pip);
+	LLGI::SafeRelease(shader_vs);
+	LLGI::SafeRelease(shader_ps);
+	LLGI::SafeRelease(ib);
+	LLGI::SafeRelease(vb);
+	LLGI::SafeRelease(translator);
+	LLGI::SafeRelease(packets);
+	LLGI::SafeRelease(commandList);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
@@ -0,0 +1,130 @@
+#include "test.h"
+#include <LLGI.StorageBuffer.h>
+
+static std::vector<uint8_t> LoadData(const char* path)
+{
+	std::vector<uint8_t> ret;
+
+#ifdef _WIN32
+	FILE* fp = nullptr;
+	fopen_s(&fp, path, "rb");
+
+#else
+	FILE* fp = fopen(path, "rb");
+#endif
+
+	if (fp == nullptr)
+		return ret;
+
+	fseek(fp, 0, SEEK_END);
+	auto size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	ret.resize(size);
+	fread(ret.data(), 1, size, fp);
+	fclose(fp);
+
+	return ret;
+}
+
+void test_compute(LLGI::DeviceType deviceType)
+{
+	const int32_t valueCount = 256;
+
+	auto platform = LLGI::CreatePlatform(deviceType);
+
+	// compute shaders are supported only on Vulkan
+	if (platform->GetDeviceType() != LLGI::DeviceType::Vulkan)
+	{
+		std::cout << "Compute is not supported" << std::endl;
+		LLGI::SafeRelease(platform);
+		return;
+	}
+
+	auto graphics = platform->CreateGraphics();
+	auto commandList = graphics->CreateComputeCommandList();
+
+	auto storageBuffer = graphics->CreateStorageBuffer(sizeof(uint32_t) * valueCount);
+	assert(storageBuffer != nullptr);
+
+	auto values = static_cast<uint32_t*>(storageBuffer->Lock());
+	assert(values != nullptr);
+	for (int32_t i = 0; i < valueCount; i++)
+	{
+		values[i] = i;
+	}
+	storageBuffer->Unlock();
+
+	// only a locked range is uploaded
+	auto half = static_cast<uint32_t*>(storageBuffer->Lock(sizeof(uint32_t) * valueCount / 2, sizeof(uint32_t) * valueCount / 2));
+	assert(half != nullptr);
+	assert(half[0] == valueCount / 2);
+	for (int32_t i = 0; i < valueCount / 2; i++)
+	{
+		half[i] = valueCount + i;
+	}
+	storageBuffer->Unlock();
+
+	assert(storageBuffer->Lock(0, sizeof(uint32_t) * (valueCount + 1)) == nullptr);
+
+	auto binary = LoadData("Shaders/SPIRV/basic.comp.spv");
+	LLGI::DataStructure data;
+	data.Data = binary.data();
+	data.Size = static_cast<int32_t>(binary.size());
+	auto shader = graphics->CreateShader(&data, 1);
+	assert(shader != nullptr);
+
+	auto pip = graphics->CreatePiplineState();
+	pip->SetShader(LLGI::ShaderStageType::Compute, shader);
+	pip->Compile();
+
+	auto isDispatched = false;
+	int count = 0;
+
+	while (count < 60)
+	{
+		if (!platform->NewFrame())
+		{
+			break;
+		}
+
+		graphics->NewFrame();
+
+		if (!isDispatched)
+		{
+			commandList->Begin();
+			commandList->SetPipelineState(pip);
+			commandList->SetStorageBuffer(storageBuffer, 0, LLGI::ShaderStageType::Compute);
+			commandList->Dispatch(valueCount, 1, 1);
+			commandList->End();
+
+			graphics->ExecuteCompute(commandList);
+			isDispatched = true;
+		}
+
+		platform->Present();
+		count++;
+	}
+
+	graphics->WaitFinish();
+
+	if (isDispatched)
+	{
+		values = static_cast<uint32_t*>(storageBuffer->Lock());
+		for (int32_t i = 0; i < valueCount; i++)
+		{
+			auto value = i < valueCount / 2 ? i : valueCount + i - valueCount / 2;
+			assert(values[i] == static_cast<uint32_t>(value * 2 + 1));
+		}
+		storageBuffer->Unlock();
+
+		std::cout << "Compute : " << valueCount << " values are written" << std::endl;
+	}
+
+	LLGI::SafeRelease(pip);
+	LLGI::SafeRelease(shader);
+	LLGI::SafeRelease(storageBuffer);
+	LLGI::SafeRelease(commandList);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
@@ -0,0 +1,70 @@
+#include "test.h"
+#include <LLGI.Fence.h>
+
+void test_fence(LLGI::DeviceType deviceType)
+{
+	int count = 0;
+
+	auto platform = LLGI::CreatePlatform(deviceType);
+	auto graphics = platform->CreateGraphics();
+	auto commandList = graphics->CreateCommandList();
+	auto fence = graphics->CreateFence();
+
+	if (fence == nullptr)
+	{
+		std::cout << "Fence is not supported" << std::endl;
+	}
+
+	uint64_t previousValue = 0;
+
+	while (count < 1000 && fence != nullptr)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		graphics->NewFrame();
+
+		commandList->Begin();
+		commandList->BeginRenderPass(graphics->GetCurrentScreen(LLGI::Color8(0, count % 255, 0, 255), true));
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		// values increase by a signal and they are known on cpu
+		auto value = graphics->Signal(fence);
+		assert(value == previousValue + 1);
+		assert(fence->GetSignaledValue() == value);
+		assert(fence->GetCompletedValue() <= value);
+
+		// a value which is not signaled is not waited
+		auto isUnsignaledWaited = fence->Wait(value + 1, 0);
+		assert(!isUnsignaledWaited);
+
+		// commands of a previous frame are finished soon
+		if (previousValue > 0)
+		{
+			auto isPreviousWaited = fence->Wait(previousValue, 1000);
+			assert(isPreviousWaited);
+			assert(fence->IsCompleted(previousValue));
+		}
+
+		previousValue = value;
+
+		platform->Present();
+		count++;
+	}
+
+	if (fence != nullptr)
+	{
+		auto isWaited = fence->Wait(fence->GetSignaledValue());
+		assert(isWaited);
+		assert(fence->IsCompleted());
+		std::cout << "Fence : " << fence->GetCompletedValue() << " values are completed" << std::endl;
+	}
+
+	LLGI::SafeRelease(fence);
+	LLGI::SafeRelease(commandList);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
@@ -0,0 +1,185 @@
+#include "test.h"
+#include <LLGI.MeshFile.h>
+
+void test_meshfile(LLGI::DeviceType deviceType)
+{
+	const char* path = "test_meshfile.llgm";
+	const char* brokenPath = "test_meshfile_broken.llgm";
+
+	// positions and other attributes are saved in different streams
+	const int division = 8;
+	std::vector<LLGI::Vec3F> positions;
+	std::vector<SimpleVertex> vertices;
+	for (int y = 0; y <= division; y++)
+	{
+		for (int x = 0; x <= division; x++)
+		{
+			SimpleVertex v;
+			v.Pos = LLGI::Vec3F(x / (float)division * 2.0f - 1.0f, y / (float)division - 0.5f, 0.5f);
+			v.UV = LLGI::Vec2F(x / (float)division, y / (float)division);
+			v.Color = LLGI::Color8(255, x * 16, y * 16, 255);
+			positions.push_back(v.Pos);
+			vertices.push_back(v);
+		}
+	}
+
+	std::vector<uint16_t> indices;
+	for (int y = 0; y < division; y++)
+	{
+		for (int x = 0; x < division; x++)
+		{
+			uint16_t i0 = y * (division + 1) + x;
+			uint16_t i1 = i0 + 1;
+			uint16_t i2 = i0 + division + 1;
+			uint16_t i3 = i2 + 1;
+			indices.insert(indices.end(), {i0, i1, i2, i1, i3, i2});
+		}
+	}
+
+	LLGI::MeshFileDescription description;
+	description.VertexCount = static_cast<int32_t>(vertices.size());
+	description.VertexStreams.resize(2);
+	description.VertexStreams[0].Stride = sizeof(LLGI::Vec3F);
+	description.VertexStreams[0].Data = positions.data();
+	description.VertexStreams[1].Stride = sizeof(SimpleVertex);
+	description.VertexStreams[1].Data = vertices.data();
+	description.Attributes.resize(3);
+	description.Attributes[0].Format = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+	description.Attributes[0].Name = "POSITION";
+	description.Attributes[1].Format = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+	description.Attributes[1].Slot = 1;
+	description.Attributes[1].Offset = 12;
+	description.Attributes[1].Name = "UV";
+	description.Attributes[2].Format = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+	description.Attributes[2].Slot = 1;
+	description.Attributes[2].Offset = 20;
+	description.Attributes[2].Name = "COLOR";
+	description.IndexData = indices.data();
+	description.IndexCount = static_cast<int32_t>(indices.size());
+	description.IndexStride = 2;
+
+	// the lower half and the upper half
+	auto halfIndexCount = description.IndexCount / 2;
+	description.SubMeshes.resize(2);
+	description.SubMeshes[0].IndexOffset = 0;
+	description.SubMeshes[0].IndexCount = halfIndexCount;
+	description.SubMeshes[1].IndexOffset = halfIndexCount;
+	description.SubMeshes[1].IndexCount = description.IndexCount - halfIndexCount;
+
+	// invalid descriptions are not saved
+	{
+		auto invalid = description;
+		invalid.Attributes[2].Offset = sizeof(SimpleVertex) - 2;
+		assert(!LLGI::MeshFile::Save(path, invalid));
+
+		invalid = description;
+		invalid.SubMeshes[1].IndexCount++;
+		assert(!LLGI::MeshFile::Save(path, invalid));
+
+		invalid = description;
+		invalid.VertexCount = INT32_MAX / 2;
+		assert(!LLGI::MeshFile::Save(path, invalid));
+	}
+
+	auto isSaved = LLGI::MeshFile::Save(path, description);
+	assert(isSaved);
+
+	auto meshFile = new LLGI::MeshFile();
+	auto isLoaded = meshFile->Initialize(path);
+	assert(isLoaded);
+
+	if (isSaved && isLoaded)
+	{
+		assert(meshFile->GetVertexCount() == description.VertexCount);
+		assert(meshFile->GetIndexCount() == description.IndexCount);
+		assert(meshFile->GetIndexStride() == 2);
+		assert(meshFile->GetVertexStreamCount() == 2);
+		assert(meshFile->GetAttributeCount() == 3);
+		assert(meshFile->GetSubMeshCount() == 2);
+
+		for (int32_t i = 0; i < meshFile->GetVertexStreamCount(); i++)
+		{
+			const auto& stream = description.VertexStreams[i];
+			assert(meshFile->GetVertexStride(i) == stream.Stride);
+			assert(reinterpret_cast<uintptr_t>(meshFile->GetVertexData(i)) % LLGI::MeshFileDataAlignment == 0);
+			assert(memcmp(meshFile->GetVertexData(i), stream.Data, stream.Stride * description.VertexCount) == 0);
+		}
+
+		assert(reinterpret_cast<uintptr_t>(meshFile->GetIndexData()) % LLGI::MeshFileDataAlignment == 0);
+		assert(memcmp(meshFile->GetIndexData(), indices.data(), indices.size() * sizeof(uint16_t)) == 0);
+
+		for (int32_t i = 0; i < meshFile->GetAttributeCount(); i++)
+		{
+			const auto& attribute = meshFile->GetAttribute(i);
+			assert(attribute.Format == static_cast<int32_t>(description.Attributes[i].Format));
+			assert(attribute.Slot == description.Attributes[i].Slot);
+			assert(attribute.Offset == description.Attributes[i].Offset);
+			assert(description.Attributes[i].Name == attribute.Name);
+		}
+
+		// bounding boxes are calculated from positions which are referred by submeshes
+		auto boundsMin = meshFile->GetBoundsMin();
+		auto boundsMax = meshFile->GetBoundsMax();
+		assert(boundsMin.X == -1.0f && boundsMin.Y == -0.5f && boundsMin.Z == 0.5f);
+		assert(boundsMax.X == 1.0f && boundsMax.Y == 0.5f && boundsMax.Z == 0.5f);
+
+		const auto& lower = meshFile->GetSubMesh(0);
+		const auto& upper = meshFile->GetSubMesh(1);
+		assert(lower.IndexOffset == 0 && lower.IndexCount == halfIndexCount);
+		assert(upper.IndexOffset == halfIndexCount && upper.IndexCount == description.IndexCount - halfIndexCount);
+		assert(lower.BoundsMin[1] == -0.5f && lower.BoundsMax[1] == 0.0f);
+		assert(upper.BoundsMin[1] == 0.0f && upper.BoundsMax[1] == 0.5f);
+
+		auto platform = LLGI::CreatePlatform(deviceType);
+		auto graphics = platform->CreateGraphics();
+
+		auto pip = graphics->CreatePiplineState();
+		meshFile->SetVertexLayouts(pip);
+		assert(pip->VertexLayoutCount == 3);
+		assert(pip->VertexLayoutSlots[1] == 1);
+		assert(pip->GetVertexLayoutOffset(2) == 20);
+		assert(pip->GetVertexStride(0) == sizeof(LLGI::Vec3F));
+		assert(pip->GetVertexStride(1) == sizeof(SimpleVertex));
+
+		auto vb = meshFile->CreateVertexBuffer(graphics, 1);
+		auto ib = meshFile->CreateIndexBuffer(graphics);
+		assert(vb != nullptr);
+		assert(ib != nullptr);
+		assert(ib->GetCount() == description.IndexCount);
+
+		std::cout << "MeshFile : " << meshFile->GetVertexCount() << " vertices, " << meshFile->GetSubMeshCount() << " submeshes"
+				  << std::endl;
+
+		LLGI::SafeRelease(pip);
+		LLGI::SafeRelease(vb);
+		LLGI::SafeRelease(ib);
+		LLGI::SafeRelease(graphics);
+		LLGI::SafeRelease(platform);
+	}
+
+	LLGI::SafeRelease(meshFile);
+
+	// broken files are not loaded
+	{
+#ifdef _WIN32
+		FILE* fp = nullptr;
+		fopen_s(&fp, brokenPath, "wb");
+#else
+		FILE* fp = fopen(brokenPath, "wb");
+#endif
+		if (fp != nullptr)
+		{
+			const uint32_t broken[4] = {LLGI::MeshFileMagic, LLGI::MeshFileVersion + 1, 0, 0};
+			fwrite(broken, sizeof(broken), 1, fp);
+			fclose(fp);
+		}
+
+		auto brokenFile = new LLGI::MeshFile();
+		assert(!brokenFile->Initialize(brokenPath));
+		assert(!brokenFile->Initialize("test_meshfile_not_found.llgm"));
+		LLGI::SafeRelease(brokenFile);
+	}
+
+	remove(path);
+	remove(brokenPath);
+}
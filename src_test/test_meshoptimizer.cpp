@@ -0,0 +1,86 @@
+#include "test.h"
+#include <LLGI.MeshOptimizer.h>
+#include <random>
+
+void test_meshoptimizer(LLGI::DeviceType deviceType)
+{
+	// grids whose triangles are shuffled like meshes exported in authoring order
+	const int meshCount = 8;
+	std::vector<LLGI::MeshOptimizerMesh> meshes(meshCount);
+	std::mt19937 random(1);
+
+	for (int m = 0; m < meshCount; m++)
+	{
+		auto& mesh = meshes[m];
+		auto division = 16 << (m % 4);
+
+		std::vector<SimpleVertex> vertices;
+		for (int y = 0; y <= division; y++)
+		{
+			for (int x = 0; x <= division; x++)
+			{
+				SimpleVertex v;
+				v.Pos = LLGI::Vec3F(x / (float)division * 2.0f - 1.0f, y / (float)division * 2.0f - 1.0f, 0.5f);
+				v.UV = LLGI::Vec2F(x / (float)division, y / (float)division);
+				v.Color = LLGI::Color8(255, 255, 255, 255);
+				vertices.push_back(v);
+			}
+		}
+
+		std::vector<std::array<uint32_t, 3>> triangles;
+		for (int y = 0; y < division; y++)
+		{
+			for (int x = 0; x < division; x++)
+			{
+				uint32_t i0 = y * (division + 1) + x;
+				uint32_t i1 = i0 + 1;
+				uint32_t i2 = i0 + division + 1;
+				uint32_t i3 = i2 + 1;
+				triangles.push_back({i0, i1, i2});
+				triangles.push_back({i1, i3, i2});
+			}
+		}
+		std::shuffle(triangles.begin(), triangles.end(), random);
+
+		mesh.VertexStride = sizeof(SimpleVertex);
+		mesh.PositionOffset = 0;
+		mesh.Vertices.resize(vertices.size() * sizeof(SimpleVertex));
+		memcpy(mesh.Vertices.data(), vertices.data(), mesh.Vertices.size());
+
+		for (auto& t : triangles)
+		{
+			mesh.Indices.insert(mesh.Indices.end(), t.begin(), t.end());
+		}
+	}
+
+	if (!LLGI::OptimizeMeshes(meshes.data(), meshCount))
+	{
+		std::cout << "Failed to optimize meshes" << std::endl;
+	}
+
+	for (auto& mesh : meshes)
+	{
+		std::cout << "MeshOptimizer : ACMR " << mesh.Before.ACMR << " -> " << mesh.After.ACMR << ", ATVR " << mesh.Before.ATVR << " -> "
+				  << mesh.After.ATVR << ", index stride " << mesh.IndexStride << std::endl;
+		assert(mesh.After.ACMR < mesh.Before.ACMR);
+	}
+
+	// optimized data are copied into buffers directly
+	auto platform = LLGI::CreatePlatform(deviceType);
+	auto graphics = platform->CreateGraphics();
+
+	auto& mesh = meshes[0];
+	auto vb = graphics->CreateVertexBuffer(static_cast<int32_t>(mesh.Vertices.size()));
+	auto ib = graphics->CreateIndexBuffer(mesh.IndexStride, static_cast<int32_t>(mesh.Indices.size()));
+
+	memcpy(vb->Lock(), mesh.Vertices.data(), mesh.Vertices.size());
+	vb->Unlock();
+
+	memcpy(ib->Lock(), mesh.IndexData.data(), mesh.IndexData.size());
+	ib->Unlock();
+
+	LLGI::SafeRelease(vb);
+	LLGI::SafeRelease(ib);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
@@ -1,4 +1,5 @@
 #include "test.h"
+#include <array>
 #include <map>
 
 static std::vector<uint8_t> LoadData(const char* path)
@@ -339,3 +340,279 @@ float4 main(PS_INPUT input) : SV_TARGET
 
 	LLGI::SafeRelease(compiler);
 }
+
+void test_renderPass_mrt(LLGI::DeviceType deviceType)
+{
+	auto code_dx_vs = R"(
+struct VS_INPUT{
+    float3 Position : POSITION0;
+	float2 UV : UV0;
+    float4 Color : COLOR0;
+};
+struct VS_OUTPUT{
+    float4 Position : SV_POSITION;
+	float2 UV : UV0;
+    float4 Color : COLOR0;
+};
+
+VS_OUTPUT main(VS_INPUT input){
+    VS_OUTPUT output;
+
+    output.Position = float4(input.Position, 1.0f);
+	output.UV = input.UV;
+    output.Color = input.Color;
+
+    return output;
+}
+)";
+
+	auto code_dx_ps = R"(
+Texture2D txt : register(t8);
+SamplerState smp : register(s8);
+
+struct PS_INPUT
+{
+    float4  Position : SV_POSITION;
+	float2  UV : UV0;
+    float4  Color    : COLOR0;
+};
+
+float4 main(PS_INPUT input) : SV_TARGET
+{
+	float4 c;
+	c = txt.Sample(smp, input.UV);
+	c.a = 255;
+	return c;
+}
+)";
+
+	const int32_t colorCount = 2;
+	const auto textureSize = LLGI::Vec2I(256, 256);
+
+	auto compiler = LLGI::CreateCompiler(deviceType);
+
+	int count = 0;
+
+	auto platform = LLGI::CreatePlatform(deviceType);
+	auto graphics = platform->CreateGraphics();
+	auto commandList = graphics->CreateCommandList();
+	auto vb = graphics->CreateVertexBuffer(sizeof(SimpleVertex) * 4 * colorCount);
+	auto ib = graphics->CreateIndexBuffer(2, 6);
+
+	std::array<LLGI::Texture*, colorCount> renderTextures;
+	renderTextures.fill(nullptr);
+	LLGI::Texture* depthTexture = nullptr;
+	LLGI::RenderPass* renderPass = nullptr;
+
+	// framebuffers which refer render targets are disposed with them
+	auto createRenderPass = [&]() -> void {
+		LLGI::SafeRelease(renderPass);
+		LLGI::SafeRelease(depthTexture);
+		for (auto& renderTexture : renderTextures)
+		{
+			LLGI::SafeRelease(renderTexture);
+			renderTexture = graphics->CreateTexture(textureSize, true, false);
+			assert(renderTexture != nullptr);
+		}
+
+		depthTexture = graphics->CreateDepthTexture(textureSize, false);
+		assert(depthTexture != nullptr);
+
+		renderPass = graphics->CreateRenderPass((const LLGI::Texture**)renderTextures.data(), colorCount, depthTexture);
+		assert(renderPass != nullptr);
+	};
+
+	createRenderPass();
+
+	LLGI::Shader* shader_vs = nullptr;
+	LLGI::Shader* shader_ps = nullptr;
+
+	std::vector<LLGI::DataStructure> data_vs;
+	std::vector<LLGI::DataStructure> data_ps;
+
+	if (compiler == nullptr)
+	{
+		auto binary_vs = LoadData("Shaders/SPIRV/simple_texture_rectangle.vert.spv");
+		auto binary_ps = LoadData("Shaders/SPIRV/simple_texture_rectangle.frag.spv");
+
+		LLGI::DataStructure d_vs;
+		LLGI::DataStructure d_ps;
+
+		d_vs.Data = binary_vs.data();
+		d_vs.Size = binary_vs.size();
+		d_ps.Data = binary_ps.data();
+		d_ps.Size = binary_ps.size();
+
+		data_vs.push_back(d_vs);
+		data_ps.push_back(d_ps);
+
+		shader_vs = graphics->CreateShader(data_vs.data(), data_vs.size());
+		shader_ps = graphics->CreateShader(data_ps.data(), data_ps.size());
+	}
+	else
+	{
+		LLGI::CompilerResult result_vs;
+		LLGI::CompilerResult result_ps;
+
+		if (platform->GetDeviceType() == LLGI::DeviceType::Metal)
+		{
+			auto code_vs = LoadData("Shaders/Metal/simple_texture_rectangle.vert");
+			auto code_ps = LoadData("Shaders/Metal/simple_texture_rectangle.frag");
+			code_vs.push_back(0);
+			code_ps.push_back(0);
+
+			compiler->Compile(result_vs, (const char*)code_vs.data(), LLGI::ShaderStageType::Vertex);
+			compiler->Compile(result_ps, (const char*)code_ps.data(), LLGI::ShaderStageType::Pixel);
+		}
+		else if (platform->GetDeviceType() == LLGI::DeviceType::DirectX12)
+		{
+			compiler->Compile(result_vs, code_dx_vs, LLGI::ShaderStageType::Vertex);
+			assert(result_vs.Message == "");
+			compiler->Compile(result_ps, code_dx_ps, LLGI::ShaderStageType::Pixel);
+			assert(result_ps.Message == "");
+		}
+
+		for (auto& b : result_vs.Binary)
+		{
+			LLGI::DataStructure d;
+			d.Data = b.data();
+			d.Size = b.size();
+			data_vs.push_back(d);
+		}
+
+		for (auto& b : result_ps.Binary)
+		{
+			LLGI::DataStructure d;
+			d.Data = b.data();
+			d.Size = b.size();
+			data_ps.push_back(d);
+		}
+
+		shader_vs = graphics->CreateShader(data_vs.data(), data_vs.size());
+		shader_ps = graphics->CreateShader(data_ps.data(), data_ps.size());
+	}
+
+	// a quad for each color buffer
+	auto vb_buf = (SimpleVertex*)vb->Lock();
+	for (int32_t i = 0; i < colorCount; i++)
+	{
+		auto left = -1.0f + i;
+		auto v = vb_buf + i * 4;
+		v[0].Pos = LLGI::Vec3F(left, 0.5f, 0.5f);
+		v[1].Pos = LLGI::Vec3F(left + 1.0f, 0.5f, 0.5f);
+		v[2].Pos = LLGI::Vec3F(left + 1.0f, -0.5f, 0.5f);
+		v[3].Pos = LLGI::Vec3F(left, -0.5f, 0.5f);
+
+		v[0].UV = LLGI::Vec2F(0.0f, 0.0f);
+		v[1].UV = LLGI::Vec2F(1.0f, 0.0f);
+		v[2].UV = LLGI::Vec2F(1.0f, 1.0f);
+		v[3].UV = LLGI::Vec2F(0.0f, 1.0f);
+
+		for (int32_t j = 0; j < 4; j++)
+		{
+			v[j].Color = LLGI::Color8();
+		}
+	}
+	vb->Unlock();
+
+	auto ib_buf = (uint16_t*)ib->Lock();
+	ib_buf[0] = 0;
+	ib_buf[1] = 1;
+	ib_buf[2] = 2;
+	ib_buf[3] = 0;
+	ib_buf[4] = 2;
+	ib_buf[5] = 3;
+	ib->Unlock();
+
+	std::map<std::shared_ptr<LLGI::RenderPassPipelineState>, std::shared_ptr<LLGI::PipelineState>> pips;
+
+	while (count < 1000)
+	{
+		if (!platform->NewFrame())
+		{
+			break;
+		}
+
+		graphics->NewFrame();
+
+		if (count > 0 && count % 60 == 0)
+		{
+			// render targets must not be released while commands refer them
+			graphics->WaitFinish();
+			createRenderPass();
+		}
+
+		// all color buffers are cleared with the same color
+		renderPass->SetIsColorCleared(true);
+		renderPass->SetIsDepthCleared(true);
+		renderPass->SetClearColor(LLGI::Color8(0, count % 255, 255 - count % 255, 255));
+
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass);
+		commandList->EndRenderPass();
+
+		auto renderPassSc = graphics->GetCurrentScreen(LLGI::Color8(0, 0, 0, 255), true);
+		auto renderPassPipelineStateSc = LLGI::CreateSharedPtr(renderPassSc->CreateRenderPassPipelineState());
+
+		if (pips.count(renderPassPipelineStateSc) == 0)
+		{
+			auto pip = graphics->CreatePiplineState();
+			pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+			pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+			pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+			pip->VertexLayoutNames[0] = "POSITION";
+			pip->VertexLayoutNames[1] = "UV";
+			pip->VertexLayoutNames[2] = "COLOR";
+			pip->VertexLayoutCount = 3;
+
+			pip->Culling = LLGI::CullingMode::DoubleSide;
+			pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs);
+			pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps);
+			pip->SetRenderPassPipelineState(renderPassPipelineStateSc.get());
+			pip->Compile();
+
+			pips[renderPassPipelineStateSc] = LLGI::CreateSharedPtr(pip);
+		}
+
+		// each color buffer is drawn side by side
+		commandList->BeginRenderPass(renderPassSc);
+		commandList->SetIndexBuffer(ib);
+		commandList->SetPipelineState(pips[renderPassPipelineStateSc].get());
+
+		for (int32_t i = 0; i < colorCount; i++)
+		{
+			commandList->SetVertexBuffer(vb, sizeof(SimpleVertex), sizeof(SimpleVertex) * 4 * i);
+			commandList->SetTexture(
+				renderTextures[i], LLGI::TextureWrapMode::Repeat, LLGI::TextureMinMagFilter::Nearest, 0, LLGI::ShaderStageType::Pixel);
+			commandList->Draw(2);
+		}
+
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+	}
+
+	graphics->WaitFinish();
+
+	pips.clear();
+
+	LLGI::SafeRelease(renderPass);
+	LLGI::SafeRelease(depthTexture);
+	for (auto& renderTexture : renderTextures)
+	{
+		LLGI::SafeRelease(renderTexture);
+	}
+	LLGI::SafeRelease(shader_vs);
+	LLGI::SafeRelease(shader_ps);
+	LLGI::SafeRelease(ib);
+	LLGI::SafeRelease(vb);
+	LLGI::SafeRelease(commandList);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+
+	LLGI::SafeRelease(compiler);
+}
@@ -0,0 +1,160 @@
+#include "test.h"
+#include <LLGI.CommandPacketList.h>
+#include <LLGI.RenderThread.h>
+
+static std::vector<uint8_t> LoadData(const char* path)
+{
+	std::vector<uint8_t> ret;
+
+#ifdef _WIN32
+	FILE* fp = nullptr;
+	fopen_s(&fp, path, "rb");
+
+#else
+	FILE* fp = fopen(path, "rb");
+#endif
+
+	if (fp == nullptr)
+		return ret;
+
+	fseek(fp, 0, SEEK_END);
+	auto size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	ret.resize(size);
+	fread(ret.data(), 1, size, fp);
+	fclose(fp);
+
+	return ret;
+}
+
+void test_renderthread(LLGI::DeviceType deviceType)
+{
+	LLGI::RenderThreadParameter parameter;
+	parameter.QueueDepth = 2;
+
+	int count = 0;
+
+	auto platform = LLGI::CreatePlatform(deviceType);
+	auto graphics = platform->CreateGraphics();
+	auto vb = graphics->CreateVertexBuffer(sizeof(SimpleVertex) * 4);
+	auto ib = graphics->CreateIndexBuffer(2, 6);
+
+	auto vb_buf = (SimpleVertex*)vb->Lock();
+	vb_buf[0].Pos = LLGI::Vec3F(-0.5, 0.5, 0.5);
+	vb_buf[1].Pos = LLGI::Vec3F(0.5, 0.5, 0.5);
+	vb_buf[2].Pos = LLGI::Vec3F(0.5, -0.5, 0.5);
+	vb_buf[3].Pos = LLGI::Vec3F(-0.5, -0.5, 0.5);
+
+	vb_buf[0].Color = LLGI::Color8(255, 255, 255, 255);
+	vb_buf[1].Color = LLGI::Color8(255, 255, 0, 255);
+	vb_buf[2].Color = LLGI::Color8(0, 255, 0, 255);
+	vb_buf[3].Color = LLGI::Color8(0, 0, 255, 255);
+	vb->Unlock();
+
+	auto ib_buf = (uint16_t*)ib->Lock();
+	ib_buf[0] = 0;
+	ib_buf[1] = 1;
+	ib_buf[2] = 2;
+	ib_buf[3] = 0;
+	ib_buf[4] = 2;
+	ib_buf[5] = 3;
+	ib->Unlock();
+
+	LLGI::DataStructure d_vs;
+	LLGI::DataStructure d_ps;
+	auto binary_vs = LoadData("Shaders/SPIRV/simple_rectangle.vert.spv");
+	auto binary_ps = LoadData("Shaders/SPIRV/simple_rectangle.frag.spv");
+	d_vs.Data = binary_vs.data();
+	d_vs.Size = binary_vs.size();
+	d_ps.Data = binary_ps.data();
+	d_ps.Size = binary_ps.size();
+
+	auto shader_vs = graphics->CreateShader(&d_vs, 1);
+	auto shader_ps = graphics->CreateShader(&d_ps, 1);
+
+	// a pipeline state is created before graphics is used on the render thread
+	auto renderPassPipelineState = graphics->GetCurrentScreen()->CreateRenderPassPipelineState();
+
+	auto pip = graphics->CreatePiplineState();
+	pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+	pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+	pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+	pip->VertexLayoutNames[0] = "POSITION";
+	pip->VertexLayoutNames[1] = "UV";
+	pip->VertexLayoutNames[2] = "COLOR";
+	pip->VertexLayoutCount = 3;
+	pip->Culling = LLGI::CullingMode::DoubleSide;
+	pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs);
+	pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps);
+	pip->SetRenderPassPipelineState(renderPassPipelineState);
+	pip->Compile();
+
+	LLGI::SafeRelease(renderPassPipelineState);
+
+	std::vector<LLGI::CommandPacketList*> packets;
+	for (int i = 0; i < parameter.QueueDepth + 2; i++)
+	{
+		packets.push_back(new LLGI::CommandPacketList());
+	}
+
+	auto renderThread = new LLGI::RenderThread();
+	if (!renderThread->Initialize(platform, graphics, parameter))
+	{
+		std::cout << "Failed to initialize RenderThread" << std::endl;
+	}
+
+	while (count < 1000 && renderThread->GetIsRunning())
+	{
+		auto p = packets[count % packets.size()];
+
+		// resources are updated on the render thread before packets of the frame are translated
+		if (count == 0)
+		{
+			renderThread->Upload([vb]() {
+				auto buf = (SimpleVertex*)vb->Lock();
+				buf[0].Color = LLGI::Color8(255, 0, 255, 255);
+				vb->Unlock();
+			});
+		}
+
+		p->Begin();
+		p->BeginScreenRenderPass(LLGI::Color8(count % 255, 0, 0, 255), true);
+		p->SetVertexBuffer(vb, sizeof(SimpleVertex), 0);
+		p->SetIndexBuffer(ib);
+		p->SetPipelineState(pip);
+		p->Draw(2);
+		p->EndRenderPass();
+		p->End();
+
+		renderThread->Execute(p);
+
+		// it returns without waiting for vsync while the queue has space
+		if (!renderThread->Present())
+			break;
+
+		count++;
+	}
+
+	renderThread->Wait();
+
+	auto statistics = renderThread->GetStatistics();
+	std::cout << "RenderThread : " << statistics.FrameCount << " frames, submission blocking " << statistics.SubmissionBlockingTime
+			  << " s, present blocking " << statistics.PresentBlockingTime << " s, idle " << statistics.IdleTime << " s" << std::endl;
+
+	// the render thread releases command lists after it waits for gpu
+	LLGI::SafeRelease(renderThread);
+
+	for (auto p : packets)
+	{
+		LLGI::SafeRelease(p);
+	}
+
+	LLGI::SafeRelease(pip);
+	LLGI::SafeRelease(shader_vs);
+	LLGI::SafeRelease(shader_ps);
+	LLGI::SafeRelease(ib);
+	LLGI::SafeRelease(vb);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
@@ -0,0 +1,89 @@
+#include "test.h"
+#include <LLGI.ResourcePool.h>
+#include <unordered_map>
+
+void test_resourcepool(LLGI::DeviceType deviceType)
+{
+	const int frameCount = 3;
+	int count = 0;
+
+	auto platform = LLGI::CreatePlatform(deviceType);
+	auto graphics = platform->CreateGraphics();
+	auto commandList = graphics->CreateCommandList();
+
+	auto pool = new LLGI::ResourcePool();
+	auto initialized = pool->Initialize(graphics, frameCount, 16 * 1024 * 1024);
+	assert(initialized);
+
+	// frames in which resources are released. Resources are not disposed in the loop, so their addresses are not reused.
+	std::unordered_map<LLGI::ReferenceObject*, int> releasedFrames;
+	auto checkReused = [&](LLGI::ReferenceObject* resource) {
+		assert(resource != nullptr);
+		auto it = releasedFrames.find(resource);
+		if (it != releasedFrames.end())
+		{
+			// frames which may use it are finished
+			assert(count - it->second >= frameCount);
+			releasedFrames.erase(it);
+		}
+	};
+
+	while (count < 1000)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		graphics->NewFrame();
+		pool->NewFrame();
+
+		// resources which are created and released in each frame
+		for (int i = 0; i < 16; i++)
+		{
+			auto cb = pool->CreateConstantBuffer(sizeof(float) * 16 * (1 + i % 4));
+			auto vb = pool->CreateVertexBuffer(sizeof(SimpleVertex) * 4 * (1 + i % 3));
+			auto texture = pool->CreateTexture(LLGI::Vec2I(64, 64), false, false);
+			checkReused(cb);
+			checkReused(vb);
+			checkReused(texture);
+
+			releasedFrames[cb] = count;
+			releasedFrames[vb] = count;
+			releasedFrames[texture] = count;
+			LLGI::SafeRelease(cb);
+			LLGI::SafeRelease(vb);
+			LLGI::SafeRelease(texture);
+		}
+
+		commandList->Begin();
+		commandList->BeginRenderPass(graphics->GetCurrentScreen(LLGI::Color8(), true));
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+
+		// resources released in the first frame are reused after warm-up
+		if (count == frameCount * 2)
+		{
+			assert(pool->GetStatistics().HitCount > 0);
+		}
+	}
+
+	auto& statistics = pool->GetStatistics();
+	std::cout << "ResourcePool : hit rate " << statistics.GetHitRate() << ", retained " << statistics.RetainedCount << " resources, "
+			  << statistics.RetainedSize << " bytes" << std::endl;
+
+	graphics->WaitFinish();
+
+	// resources over a lowered budget are released
+	assert(statistics.RetainedSize > 0);
+	pool->SetBudget(statistics.RetainedSize / 2);
+	assert(statistics.RetainedSize <= pool->GetBudget());
+
+	LLGI::SafeRelease(pool);
+	LLGI::SafeRelease(commandList);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
@@ -0,0 +1,283 @@
+#include "test.h"
+#include <LLGI.SpriteBatch.h>
+#include <map>
+
+static std::vector<uint8_t> LoadData(const char* path)
+{
+	std::vector<uint8_t> ret;
+
+#ifdef _WIN32
+	FILE* fp = nullptr;
+	fopen_s(&fp, path, "rb");
+
+#else
+	FILE* fp = fopen(path, "rb");
+#endif
+
+	if (fp == nullptr)
+		return ret;
+
+	fseek(fp, 0, SEEK_END);
+	auto size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	ret.resize(size);
+	fread(ret.data(), 1, size, fp);
+	fclose(fp);
+
+	return ret;
+}
+
+void test_spritebatch(LLGI::DeviceType deviceType)
+{
+	auto code_dx_vs = R"(
+struct VS_INPUT{
+    float3 Position : POSITION0;
+	float2 UV : UV0;
+    float4 Color : COLOR0;
+};
+struct VS_OUTPUT{
+    float4 Position : SV_POSITION;
+	float2 UV : UV0;
+    float4 Color : COLOR0;
+};
+
+VS_OUTPUT main(VS_INPUT input){
+    VS_OUTPUT output;
+
+    output.Position = float4(input.Position, 1.0f);
+	output.UV = input.UV;
+    output.Color = input.Color;
+
+    return output;
+}
+)";
+
+	auto code_dx_ps = R"(
+Texture2D txt : register(t8);
+SamplerState smp : register(s8);
+
+struct PS_INPUT
+{
+    float4  Position : SV_POSITION;
+	float2  UV : UV0;
+    float4  Color    : COLOR0;
+};
+
+float4 main(PS_INPUT input) : SV_TARGET
+{
+	return input.Color * txt.Sample(smp, input.UV);
+}
+)";
+
+	const int spriteCount = 100000;
+	const int textureCount = 4;
+
+	auto compiler = LLGI::CreateCompiler(deviceType);
+
+	int count = 0;
+
+	auto platform = LLGI::CreatePlatform(deviceType);
+	auto graphics = platform->CreateGraphics();
+	auto commandList = graphics->CreateCommandList();
+
+	auto spriteBatch = new LLGI::SpriteBatch();
+	if (!spriteBatch->Initialize(graphics))
+	{
+		// transient buffers are not supported on some backends
+		std::cout << "SpriteBatch is not supported" << std::endl;
+		LLGI::SafeRelease(spriteBatch);
+		LLGI::SafeRelease(commandList);
+		LLGI::SafeRelease(graphics);
+		LLGI::SafeRelease(platform);
+		LLGI::SafeRelease(compiler);
+		return;
+	}
+
+	std::array<LLGI::Texture*, textureCount> textures;
+	for (int i = 0; i < textureCount; i++)
+	{
+		textures[i] = graphics->CreateTexture(LLGI::Vec2I(16, 16), false, false);
+
+		auto texture_buf = (LLGI::Color8*)textures[i]->Lock();
+		for (int p = 0; p < 16 * 16; p++)
+		{
+			texture_buf[p] = LLGI::Color8(i * 64, 255 - i * 64, 255, 255);
+		}
+		textures[i]->Unlock();
+	}
+
+	LLGI::Shader* shader_vs = nullptr;
+	LLGI::Shader* shader_ps = nullptr;
+
+	std::vector<LLGI::DataStructure> data_vs;
+	std::vector<LLGI::DataStructure> data_ps;
+
+	if (compiler == nullptr)
+	{
+		auto binary_vs = LoadData("Shaders/SPIRV/simple_texture_rectangle.vert.spv");
+		auto binary_ps = LoadData("Shaders/SPIRV/simple_texture_rectangle.frag.spv");
+
+		LLGI::DataStructure d_vs;
+		LLGI::DataStructure d_ps;
+
+		d_vs.Data = binary_vs.data();
+		d_vs.Size = binary_vs.size();
+		d_ps.Data = binary_ps.data();
+		d_ps.Size = binary_ps.size();
+
+		data_vs.push_back(d_vs);
+		data_ps.push_back(d_ps);
+
+		shader_vs = graphics->CreateShader(data_vs.data(), data_vs.size());
+		shader_ps = graphics->CreateShader(data_ps.data(), data_ps.size());
+	}
+	else
+	{
+		LLGI::CompilerResult result_vs;
+		LLGI::CompilerResult result_ps;
+
+		if (platform->GetDeviceType() == LLGI::DeviceType::Metal)
+		{
+			auto code_vs = LoadData("Shaders/Metal/simple_texture_rectangle.vert");
+			auto code_ps = LoadData("Shaders/Metal/simple_texture_rectangle.frag");
+			code_vs.push_back(0);
+			code_ps.push_back(0);
+
+			compiler->Compile(result_vs, (const char*)code_vs.data(), LLGI::ShaderStageType::Vertex);
+			compiler->Compile(result_ps, (const char*)code_ps.data(), LLGI::ShaderStageType::Pixel);
+		}
+		else if (platform->GetDeviceType() == LLGI::DeviceType::DirectX12)
+		{
+			compiler->Compile(result_vs, code_dx_vs, LLGI::ShaderStageType::Vertex);
+			assert(result_vs.Message == "");
+			compiler->Compile(result_ps, code_dx_ps, LLGI::ShaderStageType::Pixel);
+			assert(result_ps.Message == "");
+		}
+
+		for (auto& b : result_vs.Binary)
+		{
+			LLGI::DataStructure d;
+			d.Data = b.data();
+			d.Size = b.size();
+			data_vs.push_back(d);
+		}
+
+		for (auto& b : result_ps.Binary)
+		{
+			LLGI::DataStructure d;
+			d.Data = b.data();
+			d.Size = b.size();
+			data_ps.push_back(d);
+		}
+
+		shader_vs = graphics->CreateShader(data_vs.data(), data_vs.size());
+		shader_ps = graphics->CreateShader(data_ps.data(), data_ps.size());
+	}
+
+	std::map<std::shared_ptr<LLGI::RenderPassPipelineState>, std::shared_ptr<LLGI::PipelineState>> pips;
+
+	while (count < 1000)
+	{
+		if (!platform->NewFrame())
+		{
+			break;
+		}
+
+		graphics->NewFrame();
+
+		auto renderPass = graphics->GetCurrentScreen(LLGI::Color8(0, 0, 0, 255), true);
+		auto renderPassPipelineState = LLGI::CreateSharedPtr(renderPass->CreateRenderPassPipelineState());
+
+		if (pips.count(renderPassPipelineState) == 0)
+		{
+			auto pip = graphics->CreatePiplineState();
+			pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+			pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+			pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+			pip->VertexLayoutNames[0] = "POSITION";
+			pip->VertexLayoutNames[1] = "UV";
+			pip->VertexLayoutNames[2] = "COLOR";
+			pip->VertexLayoutCount = 3;
+
+			pip->Culling = LLGI::CullingMode::DoubleSide;
+			pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs);
+			pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps);
+			pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+			pip->Compile();
+
+			pips[renderPassPipelineState] = LLGI::CreateSharedPtr(pip);
+		}
+
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass);
+
+		// textures are interleaved to check that sprites are sorted into a few draw calls
+		spriteBatch->Begin(commandList, pips[renderPassPipelineState].get(), true);
+		for (int i = 0; i < spriteCount; i++)
+		{
+			auto x = ((i * 37 + count) % 1000) / 500.0f - 1.0f;
+			auto y = ((i * 91) % 1000) / 500.0f - 1.0f;
+			spriteBatch->Draw(textures[i % textureCount],
+							  LLGI::Vec2F(x, y),
+							  LLGI::Vec2F(0.01f, 0.01f),
+							  LLGI::Vec2F(0.0f, 0.0f),
+							  LLGI::Vec2F(1.0f, 1.0f),
+							  LLGI::Color8(255, 255, 255, 128));
+		}
+		spriteBatch->End();
+
+		if (count == 0)
+		{
+			std::cout << "SpriteBatch : " << spriteCount << " sprites in " << spriteBatch->GetDrawCallCount() << " draw calls"
+					  << std::endl;
+
+			// a run of sorted sprites is split only at the end of a draw call
+			const auto maxDrawCallCount =
+				(spriteCount + LLGI::SpriteBatch::MaxSpriteCountPerDraw - 1) / LLGI::SpriteBatch::MaxSpriteCountPerDraw + textureCount;
+			assert(spriteBatch->GetDrawCallCount() <= maxDrawCallCount);
+
+			// without sorting, the order is kept and a draw call is issued for each run of the same texture
+			spriteBatch->Begin(commandList, pips[renderPassPipelineState].get(), false);
+			for (int i = 0; i < textureCount * 4; i++)
+			{
+				spriteBatch->Draw(
+					textures[i / 4], LLGI::Vec2F(0.0f, 0.0f), LLGI::Vec2F(0.01f, 0.01f), LLGI::Vec2F(0.0f, 0.0f), LLGI::Vec2F(1.0f, 1.0f));
+			}
+			for (int i = 0; i < textureCount * 2; i++)
+			{
+				spriteBatch->Draw(textures[i % textureCount],
+								  LLGI::Vec2F(0.0f, 0.0f),
+								  LLGI::Vec2F(0.01f, 0.01f),
+								  LLGI::Vec2F(0.0f, 0.0f),
+								  LLGI::Vec2F(1.0f, 1.0f));
+			}
+			spriteBatch->End();
+			assert(spriteBatch->GetDrawCallCount() == textureCount + textureCount * 2);
+		}
+
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+	}
+
+	pips.clear();
+
+	for (auto& texture : textures)
+	{
+		LLGI::SafeRelease(texture);
+	}
+
+	LLGI::SafeRelease(shader_vs);
+	LLGI::SafeRelease(shader_ps);
+	LLGI::SafeRelease(spriteBatch);
+	LLGI::SafeRelease(commandList);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+
+	LLGI::SafeRelease(compiler);
+}
@@ -0,0 +1,291 @@
+#include "test.h"
+#include <LLGI.SpriteBatch.h>
+#include <LLGI.TextureAtlas.h>
+#include <map>
+
+static std::vector<uint8_t> LoadData(const char* path)
+{
+	std::vector<uint8_t> ret;
+
+#ifdef _WIN32
+	FILE* fp = nullptr;
+	fopen_s(&fp, path, "rb");
+
+#else
+	FILE* fp = fopen(path, "rb");
+#endif
+
+	if (fp == nullptr)
+		return ret;
+
+	fseek(fp, 0, SEEK_END);
+	auto size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	ret.resize(size);
+	fread(ret.data(), 1, size, fp);
+	fclose(fp);
+
+	return ret;
+}
+
+void test_textureatlas(LLGI::DeviceType deviceType)
+{
+	auto code_dx_vs = R"(
+struct VS_INPUT{
+    float3 Position : POSITION0;
+	float2 UV : UV0;
+    float4 Color : COLOR0;
+};
+struct VS_OUTPUT{
+    float4 Position : SV_POSITION;
+	float2 UV : UV0;
+    float4 Color : COLOR0;
+};
+
+VS_OUTPUT main(VS_INPUT input){
+    VS_OUTPUT output;
+
+    output.Position = float4(input.Position, 1.0f);
+	output.UV = input.UV;
+    output.Color = input.Color;
+
+    return output;
+}
+)";
+
+	auto code_dx_ps = R"(
+Texture2D txt : register(t8);
+SamplerState smp : register(s8);
+
+struct PS_INPUT
+{
+    float4  Position : SV_POSITION;
+	float2  UV : UV0;
+    float4  Color    : COLOR0;
+};
+
+float4 main(PS_INPUT input) : SV_TARGET
+{
+	return input.Color * txt.Sample(smp, input.UV);
+}
+)";
+
+	const int imageCount = 512;
+
+	auto compiler = LLGI::CreateCompiler(deviceType);
+
+	int count = 0;
+
+	auto platform = LLGI::CreatePlatform(deviceType);
+	auto graphics = platform->CreateGraphics();
+	auto commandList = graphics->CreateCommandList();
+
+	auto spriteBatch = new LLGI::SpriteBatch();
+	if (!spriteBatch->Initialize(graphics))
+	{
+		std::cout << "Failed to initialize SpriteBatch" << std::endl;
+	}
+
+	auto atlas = new LLGI::TextureAtlas();
+	if (!atlas->Initialize(graphics, LLGI::Vec2I(256, 256)))
+	{
+		std::cout << "Failed to initialize TextureAtlas" << std::endl;
+	}
+
+	// images with various sizes like glyphs and icons
+	std::vector<LLGI::TextureAtlasRegion> regions(imageCount);
+	std::vector<LLGI::Color8> pixels;
+	for (int i = 0; i < imageCount; i++)
+	{
+		auto size = LLGI::Vec2I(4 + (i * 7) % 28, 4 + (i * 13) % 28);
+		if (!atlas->Allocate(size, regions[i]))
+		{
+			std::cout << "Failed to allocate " << i << std::endl;
+			continue;
+		}
+
+		pixels.assign(size.X * size.Y, LLGI::Color8((i * 37) % 256, (i * 91) % 256, 255, 255));
+		atlas->Update(regions[i], pixels.data());
+	}
+
+	// freed rectangles are reused
+	for (int i = 0; i < imageCount; i += 2)
+	{
+		atlas->Free(regions[i]);
+		auto size = regions[i].Size;
+		atlas->Allocate(size, regions[i]);
+
+		pixels.assign(size.X * size.Y, LLGI::Color8(255, (i * 91) % 256, (i * 37) % 256, 255));
+		atlas->Update(regions[i], pixels.data());
+	}
+
+	// a rectangle which is freed twice is not reused twice
+	{
+		auto freed = regions[1];
+		atlas->Free(freed);
+		atlas->Free(freed);
+
+		LLGI::TextureAtlasRegion another;
+		atlas->Allocate(freed.Size, regions[1]);
+		atlas->Allocate(freed.Size, another);
+
+		assert(regions[1].Page != another.Page || regions[1].Position.X != another.Position.X ||
+			   regions[1].Position.Y != another.Position.Y);
+
+		pixels.assign(freed.Size.X * freed.Size.Y, LLGI::Color8(255, 255, 255, 255));
+		atlas->Update(regions[1], pixels.data());
+		atlas->Free(another);
+	}
+
+	atlas->Flush();
+
+	std::cout << "TextureAtlas : " << imageCount << " images in " << atlas->GetPageCount() << " pages" << std::endl;
+
+	LLGI::Shader* shader_vs = nullptr;
+	LLGI::Shader* shader_ps = nullptr;
+
+	std::vector<LLGI::DataStructure> data_vs;
+	std::vector<LLGI::DataStructure> data_ps;
+
+	if (compiler == nullptr)
+	{
+		auto binary_vs = LoadData("Shaders/SPIRV/simple_texture_rectangle.vert.spv");
+		auto binary_ps = LoadData("Shaders/SPIRV/simple_texture_rectangle.frag.spv");
+
+		LLGI::DataStructure d_vs;
+		LLGI::DataStructure d_ps;
+
+		d_vs.Data = binary_vs.data();
+		d_vs.Size = binary_vs.size();
+		d_ps.Data = binary_ps.data();
+		d_ps.Size = binary_ps.size();
+
+		data_vs.push_back(d_vs);
+		data_ps.push_back(d_ps);
+
+		shader_vs = graphics->CreateShader(data_vs.data(), data_vs.size());
+		shader_ps = graphics->CreateShader(data_ps.data(), data_ps.size());
+	}
+	else
+	{
+		LLGI::CompilerResult result_vs;
+		LLGI::CompilerResult result_ps;
+
+		if (platform->GetDeviceType() == LLGI::DeviceType::Metal)
+		{
+			auto code_vs = LoadData("Shaders/Metal/simple_texture_rectangle.vert");
+			auto code_ps = LoadData("Shaders/Metal/simple_texture_rectangle.frag");
+			code_vs.push_back(0);
+			code_ps.push_back(0);
+
+			compiler->Compile(result_vs, (const char*)code_vs.data(), LLGI::ShaderStageType::Vertex);
+			compiler->Compile(result_ps, (const char*)code_ps.data(), LLGI::ShaderStageType::Pixel);
+		}
+		else if (platform->GetDeviceType() == LLGI::DeviceType::DirectX12)
+		{
+			compiler->Compile(result_vs, code_dx_vs, LLGI::ShaderStageType::Vertex);
+			assert(result_vs.Message == "");
+			compiler->Compile(result_ps, code_dx_ps, LLGI::ShaderStageType::Pixel);
+			assert(result_ps.Message == "");
+		}
+
+		for (auto& b : result_vs.Binary)
+		{
+			LLGI::DataStructure d;
+			d.Data = b.data();
+			d.Size = b.size();
+			data_vs.push_back(d);
+		}
+
+		for (auto& b : result_ps.Binary)
+		{
+			LLGI::DataStructure d;
+			d.Data = b.data();
+			d.Size = b.size();
+			data_ps.push_back(d);
+		}
+
+		shader_vs = graphics->CreateShader(data_vs.data(), data_vs.size());
+		shader_ps = graphics->CreateShader(data_ps.data(), data_ps.size());
+	}
+
+	std::map<std::shared_ptr<LLGI::RenderPassPipelineState>, std::shared_ptr<LLGI::PipelineState>> pips;
+
+	while (count < 1000)
+	{
+		if (!platform->NewFrame())
+		{
+			break;
+		}
+
+		graphics->NewFrame();
+
+		auto renderPass = graphics->GetCurrentScreen(LLGI::Color8(0, 0, 0, 255), true);
+		auto renderPassPipelineState = LLGI::CreateSharedPtr(renderPass->CreateRenderPassPipelineState());
+
+		if (pips.count(renderPassPipelineState) == 0)
+		{
+			auto pip = graphics->CreatePiplineState();
+			pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+			pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+			pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+			pip->VertexLayoutNames[0] = "POSITION";
+			pip->VertexLayoutNames[1] = "UV";
+			pip->VertexLayoutNames[2] = "COLOR";
+			pip->VertexLayoutCount = 3;
+
+			pip->Culling = LLGI::CullingMode::DoubleSide;
+			pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs);
+			pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps);
+			pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+			pip->Compile();
+
+			pips[renderPassPipelineState] = LLGI::CreateSharedPtr(pip);
+		}
+
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass);
+
+		spriteBatch->Begin(commandList, pips[renderPassPipelineState].get(), true);
+		for (int i = 0; i < imageCount; i++)
+		{
+			if (!regions[i].IsValid())
+				continue;
+
+			auto x = ((i % 32) / 16.0f) - 1.0f;
+			auto y = ((i / 32) / 8.0f) - 1.0f;
+			spriteBatch->Draw(atlas->GetTexture(regions[i].Page),
+							  LLGI::Vec2F(x, y),
+							  LLGI::Vec2F(regions[i].Size.X / 640.0f, regions[i].Size.Y / 480.0f),
+							  regions[i].UVPosition,
+							  regions[i].UVSize);
+		}
+		spriteBatch->End();
+
+		if (count == 0)
+		{
+			std::cout << "TextureAtlas : " << spriteBatch->GetDrawCallCount() << " draw calls" << std::endl;
+		}
+
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+	}
+
+	pips.clear();
+
+	LLGI::SafeRelease(shader_vs);
+	LLGI::SafeRelease(shader_ps);
+	LLGI::SafeRelease(spriteBatch);
+	LLGI::SafeRelease(atlas);
+	LLGI::SafeRelease(commandList);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+
+	LLGI::SafeRelease(compiler);
+}
@@ -0,0 +1,179 @@
+#include "test.h"
+#include <LLGI.SpriteBatch.h>
+
+static std::vector<uint8_t> LoadData(const char* path)
+{
+	std::vector<uint8_t> ret;
+
+#ifdef _WIN32
+	FILE* fp = nullptr;
+	fopen_s(&fp, path, "rb");
+
+#else
+	FILE* fp = fopen(path, "rb");
+#endif
+
+	if (fp == nullptr)
+		return ret;
+
+	fseek(fp, 0, SEEK_END);
+	auto size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	ret.resize(size);
+	fread(ret.data(), 1, size, fp);
+	fclose(fp);
+
+	return ret;
+}
+
+void test_texturestreaming(LLGI::DeviceType deviceType)
+{
+	auto platform = LLGI::CreatePlatform(deviceType);
+
+	// streamed textures are supported only on Vulkan
+	if (platform->GetDeviceType() != LLGI::DeviceType::Vulkan)
+	{
+		std::cout << "Texture streaming is not supported" << std::endl;
+		LLGI::SafeRelease(platform);
+		return;
+	}
+
+	auto graphics = platform->CreateGraphics();
+	auto commandList = graphics->CreateCommandList();
+
+	LLGI::TextureInitializationParameter parameter;
+	parameter.Size = LLGI::Vec2I(256, 256);
+	parameter.MipMapCount = 0;
+	parameter.IsStreamed = true;
+
+	auto texture = graphics->CreateTexture(parameter);
+	assert(texture != nullptr);
+	assert(texture->IsStreamed());
+
+	auto mipMapCount = texture->GetMipMapCount();
+	assert(mipMapCount == 9);
+	assert(texture->GetResidentMipMap() == mipMapCount);
+
+	// levels have different colors to see which level is sampled
+	std::vector<std::vector<LLGI::Color8>> levels(mipMapCount);
+	for (int32_t i = 0; i < mipMapCount; i++)
+	{
+		auto size = std::max(parameter.Size.X >> i, 1) * std::max(parameter.Size.Y >> i, 1);
+		levels[i].assign(size, LLGI::Color8((i * 71) % 256, (i * 29) % 256, 255 - i * 28, 255));
+	}
+
+	// a request with a wrong size or for a texture which is not streamed is rejected
+	assert(!graphics->RequestTextureMipMap(texture, 0, levels[1].data(), static_cast<int32_t>(levels[1].size() * sizeof(LLGI::Color8))));
+	assert(!graphics->RequestTextureMipMap(texture, mipMapCount, levels[0].data(), sizeof(LLGI::Color8)));
+
+	auto plainTexture = graphics->CreateTexture(LLGI::Vec2I(1, 1), false, false);
+	assert(!graphics->RequestTextureMipMap(plainTexture, 0, levels[mipMapCount - 1].data(), sizeof(LLGI::Color8)));
+	LLGI::SafeRelease(plainTexture);
+
+	// coarse levels are requested first and the finest level is larger than the budget
+	for (int32_t i = mipMapCount - 1; i >= 0; i--)
+	{
+		auto size = static_cast<int32_t>(levels[i].size() * sizeof(LLGI::Color8));
+		auto result = graphics->RequestTextureMipMap(texture, i, levels[i].data(), size);
+		assert(result);
+	}
+
+	graphics->SetTextureStreamingBudget(64 * 1024);
+	assert(graphics->GetPendingTextureMipMapCount() == mipMapCount);
+
+	auto spriteBatch = new LLGI::SpriteBatch();
+	if (!spriteBatch->Initialize(graphics))
+	{
+		std::cout << "Failed to initialize SpriteBatch" << std::endl;
+	}
+
+	LLGI::DataStructure d_vs;
+	LLGI::DataStructure d_ps;
+	auto binary_vs = LoadData("Shaders/SPIRV/simple_texture_rectangle.vert.spv");
+	auto binary_ps = LoadData("Shaders/SPIRV/simple_texture_rectangle.frag.spv");
+	d_vs.Data = binary_vs.data();
+	d_vs.Size = binary_vs.size();
+	d_ps.Data = binary_ps.data();
+	d_ps.Size = binary_ps.size();
+
+	auto shader_vs = graphics->CreateShader(&d_vs, 1);
+	auto shader_ps = graphics->CreateShader(&d_ps, 1);
+
+	auto renderPassPipelineState = graphics->GetCurrentScreen()->CreateRenderPassPipelineState();
+
+	auto pip = graphics->CreatePiplineState();
+	pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+	pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+	pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+	pip->VertexLayoutNames[0] = "POSITION";
+	pip->VertexLayoutNames[1] = "UV";
+	pip->VertexLayoutNames[2] = "COLOR";
+	pip->VertexLayoutCount = 3;
+	pip->Culling = LLGI::CullingMode::DoubleSide;
+	pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs);
+	pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps);
+	pip->SetRenderPassPipelineState(renderPassPipelineState);
+	pip->Compile();
+
+	LLGI::SafeRelease(renderPassPipelineState);
+
+	int count = 0;
+	int uploadedFrame = -1;
+	auto residentMipMap = mipMapCount;
+
+	while (count < 120)
+	{
+		if (!platform->NewFrame())
+		{
+			break;
+		}
+
+		// requests are uploaded under the budget in NewFrame
+		graphics->NewFrame();
+
+		// levels become resident from the coarsest one, and at least one level is uploaded in a frame
+		assert(texture->GetResidentMipMap() <= residentMipMap);
+		assert(residentMipMap == 0 || texture->GetResidentMipMap() < residentMipMap);
+		residentMipMap = texture->GetResidentMipMap();
+
+		if (uploadedFrame < 0 && graphics->GetPendingTextureMipMapCount() == 0)
+		{
+			assert(residentMipMap == 0);
+			uploadedFrame = count;
+		}
+
+		commandList->Begin();
+		commandList->BeginRenderPass(graphics->GetCurrentScreen(LLGI::Color8(0, 0, 0, 255), true));
+
+		// a texture is drawn while it is streamed
+		if (residentMipMap < mipMapCount)
+		{
+			spriteBatch->Begin(commandList, pip, true);
+			spriteBatch->Draw(
+				texture, LLGI::Vec2F(-0.5f, -0.5f), LLGI::Vec2F(1.0f, 1.0f), LLGI::Vec2F(0.0f, 0.0f), LLGI::Vec2F(1.0f, 1.0f));
+			spriteBatch->End();
+		}
+
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+	}
+
+	graphics->WaitFinish();
+
+	std::cout << "TextureStreaming : " << mipMapCount << " levels are uploaded in " << (uploadedFrame + 1) << " frames" << std::endl;
+
+	LLGI::SafeRelease(pip);
+	LLGI::SafeRelease(shader_vs);
+	LLGI::SafeRelease(shader_ps);
+	LLGI::SafeRelease(spriteBatch);
+	LLGI::SafeRelease(texture);
+	LLGI::SafeRelease(commandList);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
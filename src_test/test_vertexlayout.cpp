@@ -0,0 +1,303 @@
+#include "test.h"
+#include <map>
+
+static std::vector<uint8_t> LoadData(const char* path)
+{
+	std::vector<uint8_t> ret;
+
+#ifdef _WIN32
+	FILE* fp = nullptr;
+	fopen_s(&fp, path, "rb");
+
+#else
+	FILE* fp = fopen(path, "rb");
+#endif
+
+	if (fp == nullptr)
+		return ret;
+
+	fseek(fp, 0, SEEK_END);
+	auto size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	ret.resize(size);
+	fread(ret.data(), 1, size, fp);
+	fclose(fp);
+
+	return ret;
+}
+
+// a vertex whose attributes are compact and are not in order of a layout
+struct PackedVertex
+{
+	LLGI::Vec3F Pos;
+	LLGI::Color8 Color;
+	uint16_t UV[2];
+	uint32_t Padding;
+};
+
+void test_vertexlayout(LLGI::DeviceType deviceType)
+{
+	auto code_dx_vs = R"(
+struct VS_INPUT{
+    float3 Position : POSITION0;
+	float2 UV : UV0;
+    float4 Color : COLOR0;
+};
+struct VS_OUTPUT{
+    float4 Position : SV_POSITION;
+	float2 UV : UV0;
+    float4 Color : COLOR0;
+};
+
+VS_OUTPUT main(VS_INPUT input){
+    VS_OUTPUT output;
+
+    output.Position = float4(input.Position, 1.0f);
+	output.UV = input.UV;
+    output.Color = input.Color;
+
+    return output;
+}
+)";
+
+	auto code_dx_ps = R"(
+Texture2D txt : register(t8);
+SamplerState smp : register(s8);
+
+struct PS_INPUT
+{
+    float4  Position : SV_POSITION;
+	float2  UV : UV0;
+    float4  Color    : COLOR0;
+};
+
+float4 main(PS_INPUT input) : SV_TARGET
+{
+	return input.Color * txt.Sample(smp, input.UV);
+}
+)";
+
+	// sizes of compact formats
+	assert(LLGI::GetVertexLayoutFormatSize(LLGI::VertexLayoutFormat::R16G16_FLOAT) == 4);
+	assert(LLGI::GetVertexLayoutFormatSize(LLGI::VertexLayoutFormat::R16G16B16A16_FLOAT) == 8);
+	assert(LLGI::GetVertexLayoutFormatSize(LLGI::VertexLayoutFormat::R16G16_SNORM) == 4);
+	assert(LLGI::GetVertexLayoutFormatSize(LLGI::VertexLayoutFormat::R16G16B16A16_SNORM) == 8);
+	assert(LLGI::GetVertexLayoutFormatSize(LLGI::VertexLayoutFormat::R16G16_UNORM) == 4);
+	assert(LLGI::GetVertexLayoutFormatSize(LLGI::VertexLayoutFormat::R16G16B16A16_UNORM) == 8);
+	assert(LLGI::GetVertexLayoutFormatSize(LLGI::VertexLayoutFormat::R8G8B8A8_SNORM) == 4);
+	assert(LLGI::GetVertexLayoutFormatSize(LLGI::VertexLayoutFormat::R10G10B10A2_UNORM) == 4);
+	assert(LLGI::GetVertexLayoutFormatSize(LLGI::VertexLayoutFormat::R16G16B16A16_UINT) == 8);
+	assert(LLGI::GetVertexLayoutFormatSize(LLGI::VertexLayoutFormat::R32_UINT) == 4);
+
+	auto compiler = LLGI::CreateCompiler(deviceType);
+
+	int count = 0;
+
+	auto platform = LLGI::CreatePlatform(deviceType);
+	auto graphics = platform->CreateGraphics();
+	auto commandList = graphics->CreateCommandList();
+	auto vb = graphics->CreateVertexBuffer(sizeof(PackedVertex) * 4);
+	auto ib = graphics->CreateIndexBuffer(2, 6);
+
+	// offsets and strides which are computed from formats
+	{
+		auto pip = graphics->CreatePiplineState();
+		pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+		pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R16G16_UNORM;
+		pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+		pip->VertexLayouts[3] = LLGI::VertexLayoutFormat::R16G16B16A16_FLOAT;
+		pip->VertexLayoutSlots[3] = 1;
+		pip->VertexLayoutCount = 4;
+
+		assert(pip->GetVertexLayoutOffset(0) == 0);
+		assert(pip->GetVertexLayoutOffset(1) == 12);
+		assert(pip->GetVertexLayoutOffset(2) == 16);
+		assert(pip->GetVertexLayoutOffset(3) == 0);
+		assert(pip->GetVertexStride(0) == 20);
+		assert(pip->GetVertexStride(1) == 8);
+
+		// an attribute after an explicit offset follows it
+		pip->VertexLayoutOffsets[1] = 16;
+		assert(pip->GetVertexLayoutOffset(2) == 20);
+		assert(pip->GetVertexStride(0) == 24);
+
+		pip->VertexStrides[0] = 32;
+		assert(pip->GetVertexStride(0) == 32);
+
+		LLGI::SafeRelease(pip);
+	}
+
+	auto texture = graphics->CreateTexture(LLGI::Vec2I(256, 256), false, false);
+
+	auto texture_buf = (LLGI::Color8*)texture->Lock();
+	for (int y = 0; y < 256; y++)
+	{
+		for (int x = 0; x < 256; x++)
+		{
+			texture_buf[x + y * 256] = LLGI::Color8(x, y, 255, 255);
+		}
+	}
+	texture->Unlock();
+
+	LLGI::Shader* shader_vs = nullptr;
+	LLGI::Shader* shader_ps = nullptr;
+
+	std::vector<LLGI::DataStructure> data_vs;
+	std::vector<LLGI::DataStructure> data_ps;
+
+	if (compiler == nullptr)
+	{
+		auto binary_vs = LoadData("Shaders/SPIRV/simple_texture_rectangle.vert.spv");
+		auto binary_ps = LoadData("Shaders/SPIRV/simple_texture_rectangle.frag.spv");
+
+		LLGI::DataStructure d_vs;
+		LLGI::DataStructure d_ps;
+
+		d_vs.Data = binary_vs.data();
+		d_vs.Size = binary_vs.size();
+		d_ps.Data = binary_ps.data();
+		d_ps.Size = binary_ps.size();
+
+		data_vs.push_back(d_vs);
+		data_ps.push_back(d_ps);
+
+		shader_vs = graphics->CreateShader(data_vs.data(), data_vs.size());
+		shader_ps = graphics->CreateShader(data_ps.data(), data_ps.size());
+	}
+	else
+	{
+		LLGI::CompilerResult result_vs;
+		LLGI::CompilerResult result_ps;
+
+		if (platform->GetDeviceType() == LLGI::DeviceType::Metal)
+		{
+			auto code_vs = LoadData("Shaders/Metal/simple_texture_rectangle.vert");
+			auto code_ps = LoadData("Shaders/Metal/simple_texture_rectangle.frag");
+			code_vs.push_back(0);
+			code_ps.push_back(0);
+
+			compiler->Compile(result_vs, (const char*)code_vs.data(), LLGI::ShaderStageType::Vertex);
+			compiler->Compile(result_ps, (const char*)code_ps.data(), LLGI::ShaderStageType::Pixel);
+		}
+		else if (platform->GetDeviceType() == LLGI::DeviceType::DirectX12)
+		{
+			compiler->Compile(result_vs, code_dx_vs, LLGI::ShaderStageType::Vertex);
+			assert(result_vs.Message == "");
+			compiler->Compile(result_ps, code_dx_ps, LLGI::ShaderStageType::Pixel);
+			assert(result_ps.Message == "");
+		}
+
+		for (auto& b : result_vs.Binary)
+		{
+			LLGI::DataStructure d;
+			d.Data = b.data();
+			d.Size = b.size();
+			data_vs.push_back(d);
+		}
+
+		for (auto& b : result_ps.Binary)
+		{
+			LLGI::DataStructure d;
+			d.Data = b.data();
+			d.Size = b.size();
+			data_ps.push_back(d);
+		}
+
+		shader_vs = graphics->CreateShader(data_vs.data(), data_vs.size());
+		shader_ps = graphics->CreateShader(data_ps.data(), data_ps.size());
+	}
+
+	auto vb_buf = (PackedVertex*)vb->Lock();
+	vb_buf[0].Pos = LLGI::Vec3F(-0.5f, 0.5f, 0.5f);
+	vb_buf[1].Pos = LLGI::Vec3F(0.5f, 0.5f, 0.5f);
+	vb_buf[2].Pos = LLGI::Vec3F(0.5f, -0.5f, 0.5f);
+	vb_buf[3].Pos = LLGI::Vec3F(-0.5f, -0.5f, 0.5f);
+
+	// uvs are normalized from 16 bits
+	const uint16_t uvs[4][2] = {{0, 0}, {65535, 0}, {65535, 65535}, {0, 65535}};
+	for (int i = 0; i < 4; i++)
+	{
+		vb_buf[i].UV[0] = uvs[i][0];
+		vb_buf[i].UV[1] = uvs[i][1];
+		vb_buf[i].Color = LLGI::Color8(255, 255, 255, 255);
+		vb_buf[i].Padding = 0;
+	}
+	vb->Unlock();
+
+	auto ib_buf = (uint16_t*)ib->Lock();
+	ib_buf[0] = 0;
+	ib_buf[1] = 1;
+	ib_buf[2] = 2;
+	ib_buf[3] = 0;
+	ib_buf[4] = 2;
+	ib_buf[5] = 3;
+	ib->Unlock();
+
+	std::map<std::shared_ptr<LLGI::RenderPassPipelineState>, std::shared_ptr<LLGI::PipelineState>> pips;
+
+	while (count < 1000)
+	{
+		if (!platform->NewFrame())
+		{
+			break;
+		}
+
+		graphics->NewFrame();
+
+		auto renderPass = graphics->GetCurrentScreen(LLGI::Color8(0, 0, 0, 255), true);
+		auto renderPassPipelineState = LLGI::CreateSharedPtr(renderPass->CreateRenderPassPipelineState());
+
+		if (pips.count(renderPassPipelineState) == 0)
+		{
+			auto pip = graphics->CreatePiplineState();
+			pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+			pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R16G16_UNORM;
+			pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+			pip->VertexLayoutNames[0] = "POSITION";
+			pip->VertexLayoutNames[1] = "UV";
+			pip->VertexLayoutNames[2] = "COLOR";
+			pip->VertexLayoutOffsets[1] = 16;
+			pip->VertexLayoutOffsets[2] = 12;
+			pip->VertexStrides[0] = sizeof(PackedVertex);
+			pip->VertexLayoutCount = 3;
+
+			pip->Culling = LLGI::CullingMode::DoubleSide;
+			pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs);
+			pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps);
+			pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+			pip->Compile();
+
+			pips[renderPassPipelineState] = LLGI::CreateSharedPtr(pip);
+		}
+
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass);
+		commandList->SetVertexBuffer(vb, sizeof(PackedVertex), 0);
+		commandList->SetIndexBuffer(ib);
+		commandList->SetPipelineState(pips[renderPassPipelineState].get());
+		commandList->SetTexture(
+			texture, LLGI::TextureWrapMode::Repeat, LLGI::TextureMinMagFilter::Nearest, 0, LLGI::ShaderStageType::Pixel);
+		commandList->Draw(2);
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+	}
+
+	pips.clear();
+
+	LLGI::SafeRelease(texture);
+	LLGI::SafeRelease(shader_vs);
+	LLGI::SafeRelease(shader_ps);
+	LLGI::SafeRelease(ib);
+	LLGI::SafeRelease(vb);
+	LLGI::SafeRelease(commandList);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+
+	LLGI::SafeRelease(compiler);
+}